@@ -0,0 +1,151 @@
+//
+// Codecs of the partial psi functions of PsiCoreRLE: Elias-delta codes (enc_vector) vs. byte-aligned codes decoded in
+// blocks (StreamVByteVector), and the per-symbol choice of PsiCoreHybrid, on the decode-bound count and locate queries
+// of the CSA and their space.
+//
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <gflags/gflags.h>
+
+#include <sdsl/config.hpp>
+
+#include "sr-index/psi_hybrid.h"
+#include "sr-index/r_csa.h"
+#include "sr-index/sr_csa.h"
+
+DEFINE_string(data, "", "Data file. (MANDATORY)");
+DEFINE_string(sa_algo, "SDSL_SE_SAIS", "Suffix Array Algorithm: SDSL_SE_SAIS, SDSL_LIBDIVSUFSORT, BIG_BWT");
+DEFINE_int32(sr, 16, "Subsampling parameter s of the SR-CSA.");
+DEFINE_int32(n_patterns, 1000, "Number of patterns sampled from the text.");
+DEFINE_int32(min_len, 8, "Minimum length of the patterns.");
+DEFINE_int32(max_len, 32, "Maximum length of the patterns.");
+
+using PsiEliasDelta = sri::PsiCoreRLE<>;
+using PsiStreamVByte = sri::PsiCoreRLE<sri::StreamVByteVector<>>;
+using PsiHybrid = sri::PsiCoreHybrid<>;
+
+template<typename TPsiCore>
+using RCSA = sri::RCSAWithBWTRun<sri::GenericStorage, sri::Alphabet<>, TPsiCore>;
+
+template<typename TPsiCore>
+using SrCSA = sri::SrCSA<sri::GenericStorage, sri::Alphabet<>, TPsiCore>;
+
+//! Substrings of the text
+auto SamplePatterns(const std::string &t_text, std::size_t t_len) {
+  std::mt19937_64 gen(42);
+  t_len = std::min(t_len, t_text.size());
+  std::uniform_int_distribution<std::size_t> dist(0, t_text.size() - t_len);
+
+  std::vector<std::string> patterns;
+  for (int i = 0; i < FLAGS_n_patterns; ++i) {
+    patterns.emplace_back(t_text.substr(dist(gen), t_len));
+  }
+
+  return patterns;
+}
+
+template<typename TIndex>
+void SetSizeCounters(benchmark::State &t_state, const TIndex &t_index) {
+  std::size_t psi_size = 0;
+  for (const auto &[name, size] : t_index.breakdown()) {
+    if (name == "psi") psi_size = size;
+  }
+  const auto size = sdsl::size_in_bytes(t_index);
+  t_state.counters["Size(B)"] = size;
+  t_state.counters["Bits_x_Symbol"] = double(size * 8) / double(t_index.sizeSequence());
+  t_state.counters["Psi(B)"] = psi_size;
+}
+
+template<typename TIndex>
+void BM_Count(benchmark::State &t_state, const TIndex *t_index, const std::string *t_text) {
+  auto patterns = SamplePatterns(*t_text, t_state.range(0));
+
+  std::size_t n_occs = 0;
+  for (auto _ : t_state) {
+    for (const auto &pattern : patterns) {
+      auto [start, end] = t_index->Count(pattern);
+      n_occs += start < end ? end - start : 0;
+    }
+  }
+
+  t_state.counters["Patterns"] = benchmark::Counter(patterns.size(), benchmark::Counter::kIsIterationInvariantRate);
+  t_state.counters["Occs"] = benchmark::Counter(n_occs, benchmark::Counter::kIsRate);
+  SetSizeCounters(t_state, *t_index);
+}
+
+template<typename TIndex>
+void BM_Locate(benchmark::State &t_state, const TIndex *t_index, const std::string *t_text) {
+  auto patterns = SamplePatterns(*t_text, t_state.range(0));
+
+  std::size_t n_occs = 0;
+  for (auto _ : t_state) {
+    for (const auto &pattern : patterns) {
+      auto occs = t_index->Locate(pattern);
+      benchmark::DoNotOptimize(occs.data());
+      n_occs += occs.size();
+    }
+  }
+
+  t_state.counters["Patterns"] = benchmark::Counter(patterns.size(), benchmark::Counter::kIsIterationInvariantRate);
+  t_state.counters["Occs"] = benchmark::Counter(n_occs, benchmark::Counter::kIsRate);
+  SetSizeCounters(t_state, *t_index);
+}
+
+template<typename TIndex>
+void Register(const std::string &t_name, const TIndex *t_index, const std::string *t_text) {
+  benchmark::RegisterBenchmark(("Count/" + t_name).c_str(), BM_Count<TIndex>, t_index, t_text)
+      ->ArgName("m")->RangeMultiplier(2)->Range(FLAGS_min_len, FLAGS_max_len)->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark(("Locate/" + t_name).c_str(), BM_Locate<TIndex>, t_index, t_text)
+      ->ArgName("m")->RangeMultiplier(2)->Range(FLAGS_min_len, FLAGS_max_len)->Unit(benchmark::kMillisecond);
+}
+
+int main(int argc, char *argv[]) {
+  gflags::AllowCommandLineReparsing();
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+
+  if (FLAGS_data.empty()) {
+    std::cerr << "Command-line error!!!" << std::endl;
+    return 1;
+  }
+
+  std::string data_path = FLAGS_data;
+  sri::Config config(data_path, std::filesystem::current_path(), sri::toSAAlgo(FLAGS_sa_algo));
+
+  // The indexes share the items but the psi core, built once per codec
+  RCSA<PsiEliasDelta> r_csa_ed;
+  sri::construct(r_csa_ed, data_path, config);
+  RCSA<PsiStreamVByte> r_csa_svb;
+  sri::construct(r_csa_svb, data_path, config);
+  SrCSA<PsiEliasDelta> sr_csa_ed(FLAGS_sr);
+  sri::construct(sr_csa_ed, data_path, config);
+  SrCSA<PsiStreamVByte> sr_csa_svb(FLAGS_sr);
+  sri::construct(sr_csa_svb, data_path, config);
+  RCSA<PsiHybrid> r_csa_hybrid;
+  sri::construct(r_csa_hybrid, data_path, config);
+  SrCSA<PsiHybrid> sr_csa_hybrid(FLAGS_sr);
+  sri::construct(sr_csa_hybrid, data_path, config);
+
+  std::ifstream in(data_path, std::ios::binary);
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  Register("R-CSA/EliasDelta", &r_csa_ed, &text);
+  Register("R-CSA/StreamVByte", &r_csa_svb, &text);
+  Register("SR-CSA/EliasDelta", &sr_csa_ed, &text);
+  Register("SR-CSA/StreamVByte", &sr_csa_svb, &text);
+  Register("R-CSA/Hybrid", &r_csa_hybrid, &text);
+  Register("SR-CSA/Hybrid", &sr_csa_hybrid, &text);
+
+  // StreamVByteVector decodes with SSSE3 only if the CPU has it
+  benchmark::AddCustomContext("stream_vbyte_decode", sri::stream_vbyte::decodePath());
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+//
+// Batch backward search (one traversal of the trie of reversed patterns) vs. one backward search per pattern,
+// on overlapping k-mers of reads sampled from the text.
+//
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <gflags/gflags.h>
+
+#include <sdsl/config.hpp>
+
+#include "sr-index/sr_index.h"
+
+DEFINE_string(data, "", "Data file. (MANDATORY)");
+DEFINE_string(sa_algo, "SDSL_SE_SAIS", "Suffix Array Algorithm: SDSL_SE_SAIS, SDSL_LIBDIVSUFSORT, BIG_BWT");
+DEFINE_int32(sr, 16, "Subsampling parameter s of the SR-Index.");
+DEFINE_int32(n_reads, 1000, "Number of reads sampled from the text.");
+DEFINE_int32(read_len, 150, "Length of the reads.");
+DEFINE_int32(min_k, 8, "Minimum length of the k-mers.");
+DEFINE_int32(max_k, 32, "Maximum length of the k-mers.");
+
+using Index = sri::SrIndexValidArea<>;
+
+//! Overlapping k-mers of reads sampled from the text
+auto SampleKmers(const std::string &t_text, std::size_t t_k) {
+  std::mt19937_64 gen(42);
+  std::size_t read_len = std::min<std::size_t>(FLAGS_read_len, t_text.size());
+  std::uniform_int_distribution<std::size_t> dist(0, t_text.size() - read_len);
+
+  std::vector<std::string> kmers;
+  for (int r = 0; r < FLAGS_n_reads; ++r) {
+    auto read = t_text.substr(dist(gen), read_len);
+    for (std::size_t i = 0; i + t_k <= read.size(); ++i) {
+      kmers.emplace_back(read.substr(i, t_k));
+    }
+  }
+
+  return kmers;
+}
+
+auto BM_Count = [](benchmark::State &t_state, const Index *t_index, const std::string *t_text, bool t_batch) {
+  auto kmers = SampleKmers(*t_text, t_state.range(0));
+
+  std::size_t n_occs = 0;
+  for (auto _ : t_state) {
+    if (t_batch) {
+      auto ranges = t_index->CountBatch(kmers);
+      for (const auto &[start, end] : ranges) n_occs += start < end ? end - start : 0;
+    } else {
+      for (const auto &kmer : kmers) {
+        auto [start, end] = t_index->Count(kmer);
+        n_occs += start < end ? end - start : 0;
+      }
+    }
+  }
+
+  t_state.counters["Patterns"] = benchmark::Counter(kmers.size(), benchmark::Counter::kIsIterationInvariantRate);
+  t_state.counters["Occs"] = benchmark::Counter(n_occs, benchmark::Counter::kIsRate);
+};
+
+auto BM_Locate = [](benchmark::State &t_state, const Index *t_index, const std::string *t_text, bool t_batch) {
+  auto kmers = SampleKmers(*t_text, t_state.range(0));
+
+  std::size_t n_occs = 0;
+  for (auto _ : t_state) {
+    if (t_batch) {
+      auto occs = t_index->LocateBatch(kmers);
+      for (const auto &kmer_occs : occs) n_occs += kmer_occs.size();
+    } else {
+      for (const auto &kmer : kmers) {
+        auto occs = t_index->Locate(kmer);
+        benchmark::DoNotOptimize(occs.data());
+        n_occs += occs.size();
+      }
+    }
+  }
+
+  t_state.counters["Patterns"] = benchmark::Counter(kmers.size(), benchmark::Counter::kIsIterationInvariantRate);
+  t_state.counters["Occs"] = benchmark::Counter(n_occs, benchmark::Counter::kIsRate);
+};
+
+int main(int argc, char *argv[]) {
+  gflags::AllowCommandLineReparsing();
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+
+  if (FLAGS_data.empty()) {
+    std::cerr << "Command-line error!!!" << std::endl;
+    return 1;
+  }
+
+  std::string data_path = FLAGS_data;
+  sri::Config config(data_path, std::filesystem::current_path(), sri::toSAAlgo(FLAGS_sa_algo));
+
+  Index index(FLAGS_sr);
+  sri::construct(index, data_path, config);
+
+  std::ifstream in(data_path, std::ios::binary);
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  for (const auto &[name, batch] : {std::make_pair("PerPattern", false), std::make_pair("Batch", true)}) {
+    benchmark::RegisterBenchmark((std::string("Count/") + name).c_str(), BM_Count, &index, &text, batch)
+        ->ArgName("k")->RangeMultiplier(2)->Range(FLAGS_min_k, FLAGS_max_k)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark((std::string("Locate/") + name).c_str(), BM_Locate, &index, &text, batch)
+        ->ArgName("k")->RangeMultiplier(2)->Range(FLAGS_min_k, FLAGS_max_k)->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
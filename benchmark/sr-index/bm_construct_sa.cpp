@@ -0,0 +1,87 @@
+//
+// Suffix array construction time of the SDSL algorithms and the parallel induced sorting, for several threads.
+//
+
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+#include <gflags/gflags.h>
+
+#include <benchmark/benchmark.h>
+
+#include <sdsl/config.hpp>
+#include <sdsl/construct.hpp>
+
+#include "sr-index/construct.h"
+#include "sr-index/parallel.h"
+
+DEFINE_string(data, "", "Data file. (MANDATORY)");
+DEFINE_int32(max_threads, std::thread::hardware_concurrency(), "Maximum number of threads of the parallel algorithm.");
+
+auto BM_SDSL = [](benchmark::State &t_state, sdsl::cache_config t_config, sdsl::byte_sa_algo_type t_algo) {
+  sdsl::construct_config::byte_algo_sa = t_algo;
+
+  for (auto _ : t_state) {
+    sdsl::construct_sa<8>(t_config);
+
+    t_state.PauseTiming();
+    sdsl::remove(sdsl::cache_file_name(sdsl::conf::KEY_SA, t_config));
+    t_state.ResumeTiming();
+  }
+
+  auto n = std::filesystem::file_size(FLAGS_data);
+  t_state.SetBytesProcessed(int64_t(t_state.iterations()) * n);
+  t_state.counters["n"] = n;
+  t_state.counters["threads"] = 1;
+};
+
+auto BM_ParallelSAIS = [](benchmark::State &t_state, sdsl::cache_config t_config) {
+  std::size_t n_threads = t_state.range(0);
+  sri::setConstructionThreads(n_threads);
+
+  for (auto _ : t_state) {
+    sri::inner_sdsl::constructSAParallel<8>(t_config);
+
+    t_state.PauseTiming();
+    sdsl::remove(sdsl::cache_file_name(sdsl::conf::KEY_SA, t_config));
+    t_state.ResumeTiming();
+  }
+
+  auto n = std::filesystem::file_size(FLAGS_data);
+  t_state.SetBytesProcessed(int64_t(t_state.iterations()) * n);
+  t_state.counters["n"] = n;
+  t_state.counters["threads"] = n_threads;
+};
+
+int main(int argc, char *argv[]) {
+  gflags::AllowCommandLineReparsing();
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+
+  if (FLAGS_data.empty()) {
+    std::cerr << "Command-line error!!!" << std::endl;
+    return 1;
+  }
+
+  // The text is parsed once, and every algorithm reads it from the cache and writes the SA to the cache
+  sri::Config config(FLAGS_data, std::filesystem::current_path(), sri::SDSL_LIBDIVSUFSORT);
+  sri::inner_sdsl::constructText<8>(FLAGS_data, config);
+
+  benchmark::RegisterBenchmark("SDSL_LIBDIVSUFSORT", BM_SDSL, config, sdsl::LIBDIVSUFSORT)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("SDSL_SE_SAIS", BM_SDSL, config, sdsl::SE_SAIS)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("PARALLEL_SAIS", BM_ParallelSAIS, config)
+      ->ArgName("threads")
+      ->RangeMultiplier(2)
+      ->Range(1, std::max(1, FLAGS_max_threads))
+      ->UseRealTime()
+      ->Unit(benchmark::kMillisecond);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  sdsl::remove(sdsl::cache_file_name(sdsl::key_text_trait<8>::KEY_TEXT, config));
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+//
+// Extraction throughput (MB/s) of long text ranges for several inverse suffix array sampling rates.
+//
+
+#include <iostream>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <gflags/gflags.h>
+
+#include <sdsl/config.hpp>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/extract.h"
+
+DEFINE_string(data, "", "Data file. (MANDATORY)");
+DEFINE_string(sa_algo, "SDSL_SE_SAIS", "Suffix Array Algorithm: SDSL_SE_SAIS, SDSL_LIBDIVSUFSORT, BIG_BWT");
+DEFINE_int32(sr, 16, "Subsampling parameter s of the SR-Index.");
+DEFINE_int32(min_isa_rate, 16, "Minimum inverse suffix array sampling rate.");
+DEFINE_int32(max_isa_rate, 1024, "Maximum inverse suffix array sampling rate.");
+DEFINE_int32(min_len, 1 << 10, "Minimum length of the extracted ranges.");
+DEFINE_int32(max_len, 1 << 20, "Maximum length of the extracted ranges.");
+DEFINE_int32(n_ranges, 100, "Number of extracted ranges per length.");
+
+using Index = sri::IndexExtract<sri::SrIndexValidArea<>>;
+
+auto BM_Extract = [](benchmark::State &t_state, sri::Config t_config, const std::string &t_data_path) {
+  std::size_t isa_rate = t_state.range(0);
+  std::size_t len = t_state.range(1);
+
+  Index index(FLAGS_sr, isa_rate);
+  sri::construct(index, t_data_path, t_config);
+  auto n = index.sizeSequence();
+
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<std::size_t> dist(0, n > len ? n - len - 1 : 0);
+  std::vector<std::size_t> positions(FLAGS_n_ranges);
+  for (auto &pos : positions) pos = dist(gen);
+
+  std::size_t n_bytes = 0;
+  for (auto _ : t_state) {
+    for (const auto &pos : positions) {
+      auto text = index.Extract(pos, len);
+      benchmark::DoNotOptimize(text.data());
+      n_bytes += text.size();
+    }
+  }
+
+  t_state.SetBytesProcessed(n_bytes);
+  t_state.counters["isa_rate"] = isa_rate;
+  t_state.counters["len"] = len;
+  t_state.counters["isa_samples"] = index.breakdown().back().second;
+};
+
+int main(int argc, char *argv[]) {
+  gflags::AllowCommandLineReparsing();
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+
+  if (FLAGS_data.empty()) {
+    std::cerr << "Command-line error!!!" << std::endl;
+    return 1;
+  }
+
+  std::string data_path = FLAGS_data;
+  sri::Config config(data_path, std::filesystem::current_path(), sri::toSAAlgo(FLAGS_sa_algo));
+
+  benchmark::RegisterBenchmark("Extract", BM_Extract, config, data_path)
+      ->ArgNames({"isa_rate", "len"})
+      ->RangeMultiplier(4)
+      ->Ranges({{FLAGS_min_isa_rate, FLAGS_max_isa_rate}, {FLAGS_min_len, FLAGS_max_len}})
+      ->Unit(benchmark::kMillisecond);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
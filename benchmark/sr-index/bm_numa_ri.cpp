@@ -0,0 +1,90 @@
+//
+// Multi-threaded locate on a single shared index vs. one index replica per NUMA node.
+//
+
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <gflags/gflags.h>
+
+#include <sdsl/config.hpp>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/numa.h"
+
+#include "../bm_locate.h"
+
+DEFINE_string(patterns, "", "Patterns file. (MANDATORY)");
+DEFINE_string(index, "", "Serialized SR-Index (valid area) file. (MANDATORY)");
+
+DEFINE_bool(huge_pages, false, "Back the indexes with huge pages.");
+DEFINE_int32(max_threads, 0, "Maximum number of query threads (0 = hardware concurrency).");
+DEFINE_double(min_time, 0, "Minimum time (seconds) for the locate query micro benchmark.");
+
+using Index = sri::SrIndexValidArea<>;
+
+auto BM_Locate = [](benchmark::State &t_state,
+                    const sri::ReplicatedIndex<Index> *t_replicas,
+                    const std::vector<Pattern> *t_patterns,
+                    bool t_pin) {
+  // Each benchmark thread queries the replica of its node
+  const auto i_replica = t_state.thread_index() % t_replicas->size();
+  if (t_pin) sri::pinThreadToNode(t_replicas->node(i_replica));
+  const auto &index = (*t_replicas)[i_replica];
+
+  const auto &patterns = *t_patterns;
+  std::size_t n_occs = 0;
+  std::size_t n_queries = 0;
+  for (auto _ : t_state) {
+    for (auto i = std::size_t(t_state.thread_index()); i < patterns.size(); i += t_state.threads()) {
+      auto occs = index.Locate(patterns[i].decoded);
+      benchmark::DoNotOptimize(occs.data());
+      n_occs += occs.size();
+      ++n_queries;
+    }
+  }
+
+  t_state.counters["Patterns"] = benchmark::Counter(n_queries, benchmark::Counter::kIsRate);
+  t_state.counters["Occs"] = benchmark::Counter(n_occs, benchmark::Counter::kIsRate);
+  t_state.counters["Replicas"] = t_replicas->size();
+};
+
+int main(int argc, char *argv[]) {
+  gflags::AllowCommandLineReparsing();
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+
+  if (FLAGS_patterns.empty() || FLAGS_index.empty()) {
+    std::cerr << "Command-line error!!!" << std::endl;
+    return 1;
+  }
+
+  if (FLAGS_huge_pages) sri::useHugePages();
+
+  // Query patterns
+  auto patterns = ReadPatterns(FLAGS_patterns);
+
+  auto nodes = sri::computeNumaTopology();
+
+  // Shared index: a single copy, threads are not bound to any node
+  sri::NumaNode all;
+  for (const auto &node : nodes) all.cpus.insert(all.cpus.end(), node.cpus.begin(), node.cpus.end());
+  sri::ReplicatedIndex<Index> shared(FLAGS_index, {all});
+
+  // Replicated index: one copy per node, threads pinned to the node of their copy
+  sri::ReplicatedIndex<Index> replicated(FLAGS_index, nodes);
+
+  int max_threads = FLAGS_max_threads ? FLAGS_max_threads : int(std::max(1u, std::thread::hardware_concurrency()));
+
+  auto bm_shared = benchmark::RegisterBenchmark("Locate/Shared", BM_Locate, &shared, &patterns, false);
+  auto bm_replicated = benchmark::RegisterBenchmark("Locate/Replicated", BM_Locate, &replicated, &patterns, true);
+  for (auto bm : {bm_shared, bm_replicated}) {
+    bm->ThreadRange(1, max_threads)->UseRealTime();
+    if (FLAGS_min_time > 0) bm->MinTime(FLAGS_min_time);
+  }
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+//
+// Marks of phi: rank and select on sd_vector vs. the fused predecessor of EliasFanoVector, on phi-heavy locate queries
+// (short patterns with many occurrences) of the r-index and the sr-index, and their space.
+//
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <gflags/gflags.h>
+
+#include <sdsl/config.hpp>
+
+#include "sr-index/elias_fano_vector.h"
+#include "sr-index/r_index.h"
+#include "sr-index/sr_index.h"
+
+DEFINE_string(data, "", "Data file. (MANDATORY)");
+DEFINE_string(sa_algo, "SDSL_SE_SAIS", "Suffix Array Algorithm: SDSL_SE_SAIS, SDSL_LIBDIVSUFSORT, BIG_BWT");
+DEFINE_int32(sr, 16, "Subsampling parameter s of the SR-Index.");
+DEFINE_int32(n_patterns, 1000, "Number of patterns sampled from the text.");
+DEFINE_int32(min_len, 4, "Minimum length of the patterns.");
+DEFINE_int32(max_len, 16, "Maximum length of the patterns.");
+
+using MarksSd = sdsl::sd_vector<>;
+using MarksEF = sri::EliasFanoVector<>;
+
+template<typename TBvMark>
+using RIndex = sri::RIndex<sri::GenericStorage, sri::Alphabet<>, sri::RLEString<>, TBvMark>;
+
+template<typename TBvMark>
+using SrIndex = sri::SrIndexValidArea<sri::GenericStorage, sri::Alphabet<>, sri::RLEString<>, TBvMark>;
+
+//! Substrings of the text
+auto SamplePatterns(const std::string &t_text, std::size_t t_len) {
+  std::mt19937_64 gen(42);
+  t_len = std::min(t_len, t_text.size());
+  std::uniform_int_distribution<std::size_t> dist(0, t_text.size() - t_len);
+
+  std::vector<std::string> patterns;
+  for (int i = 0; i < FLAGS_n_patterns; ++i) {
+    patterns.emplace_back(t_text.substr(dist(gen), t_len));
+  }
+
+  return patterns;
+}
+
+template<typename TIndex>
+void BM_Locate(benchmark::State &t_state, const TIndex *t_index, const std::string *t_text) {
+  auto patterns = SamplePatterns(*t_text, t_state.range(0));
+
+  std::size_t n_occs = 0;
+  for (auto _ : t_state) {
+    for (const auto &pattern : patterns) {
+      auto occs = t_index->Locate(pattern);
+      benchmark::DoNotOptimize(occs.data());
+      n_occs += occs.size();
+    }
+  }
+
+  std::size_t marks_size = 0;
+  for (const auto &[name, size] : t_index->breakdown()) {
+    if (name.rfind("marks", 0) == 0) marks_size += size;
+  }
+  const auto size = sdsl::size_in_bytes(*t_index);
+
+  t_state.counters["Patterns"] = benchmark::Counter(patterns.size(), benchmark::Counter::kIsIterationInvariantRate);
+  t_state.counters["Occs"] = benchmark::Counter(n_occs, benchmark::Counter::kIsRate);
+  t_state.counters["Size(B)"] = size;
+  t_state.counters["Bits_x_Symbol"] = double(size * 8) / double(t_index->sizeSequence());
+  t_state.counters["Marks(B)"] = marks_size;
+}
+
+template<typename TIndex>
+void Register(const std::string &t_name, const TIndex *t_index, const std::string *t_text) {
+  benchmark::RegisterBenchmark(("Locate/" + t_name).c_str(), BM_Locate<TIndex>, t_index, t_text)
+      ->ArgName("m")->RangeMultiplier(2)->Range(FLAGS_min_len, FLAGS_max_len)->Unit(benchmark::kMillisecond);
+}
+
+int main(int argc, char *argv[]) {
+  gflags::AllowCommandLineReparsing();
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+
+  if (FLAGS_data.empty()) {
+    std::cerr << "Command-line error!!!" << std::endl;
+    return 1;
+  }
+
+  std::string data_path = FLAGS_data;
+  sri::Config config(data_path, std::filesystem::current_path(), sri::toSAAlgo(FLAGS_sa_algo));
+
+  // The indexes share the items but the marks, stored by type
+  RIndex<MarksSd> r_index_sd;
+  sri::construct(r_index_sd, data_path, config);
+  RIndex<MarksEF> r_index_ef;
+  sri::construct(r_index_ef, data_path, config);
+  SrIndex<MarksSd> sr_index_sd(FLAGS_sr);
+  sri::construct(sr_index_sd, data_path, config);
+  SrIndex<MarksEF> sr_index_ef(FLAGS_sr);
+  sri::construct(sr_index_ef, data_path, config);
+
+  std::ifstream in(data_path, std::ios::binary);
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  Register("R-Index/SdVector", &r_index_sd, &text);
+  Register("R-Index/EliasFano", &r_index_ef, &text);
+  Register("SR-Index/SdVector", &sr_index_sd, &text);
+  Register("SR-Index/EliasFano", &sr_index_ef, &text);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
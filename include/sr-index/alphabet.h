@@ -5,9 +5,15 @@
 #ifndef SRI_ALPHABET_H_
 #define SRI_ALPHABET_H_
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <sstream>
+#include <stdexcept>
 
 #include <sdsl/csa_alphabet_strategy.hpp>
+#include <sdsl/int_vector.hpp>
+#include <sdsl/io.hpp>
 
 namespace sri {
 
@@ -24,6 +30,37 @@ struct alphabet_trait<0> {
 template<uint8_t t_width = 8>
 class Alphabet : public alphabet_trait<t_width>::type {};
 
+//! Byte alphabet of a sequence from the number of occurrences of each byte, e.g., for a BWT given by its runs.
+//! sdsl::byte_alphabet is only built by reading the whole sequence, so its members are loaded as it serializes them.
+inline sdsl::byte_alphabet constructByteAlphabet(const std::array<std::size_t, 256> &t_counts) {
+  sdsl::byte_alphabet::char2comp_type char2comp(256, 0);
+  sdsl::byte_alphabet::comp2char_type comp2char(256, 0);
+  sdsl::byte_alphabet::C_type C(257, 0);
+  sdsl::byte_alphabet::sigma_type sigma = 0;
+  for (std::size_t c = 0; c < t_counts.size(); ++c) {
+    if (t_counts[c] == 0) continue;
+    char2comp[c] = sigma;
+    comp2char[sigma] = c;
+    C[sigma + 1] = C[sigma] + t_counts[c];
+    ++sigma;
+  }
+  comp2char.resize(sigma);
+  C.resize(sigma + 1);
+
+  std::stringstream buffer;
+  char2comp.serialize(buffer);
+  comp2char.serialize(buffer);
+  C.serialize(buffer);
+  sdsl::write_member(sigma, buffer);
+
+  sdsl::byte_alphabet alphabet;
+  alphabet.load(buffer);
+  if (alphabet.sigma != sigma || alphabet.C[sigma] != C[sigma]) {
+    throw std::logic_error("Error: unexpected serialization of sdsl::byte_alphabet");
+  }
+  return alphabet;
+}
+
 }
 
 #endif //SRI_ALPHABET_H_
@@ -0,0 +1,236 @@
+//
+// In-process store of the construction items, keyed by their cache files, that spills to disk over a memory limit.
+//
+
+#ifndef SRI_ARTIFACT_STORE_H_
+#define SRI_ARTIFACT_STORE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+
+#include <sdsl/config.hpp>
+#include <sdsl/io.hpp>
+
+#include "work_dir.h"
+
+namespace sri {
+
+//! Size in bytes of the serialized item
+template<typename T>
+std::size_t serializedSize(const T &t_item) {
+  sdsl::nullstream ns;
+  using sdsl::serialize;
+  return serialize(t_item, ns);
+}
+
+//! Store of the construction items kept in memory instead of being written to their cache files.
+//! The items are keyed by the names of the cache files they would be written to, so the stages keep using the cache
+//! keys and do not know where an item lives. When an item does not fit in the memory limit, the least recently used
+//! items are spilled to their cache files (or the new item is not kept, if it is larger than the limit).
+//! An item accessed by file name (e.g., streamed with an int_vector_buffer) is spilled as well, as it must be on disk.
+//! The items are moved into the store, and the memory of an item is accounted until its last reference is released,
+//! so an item shared with a stage (see share) still counts after it is spilled.
+class ArtifactStore {
+ public:
+  //! Constructor
+  //! \param t_limit Memory limit in bytes for the items kept in memory
+  explicit ArtifactStore(std::size_t t_limit) : limit_{t_limit} {}
+
+  std::size_t limit() const { return limit_; }
+
+  //! Size in bytes of the items in memory, including the spilled ones that are still shared
+  std::size_t size() const { return usage_->size.load(); }
+
+  //! Maximum size in bytes of the items in memory
+  std::size_t peak() const { return usage_->peak.load(); }
+
+  //! Number of items written to disk
+  std::size_t spilled() const { return n_spilled_; }
+
+  //! Keep the item in memory, moving it into the store
+  //! \param t_file Cache file of the item
+  //! \param t_size Serialized size of the item (see serializedSize)
+  //! \return Whether the item was kept; otherwise it is left untouched and it must be written to its cache file
+  template<typename T, typename = std::enable_if_t<!std::is_lvalue_reference_v<T>>>
+  bool put(const std::string &t_file, const std::string &t_key, T &&t_item, std::size_t t_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase(t_file);
+    if (limit_ < t_size) return false;
+
+    while (limit_ < usage_->size + t_size && !items_.empty()) spillOldest();
+    // The spilled items that are still shared keep their memory
+    if (limit_ < usage_->size + t_size) return false;
+
+    auto item = counted(std::move(t_item), t_size);
+    items_.emplace(t_file, Item{item, std::type_index(typeid(T)), t_key, ++clock_,
+                                [item](const std::string &tt_file) { return sdsl::store_to_file(*item, tt_file); }});
+    return true;
+  }
+
+  //! Copy the item in memory
+  //! \param t_file Cache file of the item
+  //! \return Whether the item is in memory; if it is stored with another type, it is spilled and false is returned
+  template<typename T>
+  bool get(const std::string &t_file, T &t_item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = items_.find(t_file);
+    if (it == items_.end()) return false;
+
+    if (it->second.type != std::type_index(typeid(T))) {
+      // Loaded as a different (serialization-compatible) type, so it goes through the file
+      spill(it);
+      return false;
+    }
+
+    it->second.last_use = ++clock_;
+    t_item = *std::static_pointer_cast<const T>(it->second.data);
+    return true;
+  }
+
+  //! Shared item in memory, without copying it
+  //! \return Item, or nullptr if it is not in memory or it is stored with another type
+  template<typename T>
+  std::shared_ptr<const T> share(const std::string &t_file) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = items_.find(t_file);
+    if (it == items_.end() || it->second.type != std::type_index(typeid(T))) return nullptr;
+
+    it->second.last_use = ++clock_;
+    return std::static_pointer_cast<const T>(it->second.data);
+  }
+
+  bool contains(const std::string &t_file) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.count(t_file) > 0;
+  }
+
+  //! Write the item to its cache file and release it from memory
+  void spill(const std::string &t_file) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = items_.find(t_file);
+    if (it != items_.end()) spill(it);
+  }
+
+ private:
+  struct Item {
+    std::shared_ptr<const void> data;
+    std::type_index type;
+    std::string key;
+    std::size_t last_use;
+    std::function<bool(const std::string &)> store;
+  };
+
+  using Items = std::map<std::string, Item>;
+
+  //! Memory of the items, shared with the items so it outlives the store
+  struct Usage {
+    std::atomic<std::size_t> size{0};
+    std::atomic<std::size_t> peak{0};
+
+    void add(std::size_t t_size) {
+      auto new_size = size += t_size;
+      auto old_peak = peak.load();
+      while (old_peak < new_size && !peak.compare_exchange_weak(old_peak, new_size)) {}
+    }
+
+    void sub(std::size_t t_size) { size -= t_size; }
+  };
+
+  //! Item whose memory is accounted until its last reference (in the store or shared) is released
+  template<typename T>
+  std::shared_ptr<const T> counted(T &&t_item, std::size_t t_size) {
+    usage_->add(t_size);
+    auto usage = usage_;
+    return std::shared_ptr<const T>(new T(std::move(t_item)), [usage, t_size](const T *tt_item) {
+      delete tt_item;
+      usage->sub(t_size);
+    });
+  }
+
+  void spill(Items::iterator t_it) {
+    const auto &file = t_it->first;
+    const std::string tmp_file = file + ".tmp";
+    if (!t_it->second.store(tmp_file)) {
+      throw std::runtime_error("Error: cannot spill item to file \"" + file + "\"");
+    }
+    std::filesystem::rename(tmp_file, file);
+    recordCachedFile(file, t_it->second.key);
+
+    ++n_spilled_;
+    items_.erase(t_it);
+  }
+
+  void spillOldest() {
+    auto oldest = std::min_element(items_.begin(), items_.end(), [](const auto &tt_a, const auto &tt_b) {
+      return tt_a.second.last_use < tt_b.second.last_use;
+    });
+    spill(oldest);
+  }
+
+  void erase(const std::string &t_file) {
+    auto it = items_.find(t_file);
+    if (it == items_.end()) return;
+    items_.erase(it);
+  }
+
+  std::size_t limit_;
+  std::shared_ptr<Usage> usage_ = std::make_shared<Usage>();
+  std::size_t n_spilled_ = 0;
+  std::size_t clock_ = 0;
+  Items items_;
+  mutable std::mutex mutex_;
+};
+
+//! Open artifact stores by cache directory
+inline std::map<std::filesystem::path, std::shared_ptr<ArtifactStore>> &artifactStores() {
+  static std::map<std::filesystem::path, std::shared_ptr<ArtifactStore>> stores;
+  return stores;
+}
+
+//! Guard of the open artifact stores, which are opened by the concurrent constructions of a sharded index
+inline std::mutex &artifactStoresMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+//! Keep the construction items of the cache directory of the configuration in memory, up to the given limit
+inline std::shared_ptr<ArtifactStore> openArtifactStore(const sdsl::cache_config &t_config, std::size_t t_limit) {
+  std::lock_guard<std::mutex> lock(artifactStoresMutex());
+  auto &store = artifactStores()[normalizedDir(t_config.dir)];
+  if (!store || store->limit() != t_limit) store = std::make_shared<ArtifactStore>(t_limit);
+  return store;
+}
+
+//! Release the items in memory of the cache directory (without writing them)
+//! \return Closed store (for its statistics), or nullptr if there was none
+inline std::shared_ptr<ArtifactStore> closeArtifactStore(const std::filesystem::path &t_dir) {
+  std::lock_guard<std::mutex> lock(artifactStoresMutex());
+  auto it = artifactStores().find(normalizedDir(t_dir));
+  if (it == artifactStores().end()) return nullptr;
+  auto store = std::move(it->second);
+  artifactStores().erase(it);
+  return store;
+}
+
+//! Artifact store of the cache directory containing the file, if any
+inline std::shared_ptr<ArtifactStore> findArtifactStore(const std::string &t_file) {
+  std::lock_guard<std::mutex> lock(artifactStoresMutex());
+  if (artifactStores().empty()) return nullptr;
+  auto it = artifactStores().find(normalizedDir(std::filesystem::path(t_file).parent_path()));
+  return it != artifactStores().end() ? it->second : nullptr;
+}
+
+}
+
+#endif //SRI_ARTIFACT_STORE_H_
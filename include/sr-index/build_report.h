@@ -0,0 +1,236 @@
+//
+// Report of the construction stages: wall and CPU time, peak RSS, I/O and output size of each stage.
+//
+
+#ifndef SRI_BUILD_REPORT_H_
+#define SRI_BUILD_REPORT_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <sdsl/memory_management.hpp>
+
+#include "config.h"
+
+namespace sri {
+
+//! Resource usage of the process at some point (Linux; the values that cannot be read are 0)
+struct ResourceUsage {
+  std::chrono::steady_clock::time_point wall;
+  double cpu_secs = 0; // User and system time of all the threads
+  std::size_t peak_rss_bytes = 0; // Since the last reset (see resetPeakRSS)
+  std::size_t bytes_read = 0; // Through read syscalls
+  std::size_t bytes_written = 0; // Through write syscalls
+
+  static ResourceUsage now() {
+    ResourceUsage usage;
+    usage.wall = std::chrono::steady_clock::now();
+
+    rusage ru{};
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+      usage.cpu_secs = double(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec)
+          + double(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+    }
+
+    usage.peak_rss_bytes = readProcField("/proc/self/status", "VmHWM:") * 1024;
+    usage.bytes_read = readProcField("/proc/self/io", "rchar:");
+    usage.bytes_written = readProcField("/proc/self/io", "wchar:");
+    return usage;
+  }
+
+  //! Reset the peak RSS of the process to its current RSS, so the next peak is local to a stage
+  //! \return Whether it is supported (Linux >= 4.0); otherwise the peak is the one of the whole process
+  static bool resetPeakRSS() {
+    std::ofstream out("/proc/self/clear_refs");
+    return out && (out << "5").flush();
+  }
+
+ private:
+  static std::size_t readProcField(const std::string &t_file, const std::string &t_field) {
+    std::ifstream in(t_file);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.compare(0, t_field.size(), t_field) == 0) {
+        std::size_t value = 0;
+        std::istringstream(line.substr(t_field.size())) >> value;
+        return value;
+      }
+    }
+    return 0;
+  }
+};
+
+//! Measures of a construction stage
+struct StageReport {
+  std::string name;
+  double wall_secs = 0;
+  double cpu_secs = 0;
+  std::size_t peak_rss_bytes = 0;
+  std::size_t bytes_read = 0;
+  std::size_t bytes_written = 0;
+  std::size_t output_bytes = 0; // Size of the items stored by the stage (in the cache or in memory)
+};
+
+//! Measures of the construction of an index
+struct IndexBuildReport {
+  JSON params; // E.g., output file, subsampling parameter and variant
+  double wall_secs = 0;
+  std::size_t output_bytes = 0; // Size of the index file
+  std::vector<StageReport> stages;
+};
+
+//! Report of the construction stages, recorded by the StageEvents when it is enabled.
+//! The stages can be nested: the peak RSS of a stage covers its nested stages, and its output and I/O include theirs.
+//! The stages are expected to run in a single thread (each stage may run several threads inside).
+class BuildReport {
+ public:
+  static BuildReport &instance() {
+    static BuildReport report;
+    return report;
+  }
+
+  bool enabled() const { return enabled_; }
+
+  void enable() { enabled_ = true; }
+
+  //! Start recording the stages of a new index construction
+  void beginIndex(JSON t_params) {
+    builds_.emplace_back();
+    builds_.back().params = std::move(t_params);
+    index_start_ = std::chrono::steady_clock::now();
+  }
+
+  //! Finish the current index construction
+  //! \param t_output_bytes Size of the stored index
+  void endIndex(std::size_t t_output_bytes) {
+    if (builds_.empty()) return;
+    builds_.back().wall_secs = secondsSince(index_start_);
+    builds_.back().output_bytes = t_output_bytes;
+  }
+
+  const std::vector<IndexBuildReport> &builds() const { return builds_; }
+
+  //! Add the size of an item stored by the running stages
+  void addOutput(std::size_t t_bytes) {
+    for (auto &running : running_) running.report.output_bytes += t_bytes;
+  }
+
+  JSON toJSON() const {
+    // The peak RSS is reset by each stage, so the peak of the whole construction is the largest one
+    std::size_t peak_rss_bytes = ResourceUsage::now().peak_rss_bytes;
+    JSON builds = JSON::array();
+    for (const auto &build : builds_) {
+      JSON stages = JSON::array();
+      for (const auto &stage : build.stages) {
+        peak_rss_bytes = std::max(peak_rss_bytes, stage.peak_rss_bytes);
+        stages.push_back({
+            {"name", stage.name},
+            {"wall_secs", stage.wall_secs},
+            {"cpu_secs", stage.cpu_secs},
+            {"peak_rss_bytes", stage.peak_rss_bytes},
+            {"bytes_read", stage.bytes_read},
+            {"bytes_written", stage.bytes_written},
+            {"output_bytes", stage.output_bytes}
+        });
+      }
+      JSON entry = build.params;
+      entry["wall_secs"] = build.wall_secs;
+      entry["output_bytes"] = build.output_bytes;
+      entry["stages"] = std::move(stages);
+      builds.push_back(std::move(entry));
+    }
+
+    JSON report;
+    report["peak_rss_bytes"] = peak_rss_bytes;
+    report["builds"] = std::move(builds);
+    return report;
+  }
+
+  void write(const std::string &t_file) const {
+    std::ofstream out(t_file);
+    out << toJSON().dump(2) << std::endl;
+  }
+
+ private:
+  friend class StageEvent;
+
+  struct RunningStage {
+    StageReport report;
+    ResourceUsage start;
+    std::size_t peak_rss_bytes = 0; // Peak before the last reset (by a nested stage)
+  };
+
+  void begin(const std::string &t_name) {
+    // The peak of the enclosing stage so far is kept before the nested stage resets it
+    if (!running_.empty()) {
+      auto &parent = running_.back();
+      parent.peak_rss_bytes = std::max(parent.peak_rss_bytes, ResourceUsage::now().peak_rss_bytes);
+    }
+    ResourceUsage::resetPeakRSS();
+
+    running_.emplace_back();
+    running_.back().report.name = t_name;
+    running_.back().start = ResourceUsage::now();
+  }
+
+  void end() {
+    auto stage = std::move(running_.back());
+    running_.pop_back();
+
+    const auto usage = ResourceUsage::now();
+    auto &report = stage.report;
+    report.wall_secs = std::chrono::duration<double>(usage.wall - stage.start.wall).count();
+    report.cpu_secs = usage.cpu_secs - stage.start.cpu_secs;
+    report.peak_rss_bytes = std::max(stage.peak_rss_bytes, usage.peak_rss_bytes);
+    report.bytes_read = usage.bytes_read - stage.start.bytes_read;
+    report.bytes_written = usage.bytes_written - stage.start.bytes_written;
+
+    if (!running_.empty()) {
+      auto &parent = running_.back();
+      parent.peak_rss_bytes = std::max(parent.peak_rss_bytes, report.peak_rss_bytes);
+    }
+
+    if (builds_.empty()) beginIndex(JSON::object());
+    builds_.back().stages.emplace_back(std::move(report));
+  }
+
+  static double secondsSince(std::chrono::steady_clock::time_point t_start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+  }
+
+  bool enabled_ = false;
+  std::vector<IndexBuildReport> builds_;
+  std::vector<RunningStage> running_;
+  std::chrono::steady_clock::time_point index_start_;
+};
+
+//! Construction stage: an event of the SDSL memory monitor, also recorded in the build report if it is enabled
+class StageEvent {
+ public:
+  explicit StageEvent(const std::string &t_name)
+      : event_{sdsl::memory_monitor::event(t_name)}, recorded_{BuildReport::instance().enabled()} {
+    if (recorded_) BuildReport::instance().begin(t_name);
+  }
+
+  StageEvent(const StageEvent &) = delete;
+  StageEvent &operator=(const StageEvent &) = delete;
+
+  ~StageEvent() {
+    if (recorded_) BuildReport::instance().end();
+  }
+
+ private:
+  sdsl::mm_event_proxy event_;
+  bool recorded_;
+};
+
+}
+
+#endif //SRI_BUILD_REPORT_H_
@@ -5,7 +5,10 @@
 #ifndef SRI_BWT_H_
 #define SRI_BWT_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <cassert>
 #include <memory>
 
@@ -65,6 +68,50 @@ std::size_t computeBWT(std::size_t t_n,
   return n_runs + 1;
 }
 
+/// Report the BWT positions in [t_first, t_last) that start a run, i.e., each i > 0 such that bwt[i - 1] != bwt[i].
+/// The ranges of consecutive calls can be disjoint chunks of the BWT, as the comparison at t_first reads bwt[t_first - 1].
+template<typename TGetBWTAt, typename TReport>
+void computeBWTRunHeads(std::size_t t_first,
+                        std::size_t t_last,
+                        const TGetBWTAt &t_get_bwt_at,
+                        const TReport &t_report) {
+  for (auto i = std::max<std::size_t>(t_first, 1); i < t_last; ++i) {
+    if (t_get_bwt_at(i - 1) != t_get_bwt_at(i)) t_report(i);
+  }
+}
+
+/// Report the run heads of a byte BWT in [t_first, t_last), comparing 32 symbols per step with their predecessors.
+/// The symbols are compared by words (XOR of the word at i and the word at i - 1), so long runs cost a load per word.
+template<typename TReport>
+void computeBWTRunHeads(const uint8_t *t_bwt, std::size_t t_first, std::size_t t_last, const TReport &t_report) {
+  auto i = std::max<std::size_t>(t_first, 1);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  auto diff_at = [t_bwt](std::size_t tt_i) {
+    uint64_t curr, prev;
+    std::memcpy(&curr, t_bwt + tt_i, sizeof(uint64_t));
+    std::memcpy(&prev, t_bwt + tt_i - 1, sizeof(uint64_t));
+    return curr ^ prev; // Non-zero bytes are run heads, the lowest byte first
+  };
+
+  auto report_word = [&t_report](std::size_t tt_i, uint64_t tt_diff) {
+    while (tt_diff) {
+      const auto byte = __builtin_ctzll(tt_diff) / 8;
+      t_report(tt_i + byte);
+      tt_diff &= ~(uint64_t{0xFF} << (byte * 8));
+    }
+  };
+
+  for (; i + 32 <= t_last; i += 32) {
+    const uint64_t diff[4] = {diff_at(i), diff_at(i + 8), diff_at(i + 16), diff_at(i + 24)};
+    if ((diff[0] | diff[1] | diff[2] | diff[3]) == 0) continue;
+    for (std::size_t j = 0; j < 4; ++j) report_word(i + 8 * j, diff[j]);
+  }
+#endif
+
+  computeBWTRunHeads(i, t_last, [t_bwt](auto tt_i) { return t_bwt[tt_i]; }, t_report);
+}
+
 /// Backward navigation (Last to First) on BWT
 template<typename TGetCRankOnBWT, typename TGetF, typename Range, typename TChar>
 Range computeLF(const TGetCRankOnBWT &get_c_rank_on_bwt,
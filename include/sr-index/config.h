@@ -6,6 +6,7 @@
 #define SRI_CONFIG_H_
 
 #include <filesystem>
+#include <string>
 #include <utility>
 
 #include <sdsl/config.hpp>
@@ -15,7 +16,9 @@ namespace sri {
 enum SAAlgo {
   SDSL_LIBDIVSUFSORT=0,
   SDSL_SE_SAIS=1,
-  BIG_BWT=2
+  BIG_BWT=2,
+  PARALLEL_SAIS=3, // In memory, with the construction threads (see parallel_sa.h)
+  IMPORTED=4 // No SA: the BWT and the SA samples at its runs are imported (see Config::import and importers.h)
 };
 
 using JSON = nlohmann::json;
@@ -101,10 +104,25 @@ inline auto str(const nlohmann::basic_json<>& t_json) {
   return t_json.get<std::string>();
 }
 
+//! Pre-built BWT and SA samples imported instead of being constructed (see importers.h)
+struct ImportSpec {
+  std::string bwt_format = "plain"; // Format of the BWT file (see bwtFormats())
+  std::string samples_format = "runs"; // Format of the SA samples (see sampleFormats())
+  std::string ssa_file; // SA values at the BWT run heads ("runs" format)
+  std::string esa_file; // SA values at the BWT run tails ("runs" format)
+  std::string sa_file; // Whole SA ("sa" format)
+  std::size_t int_bytes = 5; // Bytes of the BWT positions and SA values (little-endian)
+  std::size_t run_length_bytes = 4; // Bytes of the run lengths ("rle" BWT format)
+};
+
 struct Config : public sdsl::cache_config {
   std::filesystem::path data_path;
   SAAlgo sa_algo = SDSL_LIBDIVSUFSORT;
   JSON keys;
+  uint8_t doc_separator = 1; // Symbol terminating each document in a collection
+  std::size_t kmer_k = 0; // Length of the k-mers in the k-mer table (0 = no table)
+  std::size_t kmer_budget = 0; // Maximum size in bytes of the k-mer table (0 = unbounded)
+  ImportSpec import; // Used when sa_algo is IMPORTED, with data_path as the BWT file
 
   Config() = default;
 
@@ -123,7 +141,9 @@ inline SAAlgo toSAAlgo(const std::string& t_str) {
   static const std::map<std::string, SAAlgo> name_to_enum = {
     {"SDSL_LIBDIVSUFSORT", SDSL_LIBDIVSUFSORT},
     {"SDSL_SE_SAIS", SDSL_SE_SAIS},
-    {"BIG_BWT", BIG_BWT}
+    {"BIG_BWT", BIG_BWT},
+    {"PARALLEL_SAIS", PARALLEL_SAIS},
+    {"IMPORTED", IMPORTED}
   };
 
   return name_to_enum.at(t_str);
@@ -15,6 +15,7 @@
 #include "construct_base.h"
 #include "construct_sdsl.h"
 #include "construct_big_bwt.h"
+#include "importers.h"
 #include "alphabet.h"
 #include "psi.h"
 #include "tools.h"
@@ -22,6 +23,7 @@
 #include "rle_string.hpp"
 #include "bwt.h"
 #include "io.h"
+#include "radix_sort.h"
 
 namespace sri {
 
@@ -51,6 +53,12 @@ void constructIndexBaseItems(const std::string &t_data_path, sri::Config &t_conf
     case BIG_BWT:
       inner_big_bwt::constructIndexBaseItems<t_width>(t_data_path, t_config);
       break;
+    case PARALLEL_SAIS:
+      inner_sdsl::constructIndexBaseItems<t_width>(t_data_path, t_config, true);
+      break;
+    case IMPORTED:
+      inner_import::constructIndexBaseItems<t_width>(t_config);
+      break;
   }
 }
 
@@ -60,8 +68,8 @@ inline auto KeySortedByAlphabet(const std::string& t_key) {
 
 inline auto getExtremes(const sdsl::cache_config& t_config, const std::string& t_key, bool t_add_type_hash = false) {
   const auto filename = t_add_type_hash
-                          ? sdsl::cache_file_name<sdsl::int_vector<>>(t_key, t_config)
-                          : sdsl::cache_file_name(t_key, t_config);
+                          ? sri::cacheFileName<sdsl::int_vector<>>(t_key, t_config)
+                          : sri::cacheFileName(t_key, t_config);
   sdsl::int_vector_buffer<> buffer(filename);
   return std::array<std::size_t, 2>{buffer[0], buffer[buffer.size() - 1]};
 }
@@ -72,25 +80,41 @@ void constructPsi(sdsl::cache_config &t_config) {
                 "constructPsi: width must be `0` for integer alphabet and `8` for byte alphabet");
 
   typename alphabet_trait<t_width>::type alphabet;
-  sdsl::load_from_cache(alphabet, conf::KEY_ALPHABET, t_config);
+  sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
 
   sdsl::int_vector<> psi;
   {
     RLEString<> bwt_rle;
-    sdsl::load_from_cache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+    sri::loadFromCache(bwt_rle, conf::KEY_BWT_RLE, t_config);
     auto get_bwt_symbol = [&bwt_rle](size_t tt_i) { return bwt_rle[tt_i]; };
 
     psi = constructPsi(get_bwt_symbol, alphabet.C);
     sdsl::util::bit_compress(psi);
-    sdsl::store_to_cache(psi, sdsl::conf::KEY_PSI, t_config);
+    sri::storeToCache(psi, sdsl::conf::KEY_PSI, t_config);
   }
 
   {
     sri::PsiCoreRLE<> psi_rle(alphabet.C, psi);
-    sri::store_to_cache(psi_rle, sdsl::conf::KEY_PSI, t_config, true);
+    sri::storeToCache(std::move(psi_rle), sdsl::conf::KEY_PSI, t_config, true);
   }
 }
 
+//! Constructs and stores the psi core of the given type (e.g., with another encoded vector than the default one) from
+//! the stored psi function, unless it is already stored
+template<uint8_t t_width, typename TPsiCore>
+void constructPsiCore(sdsl::cache_config &t_config) {
+  if (sri::cacheFileExists<TPsiCore>(sdsl::conf::KEY_PSI, t_config)) return;
+
+  typename alphabet_trait<t_width>::type alphabet;
+  sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
+
+  sdsl::int_vector<> psi;
+  sri::loadFromCache(psi, sdsl::conf::KEY_PSI, t_config);
+
+  TPsiCore psi_core(alphabet.C, psi);
+  sri::storeToCache(std::move(psi_core), sdsl::conf::KEY_PSI, t_config, true);
+}
+
 template<uint8_t t_width>
 void constructPsiRuns(Config &t_config) {
   static_assert(t_width == 0 || t_width == 8,
@@ -99,10 +123,10 @@ void constructPsiRuns(Config &t_config) {
   using namespace conf;
 
   typename alphabet_trait<t_width>::type alphabet;
-  sdsl::load_from_cache(alphabet, conf::KEY_ALPHABET, t_config);
+  sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
 
   RLEString<> bwt_rle;
-  sdsl::load_from_cache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+  sri::loadFromCache(bwt_rle, conf::KEY_BWT_RLE, t_config);
 
   for (const auto &part : {conf::kHead, conf::kTail}) {
     const auto &key_bwt_run_pos = t_config.keys[kBWT][part][kPos];
@@ -111,8 +135,8 @@ void constructPsiRuns(Config &t_config) {
 
     std::vector<std::vector<std::size_t>> psi_run_text_pos_partial(alphabet.sigma);
 
-    auto bwt_run_pos = sdsl::int_vector_buffer<>(cache_file_name(key_bwt_run_pos, t_config));
-    auto bwt_run_text_pos = sdsl::int_vector_buffer<>(cache_file_name(key_bwt_run_text_pos, t_config));
+    auto bwt_run_pos = sdsl::int_vector_buffer<>(sri::cacheFileName(key_bwt_run_pos, t_config));
+    auto bwt_run_text_pos = sdsl::int_vector_buffer<>(sri::cacheFileName(key_bwt_run_text_pos, t_config));
 
     auto r = bwt_run_pos.size();
     for (std::size_t i = 0; i < r; ++i) {
@@ -120,7 +144,7 @@ void constructPsiRuns(Config &t_config) {
     }
 
     auto psi_run_text_pos = sdsl::int_vector_buffer<>(
-      sdsl::cache_file_name<sdsl::int_vector<>>(key_psi_run_text_pos, t_config),
+      sri::cacheFileName<sdsl::int_vector<>>(key_psi_run_text_pos, t_config),
       std::ios::out,
       1 << 20,
       bwt_run_text_pos.width()
@@ -133,23 +157,14 @@ void constructPsiRuns(Config &t_config) {
     }
 
     psi_run_text_pos.close();
-    sdsl::register_cache_file(key_psi_run_text_pos, t_config);
+    sri::registerCacheFile(key_psi_run_text_pos, t_config);
   }
 }
 
+//! Indices of the values sorted by value (ties in ascending order), using the construction threads
 template<typename TRAContainer>
 auto sortIndices(const TRAContainer &t_values) {
-  auto n = t_values.size();
-  auto log_n = sdsl::bits::hi(n) + 1;
-
-  sdsl::int_vector<> values_idx(n, 0, log_n); // Indices of the values sorted
-  std::iota(values_idx.begin(), values_idx.end(), 0);
-
-  std::sort(values_idx.begin(),
-            values_idx.end(),
-            [&t_values](const auto &a, const auto &b) -> bool { return t_values[a] < t_values[b]; });
-
-  return values_idx;
+  return radixSortIndices(t_values, constructionThreads());
 }
 
 template<typename TRAContainer, typename TGetLink>
@@ -173,20 +188,20 @@ void constructMarkToSampleLinksForPhiForwardWithBWTRuns(sdsl::cache_config &t_co
 
   // Marks
   sdsl::int_vector<> bwt_run_last_text_pos; // BWT run tails positions in text
-  sdsl::load_from_cache(bwt_run_last_text_pos, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+  sri::loadFromCache(bwt_run_last_text_pos, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
 
   // Mark positions
   sdsl::int_vector<> bwt_run_last;
-  sdsl::load_from_cache(bwt_run_last, conf::KEY_BWT_RUN_LAST, t_config);
+  sri::loadFromCache(bwt_run_last, conf::KEY_BWT_RUN_LAST, t_config);
 
   // LF
   RLEString<> bwt_rle;
-  sdsl::load_from_cache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+  sri::loadFromCache(bwt_rle, conf::KEY_BWT_RLE, t_config);
   auto get_char = sri::buildRandomAccessForContainer(std::cref(bwt_rle));
   auto get_rank_of_char = sri::buildRankOfChar(std::cref(bwt_rle));
 
   typename alphabet_trait<t_width>::type alphabet;
-  sdsl::load_from_cache(alphabet, conf::KEY_ALPHABET, t_config);
+  sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
   auto n = alphabet.C[alphabet.sigma];
 
   auto get_f = [&alphabet](auto tt_symbol) { return alphabet.C[tt_symbol]; };
@@ -194,7 +209,7 @@ void constructMarkToSampleLinksForPhiForwardWithBWTRuns(sdsl::cache_config &t_co
 
   // Psi
   sri::PsiCoreRLE psi_core;
-  sdsl::load_from_cache(psi_core, sdsl::conf::KEY_PSI, t_config, true);
+  sri::loadFromCache(psi_core, sdsl::conf::KEY_PSI, t_config, true);
   auto psi_select = [&psi_core](auto tt_c, auto tt_rnk) { return psi_core.select(tt_c, tt_rnk); };
 
   auto get_c = [&alphabet](auto tt_index) { return sri::computeCForSAIndex(alphabet.C, tt_index); };
@@ -204,7 +219,7 @@ void constructMarkToSampleLinksForPhiForwardWithBWTRuns(sdsl::cache_config &t_co
 
   // Samples
   sdsl::int_vector<> bwt_run_first; // BWT run heads positions in BWT
-  sdsl::load_from_cache(bwt_run_first, conf::KEY_BWT_RUN_FIRST, t_config);
+  sri::loadFromCache(bwt_run_first, conf::KEY_BWT_RUN_FIRST, t_config);
 
   auto rank_sample = [&bwt_run_first](const auto &tt_k) {
     return std::lower_bound(bwt_run_first.begin(), bwt_run_first.end(), tt_k) - bwt_run_first.begin();
@@ -217,15 +232,15 @@ void constructMarkToSampleLinksForPhiForwardWithBWTRuns(sdsl::cache_config &t_co
   // Compute links
   auto [sorted_marks_idx, mark_to_sample_links] = constructMarkToSampleLinks(bwt_run_last_text_pos, get_link);
 
-  sdsl::store_to_cache(sorted_marks_idx, conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX, t_config);
-  sdsl::store_to_cache(mark_to_sample_links, conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config);
+  sri::storeToCache(std::move(sorted_marks_idx), conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX, t_config);
+  sri::storeToCache(std::move(mark_to_sample_links), conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config);
 }
 
 inline auto constructMarkToSampleLinksForPhiForwardWithPsiRuns(Config &t_config) {
   using namespace sri::conf;
 
   sdsl::int_vector<> marks; // Text position of the Psi run tails
-  sdsl::load_from_cache(marks, t_config.keys[kPsi][kTail][kTextPos], t_config, true);
+  sri::loadFromCache(marks, t_config.keys[kPsi][kTail][kTextPos], t_config, true);
 
   auto get_link = [r = marks.size()](const auto &tt_mark_idx) {
     return (tt_mark_idx + 1) % r;
@@ -233,8 +248,8 @@ inline auto constructMarkToSampleLinksForPhiForwardWithPsiRuns(Config &t_config)
 
   auto [sorted_marks_idx, mark_to_sample_links] = constructMarkToSampleLinks(marks, get_link);
 
-  // sdsl::store_to_cache(sorted_marks_idx, t_config.keys[kPsi][kTail][kTextPosAsc][kIdx], t_config);
-  sri::store_to_cache(mark_to_sample_links, t_config.keys[kPsi][kTail][kTextPosAsc][kLink], t_config, true);
+  // sri::storeToCache(sorted_marks_idx, t_config.keys[kPsi][kTail][kTextPosAsc][kIdx], t_config);
+  sri::storeToCache(mark_to_sample_links, t_config.keys[kPsi][kTail][kTextPosAsc][kLink], t_config, true);
 
   return mark_to_sample_links;
 }
@@ -242,7 +257,7 @@ inline auto constructMarkToSampleLinksForPhiForwardWithPsiRuns(Config &t_config)
 void constructMarkToSampleLinksForPhiBackward(sdsl::cache_config &t_config) {
   // Marks
   sdsl::int_vector<> marks; // Text position of the first symbol in BWT runs
-  sdsl::load_from_cache(marks, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+  sri::loadFromCache(marks, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
 
   auto get_link = [r = marks.size()](const auto &tt_mark_idx) {
     return (tt_mark_idx + r - 1) % r;
@@ -251,8 +266,8 @@ void constructMarkToSampleLinksForPhiBackward(sdsl::cache_config &t_config) {
   // Compute links
   auto [sorted_marks_idx, mark_to_sample_links] = constructMarkToSampleLinks(marks, get_link);
 
-  sdsl::store_to_cache(sorted_marks_idx, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
-  sdsl::store_to_cache(mark_to_sample_links, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config);
+  sri::storeToCache(std::move(sorted_marks_idx), conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
+  sri::storeToCache(std::move(mark_to_sample_links), conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config);
 }
 
 template<typename TGetNextMark, typename TGetNextSubmark, typename TReport>
@@ -298,13 +313,15 @@ void constructBitVectorFromIntVector(TValues &t_values,
   sdsl::bit_vector bv_tmp = constructBitVectorFromIntVector(t_values, t_bv_size, t_init_value);
 
   TBitVector bv(std::move(bv_tmp));
-  sri::store_to_cache(bv, t_key, t_config, true);
 
   TBVRank bv_rank(&bv);
-  sri::store_to_cache(bv_rank, t_key, t_config, true);
+  sri::storeToCache(std::move(bv_rank), t_key, t_config, true);
 
   TBVSelect bv_select(&bv);
-  sri::store_to_cache(bv_select, t_key, t_config, true);
+  sri::storeToCache(std::move(bv_select), t_key, t_config, true);
+
+  // The stage is checked by the bit vector, so it is stored last
+  sri::storeToCache(std::move(bv), t_key, t_config, true);
 }
 
 template<typename TBitVector,
@@ -316,8 +333,8 @@ void constructBitVectorFromIntVector(const std::string& t_key,
                                      bool t_init_value,
                                      bool t_add_type_hash = false) {
   const auto filename = t_add_type_hash
-                          ? sdsl::cache_file_name<sdsl::int_vector<>>(t_key, t_config)
-                          : sdsl::cache_file_name(t_key, t_config);
+                          ? sri::cacheFileName<sdsl::int_vector<>>(t_key, t_config)
+                          : sri::cacheFileName(t_key, t_config);
   sdsl::int_vector_buffer<> int_buf(filename);
   constructBitVectorFromIntVector<TBitVector, sdsl::int_vector_buffer<>, TBVRank, TBVSelect>(
     int_buf,
@@ -333,11 +350,11 @@ inline void constructSortedIndices(const std::string& t_key,
                                    const std::string& t_out_key,
                                    bool t_add_type_hash = false) {
   sdsl::int_vector<> values;
-  sdsl::load_from_cache(values, t_key, t_config, t_add_type_hash);
+  sri::loadFromCache(values, t_key, t_config, t_add_type_hash);
 
   auto values_idx = sortIndices(values);
 
-  sdsl::store_to_cache(values_idx, t_out_key, t_config);
+  sri::storeToCache(std::move(values_idx), t_out_key, t_config);
 }
 
 }
@@ -14,6 +14,7 @@
 
 #include "alphabet.h"
 #include "rle_string.hpp"
+#include "io.h"
 
 namespace sri {
 
@@ -53,17 +54,23 @@ const std::string KEY_PSI_RUN_LAST = "psi_run_last"; // Positions in the Psi arr
 const std::string KEY_PSI_RUN_LAST_TEXT_POS = KEY_PSI_RUN_LAST + "_text_pos";
 }
 
+//! Length of the BWT, from the position of its last run tail, as the imported and merged BWTs are not stored plain
+inline std::size_t bwtSize(const sdsl::cache_config &t_config) {
+  sdsl::int_vector_buffer<> bwt_run_last(sri::cacheFileName(conf::KEY_BWT_RUN_LAST, t_config));
+  return bwt_run_last[bwt_run_last.size() - 1] + 1;
+}
+
 template<uint8_t t_width>
 void constructAlphabet(sdsl::cache_config &t_config) {
   static_assert(t_width == 0 or t_width == 8,
                 "constructAlphabet: width must be `0` for integer alphabet and `8` for byte alphabet");
 
-  sdsl::int_vector_buffer<t_width> bwt_buf(sdsl::cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
+  sdsl::int_vector_buffer<t_width> bwt_buf(sri::cacheFileName(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
   auto n = bwt_buf.size();
 
   typename alphabet_trait<t_width>::type alphabet(bwt_buf, n);
 
-  sdsl::store_to_cache(alphabet, conf::KEY_ALPHABET, t_config);
+  sri::storeToCache(std::move(alphabet), conf::KEY_ALPHABET, t_config);
 }
 
 template<uint8_t t_width>
@@ -71,11 +78,11 @@ void constructBWTRLE(sdsl::cache_config &t_config) {
   static_assert(t_width == 0 or t_width == 8,
                 "constructBWTRLE: width must be `0` for integer alphabet and `8` for byte alphabet");
 
-  sdsl::int_vector_buffer<t_width> bwt_buf(sdsl::cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
+  sdsl::int_vector_buffer<t_width> bwt_buf(sri::cacheFileName(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
 
   {
     typename alphabet_trait<t_width>::type alphabet;
-    sdsl::load_from_cache(alphabet, conf::KEY_ALPHABET, t_config);
+    sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
 
     auto get_symbol = [&bwt_buf, &alphabet](auto tt_i) { return alphabet.char2comp[bwt_buf[tt_i]]; };
 
@@ -83,7 +90,7 @@ void constructBWTRLE(sdsl::cache_config &t_config) {
 
     RLEString<> bwt_rle(bwt_s.begin(), bwt_s.end());
 
-    sdsl::store_to_cache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+    sri::storeToCache(std::move(bwt_rle), conf::KEY_BWT_RLE, t_config);
   }
 }
 
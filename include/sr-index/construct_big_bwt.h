@@ -39,7 +39,7 @@ void registerBigBWTFiles(const std::string &t_data_path, sdsl::cache_config &t_c
 void constructBWT(const std::string &t_data_path, sdsl::cache_config &t_config, const std::string &t_bigbwt_exe) {
 
 
-  if (!cache_file_exists(conf::KEY_BIG_BWT, t_config)) {
+  if (!sri::cacheFileExists(conf::KEY_BIG_BWT, t_config)) {
     std::cout<<"Constructing BWT with big-bwt"<<std::endl;
     auto command = t_bigbwt_exe + " -s -e " + t_data_path + " > /dev/null 2>&1";
     std::system(command.c_str());
@@ -50,11 +50,11 @@ void constructBWT(const std::string &t_data_path, sdsl::cache_config &t_config,
   auto *buffer = static_cast<uint8_t *>(malloc(buff_size));
 
   //bwt computed with bigbwt
-  std::ifstream bwt_file(cache_file_name(conf::KEY_BIG_BWT, t_config));
-  size_t f_size = std::filesystem::file_size(cache_file_name(conf::KEY_BIG_BWT, t_config));
+  std::ifstream bwt_file(sri::cacheFileName(conf::KEY_BIG_BWT, t_config));
+  size_t f_size = std::filesystem::file_size(sri::cacheFileName(conf::KEY_BIG_BWT, t_config));
 
   // Prepare to store BWT and runs to disc
-  sdsl::int_vector_buffer<8> bwt_buf(cache_file_name(sdsl::conf::KEY_BWT, t_config), std::ios::out);
+  sdsl::int_vector_buffer<8> bwt_buf(sri::cacheFileName(sdsl::conf::KEY_BWT, t_config), std::ios::out);
 
   size_t read_bytes=0;
   while(read_bytes < f_size) {
@@ -66,28 +66,28 @@ void constructBWT(const std::string &t_data_path, sdsl::cache_config &t_config,
     read_bytes+=bytes_read;
   }
 
-  //std::cout<<"Input BWT file "<<cache_file_name(conf::KEY_BIG_BWT, t_config)<<" has "<<read_bytes<<" symbol"<<" "<<std::endl;
+  //std::cout<<"Input BWT file "<<sri::cacheFileName(conf::KEY_BIG_BWT, t_config)<<" has "<<read_bytes<<" symbol"<<" "<<std::endl;
   bwt_file.close();
   bwt_buf.close();
   free(buffer);
-  register_cache_file(sdsl::conf::KEY_BWT, t_config);
+  sri::registerCacheFile(sdsl::conf::KEY_BWT, t_config);
 }
 
 void constructBWTRuns(sdsl::cache_config &t_config) {
-  const auto n = std::filesystem::file_size(sdsl::cache_file_name(conf::KEY_BIG_BWT, t_config));
+  const auto n = std::filesystem::file_size(sri::cacheFileName(conf::KEY_BIG_BWT, t_config));
 
   // Prepare to store BWT runs to disc
   const std::size_t buffer_size = 1 << 20;
   const std::size_t n_width = sdsl::bits::hi(n) + 1;
   auto out_int_vector_buf = [buffer_size, n_width, &t_config](const auto &tt_key) {
-    return sdsl::int_vector_buffer<>(cache_file_name(tt_key, t_config), std::ios::out, buffer_size, n_width);
+    return sdsl::int_vector_buffer<>(sri::cacheFileName(tt_key, t_config), std::ios::out, buffer_size, n_width);
   };
 
   auto read_runs = [n, &t_config, &out_int_vector_buf](
       const auto &tt_key, const auto &tt_key_bwt_run_pos, const auto &tt_key_bwt_run_text_pos
   ) {
     // Prepare to stream BWT run positions <j, SA[j]> from disc
-    std::ifstream input(cache_file_name(tt_key, t_config));
+    std::ifstream input(sri::cacheFileName(tt_key, t_config));
     if (!input) return;
 
     auto bwt_run_pos = out_int_vector_buf(tt_key_bwt_run_pos); // BWT run positions in BWT array
@@ -103,15 +103,16 @@ void constructBWTRuns(sdsl::cache_config &t_config) {
     }
     //std::cout<<"Read "<<cont<<" run"<<std::endl;
 
-    bwt_run_pos.close();
-    register_cache_file(tt_key_bwt_run_pos, t_config);
-
     bwt_run_text_pos.close();
-    register_cache_file(tt_key_bwt_run_text_pos, t_config);
+    sri::registerCacheFile(tt_key_bwt_run_text_pos, t_config);
+
+    bwt_run_pos.close();
+    sri::registerCacheFile(tt_key_bwt_run_pos, t_config);
   };
 
-  read_runs(conf::KEY_BIG_BWT_SSA, conf::KEY_BWT_RUN_FIRST, conf::KEY_BWT_RUN_FIRST_TEXT_POS);
+  // The stage is checked by the BWT-run first positions, so they are registered last
   read_runs(conf::KEY_BIG_BWT_ESA, conf::KEY_BWT_RUN_LAST, conf::KEY_BWT_RUN_LAST_TEXT_POS);
+  read_runs(conf::KEY_BIG_BWT_SSA, conf::KEY_BWT_RUN_FIRST, conf::KEY_BWT_RUN_FIRST_TEXT_POS);
 }
 
 template<uint8_t t_width>
@@ -125,25 +126,25 @@ void constructIndexBaseItems(const std::string &t_data_path,
 
   // Construct BWT
   {
-    auto event = sdsl::memory_monitor::event("BWT");
+    sri::StageEvent event("BWT");
     constructBWT(t_data_path, t_config, t_big_bwt_exe);
   }
 
   // Construct BWT Runs
-  if (!cache_file_exists(conf::KEY_BWT_RUN_FIRST, t_config)) {
-    auto event = sdsl::memory_monitor::event("BWT Runs");
+  if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST, t_config)) {
+    sri::StageEvent event("BWT Runs");
     constructBWTRuns(t_config);
   }
 
   // Construct Alphabet
-  if (!cache_file_exists(conf::KEY_ALPHABET, t_config)) {
-    auto event = sdsl::memory_monitor::event("Alphabet");
+  if (!sri::cacheFileExists(conf::KEY_ALPHABET, t_config)) {
+    sri::StageEvent event("Alphabet");
     constructAlphabet<t_width>(t_config);
   }
 
   // Construct BWT RLE
-  if (!cache_file_exists(conf::KEY_BWT_RLE, t_config)) {
-    auto event = sdsl::memory_monitor::event("BWT RLE");
+  if (!sri::cacheFileExists(conf::KEY_BWT_RLE, t_config)) {
+    sri::StageEvent event("BWT RLE");
     constructBWTRLE<t_width>(t_config);
   }
 }
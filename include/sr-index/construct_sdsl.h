@@ -5,17 +5,27 @@
 #ifndef SRI_CONSTRUCT_SDSL_H_
 #define SRI_CONSTRUCT_SDSL_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <sdsl/config.hpp>
 #include <sdsl/construct.hpp>
 #include <sdsl/vectors.hpp>
 
 #include "construct_base.h"
+#include "bwt.h"
+#include "parallel.h"
+#include "parallel_sa.h"
+#include "text_input.h"
 
 namespace sri::inner_sdsl {
 
+//! Parse the text into the cache. A byte text is streamed (see streamText) straight into its cache file, or into memory
+//! if an artifact store keeps the construction items of the cache directory.
+//! \param t_file Text file, "-" for the standard input, or a gzip or zstd file (for byte alphabet)
 template<uint8_t t_width>
 void constructText(const std::string &t_file, sdsl::cache_config &t_config) {
   static_assert(t_width == 0 or t_width == 8,
@@ -25,18 +35,91 @@ void constructText(const std::string &t_file, sdsl::cache_config &t_config) {
 
   const auto KEY_TEXT = sdsl::key_text_trait<t_width>::KEY_TEXT;
 
-  TText text;
-  auto num_bytes = t_width / 8;
-  load_vector_from_file(text, t_file, num_bytes);
+  if constexpr (t_width == 8) {
+    auto print_stats = [](const TextStats &tt_stats) {
+      std::cout << "Text length: " << tt_stats.size << ", alphabet size: " << tt_stats.sigma() << std::endl;
+    };
+
+    if (sri::findArtifactStore(sdsl::cache_file_name(KEY_TEXT, t_config))) {
+      // Reserved from the size of the input, with the appended zero symbol, and grown geometrically beyond it (e.g.,
+      // for the standard input)
+      TText text(InputStream::sizeHint(t_file) + 1);
+      std::size_t n = 0;
+      auto stats = streamText(t_file, [&text, &n](const char *tt_data, std::size_t tt_size) {
+        if (text.size() < n + tt_size + 1) text.resize(std::max(2 * text.size(), n + tt_size + 1));
+        std::copy(tt_data, tt_data + tt_size, (char *) text.data() + n);
+        n += tt_size;
+      });
+
+      text.resize(stats.histogram[0] ? n : n + 1);
+      if (!stats.histogram[0]) text[n] = 0;
+      sri::storeToCache(std::move(text), KEY_TEXT, t_config);
+      print_stats(stats);
+    } else {
+      const std::size_t buffer_size = 1 << 20;
+      sdsl::int_vector_buffer<8> text(sdsl::cache_file_name(KEY_TEXT, t_config), std::ios::out, buffer_size);
+      auto stats = streamText(t_file, [&text](const char *tt_data, std::size_t tt_size) {
+        for (std::size_t i = 0; i < tt_size; ++i) text.push_back((uint8_t) tt_data[i]);
+      });
+
+      if (!stats.histogram[0]) text.push_back(0);
+      text.close();
+      sri::registerCacheFile(KEY_TEXT, t_config);
+      print_stats(stats);
+    }
+  } else {
+    TText text;
+    load_vector_from_file(text, t_file, 0);
+
+    auto it_zero = std::find(text.begin(), text.end(), (uint64_t) 0);
+    if (it_zero == text.end()) {
+      sdsl::append_zero_symbol(text);
+    } else if (it_zero != text.end() - 1) {
+      throw std::logic_error(std::string("Error: File \"") + t_file + "\" contains inner zero symbol.");
+    }
 
-  auto it_zero = std::find(text.begin(), text.end(), (uint64_t) 0);
-  if (it_zero == text.end()) {
-    sdsl::append_zero_symbol(text);
-  } else if (it_zero != text.end() - 1) {
-    throw std::logic_error(std::string("Error: File \"") + t_file + "\" contains inner zero symbol.");
+    sri::storeToCache(std::move(text), KEY_TEXT, t_config);
   }
+}
+
+//! Compute the SA of the text kept in memory (see ArtifactStore), with libdivsufsort, and keep it in memory
+template<uint8_t t_width>
+void constructSAInMemory(sdsl::cache_config &t_config) {
+  static_assert(t_width == 8, "constructSAInMemory: only for byte alphabet");
+
+  auto text = sri::sharedFromCache<sdsl::int_vector<t_width>>(sdsl::key_text_trait<t_width>::KEY_TEXT, t_config);
+
+  sdsl::int_vector<> sa(text->size(), 0, sdsl::bits::hi(text->size()) + 1);
+  sdsl::algorithm::calculate_sa((const unsigned char *) text->data(), text->size(), sa);
 
-  sdsl::store_to_cache(text, KEY_TEXT, t_config);
+  sri::storeToCache(std::move(sa), sdsl::conf::KEY_SA, t_config);
+}
+
+//! Compute the SA with the parallel induced sorting, loading the text in memory if it is not kept there
+template<uint8_t t_width>
+void constructSAParallel(sdsl::cache_config &t_config) {
+  auto text = sri::sharedFromCache<sdsl::int_vector<t_width>>(sdsl::key_text_trait<t_width>::KEY_TEXT, t_config);
+
+  auto sa = computeSAByInducedSorting(*text, constructionThreads());
+  text.reset();
+
+  sri::storeToCache(std::move(sa), sdsl::conf::KEY_SA, t_config);
+}
+
+//! Compute the BWT of the text and SA kept in memory (see ArtifactStore), and keep it in memory
+template<uint8_t t_width>
+void constructBWTInMemory(sdsl::cache_config &t_config) {
+  auto text = sri::sharedFromCache<sdsl::int_vector<t_width>>(sdsl::key_text_trait<t_width>::KEY_TEXT, t_config);
+  auto sa = sri::sharedFromCache<sdsl::int_vector<>>(sdsl::conf::KEY_SA, t_config);
+
+  const auto n = text->size();
+  sdsl::int_vector<t_width> bwt(n, 0, text->width());
+  for (std::size_t i = 0; i < n; ++i) {
+    auto pos = (*sa)[i];
+    bwt[i] = (*text)[0 < pos ? pos - 1 : n - 1];
+  }
+
+  sri::storeToCache(std::move(bwt), sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config);
 }
 
 template<uint8_t t_width>
@@ -46,12 +129,12 @@ void constructBWTRuns(sdsl::cache_config &t_config) {
 
   // Prepare to stream BWT and SA from disc
   // TODO Use int_vector_buffer instead int_vector to process big files
-//  sdsl::int_vector_buffer<t_width> bwt_buf(sdsl::cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
-  sdsl::int_vector<t_width> bwt_buf;
-  sdsl::load_from_cache(bwt_buf, sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config);
-//  sdsl::int_vector_buffer<> sa_buf(sdsl::cache_file_name(sdsl::conf::KEY_SA, t_config));
-  sdsl::int_vector<> sa_buf;
-  sdsl::load_from_cache(sa_buf, sdsl::conf::KEY_SA, t_config);
+//  sdsl::int_vector_buffer<t_width> bwt_buf(sri::cacheFileName(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
+  auto bwt_ptr = sri::sharedFromCache<sdsl::int_vector<t_width>>(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config);
+  const auto &bwt_buf = *bwt_ptr;
+//  sdsl::int_vector_buffer<> sa_buf(sri::cacheFileName(sdsl::conf::KEY_SA, t_config));
+  auto sa_ptr = sri::sharedFromCache<sdsl::int_vector<>>(sdsl::conf::KEY_SA, t_config);
+  const auto &sa_buf = *sa_ptr;
 
   const auto n = bwt_buf.size();
 
@@ -64,7 +147,7 @@ void constructBWTRuns(sdsl::cache_config &t_config) {
   const std::size_t buffer_size = 1 << 20;
   const std::size_t n_width = sdsl::bits::hi(n) + 1;
   auto out_int_vector_buf = [buffer_size, n_width, &t_config](const auto &tt_key) {
-    return sdsl::int_vector_buffer<>(cache_file_name(tt_key, t_config), std::ios::out, buffer_size, n_width);
+    return sdsl::int_vector_buffer<>(sri::cacheFileName(tt_key, t_config), std::ios::out, buffer_size, n_width);
   };
 
   auto bwt_run_first_pos = out_int_vector_buf(conf::KEY_BWT_RUN_FIRST); // BWT run head positions in BWT array
@@ -72,103 +155,121 @@ void constructBWTRuns(sdsl::cache_config &t_config) {
   auto bwt_run_last_pos = out_int_vector_buf(conf::KEY_BWT_RUN_LAST); // BWT run tail positions in BWT array
   auto bwt_run_last_text_pos = out_int_vector_buf(conf::KEY_BWT_RUN_LAST_TEXT_POS); // BWT run tail positions in text
 
-  [[maybe_unused]] size_t n_runs = 0; // # BWT runs
-
-  // First BWT value
-  auto bwt_symbol = bwt_buf[0];
-  auto text_pos = get_bwt_text_pos(0);
+  // Run heads of each chunk of the BWT, found in parallel. The chunks are scanned in order, so their heads are stitched
+  // by concatenation: a run crossing a chunk edge has no head in the later chunk
+  const auto n_threads = std::max<std::size_t>(1, std::min(constructionThreads(), n >> 20));
+  std::vector<std::vector<uint64_t>> chunk_run_heads(n_threads);
+  parallelForBlocks(n, n_threads, [&bwt_buf, &chunk_run_heads](auto tt_chunk, auto tt_first, auto tt_last) {
+    auto report = [&run_heads = chunk_run_heads[tt_chunk]](auto tt_i) { run_heads.push_back(tt_i); };
+    if constexpr (t_width == 8) {
+      computeBWTRunHeads((const uint8_t *) bwt_buf.data(), tt_first, tt_last, report);
+    } else {
+      computeBWTRunHeads(tt_first, tt_last, [&bwt_buf](auto tt_i) { return bwt_buf[tt_i]; }, report);
+    }
+  });
 
   // First position starts the first BWT run.
   bwt_run_first_pos.push_back(0);
-  bwt_run_first_text_pos.push_back(text_pos);
-
-  auto prev_bwt_symbol = bwt_symbol;
-  auto prev_text_pos = text_pos;
-  for (size_t i = 1; i < n; ++i) {
-    bwt_symbol = bwt_buf[i];
-    text_pos = get_bwt_text_pos(i);
+  bwt_run_first_text_pos.push_back(get_bwt_text_pos(0));
 
-    if (bwt_symbol != prev_bwt_symbol) {
+  for (auto &run_heads : chunk_run_heads) {
+    for (auto i : run_heads) {
       // Last position of the previous BWT run
       bwt_run_last_pos.push_back(i - 1);
-      bwt_run_last_text_pos.push_back(prev_text_pos);
-
-      ++n_runs;
+      bwt_run_last_text_pos.push_back(get_bwt_text_pos(i - 1));
 
       // First position of the current BWT run
       bwt_run_first_pos.push_back(i);
-      bwt_run_first_text_pos.push_back(text_pos);
-
-      prev_bwt_symbol = bwt_symbol;
+      bwt_run_first_text_pos.push_back(get_bwt_text_pos(i));
     }
-
-    prev_text_pos = text_pos;
+    std::vector<uint64_t>().swap(run_heads);
   }
 
   // Last position ends the last BWT run
   bwt_run_last_pos.push_back(n - 1);
-  bwt_run_last_text_pos.push_back(text_pos);
-
-  bwt_run_first_pos.close();
-  register_cache_file(conf::KEY_BWT_RUN_FIRST, t_config);
+  bwt_run_last_text_pos.push_back(get_bwt_text_pos(n - 1));
 
   bwt_run_first_text_pos.close();
-  register_cache_file(conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+  sri::registerCacheFile(conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
 
   bwt_run_last_pos.close();
-  register_cache_file(conf::KEY_BWT_RUN_LAST, t_config);
+  sri::registerCacheFile(conf::KEY_BWT_RUN_LAST, t_config);
 
   bwt_run_last_text_pos.close();
-  register_cache_file(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+  sri::registerCacheFile(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+
+  // The stage is checked by this item, so it is registered last
+  bwt_run_first_pos.close();
+  sri::registerCacheFile(conf::KEY_BWT_RUN_FIRST, t_config);
 }
 
+//! \param t_parallel_sa Compute the SA with the parallel induced sorting instead of the SDSL algorithm
 template<uint8_t t_width>
-void constructIndexBaseItems(const std::string &t_data_path, sdsl::cache_config &t_config) {
+void constructIndexBaseItems(const std::string &t_data_path, sdsl::cache_config &t_config, bool t_parallel_sa = false) {
   // Parse Text
   const char *KEY_TEXT = sdsl::key_text_trait<t_width>::KEY_TEXT;
-  if (!cache_file_exists(KEY_TEXT, t_config)) {
+  if (!sri::cacheFileExists(KEY_TEXT, t_config)) {
       std::cout<<"Processing the text"<<std::endl;
-      auto event = sdsl::memory_monitor::event("Text");
+      sri::StageEvent event("Text");
       constructText<t_width>(t_data_path, t_config);
       std::cout<<"Done!"<<std::endl;
   }
 
   // Construct Suffix Array
-  if (!cache_file_exists(sdsl::conf::KEY_SA, t_config)) {
+  if (!sri::cacheFileExists(sdsl::conf::KEY_SA, t_config)) {
       std::cout<<"Computing the SA"<<std::endl;
-      auto event = sdsl::memory_monitor::event("SA");
-      sdsl::construct_sa<t_width>(t_config);
+      sri::StageEvent event("SA");
+      if (t_parallel_sa) {
+        constructSAParallel<t_width>(t_config);
+      } else if constexpr (t_width == 8) {
+        if (sdsl::construct_config::byte_algo_sa == sdsl::LIBDIVSUFSORT && sri::cacheFileInMemory(KEY_TEXT, t_config)) {
+          constructSAInMemory<t_width>(t_config);
+        }
+      }
+      if (!sri::cacheFileExists(sdsl::conf::KEY_SA, t_config)) {
+        sri::cacheFileName(KEY_TEXT, t_config); // SDSL reads the text from disk
+        sdsl::construct_sa<t_width>(t_config);
+        sri::registerCacheFile(sdsl::conf::KEY_SA, t_config);
+      }
       std::cout<<"Done!"<<std::endl;
   }
 
   // Construct BWT
-  if (!cache_file_exists(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config)) {
+  if (!sri::cacheFileExists(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config)) {
       std::cout<<"Computing the BWT"<<std::endl;
-      auto event = sdsl::memory_monitor::event("BWT");
-      sdsl::construct_bwt<t_width>(t_config);
+      sri::StageEvent event("BWT");
+      if (sri::cacheFileInMemory(KEY_TEXT, t_config) && sri::cacheFileInMemory(sdsl::conf::KEY_SA, t_config)) {
+        constructBWTInMemory<t_width>(t_config);
+      } else {
+        // SDSL reads the text and the SA from disk
+        sri::cacheFileName(KEY_TEXT, t_config);
+        sri::cacheFileName(sdsl::conf::KEY_SA, t_config);
+        sdsl::construct_bwt<t_width>(t_config);
+        sri::registerCacheFile(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config);
+      }
       std::cout<<"Done!"<<std::endl;
   }
 
   // Construct BWT Runs
-  if (!cache_file_exists(conf::KEY_BWT_RUN_FIRST, t_config)) {
+  if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST, t_config)) {
       std::cout<<"Run-length compressing the BWT"<<std::endl;
-      auto event = sdsl::memory_monitor::event("BWT Runs");
+      sri::StageEvent event("BWT Runs");
       constructBWTRuns<t_width>(t_config);
       std::cout<<"Done!"<<std::endl;
   }
 
   // Construct Alphabet
-  if (!cache_file_exists(conf::KEY_ALPHABET, t_config)) {
+  if (!sri::cacheFileExists(conf::KEY_ALPHABET, t_config)) {
       std::cout<<"Computing text alphabet"<<std::endl;
-      auto event = sdsl::memory_monitor::event("Alphabet");
+      sri::StageEvent event("Alphabet");
       constructAlphabet<t_width>(t_config);
       std::cout<<"Done!"<<std::endl;
   }
 
   // Construct BWT RLE
-  if (!cache_file_exists(conf::KEY_BWT_RLE, t_config)) {
+  if (!sri::cacheFileExists(conf::KEY_BWT_RLE, t_config)) {
       std::cout<<"Computing the RLBWT"<<std::endl;
-      auto event = sdsl::memory_monitor::event("BWT RLE");
+      sri::StageEvent event("BWT RLE");
       constructBWTRLE<t_width>(t_config);
       std::cout<<"Done!"<<std::endl;
   }
@@ -0,0 +1,456 @@
+//
+// Document collections: document listing and per-document frequencies.
+//
+
+#ifndef SRI_DOCUMENTS_H_
+#define SRI_DOCUMENTS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sdsl/config.hpp>
+#include <sdsl/construct_lcp.hpp>
+#include <sdsl/int_vector_buffer.hpp>
+#include <sdsl/rmq_support.hpp>
+#include <sdsl/sd_vector.hpp>
+
+#include "index_base.h"
+#include "construct.h"
+#include "config.h"
+#include "r_index.h"
+
+namespace sri {
+
+namespace conf {
+//! Text positions where each document starts
+const std::string KEY_DOC_START = "doc_start";
+//! BWT positions where the document array is sampled (prefixed by the sampling rate)
+const std::string KEY_DOC_SAMPLED_POS = "doc_sampled_pos";
+//! Document array sampled at the BWT positions of KEY_DOC_SAMPLED_POS (prefixed by the sampling rate)
+const std::string KEY_DOC_SAMPLES = "doc_samples";
+//! BWT positions where the runs of the interleaved LCP array (ILCP) start
+const std::string KEY_ILCP_RUN_HEADS = "ilcp_run_heads";
+//! ILCP value of each run
+const std::string KEY_ILCP_RUN_VALUES = "ilcp_run_values";
+//! Range minimum queries over the ILCP values of the runs
+const std::string KEY_ILCP_RUN_RMQ = "ilcp_run_rmq";
+}
+
+//! Index extension for document collections.
+//! The text is the concatenation of the documents, each one terminated by a separator symbol (see Config::doc_separator).
+//!
+//! The document listing does not enumerate the occurrences. It uses the interleaved LCP array (ILCP), where ILCP[i] is
+//! the LCP of the i-th suffix with the previous suffix (in SA order) of the same document: in the BWT range of a
+//! pattern of length m, the positions with ILCP < m are exactly the first occurrence of each distinct document. The
+//! ILCP is run-length encoded (it has few runs in repetitive collections) with range minimum queries over its runs, so
+//! each document is found with one query. The document of such a position is obtained with LF steps up to a sampled
+//! position of the document array, which is sampled at the BWT-run boundaries (aligned with the BWT-run samples of the
+//! index), at the document starts and at the text positions multiple of @p doc_rate_. Thus, the listing takes
+//! O(ndoc * doc_rate) LF steps, independently of the number of occurrences.
+//! \tparam TIndex Base index (RIndex, SrIndex or any of its variants)
+//! \tparam TBvDocStart Sparse bitvector marking the text positions where the documents start, and the sampled BWT
+//! positions and ILCP run heads
+template<typename TIndex,
+    typename TBvDocStart = sdsl::sd_vector<>,
+    typename TAlphabet = Alphabet<>,
+    typename TBwtRLE = RLEString<>,
+    typename TIntVector = sdsl::int_vector<>,
+    typename TRMQ = sdsl::rmq_succinct_sct<true>>
+class IndexDoc : public TIndex {
+ public:
+  using Base = TIndex;
+  using Base::Base;
+
+  IndexDoc(std::size_t t_sr, std::size_t t_doc_rate) : Base(t_sr), doc_rate_{t_doc_rate} {}
+
+  IndexDoc() = default;
+
+  std::size_t DocRate() const { return doc_rate_; }
+
+  //! Number of documents
+  std::size_t NumDocs() const { return (*doc_start_rank_)(doc_start_->size()); }
+
+  //! Document containing the given text position
+  std::size_t Doc(std::size_t t_pos) const { return (*doc_start_rank_)(t_pos + 1) - 1; }
+
+  //! Frequency of the pattern in each document where it occurs.
+  //! Unlike the listing, it locates every occurrence.
+  //! \param t_pattern Pattern
+  //! \return Pairs (document, frequency) sorted by document
+  std::vector<std::pair<std::size_t, std::size_t>> DocFrequencies(const std::string &t_pattern) const {
+    auto docs = this->Locate(t_pattern);
+    std::transform(docs.begin(), docs.end(), docs.begin(), [this](auto tt_pos) { return Doc(tt_pos); });
+    std::sort(docs.begin(), docs.end());
+
+    std::vector<std::pair<std::size_t, std::size_t>> freqs;
+    for (const auto &doc : docs) {
+      if (freqs.empty() || freqs.back().first != doc) {
+        freqs.emplace_back(doc, 0);
+      }
+      ++freqs.back().second;
+    }
+
+    return freqs;
+  }
+
+  //! Distinct documents where the pattern occurs, with one ILCP range minimum query per document
+  //! \param t_pattern Pattern
+  //! \return Documents sorted
+  std::vector<std::size_t> ListDocs(const std::string &t_pattern) const {
+    std::vector<std::size_t> docs;
+    const auto [start, end] = this->Count(t_pattern);
+    if (!(start < end)) return docs;
+
+    const auto &values = *ilcp_values_;
+    const auto &rmq = *ilcp_rmq_;
+    const auto &heads_select = *ilcp_heads_select_;
+    const auto m = t_pattern.size();
+
+    // Runs of the ILCP covering the range [start, end)
+    std::vector<std::pair<std::size_t, std::size_t>> ranges{{(*ilcp_heads_rank_)(start + 1) - 1,
+                                                              (*ilcp_heads_rank_)(end) - 1}};
+    while (!ranges.empty()) {
+      auto [first, last] = ranges.back();
+      ranges.pop_back();
+
+      auto k = rmq(first, last);
+      if (values[k] >= m) continue;
+
+      // Each position of the run within the range is the first occurrence of a document
+      auto run_start = std::max<std::size_t>(heads_select(k + 1), start);
+      auto run_end = k + 1 < values.size() ? std::min<std::size_t>(heads_select(k + 2), end) : end;
+      for (auto i = run_start; i < run_end; ++i) {
+        docs.emplace_back(docAtBWTPosition(i));
+      }
+
+      if (first < k) ranges.emplace_back(first, k - 1);
+      if (k < last) ranges.emplace_back(k + 1, last);
+    }
+
+    std::sort(docs.begin(), docs.end());
+
+    return docs;
+  }
+
+  void load(std::istream &in) override {
+    sdsl::read_member(doc_rate_, in);
+    Base::load(in);
+  }
+
+  using Base::load;
+
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+    size_t written_bytes;
+    written_bytes = this->template serializeItem<TBvDocStart>(key(ItemKey::DOC_STARTS), nulls, child, "doc_starts");
+    parts.emplace_back("doc_starts", written_bytes);
+    written_bytes = this->template serializeRank<TBvDocStart>(key(ItemKey::DOC_STARTS), nulls, child, "doc_starts_rank");
+    parts.emplace_back("doc_starts_rank", written_bytes);
+    written_bytes = this->template serializeItem<TBvDocStart>(key(ItemKey::DOC_SAMPLED_POS), nulls, child, "doc_sampled_pos");
+    written_bytes += this->template serializeRank<TBvDocStart>(key(ItemKey::DOC_SAMPLED_POS), nulls, child, "doc_sampled_pos_rank");
+    parts.emplace_back("doc_sampled_pos", written_bytes);
+    written_bytes = this->template serializeItem<TIntVector>(key(ItemKey::DOC_SAMPLES), nulls, child, "doc_samples");
+    parts.emplace_back("doc_samples", written_bytes);
+    written_bytes = this->template serializeItem<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), nulls, child, "ilcp_run_heads");
+    written_bytes += this->template serializeRank<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), nulls, child, "ilcp_run_heads_rank");
+    written_bytes += this->template serializeSelect<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), nulls, child, "ilcp_run_heads_select");
+    parts.emplace_back("ilcp_run_heads", written_bytes);
+    written_bytes = this->template serializeItem<TIntVector>(key(ItemKey::ILCP_RUN_VALUES), nulls, child, "ilcp_run_values");
+    written_bytes += this->template serializeItem<TRMQ>(key(ItemKey::ILCP_RUN_RMQ), nulls, child, "ilcp_run_rmq");
+    parts.emplace_back("ilcp_run_values", written_bytes);
+    return parts;
+  }
+
+  using typename Base::size_type;
+  using typename Base::ItemKey;
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v, const std::string &name) const override {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(doc_rate_, out, child, "doc_rate");
+
+    written_bytes += Base::serialize(out, v, name);
+
+    written_bytes += this->template serializeItem<TBvDocStart>(key(ItemKey::DOC_STARTS), out, child, "doc_starts");
+    written_bytes += this->template serializeRank<TBvDocStart>(key(ItemKey::DOC_STARTS), out, child, "doc_starts_rank");
+    written_bytes += this->template serializeItem<TBvDocStart>(key(ItemKey::DOC_SAMPLED_POS), out, child, "doc_sampled_pos");
+    written_bytes += this->template serializeRank<TBvDocStart>(key(ItemKey::DOC_SAMPLED_POS), out, child, "doc_sampled_pos_rank");
+    written_bytes += this->template serializeItem<TIntVector>(key(ItemKey::DOC_SAMPLES), out, child, "doc_samples");
+    written_bytes += this->template serializeItem<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), out, child, "ilcp_run_heads");
+    written_bytes += this->template serializeRank<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), out, child, "ilcp_run_heads_rank");
+    written_bytes += this->template serializeSelect<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), out, child, "ilcp_run_heads_select");
+    written_bytes += this->template serializeItem<TIntVector>(key(ItemKey::ILCP_RUN_VALUES), out, child, "ilcp_run_values");
+    written_bytes += this->template serializeItem<TRMQ>(key(ItemKey::ILCP_RUN_RMQ), out, child, "ilcp_run_rmq");
+
+    return written_bytes;
+  }
+
+ protected:
+
+  using Base::key;
+  void setupKeyNames() override {
+    Base::setupKeyNames();
+    key(ItemKey::DOC_STARTS) = conf::KEY_DOC_START;
+    key(ItemKey::DOC_SAMPLED_POS) = std::to_string(doc_rate_) + "_" + conf::KEY_DOC_SAMPLED_POS;
+    key(ItemKey::DOC_SAMPLES) = std::to_string(doc_rate_) + "_" + conf::KEY_DOC_SAMPLES;
+    key(ItemKey::ILCP_RUN_HEADS) = conf::KEY_ILCP_RUN_HEADS;
+    key(ItemKey::ILCP_RUN_VALUES) = conf::KEY_ILCP_RUN_VALUES;
+    key(ItemKey::ILCP_RUN_RMQ) = conf::KEY_ILCP_RUN_RMQ;
+  }
+
+  using typename Base::TSource;
+
+  void loadAllItems(TSource &t_source) override {
+    Base::loadAllItems(t_source);
+
+    this->template loadItem<TBvDocStart>(key(ItemKey::DOC_STARTS), t_source, true);
+    this->template loadBVRank<TBvDocStart>(key(ItemKey::DOC_STARTS), t_source, true);
+    this->template loadItem<TBvDocStart>(key(ItemKey::DOC_SAMPLED_POS), t_source, true);
+    this->template loadBVRank<TBvDocStart>(key(ItemKey::DOC_SAMPLED_POS), t_source, true);
+    this->template loadItem<TIntVector>(key(ItemKey::DOC_SAMPLES), t_source);
+    this->template loadItem<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), t_source, true);
+    this->template loadBVRank<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), t_source, true);
+    this->template loadBVSelect<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), t_source, true);
+    this->template loadItem<TIntVector>(key(ItemKey::ILCP_RUN_VALUES), t_source);
+    this->template loadItem<TRMQ>(key(ItemKey::ILCP_RUN_RMQ), t_source);
+  }
+
+  void constructIndex(TSource &t_source) override {
+    Base::constructIndex(t_source);
+
+    doc_start_ = &this->template loadItem<TBvDocStart>(key(ItemKey::DOC_STARTS), t_source, true).get();
+    doc_start_rank_ = &this->template loadBVRank<TBvDocStart>(key(ItemKey::DOC_STARTS), t_source, true).get();
+
+    alphabet_ = &this->template loadItem<TAlphabet>(key(ItemKey::ALPHABET), t_source).get();
+    bwt_rle_ = &this->template loadItem<TBwtRLE>(key(ItemKey::NAVIGATE), t_source).get();
+    doc_sampled_pos_rank_ = &this->template loadBVRank<TBvDocStart>(key(ItemKey::DOC_SAMPLED_POS), t_source, true).get();
+    doc_samples_ = &this->template loadItem<TIntVector>(key(ItemKey::DOC_SAMPLES), t_source).get();
+    ilcp_heads_rank_ = &this->template loadBVRank<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), t_source, true).get();
+    ilcp_heads_select_ = &this->template loadBVSelect<TBvDocStart>(key(ItemKey::ILCP_RUN_HEADS), t_source, true).get();
+    ilcp_values_ = &this->template loadItem<TIntVector>(key(ItemKey::ILCP_RUN_VALUES), t_source).get();
+    ilcp_rmq_ = &this->template loadItem<TRMQ>(key(ItemKey::ILCP_RUN_RMQ), t_source).get();
+  }
+
+  //! Document of the suffix at the given BWT position, with LF steps up to a sampled position.
+  //! The LF steps stay in the document, as its start is sampled, and they are less than doc_rate_.
+  std::size_t docAtBWTPosition(std::size_t t_pos) const {
+    const auto &bwt = *bwt_rle_;
+    const auto &alphabet = *alphabet_;
+    const auto &sampled_rank = *doc_sampled_pos_rank_;
+
+    auto report = [&t_pos, &alphabet](auto tt_rnk, auto tt_c, auto, auto, auto, auto) {
+      t_pos = alphabet.C[tt_c] + tt_rnk;
+    };
+
+    auto rnk = sampled_rank(t_pos);
+    while (sampled_rank(t_pos + 1) == rnk) {
+      bwt.rank(t_pos, report);
+      rnk = sampled_rank(t_pos);
+    }
+
+    return (*doc_samples_)[rnk];
+  }
+
+  std::size_t doc_rate_ = 64;
+
+  const TBvDocStart *doc_start_ = nullptr;
+  const typename TBvDocStart::rank_1_type *doc_start_rank_ = nullptr;
+
+  const TAlphabet *alphabet_ = nullptr;
+  const TBwtRLE *bwt_rle_ = nullptr;
+  const typename TBvDocStart::rank_1_type *doc_sampled_pos_rank_ = nullptr;
+  const TIntVector *doc_samples_ = nullptr;
+  const typename TBvDocStart::rank_1_type *ilcp_heads_rank_ = nullptr;
+  const typename TBvDocStart::select_1_type *ilcp_heads_select_ = nullptr;
+  const TIntVector *ilcp_values_ = nullptr;
+  const TRMQ *ilcp_rmq_ = nullptr;
+};
+
+//! Concatenate the given documents in a single file, appending the separator to each one
+//! \param t_files Documents
+//! \param t_separator Document separator. It cannot occur inside the documents
+//! \param t_output Output file
+inline void concatenateDocuments(const std::vector<std::string> &t_files, uint8_t t_separator, const std::string &t_output) {
+  if (t_separator == 0) {
+    throw std::invalid_argument("Error: document separator cannot be the zero symbol");
+  }
+
+  std::ofstream out(t_output, std::ios::binary);
+  std::vector<char> buffer(1 << 20);
+  for (const auto &file : t_files) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+      throw std::invalid_argument("Error: cannot open document \"" + file + "\"");
+    }
+
+    while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+      auto end = buffer.begin() + in.gcount();
+      if (std::find_if(buffer.begin(), end, [t_separator](char tt_c) {
+        return (uint8_t) tt_c == t_separator || tt_c == 0;
+      }) != end) {
+        throw std::invalid_argument(
+            "Error: document \"" + file + "\" contains the document separator or the zero symbol");
+      }
+      out.write(buffer.data(), in.gcount());
+    }
+
+    out.put((char) t_separator);
+  }
+}
+
+//! Construct the text positions where the documents start, i.e., position 0 and the one following each separator
+//! \param t_n Text length (including the terminating zero symbol)
+inline auto constructDocStarts(const Config &t_config, std::size_t t_n) {
+  std::ifstream in(t_config.data_path, std::ios::binary);
+  if (!in) {
+    throw std::invalid_argument("Error: cannot open collection \"" + t_config.data_path.string() + "\"");
+  }
+
+  std::vector<std::size_t> starts = {0};
+  std::vector<char> buffer(1 << 20);
+  std::size_t offset = 0;
+  while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+    for (std::size_t i = 0; i < std::size_t(in.gcount()); ++i) {
+      if ((uint8_t) buffer[i] == t_config.doc_separator && offset + i + 1 < t_n - 1) {
+        starts.emplace_back(offset + i + 1);
+      }
+    }
+    offset += in.gcount();
+  }
+
+  return starts;
+}
+
+//! Construct the document array sampled at the BWT run heads and tails, at the suffixes starting a document and at the
+//! text positions multiple of @p t_doc_rate, and the interleaved LCP array (ILCP) run-length encoded with range minimum
+//! queries over its runs. They require the text and its suffix array.
+//! \param t_starts Text positions where the documents start (see constructDocStarts)
+template<typename TBvDocStart, typename TIntVector, typename TRMQ>
+void constructDocArraySamplesAndILCP(const std::vector<std::size_t> &t_starts,
+                                     std::size_t t_doc_rate,
+                                     sdsl::cache_config &t_config) {
+  if (!sri::cacheFileExists(sdsl::conf::KEY_LCP, t_config)) {
+    if (!sri::cacheFileExists(sdsl::key_text_trait<8>::KEY_TEXT, t_config)
+        || !sri::cacheFileExists(sdsl::conf::KEY_SA, t_config)) {
+      throw std::invalid_argument("Document listing requires the text and its suffix array (not available with BIG_BWT or imported BWTs)");
+    }
+    // SDSL reads the text and the SA from disk
+    sri::cacheFileName(sdsl::key_text_trait<8>::KEY_TEXT, t_config);
+    sri::cacheFileName(sdsl::conf::KEY_SA, t_config);
+    sdsl::construct_lcp_kasai<8>(t_config);
+  }
+
+  sdsl::int_vector<> lcp;
+  sri::loadFromCache(lcp, sdsl::conf::KEY_LCP, t_config);
+  sdsl::rmq_succinct_sct<true> rmq(&lcp);
+
+  sdsl::int_vector_buffer<> sa(sri::cacheFileName(sdsl::conf::KEY_SA, t_config));
+  const auto n = sa.size();
+  auto doc = [&t_starts](auto tt_pos) {
+    return std::upper_bound(t_starts.begin(), t_starts.end(), tt_pos) - t_starts.begin() - 1;
+  };
+
+  // Sampled positions: BWT run boundaries, document starts and text positions multiple of the rate
+  sdsl::bit_vector sampled(n, 0);
+  {
+    sdsl::int_vector_buffer<> bwt_run_first(sri::cacheFileName(conf::KEY_BWT_RUN_FIRST, t_config));
+    for (std::size_t k = 0; k < bwt_run_first.size(); ++k) sampled[bwt_run_first[k]] = true;
+    sdsl::int_vector_buffer<> bwt_run_last(sri::cacheFileName(conf::KEY_BWT_RUN_LAST, t_config));
+    for (std::size_t k = 0; k < bwt_run_last.size(); ++k) sampled[bwt_run_last[k]] = true;
+  }
+
+  const auto width = sdsl::bits::hi(t_starts.size()) + 1;
+  std::vector<std::size_t> ilcp_heads;
+  sdsl::int_vector<> ilcp_values(n, 0, sdsl::bits::hi(n) + 1);
+  std::size_t n_runs = 0;
+  std::vector<std::size_t> last(t_starts.size(), 0); // Last position seen for each document (+1, 0 if none)
+  for (std::size_t i = 0; i < n; ++i) {
+    auto pos = sa[i];
+    auto d = doc(pos);
+    if (pos % t_doc_rate == 0 || std::binary_search(t_starts.begin(), t_starts.end(), pos)) sampled[i] = true;
+
+    std::size_t value = last[d] != 0 ? lcp[rmq(last[d], i)] : 0; // last[d] is already position + 1
+    if (n_runs == 0 || ilcp_values[n_runs - 1] != value) {
+      ilcp_heads.emplace_back(i);
+      ilcp_values[n_runs++] = value;
+    }
+    last[d] = i + 1;
+  }
+
+  TIntVector doc_samples;
+  {
+    sdsl::int_vector<> samples(sdsl::util::cnt_one_bits(sampled), 0, width);
+    for (std::size_t i = 0, k = 0; i < n; ++i) {
+      if (sampled[i]) samples[k++] = doc(sa[i]);
+    }
+    doc_samples = TIntVector(std::move(samples));
+  }
+  auto prefix = std::to_string(t_doc_rate) + "_";
+  sri::storeToCache(std::move(doc_samples), prefix + conf::KEY_DOC_SAMPLES, t_config);
+  {
+    TBvDocStart bv(std::move(sampled));
+    typename TBvDocStart::rank_1_type bv_rank(&bv);
+    sri::storeToCache(std::move(bv_rank), prefix + conf::KEY_DOC_SAMPLED_POS, t_config, true);
+    typename TBvDocStart::select_1_type bv_select(&bv);
+    sri::storeToCache(std::move(bv_select), prefix + conf::KEY_DOC_SAMPLED_POS, t_config, true);
+    sri::storeToCache(std::move(bv), prefix + conf::KEY_DOC_SAMPLED_POS, t_config, true);
+  }
+
+  constructBitVectorFromIntVector<TBvDocStart>(ilcp_heads, conf::KEY_ILCP_RUN_HEADS, t_config, n, false);
+  ilcp_values.resize(n_runs);
+  sdsl::util::bit_compress(ilcp_values);
+  TRMQ ilcp_rmq(&ilcp_values);
+  TIntVector values(std::move(ilcp_values));
+  sri::storeToCache(std::move(values), conf::KEY_ILCP_RUN_VALUES, t_config);
+  // The stage is checked by the range minimum queries, so they are stored last
+  sri::storeToCache(std::move(ilcp_rmq), conf::KEY_ILCP_RUN_RMQ, t_config);
+}
+
+template<typename TIndex, typename TBvDocStart, typename TAlphabet, typename TBwtRLE, typename TIntVector, typename TRMQ>
+void construct(IndexDoc<TIndex, TBvDocStart, TAlphabet, TBwtRLE, TIntVector, TRMQ> &t_index,
+               const std::string &t_data_path,
+               sri::Config &t_config) {
+  std::size_t n;
+  {
+    // Construct the items of the base index
+    TIndex base_index(t_index);
+    construct(base_index, t_data_path, t_config);
+    n = base_index.sizeSequence();
+  }
+
+  std::vector<std::size_t> starts;
+  {
+    std::cout << "Constructing document starts" << std::endl;
+    sri::StageEvent event("Documents");
+    if (!sri::cacheFileExists<TBvDocStart>(conf::KEY_DOC_START, t_config)) {
+      starts = constructDocStarts(t_config, n);
+      constructBitVectorFromIntVector<TBvDocStart>(starts, conf::KEY_DOC_START, t_config, n, false);
+    }
+  }
+
+  {
+    std::cout << "Constructing document array samples and ILCP" << std::endl;
+    sri::StageEvent event("Document Listing");
+    const auto doc_rate = t_index.DocRate();
+    if (!sri::cacheFileExists(std::to_string(doc_rate) + "_" + conf::KEY_DOC_SAMPLES, t_config)
+        || !sri::cacheFileExists(conf::KEY_ILCP_RUN_RMQ, t_config)) {
+      if (starts.empty()) starts = constructDocStarts(t_config, n);
+      constructDocArraySamplesAndILCP<TBvDocStart, TIntVector, TRMQ>(starts, doc_rate, t_config);
+    }
+  }
+
+  t_index.load(t_config);
+}
+
+}
+
+#endif //SRI_DOCUMENTS_H_
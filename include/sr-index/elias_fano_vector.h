@@ -0,0 +1,292 @@
+//
+// Elias-Fano bit-vector with sampled select on its upper bits, answering the circular predecessor and soft successor
+// (order and value) of the marked positions in one traversal, a replacement of sd_vector for the marks of phi.
+//
+
+#ifndef SRI_ELIAS_FANO_VECTOR_H_
+#define SRI_ELIAS_FANO_VECTOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <sdsl/bits.hpp>
+#include <sdsl/int_vector.hpp>
+#include <sdsl/io.hpp>
+#include <sdsl/structure_tree.hpp>
+#include <sdsl/util.hpp>
+
+namespace sri {
+
+//! Elias-Fano representation of the positions of the ones of a sparse bit-vector.
+//! The k-th one (0-based) at position v is split into its low part (the lowest wl bits of v, in low_) and its high
+//! part, set as the bit (v >> wl) + k of high_. The positions in high_ of every t_sample-th one and zero are sampled,
+//! so rank, select and the circular predecessor and soft successor start from a sample and scan whole words.
+//! \tparam t_sample Sampling rate of the ones and zeros of the upper bits
+template<uint32_t t_sample = 64>
+class EliasFanoVector {
+ public:
+  using size_type = std::size_t;
+
+  class rank_1_type;
+  class select_1_type;
+
+  EliasFanoVector() = default;
+
+  explicit EliasFanoVector(const sdsl::bit_vector &t_bv) : n_{t_bv.size()} {
+    m_ = sdsl::util::cnt_one_bits(t_bv);
+    wl_ = (m_ && m_ < n_) ? sdsl::bits::hi(n_ / m_) : 0;
+
+    low_ = sdsl::int_vector<>(m_, 0, std::max<uint8_t>(wl_, 1));
+    high_ = sdsl::bit_vector(m_ + (n_ >> wl_) + 1, 0);
+    const uint64_t low_mask = sdsl::bits::lo_set[wl_];
+    for (size_type i = 0, k = 0; i < n_; ++i) {
+      if (t_bv[i]) {
+        low_[k] = i & low_mask;
+        high_[(i >> wl_) + k] = 1;
+        ++k;
+      }
+    }
+
+    ones_samples_ = sdsl::int_vector<>((m_ + t_sample - 1) / t_sample, 0, sdsl::bits::hi(high_.size()) + 1);
+    zeros_samples_ = sdsl::int_vector<>((high_.size() - m_ + t_sample - 1) / t_sample, 0,
+                                        sdsl::bits::hi(high_.size()) + 1);
+    for (size_type p = 0, ones = 0, zeros = 0; p < high_.size(); ++p) {
+      if (high_[p]) {
+        if (ones % t_sample == 0) ones_samples_[ones / t_sample] = p;
+        ++ones;
+      } else {
+        if (zeros % t_sample == 0) zeros_samples_[zeros / t_sample] = p;
+        ++zeros;
+      }
+    }
+  }
+
+  //! Size of the represented bit-vector
+  size_type size() const { return n_; }
+
+  //! Number of ones of the represented bit-vector
+  size_type countOnes() const { return m_; }
+
+  bool operator[](size_type i) const {
+    return i < n_ && rank(i + 1) != rank(i);
+  }
+
+  //! Number of ones in [0, i)
+  size_type rank(size_type i) const {
+    if (i >= n_) return m_;
+    return scan(i).second;
+  }
+
+  //! Position of the k-th one (1-based)
+  size_type select(size_type k) const {
+    return value(k - 1, selectHigh1(k - 1));
+  }
+
+  //! Circular predecessor of i
+  //! \return <o, v>: the greatest one strictly smaller than i (or the greatest one if there is none) is the o-th one
+  //! (0-based) and its position is v, i.e., <(rank(i) + m - 1) % m, select(that + 1)>
+  std::pair<size_type, size_type> predecessor(size_type i) const {
+    if (i >= n_) return lastOne();
+
+    auto [p, k] = scan(i);
+    if (k == 0) return lastOne();
+
+    // The predecessor is the previous one in high_, usually in the same or the previous word
+    return {k - 1, value(k - 1, prevOne(p, k - 1))};
+  }
+
+  //! Circular soft successor of i
+  //! \return <o, v>: the smallest one greater or equal than i (or the smallest one if there is none) is the o-th one
+  //! (0-based) and its position is v, i.e., <rank(i) % m, select(that + 1)>
+  std::pair<size_type, size_type> softSuccessor(size_type i) const {
+    if (i >= n_) return {0, select(1)};
+
+    auto [p, k] = scan(i);
+    if (k == m_) return {0, select(1)};
+
+    return {k, value(k, nextOne(p, k))};
+  }
+
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, const std::string &name = "") const {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(n_, out, child, "n");
+    written_bytes += sdsl::write_member(m_, out, child, "m");
+    written_bytes += sdsl::write_member(wl_, out, child, "wl");
+    written_bytes += low_.serialize(out, child, "low");
+    written_bytes += high_.serialize(out, child, "high");
+    written_bytes += ones_samples_.serialize(out, child, "ones_samples");
+    written_bytes += zeros_samples_.serialize(out, child, "zeros_samples");
+    sdsl::structure_tree::add_size(child, written_bytes);
+    return written_bytes;
+  }
+
+  void load(std::istream &in) {
+    sdsl::read_member(n_, in);
+    sdsl::read_member(m_, in);
+    sdsl::read_member(wl_, in);
+    low_.load(in);
+    high_.load(in);
+    ones_samples_.load(in);
+    zeros_samples_.load(in);
+  }
+
+ private:
+  //! Words scanned from a position of high_ to its neighbour one before falling back to the sampled select
+  static constexpr size_type kMaxScanWords = 4;
+
+  //! Value of the k-th one (0-based) set at position t_pos of high_
+  size_type value(size_type t_k, size_type t_pos) const {
+    return ((t_pos - t_k) << wl_) | low_[t_k];
+  }
+
+  std::pair<size_type, size_type> lastOne() const { return {m_ - 1, select(m_)}; }
+
+  //! Position in high_ of the first one (0-based k) not smaller than i < n, or of the zero closing its bucket, and k
+  std::pair<size_type, size_type> scan(size_type i) const {
+    const size_type h = i >> wl_;
+    const uint64_t i_low = i & sdsl::bits::lo_set[wl_];
+
+    // The bucket h starts after its h-th zero, preceded by h zeros and k ones
+    size_type p = h ? selectHigh0(h - 1) + 1 : 0;
+    size_type k = p - h;
+    // The last bit of high_ is always zero
+    while (high_[p] && low_[k] < i_low) ++p, ++k;
+
+    return {p, k};
+  }
+
+  //! Position in high_ of the k-th one (0-based)
+  size_type selectHigh1(size_type t_k) const {
+    const size_type pos = ones_samples_[t_k / t_sample];
+    size_type rest = t_k % t_sample;
+
+    const uint64_t *data = high_.data();
+    size_type idx = pos >> 6;
+    uint64_t word = data[idx] & ~sdsl::bits::lo_set[pos & 63];
+    for (auto cnt = sdsl::bits::cnt(word); rest >= cnt; cnt = sdsl::bits::cnt(word)) {
+      rest -= cnt;
+      word = data[++idx];
+    }
+
+    return (idx << 6) + sdsl::bits::sel(word, rest + 1);
+  }
+
+  //! Position in high_ of the j-th zero (0-based)
+  size_type selectHigh0(size_type t_j) const {
+    const size_type pos = zeros_samples_[t_j / t_sample];
+    size_type rest = t_j % t_sample;
+
+    const uint64_t *data = high_.data();
+    size_type idx = pos >> 6;
+    uint64_t word = ~data[idx] & ~sdsl::bits::lo_set[pos & 63];
+    for (auto cnt = sdsl::bits::cnt(word); rest >= cnt; cnt = sdsl::bits::cnt(word)) {
+      rest -= cnt;
+      word = ~data[++idx];
+    }
+
+    return (idx << 6) + sdsl::bits::sel(word, rest + 1);
+  }
+
+  //! Position in high_ of the last one before t_pos, which is the k-th one (0-based)
+  size_type prevOne(size_type t_pos, size_type t_k) const {
+    const uint64_t *data = high_.data();
+    size_type idx = t_pos >> 6;
+    uint64_t word = data[idx] & sdsl::bits::lo_set[t_pos & 63];
+    for (size_type i = 0; !word; ++i) {
+      if (i == kMaxScanWords) return selectHigh1(t_k);
+      word = data[--idx];
+    }
+
+    return (idx << 6) + sdsl::bits::hi(word);
+  }
+
+  //! Position in high_ of the first one at or after t_pos, which is the k-th one (0-based)
+  size_type nextOne(size_type t_pos, size_type t_k) const {
+    const uint64_t *data = high_.data();
+    size_type idx = t_pos >> 6;
+    uint64_t word = data[idx] & ~sdsl::bits::lo_set[t_pos & 63];
+    for (size_type i = 0; !word; ++i) {
+      if (i == kMaxScanWords) return selectHigh1(t_k);
+      word = data[++idx];
+    }
+
+    return (idx << 6) + sdsl::bits::lo(word);
+  }
+
+  size_type n_ = 0;
+  size_type m_ = 0;
+  uint8_t wl_ = 0;
+
+  sdsl::int_vector<> low_; // Lowest wl bits of the ones
+  sdsl::bit_vector high_; // Upper bits of the ones in unary, a one per element and a zero per bucket
+  sdsl::int_vector<> ones_samples_; // Position in high_ of every t_sample-th one
+  sdsl::int_vector<> zeros_samples_; // Position in high_ of every t_sample-th zero
+};
+
+//! Rank over the Elias-Fano vector, also giving the circular predecessor and soft successor (see sequence_ops.h)
+template<uint32_t t_sample>
+class EliasFanoVector<t_sample>::rank_1_type {
+ public:
+  using size_type = std::size_t;
+
+  rank_1_type(const EliasFanoVector *t_v = nullptr) : v_{t_v} {}
+
+  size_type rank(size_type i) const { return v_->rank(i); }
+
+  size_type operator()(size_type i) const { return v_->rank(i); }
+
+  std::pair<size_type, size_type> predecessor(size_type i) const { return v_->predecessor(i); }
+
+  std::pair<size_type, size_type> softSuccessor(size_type i) const { return v_->softSuccessor(i); }
+
+  size_type size() const { return v_->size(); }
+
+  void set_vector(const EliasFanoVector *t_v = nullptr) { v_ = t_v; }
+
+  size_type serialize(std::ostream &, sdsl::structure_tree_node *v = nullptr, const std::string &name = "") const {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+    sdsl::structure_tree::add_size(child, 0);
+    return 0;
+  }
+
+  void load(std::istream &, const EliasFanoVector *t_v = nullptr) { set_vector(t_v); }
+
+ private:
+  const EliasFanoVector *v_;
+};
+
+//! Select over the Elias-Fano vector
+template<uint32_t t_sample>
+class EliasFanoVector<t_sample>::select_1_type {
+ public:
+  using size_type = std::size_t;
+
+  select_1_type(const EliasFanoVector *t_v = nullptr) : v_{t_v} {}
+
+  size_type select(size_type k) const { return v_->select(k); }
+
+  size_type operator()(size_type k) const { return v_->select(k); }
+
+  size_type size() const { return v_->size(); }
+
+  void set_vector(const EliasFanoVector *t_v = nullptr) { v_ = t_v; }
+
+  size_type serialize(std::ostream &, sdsl::structure_tree_node *v = nullptr, const std::string &name = "") const {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+    sdsl::structure_tree::add_size(child, 0);
+    return 0;
+  }
+
+  void load(std::istream &, const EliasFanoVector *t_v = nullptr) { set_vector(t_v); }
+
+ private:
+  const EliasFanoVector *v_;
+};
+
+}
+
+#endif //SRI_ELIAS_FANO_VECTOR_H_
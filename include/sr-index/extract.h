@@ -0,0 +1,238 @@
+//
+// Text extraction using a sampled inverse suffix array.
+//
+
+#ifndef SRI_EXTRACT_H_
+#define SRI_EXTRACT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sdsl/config.hpp>
+#include <sdsl/int_vector.hpp>
+#include <sdsl/int_vector_buffer.hpp>
+
+#include "index_base.h"
+#include "alphabet.h"
+#include "rle_string.hpp"
+#include "construct_base.h"
+#include "r_index.h"
+
+namespace sri {
+
+namespace conf {
+//! Inverse suffix array sampled at text positions multiple of the sampling rate
+const std::string KEY_ISA_SAMPLES = "isa_samples";
+}
+
+//! Extract a substring of the text with LF steps from the inverse suffix array sample following it.
+//! \param t_isa_samples Inverse suffix array sampled at text positions multiple of t_isa_rate
+//! \return T[t_pos..t_pos + t_len), clipped to the text end (without the terminating symbol)
+template<typename TBwtRLE, typename TAlphabet, typename TISASamples>
+std::string extractText(const TBwtRLE &t_bwt,
+                        const TAlphabet &t_alphabet,
+                        const TISASamples &t_isa_samples,
+                        std::size_t t_isa_rate,
+                        std::size_t t_pos,
+                        std::size_t t_len) {
+  const auto n = t_bwt.size();
+
+  const auto last = std::min(t_pos + t_len, n - 1);
+  if (last <= t_pos) return "";
+
+  // Start from the first sampled text position after the range (the terminating symbol is ISA[n - 1] = 0)
+  auto k = (last + t_isa_rate - 1) / t_isa_rate;
+  std::size_t j = n - 1;
+  std::size_t row = 0;
+  if (k < t_isa_samples.size() && k * t_isa_rate < n - 1) {
+    j = k * t_isa_rate;
+    row = t_isa_samples[k];
+  }
+
+  // BWT[ISA[j]] = T[j - 1]
+  std::string text(last - t_pos, 0);
+  auto report = [&](auto tt_rnk, auto tt_c, auto, auto, auto, auto) {
+    if (j <= last) text[j - 1 - t_pos] = t_alphabet.comp2char[tt_c];
+    row = t_alphabet.C[tt_c] + tt_rnk;
+  };
+  for (; t_pos < j; --j) {
+    t_bwt.rank(row, report);
+  }
+
+  return text;
+}
+
+//! Index extension for text extraction.
+//! It samples the inverse suffix array at text positions multiple of @p isa_rate_, so extracting T[i..i+l)
+//! takes l + isa_rate_ LF steps from the sample following the range.
+//! \tparam TIndex Base index (RIndex, SrIndex or any of its variants)
+template<typename TIndex,
+    typename TAlphabet = Alphabet<>,
+    typename TBwtRLE = RLEString<>,
+    typename TISASamples = sdsl::int_vector<>>
+class IndexExtract : public TIndex {
+ public:
+  using Base = TIndex;
+
+  IndexExtract(std::size_t t_sr, std::size_t t_isa_rate) : Base(t_sr), isa_rate_{t_isa_rate} {}
+
+  explicit IndexExtract(std::size_t t_sr) : Base(t_sr) {}
+
+  IndexExtract() = default;
+
+  std::size_t ISARate() const { return isa_rate_; }
+
+  //! Extract a substring of the text
+  //! \param t_pos Text position
+  //! \param t_len Length
+  //! \return T[t_pos..t_pos + t_len), clipped to the text end (without the terminating symbol)
+  std::string Extract(std::size_t t_pos, std::size_t t_len) const {
+    return extractText(*bwt_rle_, *alphabet_, *isa_samples_, isa_rate_, t_pos, t_len);
+  }
+
+  //! Extract the context around each occurrence of the pattern
+  //! \param t_pattern Pattern
+  //! \param t_context Number of symbols before and after the occurrences
+  //! \return Occurrences with their context, sorted by text position
+  std::vector<std::string> Display(const std::string &t_pattern, std::size_t t_context) const {
+    auto occs = this->Locate(t_pattern);
+    std::sort(occs.begin(), occs.end());
+
+    std::vector<std::string> snippets;
+    snippets.reserve(occs.size());
+    for (const auto &occ : occs) {
+      auto first = occ < t_context ? 0 : occ - t_context;
+      snippets.emplace_back(Extract(first, occ - first + t_pattern.size() + t_context));
+    }
+
+    return snippets;
+  }
+
+  void load(std::istream &in) override {
+    sdsl::read_member(isa_rate_, in);
+    Base::load(in);
+  }
+
+  using Base::load;
+
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+    size_t written_bytes;
+    written_bytes = this->template serializeItem<TISASamples>(key(ItemKey::ISA_SAMPLES), nulls, child, "isa_samples");
+    parts.emplace_back("isa_samples", written_bytes);
+    return parts;
+  }
+
+  using typename Base::size_type;
+  using typename Base::ItemKey;
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v, const std::string &name) const override {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(isa_rate_, out, child, "isa_rate");
+
+    written_bytes += Base::serialize(out, v, name);
+    written_bytes += this->template serializeItem<TISASamples>(key(ItemKey::ISA_SAMPLES), out, child, "isa_samples");
+
+    return written_bytes;
+  }
+
+ protected:
+
+  using Base::key;
+  void setupKeyNames() override {
+    Base::setupKeyNames();
+    key(ItemKey::ISA_SAMPLES) = std::to_string(isa_rate_) + "_" + conf::KEY_ISA_SAMPLES;
+  }
+
+  using typename Base::TSource;
+
+  void loadAllItems(TSource &t_source) override {
+    Base::loadAllItems(t_source);
+
+    this->template loadItem<TISASamples>(key(ItemKey::ISA_SAMPLES), t_source);
+  }
+
+  void constructIndex(TSource &t_source) override {
+    Base::constructIndex(t_source);
+
+    alphabet_ = &this->template loadItem<TAlphabet>(key(ItemKey::ALPHABET), t_source).get();
+    bwt_rle_ = &this->template loadItem<TBwtRLE>(key(ItemKey::NAVIGATE), t_source).get();
+    isa_samples_ = &this->template loadItem<TISASamples>(key(ItemKey::ISA_SAMPLES), t_source).get();
+  }
+
+  std::size_t isa_rate_ = 64;
+
+  const TAlphabet *alphabet_ = nullptr;
+  const TBwtRLE *bwt_rle_ = nullptr;
+  const TISASamples *isa_samples_ = nullptr;
+};
+
+//! Construct the inverse suffix array samples at text positions multiple of the sampling rate.
+//! It uses the suffix array if it is in the cache; otherwise, it traverses the text backward with LF on the RLBWT.
+template<uint8_t t_width>
+void constructISASamples(std::size_t t_isa_rate, sdsl::cache_config &t_config) {
+  static_assert(t_width == 0 or t_width == 8,
+                "constructISASamples: width must be `0` for integer alphabet and `8` for byte alphabet");
+
+  RLEString<> bwt_rle;
+  sri::loadFromCache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+  const auto n = bwt_rle.size();
+
+  sdsl::int_vector<> isa_samples((n + t_isa_rate - 1) / t_isa_rate, 0, sdsl::bits::hi(n) + 1);
+
+  if (sri::cacheFileExists(sdsl::conf::KEY_SA, t_config)) {
+    sdsl::int_vector_buffer<> sa_buf(sri::cacheFileName(sdsl::conf::KEY_SA, t_config));
+    for (std::size_t i = 0; i < n; ++i) {
+      auto pos = sa_buf[i];
+      if (pos % t_isa_rate == 0) isa_samples[pos / t_isa_rate] = i;
+    }
+  } else {
+    typename alphabet_trait<t_width>::type alphabet;
+    sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
+
+    // ISA[n - 1] = 0, and LF(ISA[j]) = ISA[j - 1]
+    std::size_t row = 0;
+    auto report = [&row, &alphabet](auto tt_rnk, auto tt_c, auto, auto, auto, auto) {
+      row = alphabet.C[tt_c] + tt_rnk;
+    };
+    for (std::size_t j = n - 1; j > 0; --j) {
+      if (j % t_isa_rate == 0) isa_samples[j / t_isa_rate] = row;
+      bwt_rle.rank(row, report);
+    }
+    isa_samples[0] = row;
+  }
+
+  sri::storeToCache(std::move(isa_samples), std::to_string(t_isa_rate) + "_" + conf::KEY_ISA_SAMPLES, t_config);
+}
+
+template<typename TIndex, template<uint8_t> typename TAlphabet, uint8_t t_width, typename TBwtRLE, typename TISASamples>
+void construct(IndexExtract<TIndex, TAlphabet<t_width>, TBwtRLE, TISASamples> &t_index,
+               const std::string &t_data_path,
+               sri::Config &t_config) {
+  {
+    // Construct the items of the base index
+    TIndex base_index(t_index);
+    construct(base_index, t_data_path, t_config);
+  }
+
+  {
+    std::cout << "Constructing ISA samples" << std::endl;
+    sri::StageEvent event("ISA Samples");
+    if (!sri::cacheFileExists(std::to_string(t_index.ISARate()) + "_" + conf::KEY_ISA_SAMPLES, t_config)) {
+      constructISASamples<t_width>(t_index.ISARate(), t_config);
+    }
+  }
+
+  t_index.load(t_config);
+}
+
+}
+
+#endif //SRI_EXTRACT_H_
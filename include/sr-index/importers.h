@@ -0,0 +1,379 @@
+//
+// Import of pre-built BWTs and SA samples from other tools into the construction cache.
+//
+
+#ifndef SRI_IMPORTERS_H_
+#define SRI_IMPORTERS_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sdsl/config.hpp>
+#include <sdsl/int_vector_buffer.hpp>
+
+#include "config.h"
+#include "construct_base.h"
+#include "build_report.h"
+#include "text_input.h"
+
+namespace sri {
+
+//! Input read byte by byte, or by little-endian integers, through a block buffer
+class BufferedInput {
+ public:
+  explicit BufferedInput(const std::string &t_file, std::size_t t_buffer_size = 1 << 20)
+      : in_{t_file}, buffer_(t_buffer_size) {}
+
+  //! Next byte, without consuming it
+  //! \return Whether there is a next byte
+  bool peek(uint8_t &t_byte) {
+    if (pos_ == size_ && !fill()) return false;
+    t_byte = buffer_[pos_];
+    return true;
+  }
+
+  bool get(uint8_t &t_byte) {
+    if (!peek(t_byte)) return false;
+    ++pos_;
+    return true;
+  }
+
+  //! Read a little-endian unsigned integer of the given number of bytes
+  //! \return Whether the input had a whole integer
+  bool getInt(uint64_t &t_value, std::size_t t_bytes) {
+    t_value = 0;
+    uint8_t byte;
+    for (std::size_t i = 0; i < t_bytes; ++i) {
+      if (!get(byte)) {
+        if (i == 0) return false;
+        throw std::runtime_error("Error: truncated integer in import file");
+      }
+      t_value |= uint64_t(byte) << (8 * i);
+    }
+    return true;
+  }
+
+ private:
+  bool fill() {
+    size_ = in_.read((char *) buffer_.data(), buffer_.size());
+    pos_ = 0;
+    return 0 < size_;
+  }
+
+  InputStream in_;
+  std::vector<uint8_t> buffer_;
+  std::size_t pos_ = 0;
+  std::size_t size_ = 0;
+};
+
+//! Reader of the runs of an imported BWT, in order. Consecutive runs may have the same symbol.
+class BWTRunReader {
+ public:
+  virtual ~BWTRunReader() = default;
+
+  //! Length of the BWT
+  virtual std::size_t size() = 0;
+
+  //! Read the next run
+  //! \return Whether there was a run
+  virtual bool next(uint8_t &t_symbol, uint64_t &t_length) = 0;
+};
+
+//! BWT with a byte per symbol (e.g., the .bwt of bigbwt), possibly compressed with gzip or zstd
+class PlainBWTReader : public BWTRunReader {
+ public:
+  explicit PlainBWTReader(const std::string &t_file) : file_{t_file}, in_{t_file} {}
+
+  std::size_t size() override {
+    if (!size_ && !InputStream::isCompressed(file_)) {
+      size_ = std::filesystem::file_size(file_);
+    } else if (!size_) {
+      BufferedInput in(file_);
+      uint8_t byte;
+      while (in.get(byte)) ++size_;
+    }
+    return size_;
+  }
+
+  bool next(uint8_t &t_symbol, uint64_t &t_length) override {
+    if (!in_.get(t_symbol)) return false;
+    t_length = 1;
+    uint8_t byte;
+    while (in_.peek(byte) && byte == t_symbol) {
+      in_.get(byte);
+      ++t_length;
+    }
+    return true;
+  }
+
+ private:
+  std::string file_;
+  BufferedInput in_;
+  std::size_t size_ = 0;
+};
+
+//! Run-length BWT: a symbol byte followed by the length of its run (little-endian, ImportSpec::run_length_bytes)
+class RunLengthBWTReader : public BWTRunReader {
+ public:
+  RunLengthBWTReader(const std::string &t_file, std::size_t t_length_bytes)
+      : file_{t_file}, length_bytes_{t_length_bytes}, in_{t_file} {}
+
+  std::size_t size() override {
+    if (!size_) {
+      RunLengthBWTReader reader(file_, length_bytes_);
+      uint8_t symbol;
+      uint64_t length;
+      while (reader.next(symbol, length)) size_ += length;
+    }
+    return size_;
+  }
+
+  bool next(uint8_t &t_symbol, uint64_t &t_length) override {
+    if (!in_.get(t_symbol)) return false;
+    if (!in_.getInt(t_length, length_bytes_) || t_length == 0) {
+      throw std::runtime_error("Error: invalid run in run-length BWT \"" + file_ + "\"");
+    }
+    return true;
+  }
+
+ private:
+  std::string file_;
+  std::size_t length_bytes_;
+  BufferedInput in_;
+  std::size_t size_ = 0;
+};
+
+//! Reader of the SA values at the heads and tails of the BWT runs. Each kind is requested in increasing BWT positions.
+class RunSampleReader {
+ public:
+  virtual ~RunSampleReader() = default;
+
+  //! SA value at the head of the run starting at BWT position t_j
+  virtual uint64_t head(uint64_t t_j) = 0;
+
+  //! SA value at the tail of the run ending at BWT position t_j
+  virtual uint64_t tail(uint64_t t_j) = 0;
+};
+
+//! Pairs <BWT position, SA value> at the run heads and tails, in separated files (e.g., the .ssa and .esa of bigbwt or
+//! the r-index). The pairs must match the maximal runs of the BWT.
+class RunPairsReader : public RunSampleReader {
+ public:
+  RunPairsReader(const std::string &t_ssa_file, const std::string &t_esa_file, std::size_t t_int_bytes)
+      : ssa_file_{t_ssa_file}, esa_file_{t_esa_file}, int_bytes_{t_int_bytes}, ssa_{t_ssa_file}, esa_{t_esa_file} {}
+
+  uint64_t head(uint64_t t_j) override { return read(ssa_, ssa_file_, t_j); }
+
+  uint64_t tail(uint64_t t_j) override { return read(esa_, esa_file_, t_j); }
+
+ private:
+  uint64_t read(BufferedInput &t_in, const std::string &t_file, uint64_t t_j) const {
+    uint64_t j, sa_j;
+    if (!t_in.getInt(j, int_bytes_) || !t_in.getInt(sa_j, int_bytes_) || j != t_j) {
+      throw std::runtime_error("Error: the samples of \"" + t_file + "\" do not match the BWT runs");
+    }
+    return sa_j;
+  }
+
+  std::string ssa_file_;
+  std::string esa_file_;
+  std::size_t int_bytes_;
+  BufferedInput ssa_;
+  BufferedInput esa_;
+};
+
+//! Whole SA as little-endian integers of ImportSpec::int_bytes, read only at the run boundaries
+class SAFileReader : public RunSampleReader {
+ public:
+  SAFileReader(const std::string &t_file, std::size_t t_int_bytes)
+      : file_{t_file}, int_bytes_{t_int_bytes}, in_{t_file, std::ios::binary} {
+    if (!in_) {
+      throw std::invalid_argument("Error: cannot open SA file \"" + t_file + "\"");
+    }
+  }
+
+  uint64_t head(uint64_t t_j) override { return read(t_j); }
+
+  uint64_t tail(uint64_t t_j) override { return read(t_j); }
+
+ private:
+  uint64_t read(uint64_t t_j) {
+    uint64_t value = 0;
+    in_.seekg(t_j * int_bytes_);
+    if (!in_.read((char *) &value, int_bytes_)) {
+      throw std::runtime_error("Error: SA file \"" + file_ + "\" is shorter than the BWT");
+    }
+    return value; // Little-endian host
+  }
+
+  std::string file_;
+  std::size_t int_bytes_;
+  std::ifstream in_;
+};
+
+using BWTReaderFactory = std::function<std::unique_ptr<BWTRunReader>(const std::string &, const ImportSpec &)>;
+using SampleReaderFactory = std::function<std::unique_ptr<RunSampleReader>(const ImportSpec &)>;
+
+//! Supported BWT formats, by name (ImportSpec::bwt_format). New formats can be registered.
+inline std::map<std::string, BWTReaderFactory> &bwtFormats() {
+  static std::map<std::string, BWTReaderFactory> formats = {
+      {"plain", [](const std::string &tt_file, const ImportSpec &) {
+        return std::make_unique<PlainBWTReader>(tt_file);
+      }},
+      {"rle", [](const std::string &tt_file, const ImportSpec &tt_spec) {
+        return std::make_unique<RunLengthBWTReader>(tt_file, tt_spec.run_length_bytes);
+      }}
+  };
+  return formats;
+}
+
+//! Supported SA sample formats, by name (ImportSpec::samples_format). New formats can be registered.
+inline std::map<std::string, SampleReaderFactory> &sampleFormats() {
+  static std::map<std::string, SampleReaderFactory> formats = {
+      {"runs", [](const ImportSpec &tt_spec) {
+        return std::make_unique<RunPairsReader>(tt_spec.ssa_file, tt_spec.esa_file, tt_spec.int_bytes);
+      }},
+      {"sa", [](const ImportSpec &tt_spec) {
+        return std::make_unique<SAFileReader>(tt_spec.sa_file, tt_spec.int_bytes);
+      }}
+  };
+  return formats;
+}
+
+namespace inner_import {
+
+template<typename TFactories>
+const auto &findFormat(const TFactories &t_formats, const std::string &t_name) {
+  auto it = t_formats.find(t_name);
+  if (it == t_formats.end()) {
+    throw std::invalid_argument("Error: unknown import format \"" + t_name + "\"");
+  }
+  return it->second;
+}
+
+//! Stream the runs of the BWT and its run samples into the base items of the cache, in a single pass: the alphabet, the
+//! RLBWT and the BWT-run items. The plain BWT is neither stored nor read back.
+//! \param t_name Name of the BWT in the error messages
+inline void storeBWTAndRuns(BWTRunReader &t_bwt_reader,
+                            RunSampleReader &t_sample_reader,
+                            const std::string &t_name,
+                            sdsl::cache_config &t_config) {
+  const auto n = t_bwt_reader.size();
+  if (n == 0) {
+    throw std::invalid_argument("Error: empty BWT \"" + t_name + "\"");
+  }
+  auto get_text_pos = [n](auto tt_sa_value) { return 0 < tt_sa_value ? tt_sa_value - 1 : n - 1; };
+
+  const std::size_t buffer_size = 1 << 20;
+  const std::size_t n_width = sdsl::bits::hi(n) + 1;
+  auto out_int_vector_buf = [buffer_size, n_width, &t_config](const auto &tt_key) {
+    return sdsl::int_vector_buffer<>(sdsl::cache_file_name(tt_key, t_config), std::ios::out, buffer_size, n_width);
+  };
+
+  auto bwt_run_first_pos = out_int_vector_buf(conf::KEY_BWT_RUN_FIRST);
+  auto bwt_run_first_text_pos = out_int_vector_buf(conf::KEY_BWT_RUN_FIRST_TEXT_POS);
+  auto bwt_run_last_pos = out_int_vector_buf(conf::KEY_BWT_RUN_LAST);
+  auto bwt_run_last_text_pos = out_int_vector_buf(conf::KEY_BWT_RUN_LAST_TEXT_POS);
+
+  // The maximal runs are kept to build the RLBWT on the compact alphabet, known once all of them are read
+  std::array<std::size_t, 256> counts{};
+  std::vector<uint8_t> run_symbols;
+  std::vector<uint64_t> run_lengths;
+
+  // Report a maximal run, merging the consecutive runs of the same symbol
+  uint64_t run_first = 0;
+  uint64_t run_length = 0;
+  uint8_t run_symbol = 0;
+  auto report_run = [&]() {
+    bwt_run_first_pos.push_back(run_first);
+    bwt_run_first_text_pos.push_back(get_text_pos(t_sample_reader.head(run_first)));
+    bwt_run_last_pos.push_back(run_first + run_length - 1);
+    bwt_run_last_text_pos.push_back(get_text_pos(t_sample_reader.tail(run_first + run_length - 1)));
+
+    counts[run_symbol] += run_length;
+    run_symbols.push_back(run_symbol);
+    run_lengths.push_back(run_length);
+  };
+
+  uint8_t symbol;
+  uint64_t length;
+  while (t_bwt_reader.next(symbol, length)) {
+    if (run_length && symbol == run_symbol) {
+      run_length += length;
+      continue;
+    }
+    if (run_length) report_run();
+    run_first += run_length;
+    run_symbol = symbol;
+    run_length = length;
+  }
+  report_run();
+
+  if (run_first + run_length != n) {
+    throw std::runtime_error("Error: BWT \"" + t_name + "\" changed while it was imported");
+  }
+
+  {
+    auto alphabet = constructByteAlphabet(counts);
+
+    sdsl::int_vector<> heads(run_symbols.size(), 0, 8);
+    for (std::size_t i = 0; i < run_symbols.size(); ++i) heads[i] = alphabet.char2comp[run_symbols[i]];
+    std::vector<uint8_t>().swap(run_symbols);
+    sdsl::int_vector<> lengths(run_lengths.size(), 0, n_width);
+    std::copy(run_lengths.begin(), run_lengths.end(), lengths.begin());
+    std::vector<uint64_t>().swap(run_lengths);
+
+    RLEString<> bwt_rle(heads, lengths);
+    sri::storeToCache(std::move(alphabet), conf::KEY_ALPHABET, t_config);
+    sri::storeToCache(std::move(bwt_rle), conf::KEY_BWT_RLE, t_config);
+  }
+
+  bwt_run_first_text_pos.close();
+  sri::registerCacheFile(conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+
+  bwt_run_last_pos.close();
+  sri::registerCacheFile(conf::KEY_BWT_RUN_LAST, t_config);
+
+  bwt_run_last_text_pos.close();
+  sri::registerCacheFile(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+
+  // The stage is checked by this item, so it is registered last
+  bwt_run_first_pos.close();
+  sri::registerCacheFile(conf::KEY_BWT_RUN_FIRST, t_config);
+}
+
+//! Stream the imported BWT and its run samples into the BWT and BWT-run items of the cache, in a single pass
+inline void importBWTAndRuns(const std::string &t_bwt_file, const ImportSpec &t_spec, sdsl::cache_config &t_config) {
+  auto bwt_reader = findFormat(bwtFormats(), t_spec.bwt_format)(t_bwt_file, t_spec);
+  auto sample_reader = findFormat(sampleFormats(), t_spec.samples_format)(t_spec);
+
+  storeBWTAndRuns(*bwt_reader, *sample_reader, t_bwt_file, t_config);
+}
+
+//! Construct the base items of the index from the imported BWT (Config::data_path) and SA samples (Config::import).
+//! The imported BWTs have byte alphabets.
+template<uint8_t t_width>
+void constructIndexBaseItems(Config &t_config) {
+  if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST, t_config)) {
+    std::cout << "Importing the BWT and its run samples" << std::endl;
+    sri::StageEvent event("Import");
+    importBWTAndRuns(t_config.data_path.string(), t_config.import, t_config);
+    std::cout << "Done!" << std::endl;
+  }
+}
+
+} // namespace inner_import
+} // namespace sri
+
+#endif //SRI_IMPORTERS_H_
@@ -5,7 +5,10 @@
 #ifndef SRI_INDEX_BASE_H_
 #define SRI_INDEX_BASE_H_
 
+#include <algorithm>
 #include <map>
+#include <numeric>
+#include <ostream>
 #include <string>
 #include <any>
 #include <functional>
@@ -14,6 +17,7 @@
 #include <sdsl/io.hpp>
 
 #include "config.h"
+#include "io.h"
 
 namespace sri {
 
@@ -22,6 +26,41 @@ class LocateIndex {
   virtual std::vector<std::size_t> Locate(const std::string &_pattern) const = 0;
 
   virtual std::pair<std::size_t, std::size_t> Count(const std::string &_pattern) const = 0;
+
+  //! Count for a batch of patterns
+  //! \return Range of each pattern
+  virtual std::vector<std::pair<std::size_t, std::size_t>> CountBatch(const std::vector<std::string> &t_patterns) const {
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    ranges.reserve(t_patterns.size());
+    for (const auto &pattern : t_patterns) {
+      ranges.emplace_back(Count(pattern));
+    }
+    return ranges;
+  }
+
+  //! Locate for a batch of patterns
+  //! \return Occurrences of each pattern
+  virtual std::vector<std::vector<std::size_t>> LocateBatch(const std::vector<std::string> &t_patterns) const {
+    std::vector<std::vector<std::size_t>> values;
+    values.reserve(t_patterns.size());
+    for (const auto &pattern : t_patterns) {
+      values.emplace_back(Locate(pattern));
+    }
+    return values;
+  }
+};
+
+//! Output stream that discards its content, used to measure the serialized size of the index components (breakdown)
+struct nullstream : std::ostream {
+  struct nullbuf : std::streambuf {
+    int overflow(int c) {
+      return traits_type::not_eof(c);
+    }
+    int xputc(int) { return 0; }
+    std::streamsize xsputn(char const *, std::streamsize n) { return n; }
+    int sync() { return 0; }
+  } m_sbuf;
+  nullstream() : std::ios(&m_sbuf), std::ostream(&m_sbuf), m_sbuf() {}
 };
 
 using GenericStorage = std::map<std::string, std::any>;
@@ -54,6 +93,14 @@ class IndexBaseWithExternalStorage : public LocateIndex {
     return index_->Count(t_pattern);
   }
 
+  std::vector<std::pair<std::size_t, std::size_t>> CountBatch(const std::vector<std::string> &t_patterns) const override {
+    return index_->CountBatch(t_patterns);
+  }
+
+  std::vector<std::vector<std::size_t>> LocateBatch(const std::vector<std::string> &t_patterns) const override {
+    return index_->LocateBatch(t_patterns);
+  }
+
   auto sizeSequence() const { return n_; }
 
   virtual void load(Config t_config) = 0;
@@ -79,6 +126,16 @@ protected:
     RUN_CUMULATIVE_COUNT,
     VALID_MARKS,
     VALID_AREAS,
+    THRESHOLDS,
+    RUN_BOUNDARY_SAMPLES,
+    DOC_STARTS,
+    ISA_SAMPLES,
+    KMER_TABLE,
+    DOC_SAMPLED_POS,
+    DOC_SAMPLES,
+    ILCP_RUN_HEADS,
+    ILCP_RUN_VALUES,
+    ILCP_RUN_RMQ,
     NUM_ITEMS
   };
 
@@ -114,7 +171,7 @@ protected:
 
   template<typename TItem>
   auto load(TItem &t_item, const sdsl::cache_config &t_config, const std::string &t_key, bool t_add_type_hash) {
-    if (!sdsl::load_from_cache(t_item, t_key, t_config, t_add_type_hash))
+    if (!sri::loadFromCache(t_item, t_key, t_config, t_add_type_hash))
       throw std::invalid_argument("File not found (Key: '" + t_key + "')");
   }
 
@@ -129,6 +186,19 @@ protected:
     return std::cref(*item);
   }
 
+  //! Load an item that may be missing from the cache, in which case it is default constructed
+  template<typename TItem>
+  auto loadOptionalItem(const std::string &t_key, TSource &t_source, bool t_add_type_hash = false) {
+    auto item = get<TItem>(storage_, t_key);
+    if (!item) {
+      auto *config = std::get_if<std::reference_wrapper<Config>>(&t_source);
+      if (config && !sri::cacheFileExists(t_key, config->get())) {
+        item = set(storage_, t_key, TItem());
+      }
+    }
+    return loadItem<TItem>(t_key, t_source, t_add_type_hash);
+  }
+
   template<typename TBv, typename TBvRank = typename TBv::rank_1_type>
   auto loadBVRank(const std::string &t_key, TSource &t_source, bool t_add_type_hash = false) {
     auto key_rank = t_key + "_rank";
@@ -191,6 +261,15 @@ protected:
     return serializeItem<TItemSelect>(t_key + "_select", out, v, name);
   }
 
+  //! Store the item, if it is loaded, in the cache
+  template<typename TItem>
+  void storeItem(const std::string &t_key, Config &t_config, bool t_add_type_hash = false) const {
+    auto item = get<TItem>(storage_, t_key);
+    if (item) {
+      sri::storeToCache(*item, t_key, t_config, t_add_type_hash);
+    }
+  }
+
   //********************
   //********************
   //********************
@@ -202,7 +281,20 @@ protected:
   std::shared_ptr<LocateIndex> index_ = nullptr;
 };
 
-template<typename TBackwardNav, typename TUpdateToeholdData, typename TComputeAllValues, typename TGetInitialToeholdData, typename TGetSymbol, typename TCreateFullRange, typename TIsRangeEmpty>
+//! Seed for the backward search that skips no step
+struct NoSeedBackwardSearch {
+  template<typename... TArgs>
+  std::size_t operator()(const TArgs &...) const { return 0; }
+
+  template<typename... TArgs>
+  void record(const TArgs &...) const {}
+};
+
+//! Backward search (count and locate) for r-index-like structures
+//! \tparam TSeedBackwardSearch Function that may jump over the first backward-search steps, i.e., given the pattern,
+//!     it sets the range (and toehold data) after processing its last k symbols and returns k (0 if it cannot jump).
+//!     Its method record receives the state after each backward-search step.
+template<typename TBackwardNav, typename TUpdateToeholdData, typename TComputeAllValues, typename TGetInitialToeholdData, typename TGetSymbol, typename TCreateFullRange, typename TIsRangeEmpty, typename TSeedBackwardSearch = NoSeedBackwardSearch>
 class RIndexBase : public LocateIndex {
  public:
   RIndexBase(const TBackwardNav &t_lf,
@@ -212,7 +304,8 @@ class RIndexBase : public LocateIndex {
              const TGetInitialToeholdData &t_get_initial_toehold_data,
              const TGetSymbol &t_get_symbol,
              const TCreateFullRange &t_create_full_range,
-             const TIsRangeEmpty &t_is_range_empty)
+             const TIsRangeEmpty &t_is_range_empty,
+             const TSeedBackwardSearch &t_seed_backward_search = TSeedBackwardSearch())
       : lf_{t_lf},
         update_toehold_data_{t_update_toehold_data},
         compute_all_values_{t_compute_all_values},
@@ -220,7 +313,8 @@ class RIndexBase : public LocateIndex {
         get_initial_toehold_data_{t_get_initial_toehold_data},
         get_symbol_{t_get_symbol},
         create_full_range_{t_create_full_range},
-        is_range_empty_{t_is_range_empty} {
+        is_range_empty_{t_is_range_empty},
+        seed_backward_search_{t_seed_backward_search} {
   }
 
   std::vector<std::size_t> Locate(const std::string &t_pattern) const override {
@@ -240,13 +334,17 @@ class RIndexBase : public LocateIndex {
     //TODO use default value (step == 0) instead of get_initial_toehold_data_
     auto toehold_data = get_initial_toehold_data_(i);
 
-    for (auto it = rbegin(t_pattern); it != rend(t_pattern) && !is_range_empty_(range); ++it, --i) {
+    auto k = seed_backward_search_(t_pattern, range, toehold_data);
+    i -= k;
+
+    for (auto it = std::next(rbegin(t_pattern), k); it != rend(t_pattern) && !is_range_empty_(range); ++it, --i) {
       auto c = get_symbol_(*it);
 
       auto next_range = lf_(range, c);
       update_toehold_data_(range, next_range, c, i, toehold_data);
 
       range = next_range;
+      seed_backward_search_.record(t_pattern, ++k, range, toehold_data);
     }
 
     if (!is_range_empty_(range)) {
@@ -270,16 +368,134 @@ class RIndexBase : public LocateIndex {
   void Count(const TPattern &t_pattern, TReport &t_report) const {
     auto range = create_full_range_(bwt_size_);
 
-    for (auto it = rbegin(t_pattern); it != rend(t_pattern) && !is_range_empty_(range); ++it) {
+    auto k = seed_backward_search_(t_pattern, range);
+
+    for (auto it = std::next(rbegin(t_pattern), k); it != rend(t_pattern) && !is_range_empty_(range); ++it) {
       auto c = get_symbol_(*it);
       range = lf_(range, c);
+      seed_backward_search_.record(t_pattern, ++k, range);
     }
 
     t_report(range);
   }
 
+  std::vector<std::pair<std::size_t, std::size_t>> CountBatch(const std::vector<std::string> &t_patterns) const override {
+    std::vector<std::pair<std::size_t, std::size_t>> ranges(t_patterns.size());
+    auto report = [&ranges](auto tt_i, const auto &tt_range) {
+      const auto &[start, end] = tt_range;
+      ranges[tt_i] = {start, end};
+    };
+
+    CountBatch(t_patterns, report);
+
+    return ranges;
+  }
+
+  //! Count for a batch of patterns, doing each distinct LF step once (see BatchBackwardSearch)
+  //! \param t_report Report the final range of the i-th pattern: t_report(i, range)
+  template<typename TPatterns, typename TReport>
+  void CountBatch(const TPatterns &t_patterns, TReport &t_report) const {
+    BatchBackwardSearch<false>(t_patterns, t_report);
+  }
+
+  std::vector<std::vector<std::size_t>> LocateBatch(const std::vector<std::string> &t_patterns) const override {
+    std::vector<std::vector<std::size_t>> values(t_patterns.size());
+    auto report = [&values](auto tt_i, const auto &tt_value) { values[tt_i].emplace_back(tt_value); };
+
+    LocateBatch(t_patterns, report);
+
+    return values;
+  }
+
+  //! Locate for a batch of patterns, doing each distinct LF step once (see BatchBackwardSearch)
+  //! \param t_report Report an occurrence of the i-th pattern: t_report(i, value)
+  template<typename TPatterns, typename TReport>
+  void LocateBatch(const TPatterns &t_patterns, TReport &t_report) const {
+    BatchBackwardSearch<true>(t_patterns, t_report);
+  }
+
  private:
 
+  //! Backward search for a batch of patterns as a depth-first traversal of the trie of the reversed patterns.
+  //! The patterns are sorted by their reversed sequence, so the patterns sharing a suffix are contiguous and the trie
+  //! is visited in order keeping only the states on the path to the current pattern. A pattern only performs the LF
+  //! steps beyond the longest suffix it shares with the previous one, so each trie edge costs one LF step.
+  //! The toehold data is computed with a virtual step (the one of the longest pattern), which is shifted to the actual
+  //! step of each pattern before computing its values.
+  template<bool t_locate, typename TPatterns, typename TReport>
+  void BatchBackwardSearch(const TPatterns &t_patterns, TReport &t_report) const {
+    if (t_patterns.empty()) return;
+
+    std::vector<std::size_t> order(t_patterns.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&t_patterns](auto tt_a, auto tt_b) {
+      const auto &a = t_patterns[tt_a];
+      const auto &b = t_patterns[tt_b];
+      return std::lexicographical_compare(rbegin(a), rend(a), rbegin(b), rend(b));
+    });
+
+    std::size_t max_len = 0;
+    for (const auto &pattern : t_patterns) max_len = std::max<std::size_t>(max_len, pattern.size());
+    const std::size_t top_step = max_len ? max_len - 1 : 0; // Virtual step of the last symbol
+
+    // States (range and toehold data) after processing d symbols of the current pattern, for d in [0..m]
+    std::vector<decltype(create_full_range_(bwt_size_))> ranges = {create_full_range_(bwt_size_)};
+    std::vector<decltype(get_initial_toehold_data_(top_step))> toeholds;
+    if constexpr (t_locate) toeholds.emplace_back(get_initial_toehold_data_(top_step));
+
+    const typename TPatterns::value_type *prev = nullptr;
+    for (const auto &i_pattern : order) {
+      const auto &pattern = t_patterns[i_pattern];
+      const std::size_t m = pattern.size();
+
+      // Longest suffix shared with the previous pattern
+      std::size_t lcs = 0;
+      if (prev) {
+        auto mismatch = std::mismatch(rbegin(*prev), rend(*prev), rbegin(pattern), rend(pattern));
+        lcs = std::distance(rbegin(pattern), mismatch.second);
+      }
+      ranges.erase(ranges.begin() + lcs + 1, ranges.end());
+      if constexpr (t_locate) toeholds.erase(toeholds.begin() + lcs + 1, toeholds.end());
+
+      for (std::size_t d = lcs; d < m; ++d) {
+        auto range = ranges[d];
+        if (is_range_empty_(range)) {
+          // The search stopped at this range
+          ranges.emplace_back(range);
+          if constexpr (t_locate) toeholds.emplace_back(toeholds[d]);
+          continue;
+        }
+
+        auto c = get_symbol_(*std::next(rbegin(pattern), d));
+        auto next_range = lf_(range, c);
+        if constexpr (t_locate) {
+          auto toehold_data = toeholds[d];
+          update_toehold_data_(range, next_range, c, top_step - d, toehold_data);
+          toeholds.emplace_back(toehold_data);
+        }
+
+        range = next_range;
+        ranges.emplace_back(range);
+      }
+
+      if constexpr (t_locate) {
+        if (m == 0) {
+          auto report = [&t_report, i_pattern](const auto &tt_value) { t_report(i_pattern, tt_value); };
+          Locate(pattern, report);
+        } else if (!is_range_empty_(ranges[m])) {
+          auto toehold_data = toeholds[m];
+          toehold_data.step -= top_step - (m - 1);
+          auto report = [&t_report, i_pattern](const auto &tt_value) { t_report(i_pattern, tt_value); };
+          compute_all_values_(ranges[m], toehold_data, report);
+        }
+      } else {
+        t_report(i_pattern, ranges[m]);
+      }
+
+      prev = &pattern;
+    }
+  }
+
   TBackwardNav lf_;
   TUpdateToeholdData update_toehold_data_;
   TComputeAllValues compute_all_values_;
@@ -291,6 +507,8 @@ class RIndexBase : public LocateIndex {
 
   TCreateFullRange create_full_range_;
   TIsRangeEmpty is_range_empty_;
+
+  TSeedBackwardSearch seed_backward_search_;
 };
 
 template<typename TBackwardNav, typename TGetLastValue, typename TComputeAllValues, typename TGetFinalValue, typename TGetSymbol>
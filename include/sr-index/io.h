@@ -5,14 +5,21 @@
 #ifndef SRI_IO_H_
 #define SRI_IO_H_
 
+#include <filesystem>
+#include <memory>
 #include <utility>
 #include <iostream>
 #include <string>
+#include <type_traits>
 
 #include <sdsl/io.hpp>
 #include <sdsl/config.hpp>
 #include <sdsl/util.hpp>
 
+#include "artifact_store.h"
+#include "build_report.h"
+#include "work_dir.h"
+
 namespace std {
 
 template<typename X, typename Y>
@@ -35,23 +42,112 @@ void load(std::pair<X, Y> &x, std::istream &in) {
 namespace sri {
 
 //! Stores the object v as a resource in the cache.
-template<class T>
-bool store_to_cache(const T &v, const std::string &key, sdsl::cache_config &config, bool add_type_hash = false) {
+//! With an artifact store open for the cache directory, an rvalue object is moved into memory (see ArtifactStore), so
+//! the callers move the items they no longer need. Otherwise, the file is written atomically (temporary file and
+//! rename), and recorded as complete in its work directory, if any.
+template<class TRef>
+bool storeToCache(TRef &&v, const std::string &key, sdsl::cache_config &config, bool add_type_hash = false) {
+  using T = std::decay_t<TRef>;
   std::string file;
   if (add_type_hash) {
     file = sdsl::cache_file_name<T>(key, config);
   } else {
     file = sdsl::cache_file_name(key, config);
   }
-  if (sdsl::store_to_file(v, file)) {
+  if constexpr (!std::is_lvalue_reference_v<TRef>) {
+    if (auto store = findArtifactStore(file)) {
+      const auto size = serializedSize(v);
+      if (store->put(file, key, std::move(v), size)) {
+        config.file_map[key + (add_type_hash ? "_" + sdsl::util::class_to_hash(T()) : "")] = file;
+        BuildReport::instance().addOutput(size);
+        return true;
+      }
+    }
+  }
+
+  const std::string tmp_file = file + ".tmp";
+  if (sdsl::store_to_file(v, tmp_file)) {
+    std::filesystem::rename(tmp_file, file);
     config.file_map[key + (add_type_hash ? "_" + sdsl::util::class_to_hash(T()) : "")] = file;
+    recordCachedFile(file, key);
+    BuildReport::instance().addOutput(std::filesystem::file_size(file));
     return true;
   } else {
-    std::cerr << "WARNING: store_to_cache: could not store file `" << file << "`" << std::endl;
+    std::cerr << "WARNING: storeToCache: could not store file `" << file << "`" << std::endl;
     return false;
   }
 }
 
+//! Whether the resource is in the cache.
+//! In a work directory, only the files recorded as complete in its manifest count (see StageManifest).
+inline bool cacheFileExists(const std::string &key, const sdsl::cache_config &config) {
+  const auto file = sdsl::cache_file_name(key, config);
+  auto store = findArtifactStore(file);
+  return (store && store->contains(file)) || isCachedFileComplete(file);
+}
+
+template<class T>
+bool cacheFileExists(const std::string &key, const sdsl::cache_config &config) {
+  const auto file = sdsl::cache_file_name<T>(key, config);
+  auto store = findArtifactStore(file);
+  return (store && store->contains(file)) || isCachedFileComplete(file);
+}
+
+//! Loads the resource from the cache, from memory if it is in an artifact store.
+template<class T>
+bool loadFromCache(T &v, const std::string &key, const sdsl::cache_config &config, bool add_type_hash = false) {
+  const auto file = add_type_hash ? sdsl::cache_file_name<T>(key, config) : sdsl::cache_file_name(key, config);
+  if (auto store = findArtifactStore(file); store && store->get(file, v)) return true;
+  return sdsl::load_from_cache(v, key, config, add_type_hash);
+}
+
+//! Loads the resource from the cache, sharing it (without a copy) if it is in an artifact store.
+template<class T>
+std::shared_ptr<const T> sharedFromCache(const std::string &key,
+                                           const sdsl::cache_config &config,
+                                           bool add_type_hash = false) {
+  const auto file = add_type_hash ? sdsl::cache_file_name<T>(key, config) : sdsl::cache_file_name(key, config);
+  if (auto store = findArtifactStore(file)) {
+    if (auto item = store->template share<T>(file)) return item;
+  }
+
+  auto item = std::make_shared<T>();
+  sdsl::load_from_cache(*item, key, config, add_type_hash);
+  return item;
+}
+
+//! Whether the resource is kept in memory by an artifact store
+inline bool cacheFileInMemory(const std::string &key, const sdsl::cache_config &config) {
+  const auto file = sdsl::cache_file_name(key, config);
+  auto store = findArtifactStore(file);
+  return store && store->contains(file);
+}
+
+//! File name of the resource in the cache, for the stages that access the file directly (e.g., with an
+//! int_vector_buffer). If the resource is in an artifact store, it is written to the file first.
+inline std::string cacheFileName(const std::string &key, const sdsl::cache_config &config) {
+  auto file = sdsl::cache_file_name(key, config);
+  if (auto store = findArtifactStore(file)) store->spill(file);
+  return file;
+}
+
+template<class T>
+std::string cacheFileName(const std::string &key, const sdsl::cache_config &config) {
+  auto file = sdsl::cache_file_name<T>(key, config);
+  if (auto store = findArtifactStore(file)) store->spill(file);
+  return file;
+}
+
+//! Register a resource written to the cache, and record it as complete in its work directory, if any.
+//! It must be called once the file is completely written.
+inline void registerCacheFile(const std::string &key, sdsl::cache_config &config) {
+  sdsl::register_cache_file(key, config);
+  const auto file = sdsl::cache_file_name(key, config);
+  recordCachedFile(file, key);
+  std::error_code ec;
+  BuildReport::instance().addOutput(std::filesystem::file_size(file, ec));
+}
+
 }
 
 #endif //SRI_IO_H_
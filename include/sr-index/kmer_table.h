@@ -0,0 +1,276 @@
+//
+// Table of the backward-search state (range and toehold data) for the k-mers of the text.
+//
+
+#ifndef SRI_KMER_TABLE_H_
+#define SRI_KMER_TABLE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sdsl/config.hpp>
+#include <sdsl/int_vector.hpp>
+#include <sdsl/io.hpp>
+
+#include "alphabet.h"
+#include "config.h"
+#include "io.h"
+#include "rle_string.hpp"
+
+namespace sri {
+
+namespace conf {
+//! Backward-search state for the k-mers of the text
+const std::string KEY_KMER_TABLE = "kmer_table";
+}
+
+//! Table mapping k-mers to their backward-search state, i.e., the suffix array range and the data of the last
+//! non-trivial LF step (toehold data), so the backward search of a pattern can start at step k.
+//! The k-mers are encoded in base sigma (compact alphabet), with the first symbol as the most significant digit.
+class KmerTable {
+ public:
+  //! Data of the last non-trivial LF step in the backward search of a k-mer
+  struct Toehold {
+    std::size_t offset; // Number of symbols processed before this step (from the k-mer end)
+    std::size_t c; // Symbol of the step
+    std::size_t run_rank; // Rank of the run of c at the range end
+    std::size_t value; // Range end after the step
+  };
+
+  KmerTable() = default;
+
+  KmerTable(std::size_t t_k, std::size_t t_sigma, std::size_t t_n, std::size_t t_size)
+      : k_{t_k}, sigma_{t_sigma},
+        codes_(t_size, 0, sdsl::bits::hi(std::max<std::size_t>(maxCode(t_k, t_sigma), 1)) + 1),
+        starts_(t_size, 0, sdsl::bits::hi(t_n) + 1),
+        ends_(t_size, 0, sdsl::bits::hi(t_n) + 1),
+        offsets_(t_size, 0, sdsl::bits::hi(std::max<std::size_t>(t_k, 1)) + 1),
+        symbols_(t_size, 0, sdsl::bits::hi(std::max<std::size_t>(t_sigma, 1)) + 1),
+        run_ranks_(t_size, 0, sdsl::bits::hi(t_n) + 1),
+        values_(t_size, 0, sdsl::bits::hi(t_n) + 1) {}
+
+  std::size_t K() const { return k_; }
+
+  std::size_t sigma() const { return sigma_; }
+
+  //! Number of k-mers in the table
+  std::size_t size() const { return codes_.size(); }
+
+  //! Largest code of a k-mer, i.e., sigma^k - 1
+  static std::size_t maxCode(std::size_t t_k, std::size_t t_sigma) {
+    std::size_t max_code = 1;
+    for (std::size_t i = 0; i < t_k; ++i) {
+      if (max_code > std::numeric_limits<std::size_t>::max() / t_sigma) {
+        throw std::invalid_argument("Error: k-mers of length " + std::to_string(t_k) + " do not fit in a machine word");
+      }
+      max_code *= t_sigma;
+    }
+    return max_code - 1;
+  }
+
+  //! Index of the k-mer with the given code, or size() if it is not in the table
+  std::size_t find(std::size_t t_code) const {
+    auto it = std::lower_bound(codes_.begin(), codes_.end(), t_code);
+    return (it != codes_.end() && *it == t_code) ? std::distance(codes_.begin(), it) : size();
+  }
+
+  //! Suffix array range [start, end) of the i-th k-mer
+  auto range(std::size_t t_i) const { return std::make_pair(std::size_t(starts_[t_i]), std::size_t(ends_[t_i])); }
+
+  Toehold toehold(std::size_t t_i) const { return {offsets_[t_i], symbols_[t_i], run_ranks_[t_i], values_[t_i]}; }
+
+  void set(std::size_t t_i, std::size_t t_code, std::size_t t_start, std::size_t t_end, const Toehold &t_toehold) {
+    codes_[t_i] = t_code;
+    starts_[t_i] = t_start;
+    ends_[t_i] = t_end;
+    offsets_[t_i] = t_toehold.offset;
+    symbols_[t_i] = t_toehold.c;
+    run_ranks_[t_i] = t_toehold.run_rank;
+    values_[t_i] = t_toehold.value;
+  }
+
+  typedef std::size_t size_type;
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, const std::string &name = "") const {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(k_, out, child, "k");
+    written_bytes += sdsl::write_member(sigma_, out, child, "sigma");
+    written_bytes += codes_.serialize(out, child, "codes");
+    written_bytes += starts_.serialize(out, child, "starts");
+    written_bytes += ends_.serialize(out, child, "ends");
+    written_bytes += offsets_.serialize(out, child, "offsets");
+    written_bytes += symbols_.serialize(out, child, "symbols");
+    written_bytes += run_ranks_.serialize(out, child, "run_ranks");
+    written_bytes += values_.serialize(out, child, "values");
+    sdsl::structure_tree::add_size(child, written_bytes);
+    return written_bytes;
+  }
+
+  void load(std::istream &in) {
+    sdsl::read_member(k_, in);
+    sdsl::read_member(sigma_, in);
+    codes_.load(in);
+    starts_.load(in);
+    ends_.load(in);
+    offsets_.load(in);
+    symbols_.load(in);
+    run_ranks_.load(in);
+    values_.load(in);
+  }
+
+ private:
+  std::size_t k_ = 0;
+  std::size_t sigma_ = 0;
+
+  sdsl::int_vector<> codes_;
+  sdsl::int_vector<> starts_;
+  sdsl::int_vector<> ends_;
+  sdsl::int_vector<> offsets_;
+  sdsl::int_vector<> symbols_;
+  sdsl::int_vector<> run_ranks_;
+  sdsl::int_vector<> values_;
+};
+
+//! Seed for the backward search that jumps to step k when the last k symbols of the pattern are in the k-mer table
+//! \tparam TGetSymbol Function to map a pattern symbol to the compact alphabet
+//! \tparam TCreateToeholdData Function to create the toehold data from the table data and the pattern step
+template<typename TGetSymbol, typename TCreateToeholdData>
+class SeedBackwardSearchWithKmerTable {
+ public:
+  SeedBackwardSearchWithKmerTable(const std::reference_wrapper<const KmerTable> &t_table,
+                                  const TGetSymbol &t_get_symbol,
+                                  const TCreateToeholdData &t_create_toehold_data)
+      : table_{t_table}, get_symbol_{t_get_symbol}, create_toehold_data_{t_create_toehold_data} {}
+
+  //! Seed for count
+  //! \return Number of skipped steps
+  template<typename TPattern, typename TRange>
+  std::size_t operator()(const TPattern &t_pattern, TRange &t_range) const {
+    auto i = find(t_pattern);
+    if (i == table_.get().size()) return 0;
+
+    const auto &[start, end] = table_.get().range(i);
+    t_range = TRange{start, end};
+    return table_.get().K();
+  }
+
+  //! Seed for locate
+  //! \return Number of skipped steps
+  template<typename TPattern, typename TRange, typename TToeholdData>
+  std::size_t operator()(const TPattern &t_pattern, TRange &t_range, TToeholdData &t_toehold_data) const {
+    auto i = find(t_pattern);
+    if (i == table_.get().size()) return 0;
+
+    const auto &[start, end] = table_.get().range(i);
+    t_range = TRange{start, end};
+    auto toehold = table_.get().toehold(i);
+    t_toehold_data = create_toehold_data_(toehold, t_pattern.size() - 1 - toehold.offset);
+    return table_.get().K();
+  }
+
+ private:
+
+  //! Index in the table of the last k symbols of the pattern
+  template<typename TPattern>
+  std::size_t find(const TPattern &t_pattern) const {
+    const auto &table = table_.get();
+    auto k = table.K();
+    if (k == 0 || t_pattern.size() < k) return table.size();
+
+    std::size_t code = 0;
+    for (auto it = std::prev(std::end(t_pattern), k); it != std::end(t_pattern); ++it) {
+      code = code * table.sigma() + get_symbol_(*it);
+    }
+    return table.find(code);
+  }
+
+  std::reference_wrapper<const KmerTable> table_;
+  TGetSymbol get_symbol_;
+  TCreateToeholdData create_toehold_data_;
+};
+
+//! Construct the k-mer table (Config::kmer_k) visiting the k-mers of the text in depth-first order with LF steps.
+//! If the table exceeds the budget (Config::kmer_budget, in bytes), it only keeps the most frequent k-mers.
+template<uint8_t t_width>
+void constructKmerTable(Config &t_config) {
+  static_assert(t_width == 0 or t_width == 8,
+                "constructKmerTable: width must be `0` for integer alphabet and `8` for byte alphabet");
+
+  typename alphabet_trait<t_width>::type alphabet;
+  sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
+  RLEString<> bwt_rle;
+  sri::loadFromCache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+  const std::size_t n = bwt_rle.size();
+  const std::size_t k = t_config.kmer_k;
+  const std::size_t sigma = alphabet.sigma;
+
+  struct Node {
+    std::size_t depth;
+    std::size_t code;
+    std::size_t start;
+    std::size_t end;
+    KmerTable::Toehold toehold;
+  };
+
+  // Depth-first traversal of the reversed k-mers, replicating the LF steps (and toehold updates) of the backward search
+  std::vector<Node> kmers;
+  std::vector<Node> stack = {Node{0, 0, 0, n, {}}};
+  std::vector<std::size_t> weights = {1};
+  while (weights.size() < k) weights.emplace_back(weights.back() * sigma);
+  while (!stack.empty()) {
+    auto node = stack.back();
+    stack.pop_back();
+    if (node.depth == k) {
+      kmers.emplace_back(node);
+      continue;
+    }
+
+    // The symbol 0 is the text terminator, which never occurs in a pattern
+    for (std::size_t c = 1; c < sigma; ++c) {
+      std::size_t start;
+      bwt_rle.rank(node.start, c, [&start, &alphabet, c](auto tt_rnk, auto, auto) { start = alphabet.C[c] + tt_rnk; });
+      std::size_t end, run_rank;
+      bool is_cover;
+      bwt_rle.rank(node.end - 1, c, [&](auto tt_rnk, auto tt_run_rnk, auto tt_is_cover) {
+        end = alphabet.C[c] + tt_rnk - !tt_is_cover + 1;
+        run_rank = tt_run_rnk;
+        is_cover = tt_is_cover;
+      });
+      if (!(start < end)) continue;
+
+      auto toehold = (node.depth == 0 || !is_cover) ? KmerTable::Toehold{node.depth, c, run_rank, end} : node.toehold;
+      stack.emplace_back(Node{node.depth + 1, node.code + c * weights[node.depth], start, end, toehold});
+    }
+  }
+
+  if (t_config.kmer_budget) {
+    // Keep the most frequent k-mers within the budget
+    const std::size_t bits_per_kmer = sdsl::bits::hi(std::max<std::size_t>(KmerTable::maxCode(k, sigma), 1)) + 1
+        + 4 * (sdsl::bits::hi(n) + 1) + sdsl::bits::hi(std::max<std::size_t>(k, 1)) + 1 + sdsl::bits::hi(sigma) + 1;
+    const std::size_t max_kmers = t_config.kmer_budget * 8 / bits_per_kmer;
+    if (kmers.size() > max_kmers) {
+      std::nth_element(kmers.begin(), kmers.begin() + max_kmers, kmers.end(), [](const auto &tt_a, const auto &tt_b) {
+        return tt_a.end - tt_a.start > tt_b.end - tt_b.start;
+      });
+      kmers.resize(max_kmers);
+    }
+  }
+  std::sort(kmers.begin(), kmers.end(), [](const auto &tt_a, const auto &tt_b) { return tt_a.code < tt_b.code; });
+
+  KmerTable table(k, sigma, n, kmers.size());
+  for (std::size_t i = 0; i < kmers.size(); ++i) {
+    table.set(i, kmers[i].code, kmers[i].start, kmers[i].end, kmers[i].toehold);
+  }
+
+  sri::storeToCache(std::move(table), conf::KEY_KMER_TABLE, t_config);
+}
+
+}
+
+#endif //SRI_KMER_TABLE_H_
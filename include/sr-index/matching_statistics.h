@@ -0,0 +1,351 @@
+//
+// Matching statistics over the r-index using BWT-run thresholds.
+//
+
+#ifndef SRI_MATCHING_STATISTICS_H_
+#define SRI_MATCHING_STATISTICS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+#include <sdsl/config.hpp>
+#include <sdsl/construct_lcp.hpp>
+#include <sdsl/int_vector.hpp>
+#include <sdsl/int_vector_buffer.hpp>
+#include <sdsl/rmq_support.hpp>
+
+#include "index_base.h"
+#include "alphabet.h"
+#include "rle_string.hpp"
+#include "construct_base.h"
+#include "r_index.h"
+#include "extract.h"
+
+namespace sri {
+
+namespace conf {
+//! BWT position of the minimum LCP value between a run head and the tail of the previous run with the same symbol
+const std::string KEY_BWT_RUN_FIRST_THRESHOLD = KEY_BWT_RUN_FIRST + "_threshold";
+//! Text positions of the BWT run heads and tails interleaved, i.e., SA[head_k] - 1 at 2k and SA[tail_k] - 1 at 2k + 1
+const std::string KEY_BWT_RUN_BOUNDARY_TEXT_POS = "bwt_run_boundary_text_pos";
+}
+
+//! Index extension for matching statistics.
+//! For each position i in pattern P, it computes the length of the longest prefix of P[i..m) that occurs in the text
+//! and a text position where such prefix occurs.
+//! The positions are computed from right to left with the BWT-run thresholds, and the lengths from left to right by
+//! comparing P with the text at these positions, which is extracted with the inverse suffix array sampled every
+//! @p isa_rate_ text positions. As the length at i + 1 is at least the length at i minus 1, and it is exactly that after
+//! an LF step, the text is only extracted after the jumps to run boundaries, taking O(m + jumps * isa_rate) LF steps.
+//! \tparam TIndex Base index (RIndex, SrIndex or any of its variants)
+template<typename TIndex,
+    typename TAlphabet = Alphabet<>,
+    typename TBwtRLE = RLEString<>,
+    typename TThresholds = sdsl::int_vector<>,
+    typename TRunSamples = sdsl::int_vector<>,
+    typename TISASamples = sdsl::int_vector<>>
+class IndexMS : public TIndex {
+ public:
+  using Base = TIndex;
+  using Base::Base;
+
+  IndexMS(std::size_t t_sr, std::size_t t_isa_rate) : Base(t_sr), isa_rate_{t_isa_rate} {}
+
+  IndexMS() = default;
+
+  std::size_t ISARate() const { return isa_rate_; }
+
+  //! Compute the matching statistics of the given pattern
+  //! \param t_pattern Pattern P
+  //! \param t_report Report (i, length, text position) for each position i of P, from left to right.
+  //! The text position is meaningless when the length is 0
+  template<typename TReport>
+  void MS(const std::string &t_pattern, TReport t_report) const {
+    if (t_pattern.empty()) return;
+
+    const auto &bwt = *bwt_rle_;
+    const auto &alphabet = *alphabet_;
+    const auto &thresholds = *thresholds_;
+    const auto &samples = *run_samples_;
+    const auto n = this->n_;
+    const auto r = thresholds.size();
+    const auto m = t_pattern.size();
+
+    // Positions, and the kind of step that computed them
+    enum class Step : uint8_t { kMissing, kLF, kJump };
+    std::vector<std::size_t> positions(m);
+    std::vector<Step> steps(m);
+
+    // Start at the last BWT position, which is the tail of the last run
+    std::size_t q = n - 1;
+    std::size_t pos = (samples[2 * (r - 1) + 1] + 1) % n;
+
+    for (auto i = m; i-- > 0;) {
+      auto c = alphabet.char2comp[(uint8_t) t_pattern[i]];
+
+      if (c == 0 || alphabet.C[c + 1] == alphabet.C[c]) {
+        // Symbol does not occur in the text
+        positions[i] = pos;
+        steps[i] = Step::kMissing;
+        continue;
+      }
+
+      if (bwt[q] == c) {
+        q = alphabet.C[c] + bwt.rank(q, c);
+        positions[i] = --pos;
+        steps[i] = Step::kLF;
+        continue;
+      }
+
+      std::size_t rnk = 0; // Number of symbols c before q
+      std::size_t symbol_run_rnk = 0; // Number of runs of symbol c before q
+      bwt.rank(q, c, [&rnk, &symbol_run_rnk](auto tt_rnk, auto tt_symbol_run_rnk, auto) {
+        rnk = tt_rnk;
+        symbol_run_rnk = tt_symbol_run_rnk;
+      });
+
+      // Choose the run boundary (tail of the previous c-run or head of the next one) that maximizes the LCE with q
+      bool go_up;
+      if (rnk == alphabet.C[c + 1] - alphabet.C[c]) {
+        go_up = true;
+      } else if (symbol_run_rnk == 0) {
+        go_up = false;
+      } else {
+        go_up = q < thresholds[bwt.selectOnRuns(symbol_run_rnk + 1, c)];
+      }
+
+      if (go_up) {
+        pos = samples[2 * bwt.selectOnRuns(symbol_run_rnk, c) + 1];
+        q = alphabet.C[c] + rnk - 1;
+      } else {
+        pos = samples[2 * bwt.selectOnRuns(symbol_run_rnk + 1, c)];
+        q = alphabet.C[c] + rnk;
+      }
+      positions[i] = pos;
+      steps[i] = Step::kJump;
+    }
+
+    std::size_t len = 0;
+    for (std::size_t i = 0; i < m; ++i) {
+      if (steps[i] == Step::kMissing) {
+        len = 0;
+      } else if (i > 0 && steps[i - 1] == Step::kLF) {
+        // P[i - 1..] matched at positions[i] - 1
+        --len;
+      } else {
+        len = extendMatch(t_pattern, i, positions[i], len ? len - 1 : 0);
+      }
+
+      t_report(i, len, positions[i]);
+    }
+  }
+
+  //! Compute the matching statistics lengths of the given pattern
+  //! \param t_pattern Pattern P
+  //! \return Lengths of the longest prefix of P[i..m) occurring in the text, for each position i
+  std::vector<std::size_t> MS(const std::string &t_pattern) const {
+    std::vector<std::size_t> lengths(t_pattern.size());
+    MS(t_pattern, [&lengths](auto tt_i, auto tt_len, auto) { lengths[tt_i] = tt_len; });
+    return lengths;
+  }
+
+  void load(std::istream &in) override {
+    sdsl::read_member(isa_rate_, in);
+    Base::load(in);
+  }
+
+  using Base::load;
+
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+    size_t written_bytes;
+    written_bytes = this->template serializeItem<TThresholds>(key(ItemKey::THRESHOLDS), nulls, child, "thresholds");
+    parts.emplace_back("thresholds", written_bytes);
+    written_bytes = this->template serializeItem<TRunSamples>(key(ItemKey::RUN_BOUNDARY_SAMPLES), nulls, child, "run_boundary_samples");
+    parts.emplace_back("run_boundary_samples", written_bytes);
+    written_bytes = this->template serializeItem<TISASamples>(key(ItemKey::ISA_SAMPLES), nulls, child, "isa_samples");
+    parts.emplace_back("isa_samples", written_bytes);
+    return parts;
+  }
+
+  using typename Base::size_type;
+  using typename Base::ItemKey;
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v, const std::string &name) const override {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(isa_rate_, out, child, "isa_rate");
+
+    written_bytes += Base::serialize(out, v, name);
+
+    written_bytes += this->template serializeItem<TThresholds>(key(ItemKey::THRESHOLDS), out, child, "thresholds");
+    written_bytes += this->template serializeItem<TRunSamples>(
+        key(ItemKey::RUN_BOUNDARY_SAMPLES), out, child, "run_boundary_samples");
+    written_bytes += this->template serializeItem<TISASamples>(key(ItemKey::ISA_SAMPLES), out, child, "isa_samples");
+
+    return written_bytes;
+  }
+
+ protected:
+
+  using Base::key;
+  void setupKeyNames() override {
+    Base::setupKeyNames();
+    key(ItemKey::THRESHOLDS) = conf::KEY_BWT_RUN_FIRST_THRESHOLD;
+    key(ItemKey::RUN_BOUNDARY_SAMPLES) = conf::KEY_BWT_RUN_BOUNDARY_TEXT_POS;
+    key(ItemKey::ISA_SAMPLES) = std::to_string(isa_rate_) + "_" + conf::KEY_ISA_SAMPLES;
+  }
+
+  using typename Base::TSource;
+
+  void loadAllItems(TSource &t_source) override {
+    Base::loadAllItems(t_source);
+
+    this->template loadItem<TThresholds>(key(ItemKey::THRESHOLDS), t_source);
+    this->template loadItem<TRunSamples>(key(ItemKey::RUN_BOUNDARY_SAMPLES), t_source);
+    this->template loadItem<TISASamples>(key(ItemKey::ISA_SAMPLES), t_source);
+  }
+
+  void constructIndex(TSource &t_source) override {
+    Base::constructIndex(t_source);
+
+    alphabet_ = &this->template loadItem<TAlphabet>(key(ItemKey::ALPHABET), t_source).get();
+    bwt_rle_ = &this->template loadItem<TBwtRLE>(key(ItemKey::NAVIGATE), t_source).get();
+    thresholds_ = &this->template loadItem<TThresholds>(key(ItemKey::THRESHOLDS), t_source).get();
+    run_samples_ = &this->template loadItem<TRunSamples>(key(ItemKey::RUN_BOUNDARY_SAMPLES), t_source).get();
+    isa_samples_ = &this->template loadItem<TISASamples>(key(ItemKey::ISA_SAMPLES), t_source).get();
+  }
+
+  //! Length of the longest common prefix of P[t_i..m) and T[t_pos..n), knowing that it is at least t_len.
+  //! The text is extracted in blocks of isa_rate_ symbols, so each block takes at most 2 * isa_rate_ LF steps.
+  std::size_t extendMatch(const std::string &t_pattern, std::size_t t_i, std::size_t t_pos, std::size_t t_len) const {
+    const auto m = t_pattern.size();
+    while (t_i + t_len < m) {
+      auto block = extractText(*bwt_rle_, *alphabet_, *isa_samples_, isa_rate_, t_pos + t_len,
+                               std::min(isa_rate_, m - t_i - t_len));
+      std::size_t j = 0;
+      while (j < block.size() && block[j] == t_pattern[t_i + t_len]) ++j, ++t_len;
+      if (block.empty() || j < block.size()) break;
+    }
+
+    return t_len;
+  }
+
+  std::size_t isa_rate_ = 64;
+
+  const TAlphabet *alphabet_ = nullptr;
+  const TBwtRLE *bwt_rle_ = nullptr;
+  const TThresholds *thresholds_ = nullptr;
+  const TRunSamples *run_samples_ = nullptr;
+  const TISASamples *isa_samples_ = nullptr;
+};
+
+//! Construct the thresholds of the BWT runs.
+//! The threshold of a run with symbol c is the position of the minimum LCP value in the range between the tail of the
+//! previous run with symbol c (excluded) and the head of the run. It is 0 if there is no previous run with symbol c.
+//! Requires the text and the suffix array in the cache to compute the LCP array.
+template<uint8_t t_width>
+void constructThresholds(sdsl::cache_config &t_config) {
+  static_assert(t_width == 0 or t_width == 8,
+                "constructThresholds: width must be `0` for integer alphabet and `8` for byte alphabet");
+
+  if (!sri::cacheFileExists(sdsl::conf::KEY_LCP, t_config)) {
+    if (!sri::cacheFileExists(sdsl::key_text_trait<t_width>::KEY_TEXT, t_config)
+        || !sri::cacheFileExists(sdsl::conf::KEY_SA, t_config)) {
+      throw std::invalid_argument("Thresholds require the text and its suffix array (not available with BIG_BWT or imported BWTs)");
+    }
+    // SDSL reads the text and the SA from disk
+    sri::cacheFileName(sdsl::key_text_trait<t_width>::KEY_TEXT, t_config);
+    sri::cacheFileName(sdsl::conf::KEY_SA, t_config);
+    sdsl::construct_lcp_kasai<t_width>(t_config);
+  }
+
+  sdsl::int_vector<> lcp;
+  sri::loadFromCache(lcp, sdsl::conf::KEY_LCP, t_config);
+  sdsl::rmq_succinct_sct<true> rmq(&lcp);
+
+  RLEString<> bwt_rle;
+  sri::loadFromCache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+
+  sdsl::int_vector_buffer<> bwt_run_first(sri::cacheFileName(conf::KEY_BWT_RUN_FIRST, t_config));
+  sdsl::int_vector_buffer<> bwt_run_last(sri::cacheFileName(conf::KEY_BWT_RUN_LAST, t_config));
+
+  const auto r = bwt_run_first.size();
+  const auto n = bwt_rle.size();
+  sdsl::int_vector<> thresholds(r, 0, sdsl::bits::hi(n) + 1);
+
+  std::vector<std::size_t> last_tail; // Last run tail seen for each symbol (+1, 0 if none)
+  for (std::size_t k = 0; k < r; ++k) {
+    auto head = bwt_run_first[k];
+    auto c = bwt_rle[head];
+    if (last_tail.size() <= c) last_tail.resize(c + 1, 0);
+
+    if (last_tail[c] != 0) {
+      thresholds[k] = rmq(last_tail[c], head); // last_tail[c] is already tail + 1
+    }
+    last_tail[c] = bwt_run_last[k] + 1;
+  }
+
+  sri::storeToCache(std::move(thresholds), conf::KEY_BWT_RUN_FIRST_THRESHOLD, t_config);
+}
+
+//! Construct the text positions of the BWT run heads and tails interleaved by run
+inline void constructRunBoundarySamples(sdsl::cache_config &t_config) {
+  sdsl::int_vector_buffer<> heads(sri::cacheFileName(conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config));
+  sdsl::int_vector_buffer<> tails(sri::cacheFileName(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config));
+
+  const auto r = heads.size();
+  sdsl::int_vector<> samples(2 * r, 0, std::max(heads.width(), tails.width()));
+  for (std::size_t k = 0; k < r; ++k) {
+    samples[2 * k] = heads[k];
+    samples[2 * k + 1] = tails[k];
+  }
+
+  sri::storeToCache(std::move(samples), conf::KEY_BWT_RUN_BOUNDARY_TEXT_POS, t_config);
+}
+
+template<typename TIndex, template<uint8_t> typename TAlphabet, uint8_t t_width, typename TBwtRLE, typename TThresholds, typename TRunSamples, typename TISASamples>
+void construct(IndexMS<TIndex, TAlphabet<t_width>, TBwtRLE, TThresholds, TRunSamples, TISASamples> &t_index,
+               const std::string &t_data_path,
+               sri::Config &t_config) {
+  {
+    // Construct the items of the base index
+    TIndex base_index(t_index);
+    construct(base_index, t_data_path, t_config);
+  }
+
+  {
+    std::cout << "Constructing BWT-run thresholds" << std::endl;
+    sri::StageEvent event("Thresholds");
+    if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST_THRESHOLD, t_config)) {
+      constructThresholds<t_width>(t_config);
+    }
+  }
+
+  {
+    sri::StageEvent event("Run Boundary Samples");
+    if (!sri::cacheFileExists(conf::KEY_BWT_RUN_BOUNDARY_TEXT_POS, t_config)) {
+      constructRunBoundarySamples(t_config);
+    }
+  }
+
+  {
+    sri::StageEvent event("ISA Samples");
+    if (!sri::cacheFileExists(std::to_string(t_index.ISARate()) + "_" + conf::KEY_ISA_SAMPLES, t_config)) {
+      constructISASamples<t_width>(t_index.ISARate(), t_config);
+    }
+  }
+
+  t_index.load(t_config);
+}
+
+}
+
+#endif //SRI_MATCHING_STATISTICS_H_
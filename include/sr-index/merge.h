@@ -0,0 +1,420 @@
+//
+// Merge of two stored r-indexes into the index of the concatenation of their texts, without the texts or their
+// suffix arrays.
+//
+
+#ifndef SRI_MERGE_H_
+#define SRI_MERGE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <sdsl/int_vector.hpp>
+#include <sdsl/io.hpp>
+#include <sdsl/rank_support_v.hpp>
+
+#include "config.h"
+#include "io.h"
+#include "importers.h"
+#include "construct.h"
+#include "r_index.h"
+#include "resample.h"
+
+namespace sri {
+
+namespace inner_merge {
+
+//! RLBWT of a merged index, with the SA values at the heads and tails of its runs
+template<typename TAlphabet, typename TBwtRLE>
+class MergeSource {
+ public:
+  //! Load the items stored by inner_resample::storeRunItems
+  explicit MergeSource(Config &t_config) {
+    sri::loadFromCache(alphabet_, conf::KEY_ALPHABET, t_config);
+    sri::loadFromCache(bwt_, conf::KEY_BWT_RLE, t_config);
+    n_ = bwt_.size();
+
+    // The items have the text positions of the BWT symbols, i.e., the SA values minus one
+    auto load_sa_values = [this, &t_config](auto &tt_values, const auto &tt_key) {
+      sri::loadFromCache(tt_values, tt_key, t_config);
+      for (auto it = tt_values.begin(); it != tt_values.end(); ++it) *it = (*it + 1) % n_;
+    };
+    load_sa_values(heads_, conf::KEY_BWT_RUN_FIRST_TEXT_POS);
+    load_sa_values(tails_, conf::KEY_BWT_RUN_LAST_TEXT_POS);
+
+    // Number of symbols smaller than each byte, and the closest symbols (in the compact alphabet) below and above it
+    smaller_.fill(0);
+    for (std::size_t c = 0; c < alphabet_.sigma; ++c) smaller_[alphabet_.comp2char[c] + 1] = count(c);
+    for (std::size_t s = 1; s < smaller_.size(); ++s) smaller_[s] += smaller_[s - 1];
+
+    below_[0] = kNoSymbol;
+    for (std::size_t s = 1; s < 256; ++s) below_[s] = contains(s - 1) ? alphabet_.char2comp[s - 1] : below_[s - 1];
+    above_[255] = kNoSymbol;
+    for (std::size_t s = 255; 0 < s; --s) above_[s - 1] = contains(s) ? alphabet_.char2comp[s] : above_[s];
+  }
+
+  std::size_t size() const { return n_; }
+
+  //! Byte symbol at the BWT position
+  uint8_t operator[](std::size_t t_i) const { return alphabet_.comp2char[bwt_[t_i]]; }
+
+  //! LF of the position for the symbol, i.e., number of suffixes smaller than t_symbol followed by the suffix at t_i
+  std::size_t lf(std::size_t t_i, uint8_t t_symbol) const {
+    return smaller_[t_symbol] + (contains(t_symbol) ? bwt_.rank(t_i, alphabet_.char2comp[t_symbol]) : 0);
+  }
+
+  //! SA value at the position preceding lf(t_i, t_symbol), given the SA value at the position preceding t_i. The
+  //! previous t_symbol is the tail of a run, or the preceding position itself.
+  std::size_t saBeforeLF(std::size_t t_i, uint8_t t_symbol, std::size_t t_prev_sa) const {
+    const auto c = alphabet_.char2comp[t_symbol];
+    const std::size_t rnk = contains(t_symbol) ? bwt_.rank(t_i, c) : 0;
+    if (0 < rnk) {
+      auto i = bwt_.select(rnk, c);
+      return predecessor(i + 1 == t_i ? t_prev_sa : tails_[runOf(i)]);
+    }
+
+    // The last position of the largest smaller symbol (there is always the terminator)
+    const auto d = below_[t_symbol];
+    return predecessor(tails_[runOf(bwt_.select(count(d), d))]);
+  }
+
+  //! SA value at the position lf(t_i, t_symbol), given the SA value at the position t_i. The next t_symbol is the head
+  //! of a run, or the position itself.
+  //! \return SA value, or 0 if the position is the end of the BWT
+  std::size_t saAtLF(std::size_t t_i, uint8_t t_symbol, std::size_t t_sa) const {
+    const auto c = alphabet_.char2comp[t_symbol];
+    const std::size_t rnk = contains(t_symbol) ? bwt_.rank(t_i, c) : 0;
+    if (contains(t_symbol) && rnk < count(c)) {
+      auto i = bwt_.select(rnk + 1, c);
+      return predecessor(i == t_i ? t_sa : heads_[runOf(i)]);
+    }
+
+    // The first position of the smallest larger symbol
+    const auto e = above_[t_symbol];
+    if (e == kNoSymbol) return 0;
+    return predecessor(heads_[runOf(bwt_.select(1, e))]);
+  }
+
+  //! Report the run containing the position as (run index, byte symbol, first position, end position)
+  template<typename TReport>
+  void runAt(std::size_t t_i, TReport t_report) const {
+    bwt_.splitInRuns(t_i, t_i + 1, [this, &t_report](auto tt_idx, auto tt_c, auto tt_start, auto tt_end) {
+      t_report(tt_idx, alphabet_.comp2char[tt_c], tt_start, tt_end);
+    });
+  }
+
+  std::size_t head(std::size_t t_run) const { return heads_[t_run]; }
+
+  std::size_t tail(std::size_t t_run) const { return tails_[t_run]; }
+
+  //! Whether the byte symbol is in the BWT
+  bool contains(uint8_t t_symbol) const { return t_symbol == 0 || alphabet_.char2comp[t_symbol] != 0; }
+
+ private:
+  static constexpr std::size_t kNoSymbol = 256;
+
+  std::size_t count(std::size_t t_c) const { return alphabet_.C[t_c + 1] - alphabet_.C[t_c]; }
+
+  std::size_t predecessor(std::size_t t_sa) const { return (t_sa + n_ - 1) % n_; }
+
+  std::size_t runOf(std::size_t t_i) const {
+    std::size_t run = 0;
+    bwt_.splitInRuns(t_i, t_i + 1, [&run](auto tt_idx, auto, auto, auto) { run = tt_idx; });
+    return run;
+  }
+
+  TAlphabet alphabet_;
+  TBwtRLE bwt_;
+  std::size_t n_ = 0;
+  sdsl::int_vector<> heads_;
+  sdsl::int_vector<> tails_;
+  std::array<std::size_t, 257> smaller_{};
+  std::array<std::size_t, 256> below_{};
+  std::array<std::size_t, 256> above_{};
+};
+
+//! Number of suffixes of the first text smaller than each suffix of the second text, by the BWT position of the second
+//! text. The second text is walked backward with LF, while its suffixes are searched backward in the first BWT.
+template<typename TSource>
+sdsl::int_vector<> computeInsertionPoints(const TSource &t_first, const TSource &t_second) {
+  sdsl::int_vector<> points(t_second.size(), 0, sdsl::bits::hi(t_first.size()) + 1);
+
+  // The suffix of the second text with only its terminator is the smallest one
+  std::size_t q = 0;
+  std::size_t p = 0;
+  for (uint8_t symbol; (symbol = t_second[q]) != 0;) {
+    q = t_second.lf(q, symbol);
+    p = t_first.lf(p, symbol);
+    points[q] = p;
+  }
+
+  return points;
+}
+
+//! SA values at the positions of the second BWT next to the suffixes of the first text, which can be run boundaries of
+//! the merged BWT. With them, the SA values of the suffixes of the first text next to the insertions.
+struct InsertionEdges {
+  sdsl::bit_vector is_edge;
+  sdsl::rank_support_v<> is_edge_rank;
+  sdsl::int_vector<> second_sa; // SA value in the second text
+  sdsl::int_vector<> first_prev_sa; // SA value of the preceding suffix of the first text
+  sdsl::int_vector<> first_next_sa; // SA value of the following suffix of the first text
+
+  std::size_t idx(std::size_t t_q) const { return is_edge_rank(t_q); }
+};
+
+//! Compute the SA values at the insertion edges, walking the second text again while the SA values of the suffixes of
+//! the first text around the insertion point are updated as in the toehold lemma of the r-index
+template<typename TSource>
+void computeInsertionEdges(const TSource &t_first,
+                           const TSource &t_second,
+                           const sdsl::int_vector<> &t_points,
+                           InsertionEdges &t_edges) {
+  const auto n2 = t_second.size();
+  // The suffixes of the first text after the last insertion are also next to it
+  auto next_point = [&](auto tt_q) { return tt_q + 1 < n2 ? t_points[tt_q + 1] : t_first.size(); };
+  t_edges.is_edge = sdsl::bit_vector(n2, 0);
+  for (std::size_t q = 0; q < n2; ++q) {
+    t_edges.is_edge[q] = (0 < q && t_points[q - 1] != t_points[q]) || next_point(q) != t_points[q];
+  }
+  sdsl::util::init_support(t_edges.is_edge_rank, &t_edges.is_edge);
+
+  const auto n_edges = t_edges.is_edge_rank(n2);
+  const uint8_t width = sdsl::bits::hi(std::max(t_first.size(), n2)) + 1;
+  t_edges.second_sa = sdsl::int_vector<>(n_edges, 0, width);
+  t_edges.first_prev_sa = sdsl::int_vector<>(n_edges, 0, width);
+  t_edges.first_next_sa = sdsl::int_vector<>(n_edges, 0, width);
+
+  std::size_t q = 0;
+  std::size_t p = 0;
+  std::size_t sa = n2 - 1;
+  std::size_t prev_sa = 0; // Undefined at the first position
+  std::size_t next_sa = t_first.size() - 1; // The first suffix of the first text has only its terminator
+  while (true) {
+    if (t_edges.is_edge[q]) {
+      auto e = t_edges.idx(q);
+      t_edges.second_sa[e] = sa;
+      t_edges.first_prev_sa[e] = prev_sa;
+      t_edges.first_next_sa[e] = next_sa;
+    }
+
+    const auto symbol = t_second[q];
+    if (symbol == 0) break;
+
+    prev_sa = t_first.saBeforeLF(p, symbol, prev_sa);
+    next_sa = t_first.saAtLF(p, symbol, next_sa);
+    p = t_first.lf(p, symbol);
+    q = t_second.lf(q, symbol);
+    --sa;
+  }
+}
+
+//! Runs of the merged BWT, interleaving the runs of both BWTs at the insertion points, with the SA values at their
+//! boundaries. The terminator of the first text becomes the boundary symbol.
+template<typename TSource>
+class MergedBWT : public BWTRunReader, public RunSampleReader {
+ public:
+  MergedBWT(const TSource &t_first,
+            const TSource &t_second,
+            const sdsl::int_vector<> &t_points,
+            const InsertionEdges &t_edges,
+            uint8_t t_boundary)
+      : first_{t_first}, second_{t_second}, points_{t_points}, edges_{t_edges}, boundary_{t_boundary} {}
+
+  std::size_t size() override { return first_.size() + second_.size(); }
+
+  bool next(uint8_t &t_symbol, uint64_t &t_length) override {
+    const auto n1 = first_.size();
+    while (true) {
+      if (i1_ < end1_) {
+        // Part of a run of the first BWT before the next insertion
+        first_.runAt(i1_, [&](auto tt_run, auto tt_symbol, auto tt_start, auto tt_end) {
+          // The SA values next to the insertions are kept at the edges of the previous and the next insertions
+          const auto last = std::min<std::size_t>(tt_end, end1_);
+          const auto sa_head = tt_start == i1_ ? first_.head(tt_run)
+                                               : edges_.first_next_sa[edges_.idx(group_first_ - 1)];
+          const auto sa_tail = tt_end == last ? first_.tail(tt_run)
+                                              : edges_.first_prev_sa[edges_.idx(group_first_)];
+          report(tt_symbol, last - i1_, sa_head, sa_tail, t_symbol, t_length);
+          i1_ = last;
+        });
+        return true;
+      }
+
+      if (group_first_ < q_) {
+        // Suffixes of the second text inserted at the same point and in the same run
+        second_.runAt(group_first_, [&](auto tt_run, auto tt_symbol, auto tt_start, auto tt_end) {
+          const auto sa_head = tt_start == group_first_ ? second_.head(tt_run)
+                                                        : edges_.second_sa[edges_.idx(group_first_)];
+          const auto sa_tail = tt_end == q_ ? second_.tail(tt_run) : edges_.second_sa[edges_.idx(q_ - 1)];
+          report(tt_symbol ? tt_symbol : boundary_, q_ - group_first_, n1 + sa_head, n1 + sa_tail, t_symbol, t_length);
+        });
+        group_first_ = q_;
+        return true;
+      }
+
+      if (q_ < second_.size()) {
+        second_.runAt(q_, [this](auto, auto, auto, auto tt_end) {
+          group_first_ = q_;
+          end1_ = points_[q_];
+          while (++q_ < tt_end && points_[q_] == end1_) {}
+        });
+        continue;
+      }
+
+      if (end1_ < n1) {
+        end1_ = n1;
+        continue;
+      }
+
+      return false;
+    }
+  }
+
+  uint64_t head(uint64_t t_j) override { return sample(heads_, t_j); }
+
+  uint64_t tail(uint64_t t_j) override { return sample(tails_, t_j); }
+
+ private:
+  void report(uint8_t t_symbol,
+              std::size_t t_length,
+              std::size_t t_head,
+              std::size_t t_tail,
+              uint8_t &t_out_symbol,
+              uint64_t &t_out_length) {
+    // Only the boundaries of the maximal runs are requested
+    if (pos_ && t_symbol == symbol_) tails_.pop_back();
+    else heads_.emplace_back(pos_, t_head);
+    tails_.emplace_back(pos_ + t_length - 1, t_tail);
+
+    symbol_ = t_out_symbol = t_symbol;
+    t_out_length = t_length;
+    pos_ += t_length;
+  }
+
+  static uint64_t sample(std::deque<std::pair<std::size_t, std::size_t>> &t_samples, uint64_t t_j) {
+    while (!t_samples.empty() && t_samples.front().first < t_j) t_samples.pop_front();
+    if (t_samples.empty() || t_samples.front().first != t_j) {
+      throw std::logic_error("Error: no SA sample at the merged BWT position " + std::to_string(t_j));
+    }
+    return t_samples.front().second;
+  }
+
+  const TSource &first_;
+  const TSource &second_;
+  const sdsl::int_vector<> &points_;
+  const InsertionEdges &edges_;
+  uint8_t boundary_;
+
+  std::size_t i1_ = 0; // Next position of the first BWT
+  std::size_t end1_ = 0; // End of the positions of the first BWT before the current insertion
+  std::size_t group_first_ = 0; // First position of the second BWT in the current insertion
+  std::size_t q_ = 0; // End of the positions of the second BWT in the current insertion
+
+  std::size_t pos_ = 0; // Next position of the merged BWT
+  uint8_t symbol_ = 0;
+  std::deque<std::pair<std::size_t, std::size_t>> heads_;
+  std::deque<std::pair<std::size_t, std::size_t>> tails_;
+};
+
+//! Check that the boundary symbol is smaller than the symbols of both texts (but the terminator), so it keeps the
+//! order of the suffixes of the first text, and that it is not in the texts
+template<typename TSource>
+void checkBoundary(const TSource &t_source, uint8_t t_boundary) {
+  if (t_boundary == 0) {
+    throw std::invalid_argument("Error: the boundary symbol cannot be the terminator");
+  }
+  for (std::size_t s = 1; s <= t_boundary; ++s) {
+    if (t_source.contains(s)) {
+      throw std::invalid_argument("Error: the boundary symbol (" + std::to_string(t_boundary)
+                                      + ") must be smaller than the symbols of both texts");
+    }
+  }
+}
+
+//! Store the run items of the stored r-index in a folder of its own
+template<typename TSource>
+Config storeSourceItems(const std::string &t_source_file, const std::filesystem::path &t_dir) {
+  TSource source;
+  if (!sdsl::load_from_file(source, t_source_file)) {
+    throw std::invalid_argument("Error: cannot load index \"" + t_source_file + "\"");
+  }
+
+  std::filesystem::create_directories(t_dir);
+  Config config(t_source_file, t_dir, SDSL_LIBDIVSUFSORT);
+  inner_resample::storeRunItems(source, config);
+  return config;
+}
+
+//! Store the alphabet, the RLBWT and the run samples of the merged BWT as the base items of the construction, built
+//! from its runs without the plain BWT
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample>
+void storeMergedBWTAndRuns(const RIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample> &,
+                           const std::string &t_first_file,
+                           const std::string &t_second_file,
+                           uint8_t t_boundary,
+                           Config &t_config) {
+  using Index = RIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample>;
+  const auto dir = std::filesystem::path(t_config.dir);
+
+  auto first_config = storeSourceItems<Index>(t_first_file, dir / "merge_first");
+  auto second_config = storeSourceItems<Index>(t_second_file, dir / "merge_second");
+  {
+    MergeSource<TAlphabet, TBwtRLE> first(first_config);
+    MergeSource<TAlphabet, TBwtRLE> second(second_config);
+    checkBoundary(first, t_boundary);
+    checkBoundary(second, t_boundary);
+
+    auto points = computeInsertionPoints(first, second);
+    InsertionEdges edges;
+    computeInsertionEdges(first, second, points, edges);
+
+    MergedBWT<MergeSource<TAlphabet, TBwtRLE>> merged(first, second, points, edges, t_boundary);
+    storeBWTAndRuns(merged, merged, t_first_file + " + " + t_second_file, t_config);
+  }
+
+  for (auto *config : {&first_config, &second_config}) {
+    sdsl::util::delete_all_files(config->file_map);
+    std::filesystem::remove_all(config->dir);
+  }
+}
+
+} // namespace inner_merge
+
+//! Construct the index of the concatenation of the texts of two stored r-indexes, separated by the boundary symbol,
+//! i.e., text1 + boundary + text2, from their RLBWTs and run samples. The RLBWTs are merged interleaving the LF walk of
+//! the second text with its backward search in the first BWT, so the cost depends on the length of the second text
+//! (e.g., the new documents) and on the runs of the first one, but not on the length of the first text.
+//! The occurrences in the second text are shifted by the length of the first text plus one.
+//! \tparam TSource Type of the stored r-indexes
+//! \param t_boundary Symbol between both texts, smaller than their symbols (but the terminator)
+//! \param t_config Configuration with the folder of the intermediate items
+template<typename TSource, typename TIndex>
+void merge(TIndex &t_index,
+           const std::string &t_first_file,
+           const std::string &t_second_file,
+           Config &t_config,
+           uint8_t t_boundary = 1) {
+  if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST, t_config)) {
+    std::cout << "Merging the BWTs and their run samples" << std::endl;
+    sri::StageEvent event("Merge");
+    inner_merge::storeMergedBWTAndRuns(TSource(), t_first_file, t_second_file, t_boundary, t_config);
+    std::cout << "Done!" << std::endl;
+  }
+
+  // The remaining items are constructed from the merged RLBWT and its run samples, as for an imported BWT
+  t_config.sa_algo = IMPORTED;
+  sri::construct(t_index, t_config.data_path.string(), t_config);
+}
+
+}
+
+#endif //SRI_MERGE_H_
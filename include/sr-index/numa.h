@@ -0,0 +1,202 @@
+//
+// NUMA topology, thread pinning and per-node index replicas.
+//
+
+#ifndef SRI_NUMA_H_
+#define SRI_NUMA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <sdsl/io.hpp>
+#include <sdsl/memory_management.hpp>
+
+namespace sri {
+
+//! NUMA node and the CPUs attached to it
+struct NumaNode {
+  std::size_t id = 0;
+  std::vector<int> cpus;
+};
+
+//! Parse a Linux CPU list (e.g., "0-3,8,10-11")
+//! \param t_list CPU list as reported by sysfs
+//! \return CPU ids in the list
+inline std::vector<int> parseCPUList(const std::string &t_list) {
+  std::vector<int> cpus;
+  std::stringstream ss(t_list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty() || item == "\n") continue;
+
+    auto dash = item.find('-');
+    if (dash == std::string::npos) {
+      cpus.emplace_back(std::stoi(item));
+    } else {
+      auto first = std::stoi(item.substr(0, dash));
+      auto last = std::stoi(item.substr(dash + 1));
+      for (auto cpu = first; cpu <= last; ++cpu) {
+        cpus.emplace_back(cpu);
+      }
+    }
+  }
+
+  return cpus;
+}
+
+//! Compute the NUMA topology of the host from sysfs.
+//! If the topology is not available, a single node with all the CPUs is reported.
+//! \param t_sysfs_path Root of the sysfs node directory
+//! \return NUMA nodes with at least one CPU, sorted by id
+inline std::vector<NumaNode> computeNumaTopology(
+    const std::filesystem::path &t_sysfs_path = "/sys/devices/system/node") {
+  namespace fs = std::filesystem;
+
+  std::vector<NumaNode> nodes;
+  std::error_code ec;
+  if (fs::is_directory(t_sysfs_path, ec)) {
+    for (const auto &entry : fs::directory_iterator(t_sysfs_path, ec)) {
+      const auto name = entry.path().filename().string();
+      if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+          name.find_first_not_of("0123456789", 4) != std::string::npos)
+        continue;
+
+      std::ifstream in(entry.path() / "cpulist");
+      std::string list;
+      if (!in || !std::getline(in, list)) continue;
+
+      NumaNode node{std::stoul(name.substr(4)), parseCPUList(list)};
+      if (!node.cpus.empty()) {
+        nodes.emplace_back(std::move(node));
+      }
+    }
+  }
+
+  if (nodes.empty()) {
+    NumaNode node;
+    auto n_cpus = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int cpu = 0; cpu < n_cpus; ++cpu) {
+      node.cpus.emplace_back(cpu);
+    }
+    nodes.emplace_back(std::move(node));
+  }
+
+  std::sort(nodes.begin(), nodes.end(), [](const auto &a, const auto &b) { return a.id < b.id; });
+
+  return nodes;
+}
+
+//! Pin the calling thread to the CPUs of the given NUMA node.
+//! The CPU set is allocated for the largest CPU id of the node, which may be beyond CPU_SETSIZE on large hosts.
+//! \return True if the affinity was set
+inline bool pinThreadToNode(const NumaNode &t_node) {
+  int max_cpu = -1;
+  for (auto cpu : t_node.cpus) max_cpu = std::max(max_cpu, cpu);
+  if (max_cpu < 0) return false;
+
+  cpu_set_t *cpu_set = CPU_ALLOC(max_cpu + 1);
+  if (!cpu_set) return false;
+  const auto set_size = CPU_ALLOC_SIZE(max_cpu + 1);
+  CPU_ZERO_S(set_size, cpu_set);
+  for (auto cpu : t_node.cpus) {
+    if (cpu >= 0) CPU_SET_S(cpu, set_size, cpu_set);
+  }
+
+  bool pinned = pthread_setaffinity_np(pthread_self(), set_size, cpu_set) == 0;
+  CPU_FREE(cpu_set);
+
+  return pinned;
+}
+
+//! Size (in bytes) of the default huge page of the host, or 0 if it is not available.
+inline std::size_t defaultHugePageSize() {
+  std::ifstream in("/proc/meminfo");
+  std::string key;
+  std::size_t value;
+  std::string unit;
+  while (in >> key >> value) {
+    std::getline(in, unit);
+    if (key == "Hugepagesize:") return value * 1024;
+  }
+
+  return 0;
+}
+
+//! Back all the succinct structures allocated from now on (int_vectors, bitvectors, ...) with huge pages.
+//! The pages have the default huge page size of the host (2 MB, or 1 GB with `default_hugepagesz=1G`).
+//! \param t_bytes Bytes to reserve; 0 reserves all the free huge pages
+//! \return True if the huge pages were reserved
+inline bool useHugePages(std::size_t t_bytes = 0) {
+  try {
+    sdsl::memory_manager::use_hugepages(t_bytes);
+  } catch (const std::exception &e) {
+    std::cerr << "WARNING: huge pages not available (" << e.what() << ")" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//! Read-only index replicated on each NUMA node.
+//! Each replica is loaded by a thread pinned to its node, so the first-touch policy places its memory on that node.
+//! The replicas are loaded one after the other, as the sdsl memory manager (and its huge-page allocator) is global.
+//! A failed load (e.g., a missing file or bad_alloc) is rethrown in the calling thread.
+//! \tparam TIndex Index type
+template<typename TIndex>
+class ReplicatedIndex {
+ public:
+  //! Constructor
+  //! \param t_index_file Serialized index
+  //! \param t_nodes NUMA nodes where the index is replicated
+  ReplicatedIndex(const std::string &t_index_file, std::vector<NumaNode> t_nodes) : nodes_{std::move(t_nodes)} {
+    replicas_.resize(nodes_.size());
+
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+      std::exception_ptr error;
+      std::thread loader([this, i, &t_index_file, &error]() {
+        try {
+          pinThreadToNode(nodes_[i]);
+          replicas_[i] = std::make_shared<TIndex>();
+          if (!sdsl::load_from_file(*replicas_[i], t_index_file)) {
+            throw std::runtime_error("Error: cannot load the index \"" + t_index_file + "\"");
+          }
+        } catch (...) {
+          error = std::current_exception();
+        }
+      });
+      loader.join();
+
+      if (error) std::rethrow_exception(error);
+    }
+  }
+
+  //! Number of replicas (one per NUMA node)
+  [[nodiscard]] std::size_t size() const { return replicas_.size(); }
+
+  //! Replica on the i-th node
+  const TIndex &operator[](std::size_t t_i) const { return *replicas_[t_i]; }
+
+  //! i-th NUMA node
+  const NumaNode &node(std::size_t t_i) const { return nodes_[t_i]; }
+
+ private:
+  std::vector<NumaNode> nodes_;
+  std::vector<std::shared_ptr<TIndex>> replicas_;
+};
+
+}
+
+#endif //SRI_NUMA_H_
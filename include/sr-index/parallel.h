@@ -0,0 +1,171 @@
+//
+// Threads of the parallel construction kernels.
+//
+
+#ifndef SRI_PARALLEL_H_
+#define SRI_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sri {
+
+//! Number of threads of the parallel construction kernels (1 by default; set by the build option --threads)
+inline std::size_t &constructionThreads() {
+  static std::size_t n_threads = 1;
+  return n_threads;
+}
+
+inline void setConstructionThreads(std::size_t t_n_threads) {
+  constructionThreads() = std::max<std::size_t>(1, t_n_threads);
+}
+
+//! First position of the given block when splitting [0, t_n) into t_n_blocks contiguous blocks
+//! \param t_align The block boundaries are multiples of it (except t_n)
+inline std::size_t blockBoundary(std::size_t t_n, std::size_t t_n_blocks, std::size_t t_block, std::size_t t_align = 1) {
+  if (t_n_blocks <= t_block) return t_n;
+  auto boundary = static_cast<std::size_t>((static_cast<unsigned __int128>(t_n) * t_block) / t_n_blocks);
+  boundary = (boundary + t_align - 1) / t_align * t_align;
+  return std::min(boundary, t_n);
+}
+
+//! Call t_fn(tt_block, tt_first, tt_last) for t_n_threads contiguous blocks of [0, t_n), each one in its own thread.
+//! The blocks are the same for the same arguments, so several passes can exchange per-block data.
+//! \param t_align The block boundaries are multiples of it, e.g., so the threads write disjoint words of an int_vector
+template<typename TFn>
+void parallelForBlocks(std::size_t t_n, std::size_t t_n_threads, const TFn &t_fn, std::size_t t_align = 1) {
+  t_n_threads = std::max<std::size_t>(1, t_n_threads);
+  if (t_n_threads == 1) {
+    t_fn(std::size_t{0}, std::size_t{0}, t_n);
+    return;
+  }
+
+  std::vector<std::exception_ptr> errors(t_n_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(t_n_threads);
+  for (std::size_t t = 0; t < t_n_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      try {
+        t_fn(t, blockBoundary(t_n, t_n_threads, t, t_align), blockBoundary(t_n, t_n_threads, t + 1, t_align));
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  for (const auto &error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+//! Fixed set of worker threads that run the tasks of forEach calls, e.g., the fan-out of a query to the shards of an
+//! index. Several threads can call forEach at the same time; each call also runs tasks in the calling thread.
+class ThreadPool {
+ public:
+  //! \param t_n_threads Number of threads running the tasks, including the calling one (so t_n_threads - 1 workers)
+  explicit ThreadPool(std::size_t t_n_threads) {
+    for (std::size_t t = 1; t < t_n_threads; ++t) {
+      workers_.emplace_back([this]() { work(); });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) worker.join();
+  }
+
+  std::size_t size() const { return workers_.size() + 1; }
+
+  //! Call t_fn(tt_i) for each i in [0, t_n), and wait for all of them. The first exception thrown is rethrown
+  template<typename TFn>
+  void forEach(std::size_t t_n, const TFn &t_fn) {
+    if (t_n == 0) return;
+
+    auto batch = std::make_shared<Batch>();
+    batch->n = t_n;
+    batch->fn = [&t_fn](std::size_t tt_i) { t_fn(tt_i); };
+
+    const auto n_helpers = std::min(workers_.size(), t_n - 1);
+    if (n_helpers) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < n_helpers; ++i) queue_.push_back(batch);
+      }
+      cv_.notify_all();
+    }
+
+    run(*batch);
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->cv.wait(lock, [&batch]() { return batch->done == batch->n; });
+    if (batch->error) std::rethrow_exception(batch->error);
+  }
+
+ private:
+  struct Batch {
+    std::size_t n = 0;
+    std::function<void(std::size_t)> fn;
+    std::atomic<std::size_t> next{0};
+    std::size_t done = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+
+  //! Run the pending tasks of the batch
+  static void run(Batch &t_batch) {
+    for (auto i = t_batch.next++; i < t_batch.n; i = t_batch.next++) {
+      std::exception_ptr error;
+      try {
+        t_batch.fn(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(t_batch.mutex);
+      if (error && !t_batch.error) t_batch.error = error;
+      if (++t_batch.done == t_batch.n) t_batch.cv.notify_all();
+    }
+  }
+
+  void work() {
+    while (true) {
+      std::shared_ptr<Batch> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        batch = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      run(*batch);
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::deque<std::shared_ptr<Batch>> queue_;
+  bool stop_ = false;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+}
+
+#endif //SRI_PARALLEL_H_
@@ -0,0 +1,356 @@
+//
+// Parallel suffix array construction by induced sorting.
+//
+
+#ifndef SRI_PARALLEL_SA_H_
+#define SRI_PARALLEL_SA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <sdsl/bits.hpp>
+#include <sdsl/int_vector.hpp>
+
+#include "parallel.h"
+
+namespace sri {
+
+namespace induced_sorting {
+
+//! Entries of the SA whose preceding suffixes are read by the threads at a time in the induction scans
+constexpr std::size_t kBlock = std::size_t{1} << 16;
+
+//! Induced sorting (SA-IS of Nong, Zhang and Chan) of a string ending with a unique smallest symbol.
+//! The induction scans, which take most of the time with their random accesses to the string and the types, are split
+//! into blocks of the SA: the threads read the symbols and types of the suffixes preceding those in the block, and a
+//! single thread then moves them to their buckets, reading again the entries filled while their block is scanned.
+//! The reduced string and its SA live in the SA, so the memory is the SA, the types (a bit per symbol of each level)
+//! and the buckets (a word per distinct symbol or LMS substring of each level, up to half a word per symbol).
+template<typename TIdx>
+class Sorter {
+ public:
+  //! Empty entry of the SA
+  static constexpr TIdx kEmpty = std::numeric_limits<TIdx>::max();
+
+  explicit Sorter(std::size_t t_n_threads)
+      : n_threads_{std::max<std::size_t>(1, t_n_threads)}, pool_(n_threads_) {
+  }
+
+  //! Sort the suffixes of the string
+  //! \param t_s String, with symbols in [0, t_sigma)
+  //! \param t_sa SA, with t_n entries
+  template<typename TString>
+  void sort(const TString &t_s, TIdx *t_sa, std::size_t t_n, std::size_t t_sigma) {
+    // Only the suffixes of longer strings are induced from the last one, an LMS suffix
+    if (t_n == 1) {
+      t_sa[0] = 0;
+      return;
+    }
+
+    // The types of the suffixes: S (1) if smaller than the next one, or L (0)
+    sdsl::bit_vector types(t_n, 0);
+    types[t_n - 1] = 1;
+    for (std::size_t i = t_n - 1; 0 < i; --i) {
+      types[i - 1] = t_s[i - 1] < t_s[i] || (t_s[i - 1] == t_s[i] && types[i]);
+    }
+    auto is_lms = [&types](std::size_t tt_i) { return 0 < tt_i && types[tt_i] && !types[tt_i - 1]; };
+
+    // Sort the LMS substrings, from the LMS suffixes at the ends of their buckets
+    fill(t_sa, t_n, kEmpty);
+    {
+      auto bkt = buckets(t_s, t_n, t_sigma, true);
+      for (std::size_t i = 1; i < t_n; ++i) {
+        if (is_lms(i)) t_sa[--bkt[t_s[i]]] = i;
+      }
+    }
+    induce(t_s, types, t_sa, t_n, t_sigma);
+
+    // Name the LMS substrings, and move their names in text order (the reduced string) to the end of the SA
+    const auto n1 = compact(t_sa, t_n, [&is_lms](TIdx tt_pos) { return tt_pos != kEmpty && is_lms(tt_pos); });
+    fill(t_sa + n1, t_n - n1, kEmpty);
+    const auto n_names = name(t_s, types, t_sa, n1);
+    for (std::size_t i = t_n, j = t_n; n1 < i;) {
+      if (t_sa[--i] != kEmpty) t_sa[--j] = t_sa[i];
+    }
+
+    // Sort the suffixes of the reduced string, i.e., the LMS suffixes
+    TIdx *s1 = t_sa + t_n - n1;
+    if (n_names < n1) {
+      sort(static_cast<const TIdx *>(s1), t_sa, n1, n_names);
+    } else {
+      forBlocks(n1, [s1, t_sa](auto, auto tt_first, auto tt_last) {
+        for (auto i = tt_first; i < tt_last; ++i) t_sa[s1[i]] = i;
+      });
+    }
+
+    // Sort the suffixes, from the sorted LMS suffixes at the ends of their buckets
+    for (std::size_t i = 1, j = 0; i < t_n; ++i) {
+      if (is_lms(i)) s1[j++] = i;
+    }
+    forBlocks(n1, [s1, t_sa](auto, auto tt_first, auto tt_last) {
+      for (auto i = tt_first; i < tt_last; ++i) t_sa[i] = s1[t_sa[i]];
+    });
+    fill(t_sa + n1, t_n - n1, kEmpty);
+    {
+      auto bkt = buckets(t_s, t_n, t_sigma, true);
+      for (std::size_t i = n1; 0 < i;) {
+        auto pos = t_sa[--i];
+        t_sa[i] = kEmpty;
+        t_sa[--bkt[t_s[pos]]] = pos;
+      }
+    }
+    induce(t_s, types, t_sa, t_n, t_sigma);
+  }
+
+ private:
+  //! Marks of the preceding suffixes read in parallel: none to induce, or read again by the scanning thread
+  static constexpr TIdx kNone = kEmpty - 1;
+  static constexpr TIdx kReread = kEmpty - 2;
+
+  //! Call t_fn(tt_thread, tt_first, tt_last) for contiguous blocks of [0, t_n), one per thread
+  template<typename TFn>
+  void forBlocks(std::size_t t_n, const TFn &t_fn) {
+    pool_.forEach(n_threads_, [this, t_n, &t_fn](auto tt_thread) {
+      t_fn(tt_thread, blockBoundary(t_n, n_threads_, tt_thread), blockBoundary(t_n, n_threads_, tt_thread + 1));
+    });
+  }
+
+  void fill(TIdx *t_values, std::size_t t_n, TIdx t_value) {
+    forBlocks(t_n, [t_values, t_value](auto, auto tt_first, auto tt_last) {
+      std::fill(t_values + tt_first, t_values + tt_last, t_value);
+    });
+  }
+
+  //! Heads or ends of the buckets of the symbols
+  template<typename TString>
+  std::vector<TIdx> buckets(const TString &t_s, std::size_t t_n, std::size_t t_sigma, bool t_ends) {
+    std::vector<TIdx> bkt(t_sigma, 0);
+    if (n_threads_ == 1 || t_n < t_sigma * n_threads_) {
+      for (std::size_t i = 0; i < t_n; ++i) ++bkt[t_s[i]];
+    } else {
+      std::vector<std::vector<TIdx>> counts(n_threads_);
+      forBlocks(t_n, [&t_s, t_sigma, &counts](auto tt_thread, auto tt_first, auto tt_last) {
+        counts[tt_thread].assign(t_sigma, 0);
+        for (auto i = tt_first; i < tt_last; ++i) ++counts[tt_thread][t_s[i]];
+      });
+      for (const auto &thread_counts : counts) {
+        for (std::size_t c = 0; c < t_sigma; ++c) bkt[c] += thread_counts[c];
+      }
+    }
+
+    TIdx sum = 0;
+    for (auto &b : bkt) {
+      sum += b;
+      b = t_ends ? sum : sum - b;
+    }
+    return bkt;
+  }
+
+  //! Induce the L suffixes from left to right, and then the S suffixes from right to left
+  template<typename TString>
+  void induce(const TString &t_s, const sdsl::bit_vector &t_types, TIdx *t_sa, std::size_t t_n, std::size_t t_sigma) {
+    auto bkt = buckets(t_s, t_n, t_sigma, false);
+    induceType<false>(t_s, t_types, t_sa, t_n, bkt);
+    bkt = buckets(t_s, t_n, t_sigma, true);
+    induceType<true>(t_s, t_types, t_sa, t_n, bkt);
+  }
+
+  //! Scan the SA, in order for the L suffixes and backwards for the S ones, moving the suffix preceding each scanned
+  //! one, if it has the given type, to the next free entry of its bucket
+  template<bool t_type, typename TString>
+  void induceType(const TString &t_s,
+                  const sdsl::bit_vector &t_types,
+                  TIdx *t_sa,
+                  std::size_t t_n,
+                  std::vector<TIdx> &t_bkt) {
+    // Entry at the given step of the scan, which is also the step of an entry
+    auto entry = [t_n](std::size_t tt_k) { return t_type ? t_n - 1 - tt_k : tt_k; };
+    auto induced = [&t_types](TIdx tt_pos) { return tt_pos != kEmpty && 0 < tt_pos && t_types[tt_pos - 1] == t_type; };
+    auto push = [t_sa, &t_bkt](TIdx tt_pos, TIdx tt_symbol) {
+      auto i = t_type ? --t_bkt[tt_symbol] : t_bkt[tt_symbol]++;
+      t_sa[i] = tt_pos;
+      return i;
+    };
+
+    if (n_threads_ == 1) {
+      for (std::size_t k = 0; k < t_n; ++k) {
+        auto pos = t_sa[entry(k)];
+        if (induced(pos)) push(pos - 1, t_s[pos - 1]);
+      }
+      return;
+    }
+
+    std::vector<TIdx> prev(kBlock), symbols(kBlock);
+    for (std::size_t first = 0; first < t_n; first += kBlock) {
+      const auto size = std::min(kBlock, t_n - first);
+      forBlocks(size, [&](auto, auto tt_first, auto tt_last) {
+        for (auto k = tt_first; k < tt_last; ++k) {
+          auto pos = t_sa[entry(first + k)];
+          if (pos == kEmpty) {
+            prev[k] = kReread;
+          } else if (induced(pos)) {
+            prev[k] = pos - 1;
+            symbols[k] = t_s[pos - 1];
+          } else {
+            prev[k] = kNone;
+          }
+        }
+      });
+
+      for (std::size_t k = 0; k < size; ++k) {
+        TIdx pos = prev[k];
+        TIdx symbol = symbols[k];
+        if (pos == kNone) continue;
+        if (pos == kReread) {
+          pos = t_sa[entry(first + k)];
+          if (!induced(pos)) continue;
+          symbol = t_s[--pos];
+        }
+
+        // An entry of the block to be scanned may change, so it is read again
+        const auto step = entry(push(pos, symbol));
+        if (first + k < step && step < first + size) prev[step - first] = kReread;
+      }
+    }
+  }
+
+  //! Move the entries of the SA satisfying the predicate to its beginning, keeping their order
+  //! \return Number of entries moved
+  template<typename TKeep>
+  std::size_t compact(TIdx *t_sa, std::size_t t_n, const TKeep &t_keep) {
+    std::vector<std::size_t> sizes(n_threads_);
+    forBlocks(t_n, [t_sa, &t_keep, &sizes](auto tt_thread, auto tt_first, auto tt_last) {
+      auto last = tt_first;
+      for (auto i = tt_first; i < tt_last; ++i) {
+        if (t_keep(t_sa[i])) t_sa[last++] = t_sa[i];
+      }
+      sizes[tt_thread] = last - tt_first;
+    });
+
+    std::size_t size = 0;
+    for (std::size_t t = 0; t < n_threads_; ++t) {
+      const auto first = blockBoundary(t_n, n_threads_, t);
+      if (size < first) std::copy(t_sa + first, t_sa + first + sizes[t], t_sa + size);
+      size += sizes[t];
+    }
+    return size;
+  }
+
+  //! Name the sorted LMS substrings in t_sa[0, t_n1) by their order among the distinct ones, setting the name of the
+  //! one at position p in t_sa[t_n1 + p / 2] (the LMS positions are at least 2 apart)
+  //! \return Number of distinct LMS substrings
+  template<typename TString>
+  std::size_t name(const TString &t_s, const sdsl::bit_vector &t_types, TIdx *t_sa, std::size_t t_n1) {
+    auto is_lms = [&t_types](std::size_t tt_i) { return 0 < tt_i && t_types[tt_i] && !t_types[tt_i - 1]; };
+    // Whether the i-th LMS substring differs from the previous one. They never reach the end of the string, as the
+    // last symbol is unique
+    auto differs = [&](std::size_t tt_i) {
+      if (tt_i == 0) return true;
+      const std::size_t a = t_sa[tt_i - 1], b = t_sa[tt_i];
+      for (std::size_t d = 0;; ++d) {
+        if (t_s[a + d] != t_s[b + d] || t_types[a + d] != t_types[b + d]) return true;
+        if (0 < d && is_lms(a + d)) return false;
+      }
+    };
+
+    std::vector<std::size_t> counts(n_threads_, 0);
+    forBlocks(t_n1, [&differs, &counts](auto tt_thread, auto tt_first, auto tt_last) {
+      std::size_t count = 0;
+      for (auto i = tt_first; i < tt_last; ++i) count += differs(i);
+      counts[tt_thread] = count;
+    });
+
+    std::size_t n_names = 0;
+    for (auto &count : counts) {
+      n_names += count;
+      count = n_names - count;
+    }
+
+    forBlocks(t_n1, [&differs, &counts, t_sa, t_n1](auto tt_thread, auto tt_first, auto tt_last) {
+      auto names = counts[tt_thread];
+      for (auto i = tt_first; i < tt_last; ++i) {
+        names += differs(i);
+        t_sa[t_n1 + t_sa[i] / 2] = names - 1;
+      }
+    });
+
+    return n_names;
+  }
+
+  std::size_t n_threads_;
+  ThreadPool pool_;
+};
+
+//! Pack in place the values of the vector with the given (smaller) width
+inline void narrow(sdsl::int_vector<> &t_v, uint8_t t_width) {
+  const auto width = t_v.width();
+  for (std::size_t i = 0; i < t_v.size(); ++i) {
+    t_v.set_int(i * t_width, t_v.get_int(i * width, width), t_width);
+  }
+  t_v.bit_resize(t_v.size() * t_width);
+  t_v.width(t_width);
+}
+
+template<typename TIdx, typename TText>
+sdsl::int_vector<> computeSA(const TText &t_text, std::size_t t_n_threads) {
+  const std::size_t n = t_text.size();
+  const uint64_t max_symbol = *std::max_element(t_text.begin(), t_text.end());
+
+  // The SA is computed with words of TIdx bits, viewed as an array as sdsl does for int_vector<32> and int_vector<64>
+  sdsl::int_vector<> sa(n, 0, sizeof(TIdx) * 8);
+  auto *sa_data = reinterpret_cast<TIdx *>(sa.data());
+
+  Sorter<TIdx> sorter(t_n_threads);
+  if (max_symbol < n) {
+    sorter.sort(t_text, sa_data, n, max_symbol + 1);
+  } else {
+    // The buckets are indexed by symbol, so large symbols are replaced by their ranks
+    std::vector<uint64_t> symbols(t_text.begin(), t_text.end());
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+    std::vector<TIdx> ranks(n);
+    parallelForBlocks(n, t_n_threads, [&](auto, auto tt_first, auto tt_last) {
+      for (auto i = tt_first; i < tt_last; ++i) {
+        ranks[i] = std::lower_bound(symbols.begin(), symbols.end(), t_text[i]) - symbols.begin();
+      }
+    });
+    sorter.sort(static_cast<const TIdx *>(ranks.data()), sa_data, n, symbols.size());
+  }
+
+  narrow(sa, sdsl::bits::hi(n) + 1);
+  return sa;
+}
+
+}
+
+//! Compute the suffix array of the text with a parallel induced sorting (see induced_sorting::Sorter). The text must
+//! end with a unique smallest symbol, as the texts of the construction do.
+//! Besides the text, it uses a word per symbol (of 32 bits if the text is shorter than 2^32 - 2, or 64 bits otherwise),
+//! plus up to 2 bits and half a word per symbol for the types and buckets of the reduced strings. The SA is packed in
+//! place at the end. Texts with symbols not smaller than their length are first mapped to the ranks of their symbols,
+//! which takes 8 bytes and a word per symbol more.
+//! \param t_text Text as an int_vector
+//! \return SA, with width log n
+template<typename TText>
+sdsl::int_vector<> computeSAByInducedSorting(const TText &t_text, std::size_t t_n_threads = constructionThreads()) {
+  const std::size_t n = t_text.size();
+  if (n == 0) return sdsl::int_vector<>(0, 0, 1);
+
+  const auto last = t_text[n - 1];
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    if (t_text[i] <= last) throw std::invalid_argument("Error: the text must end with a unique smallest symbol");
+  }
+
+  // Besides the positions, the empty entries and the marks of the induction scans need 3 values
+  if (n < (uint64_t{1} << 32) - 3) return induced_sorting::computeSA<uint32_t>(t_text, t_n_threads);
+  return induced_sorting::computeSA<uint64_t>(t_text, t_n_threads);
+}
+
+}
+
+#endif //SRI_PARALLEL_SA_H_
@@ -7,6 +7,7 @@
 
 #include <cstddef>
 #include <algorithm>
+#include <type_traits>
 
 #include <sdsl/bits.hpp>
 #include <sdsl/vectors.hpp>
@@ -15,6 +16,7 @@
 #include <sdsl/coder.hpp>
 
 #include "enc_vector.hpp"
+#include "stream_vbyte_vector.h"
 #include "coder.h"
 #include "io.h"
 
@@ -40,11 +42,41 @@ auto constructPsi(const TGetBwtSymbol &t_get_bwt_symbol, const TCumulativeC &t_c
 template<typename TGetBwtSymbol, typename TCumulativeC>
 void constructPsi(TGetBwtSymbol &t_get_bwt_symbol, const TCumulativeC &t_cumulative_c, sdsl::cache_config &t_config) {
   // Store psi
-  sdsl::store_to_cache(constructPsi(t_get_bwt_symbol, t_cumulative_c), sdsl::conf::KEY_PSI, t_config);
+  sri::storeToCache(constructPsi(t_get_bwt_symbol, t_cumulative_c), sdsl::conf::KEY_PSI, t_config);
 }
 
+//! Sequential decoder of the values following the t_i-th sample of an enc_vector, one bit-level code at a time
+template<typename TEncVector>
+class EncVectorBitDecoder {
+ public:
+  EncVectorBitDecoder(const TEncVector &t_values, std::size_t t_i) {
+    data_ = t_values.delta().data(); // RLE data
+    pointer_ = t_values.sample_and_pointer()[2 * t_i + 1]; // Pointer to next coded value
+  }
+
+  auto operator()() {
+    return decode<typename TEncVector::coder>(data_, pointer_);
+  }
+
+ private:
+  const uint64_t *data_ = nullptr;
+  typename TEncVector::int_vector_type::value_type pointer_ = 0;
+};
+
+//! Decoder of the encoded vector: its own one if it has it (e.g., StreamVByteVector), or the one of enc_vector
+template<typename TEncVector, typename = void>
+struct EncVectorDecoder {
+  using type = EncVectorBitDecoder<TEncVector>;
+};
+
+template<typename TEncVector>
+struct EncVectorDecoder<TEncVector, std::void_t<typename TEncVector::Decoder>> {
+  using type = typename TEncVector::Decoder;
+};
+
 //! Psi function core based on partial psi per symbol using run-length encoded representation.
-//! \tparam TEncVector Encoded vector to store each partial psi function
+//! \tparam TEncVector Encoded vector to store each partial psi function, e.g., enc_vector (Elias-delta codes) or
+//! StreamVByteVector (byte-aligned codes decoded in blocks, faster but larger)
 //! \tparam TIntVector Integer vector to store rank per sampled value in each RLE partial psi
 //! \tparam TChar Character or symbol in the compact alphabet
 template<typename TEncVector = enc_vector<sdsl::coder::elias_delta, 64>,
@@ -62,7 +94,22 @@ class PsiCoreRLE {
    * @param t_psi Full psi function as a container
    */
   template<typename TCumulativeC, typename TPsi>
-  PsiCoreRLE(const TCumulativeC &t_cumulative_c, const TPsi &t_psi) {
+  PsiCoreRLE(const TCumulativeC &t_cumulative_c, const TPsi &t_psi)
+      : PsiCoreRLE(t_cumulative_c, t_psi, [](auto) { return true; }) {
+  }
+
+  //! Constructor storing only the partial psi functions of some symbols, the others are left empty and must not be
+  //! queried (e.g., PsiCoreHybrid stores them apart)
+  /**
+   * @tparam TCumulativeC Random access container
+   * @tparam TPsi Random access container
+   * @tparam TKeep Predicate on symbols
+   * @param t_cumulative_c Cumulative count for the alphabet [0..sigma]
+   * @param t_psi Full psi function as a container
+   * @param t_keep Whether to store the partial psi function of the symbol
+   */
+  template<typename TCumulativeC, typename TPsi, typename TKeep>
+  PsiCoreRLE(const TCumulativeC &t_cumulative_c, const TPsi &t_psi, TKeep t_keep) {
     auto sigma = t_cumulative_c.size() - 1;
     n_ = t_cumulative_c[sigma];
 
@@ -76,6 +123,11 @@ class PsiCoreRLE {
       // Compute first symbol in BWT (BWT[0])
       if (t_psi[sa_sp] == 0) { first_bwt_symbol_ = i; }
 
+      if (!t_keep(i)) {
+        partial_psi_.emplace_back();
+        continue;
+      }
+
       std::vector<std::size_t> psi_c; // Partial psi for symbol i
       psi_c.reserve(2 * n_c);
 
@@ -440,7 +492,17 @@ class PsiCoreRLE {
 
   inline auto sigma() const { return partial_psi_.size(); }
 
-  auto countRuns(TChar t_c) { return partial_psi_[t_c].first.size() / 2; }
+  auto countRuns(TChar t_c) const { return partial_psi_[t_c].first.size() / 2; }
+
+  //! Size in bytes of the partial psi function of the symbol
+  auto partialSizeInBytes(TChar t_c) const {
+    const auto &[values, ranks] = partial_psi_[t_c];
+    return sdsl::size_in_bytes(values) + sdsl::size_in_bytes(ranks);
+  }
+
+  //! Drop the partial psi function of the symbol, which must not be queried anymore (e.g., PsiCoreHybrid stores it
+  //! apart), as if the constructor had not kept it
+  void dropPartial(TChar t_c) { partial_psi_[t_c] = typename decltype(partial_psi_)::value_type(); }
 
   typedef std::size_t size_type;
 
@@ -487,21 +549,7 @@ class PsiCoreRLE {
     return *upper_bound;
   }
 
-  class DecodeUInt {
-   public:
-    DecodeUInt(const TEncVector &t_values, std::size_t t_i) {
-      data_ = t_values.delta().data(); // RLE data
-      pointer_ = t_values.sample_and_pointer()[2 * t_i + 1]; // Pointer to next coded value
-    }
-
-    auto operator()() {
-      return decode<typename TEncVector::coder>(data_, pointer_);
-    }
-
-   private:
-    const uint64_t *data_ = nullptr;
-    typename TEncVector::int_vector_type::value_type pointer_ = 0;
-  };
+  using DecodeUInt = typename EncVectorDecoder<TEncVector>::type;
 
   class RunOps {
    public:
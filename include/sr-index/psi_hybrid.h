@@ -0,0 +1,575 @@
+//
+// Psi function core choosing, per symbol, between run-length encoded and bit-vector partial psi functions.
+//
+
+#ifndef SRI_PSI_HYBRID_H_
+#define SRI_PSI_HYBRID_H_
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include <sdsl/bits.hpp>
+#include <sdsl/int_vector.hpp>
+#include <sdsl/bit_vectors.hpp>
+#include <sdsl/io.hpp>
+
+#include "psi.h"
+
+namespace sri {
+
+//! Partial psi function of a symbol as a bit-vector marking its psi values, with the operations over its runs of
+//! consecutive values (i.e., the BWT runs) that PsiCoreRLE answers for the run-length encoded ones.
+//! The run boundaries are found scanning the words of the bit-vector and the runs are counted with the run heads
+//! (1s preceded by a 0) cumulated per block of words.
+class PartialPsiBV {
+ public:
+  typedef std::size_t size_type;
+
+  PartialPsiBV() = default;
+
+  //! Constructor
+  /**
+   * @tparam TPsi Random access container
+   * @param t_psi Full psi function as a container
+   * @param t_first First position of the SA range of the symbol
+   * @param t_last Last position of the SA range of the symbol (not included)
+   * @param t_n Size of the sequence
+   */
+  template<typename TPsi>
+  PartialPsiBV(const TPsi &t_psi, std::size_t t_first, std::size_t t_last, std::size_t t_n)
+      : n_{t_n}, values_(t_n, 0) {
+    for (auto j = t_first; j < t_last; ++j) {
+      values_[t_psi[j]] = 1;
+    }
+    sdsl::util::init_support(rank_, &values_);
+    sdsl::util::init_support(select_, &values_);
+
+    // Number of run heads before each block of words
+    const auto n_words = nWords();
+    run_heads_ = sdsl::int_vector<>(n_words / kBlockWords + 1, 0, sdsl::bits::hi(n_ + 1) + 1);
+    std::size_t n_heads = 0;
+    for (std::size_t i = 0; i < n_words; ++i) {
+      if (i % kBlockWords == 0) run_heads_[i / kBlockWords] = n_heads;
+      n_heads += sdsl::bits::cnt(runHeads(i));
+    }
+    if (n_words % kBlockWords == 0) run_heads_[n_words / kBlockWords] = n_heads;
+  }
+
+  PartialPsiBV(const PartialPsiBV &t_other)
+      : n_{t_other.n_}, values_{t_other.values_}, rank_{t_other.rank_}, select_{t_other.select_},
+        run_heads_{t_other.run_heads_} {
+    setVector();
+  }
+
+  PartialPsiBV(PartialPsiBV &&t_other)
+      : n_{t_other.n_}, values_{std::move(t_other.values_)}, rank_{std::move(t_other.rank_)},
+        select_{std::move(t_other.select_)}, run_heads_{std::move(t_other.run_heads_)} {
+    setVector();
+  }
+
+  PartialPsiBV &operator=(const PartialPsiBV &t_other) {
+    if (this != &t_other) {
+      n_ = t_other.n_;
+      values_ = t_other.values_;
+      rank_ = t_other.rank_;
+      select_ = t_other.select_;
+      run_heads_ = t_other.run_heads_;
+      setVector();
+    }
+    return *this;
+  }
+
+  PartialPsiBV &operator=(PartialPsiBV &&t_other) {
+    if (this != &t_other) {
+      n_ = t_other.n_;
+      values_ = std::move(t_other.values_);
+      rank_ = std::move(t_other.rank_);
+      select_ = std::move(t_other.select_);
+      run_heads_ = std::move(t_other.run_heads_);
+      setVector();
+    }
+    return *this;
+  }
+
+  //! Psi value of the t_rnk-th symbol (t_rnk >= 1)
+  std::size_t select(std::size_t t_rnk) const { return select_(t_rnk); }
+
+  //! Select reporting the psi value and the data of its run, as PsiCoreRLE::select
+  template<typename TReport>
+  void select(std::size_t t_rnk, TReport t_report) const {
+    auto value = select_(t_rnk);
+    auto run_start = runStart(value);
+    t_report(value, run_start, runEnd(value), rankRunHead(run_start));
+  }
+
+  //! Number of symbols with psi value less than t_value
+  std::size_t rank(std::size_t t_value) const { return rank_(t_value); }
+
+  //! Rank reporting the data of the run containing the value or the next one, as PsiCoreRLE::rank
+  template<typename TReport>
+  void rank(std::size_t t_value, TReport t_report) const {
+    auto value = t_value == n_ ? t_value - 1 : t_value;
+    auto run_start = values_[value] ? runStart(value) : nextValue(value);
+    auto run_end = run_start < n_ ? runEnd(run_start) : n_;
+    t_report(rank_(t_value), run_start, run_end, rankRunHead(run_start));
+  }
+
+  bool exist(std::size_t t_value) const { return values_[t_value]; }
+
+  //! Number of runs started up to the value (including it) and start of the run containing it or n, as
+  //! PsiCoreRLE::rankSoftRun
+  std::pair<std::size_t, std::size_t> rankSoftRun(std::size_t t_value) const {
+    if (t_value >= n_) return {countRuns(), n_};
+
+    return {rankRunHead(t_value + 1), values_[t_value] ? runStart(t_value) : n_};
+  }
+
+  //! Report the runs intersecting [t_first..t_last) as {first, last, number of run, if first is the run start}
+  template<typename TReportRun>
+  void splitInRuns(std::size_t t_first, std::size_t t_last, TReportRun t_report_run) const {
+    if (t_first >= n_) return;
+
+    auto run_start = values_[t_first] ? runStart(t_first) : nextValue(t_first);
+    auto n_run = rankRunHead(run_start);
+    while (run_start < t_last) {
+      auto run_end = runEnd(run_start);
+      auto first = std::max(t_first, run_start);
+      t_report_run(first, std::min(t_last, run_end), n_run++, first == run_start);
+
+      run_start = nextValue(run_end);
+    }
+  }
+
+  //! Report the psi values of the ranks [t_first_rank..t_last_rank) split in runs, as
+  //! {first, last, number of run, if first is the run start}
+  template<typename TReportRun>
+  void computeForwardRuns(std::size_t t_first_rank, std::size_t t_last_rank, TReportRun t_report_run) const {
+    auto first = select_(t_first_rank);
+    auto run_start = runStart(first), run_end = runEnd(first);
+    auto rank_end = rank_(run_end);
+    auto n_run = rankRunHead(run_start);
+
+    --t_last_rank;
+    while (rank_end < t_last_rank) {
+      t_report_run(first, run_end, n_run++, first == run_start);
+
+      first = run_start = nextValue(run_end);
+      run_end = runEnd(run_start);
+      rank_end += run_end - run_start;
+    }
+
+    t_report_run(first, run_end - (rank_end - t_last_rank), n_run, first == run_start);
+  }
+
+  //! Report the runs as {start, end}
+  template<typename TReportRun>
+  void traverse(TReportRun t_report_run) const {
+    for (auto run_start = nextValue(0); run_start < n_;) {
+      auto run_end = runEnd(run_start);
+      t_report_run(run_start, run_end);
+      run_start = nextValue(run_end);
+    }
+  }
+
+  std::size_t countRuns() const { return rankRunHead(n_); }
+
+  //! Serialize method
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, const std::string &name = "") const {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(n_, out, child, "n");
+    written_bytes += values_.serialize(out, child, "values");
+    written_bytes += rank_.serialize(out, child, "rank");
+    written_bytes += select_.serialize(out, child, "select");
+    written_bytes += run_heads_.serialize(out, child, "run_heads");
+
+    sdsl::structure_tree::add_size(child, written_bytes);
+
+    return written_bytes;
+  }
+
+  //! Load method
+  void load(std::istream &in) {
+    sdsl::read_member(n_, in);
+    values_.load(in);
+    rank_.load(in);
+    select_.load(in);
+    run_heads_.load(in);
+    setVector();
+  }
+
+ private:
+  static constexpr std::size_t kBlockWords = 8; // Words per block of cumulated run heads
+
+  void setVector() {
+    rank_.set_vector(&values_);
+    select_.set_vector(&values_);
+  }
+
+  std::size_t nWords() const { return (n_ + 63) / 64; }
+
+  //! Run heads in the t_i-th word, i.e., its 1s preceded by a 0 (the first bit of the sequence has a 0 before)
+  uint64_t runHeads(std::size_t t_i) const {
+    const auto *data = values_.data();
+    return data[t_i] & ~((data[t_i] << 1) | (t_i ? data[t_i - 1] >> 63 : 0));
+  }
+
+  //! Number of runs started before the value
+  std::size_t rankRunHead(std::size_t t_value) const {
+    const auto word = t_value / 64, offset = t_value % 64;
+    std::size_t n_heads = run_heads_[word / kBlockWords];
+    for (auto i = word - word % kBlockWords; i < word; ++i) {
+      n_heads += sdsl::bits::cnt(runHeads(i));
+    }
+    if (offset) n_heads += sdsl::bits::cnt(runHeads(word) & sdsl::bits::lo_set[offset]);
+
+    return n_heads;
+  }
+
+  //! Start of the run containing the value, i.e., the position after the last 0 before it
+  std::size_t runStart(std::size_t t_value) const {
+    const auto *data = values_.data();
+    auto i = t_value / 64;
+    uint64_t zeros = ~data[i] & sdsl::bits::lo_set[t_value % 64];
+    while (!zeros) {
+      if (i == 0) return 0;
+      zeros = ~data[--i];
+    }
+
+    return i * 64 + sdsl::bits::hi(zeros) + 1;
+  }
+
+  //! End (not included) of the run containing the value, i.e., the position of the first 0 after it or n
+  std::size_t runEnd(std::size_t t_value) const {
+    const auto *data = values_.data();
+    auto i = t_value / 64;
+    uint64_t zeros = ~data[i] & ~sdsl::bits::lo_set[t_value % 64 + 1];
+    while (!zeros) {
+      if (++i == nWords()) return n_;
+      zeros = ~data[i];
+    }
+
+    return std::min(n_, i * 64 + sdsl::bits::lo(zeros));
+  }
+
+  //! First psi value greater or equal than t_value or n
+  std::size_t nextValue(std::size_t t_value) const {
+    if (t_value >= n_) return n_;
+
+    auto rnk = rank_(t_value);
+    return rnk < rank_(n_) ? select_(rnk + 1) : n_;
+  }
+
+  std::size_t n_ = 0; // Size of sequence
+
+  sdsl::bit_vector values_; // Marks the psi values of the symbol
+  sdsl::rank_support_v<> rank_;
+  sdsl::select_support_mcl<> select_;
+  sdsl::int_vector<> run_heads_; // Number of run heads before each block of kBlockWords words
+};
+
+//! Psi function core that stores each partial psi either run-length encoded (as PsiCoreRLE) or as a bit-vector (as
+//! PsiCoreBV, with the run operations of PartialPsiBV), chosen per symbol at construction, and dispatches each
+//! operation to the representation of the queried symbol. It has the interface of PsiCoreRLE.
+//!
+//! The choice minimizes an expected cost per symbol: its space in bits plus the steps of a query over it (the binary
+//! search on the samples and half of the deltas between samples decoded for the run-length encoding; a constant for
+//! the bit-vector) weighted by the number of occurrences of the symbol, i.e., by how often the psi and LF steps land on
+//! it, and by the bits that a step is worth. Frequent symbols with many short runs go to bit-vectors, while those
+//! with long runs, and the rare ones, stay run-length encoded.
+//!
+//! \tparam TEncVector Encoded vector to store each run-length encoded partial psi function
+//! \tparam TIntVector Integer vector to store rank per sampled value in each run-length encoded partial psi
+//! \tparam TChar Character or symbol in the compact alphabet
+template<typename TEncVector = enc_vector<sdsl::coder::elias_delta, 64>,
+    typename TIntVector = sdsl::int_vector<>,
+    typename TChar = uint8_t>
+class PsiCoreHybrid {
+ public:
+  using PsiCoreRLEType = PsiCoreRLE<TEncVector, TIntVector, TChar>;
+
+  //! Default bits of space worth a query step per occurrence of the symbol
+  static constexpr double kBitsPerStep = 0.125;
+
+  //! Steps of a query over a bit-vector partial psi: rank/select and the scans of the run boundaries
+  static constexpr double kBitVectorSteps = 4;
+
+  PsiCoreHybrid() = default;
+
+  //! Constructor choosing the representation of each partial psi with the cost model. The run-length encoded partial
+  //! psi functions are built once, measured and dropped for the symbols that get bit-vectors, and each candidate
+  //! bit-vector is built once and kept if it is chosen.
+  /**
+   * @tparam TCumulativeC Random access container
+   * @tparam TPsi Random access container
+   * @param t_cumulative_c Cumulative count for the alphabet [0..sigma]
+   * @param t_psi Full psi function as a container
+   * @param t_bits_per_step Bits of space worth a query step per occurrence of the symbol (0 minimizes the space)
+   */
+  template<typename TCumulativeC, typename TPsi>
+  PsiCoreHybrid(const TCumulativeC &t_cumulative_c, const TPsi &t_psi, double t_bits_per_step = kBitsPerStep)
+      : psi_rle_(t_cumulative_c, t_psi) {
+    auto sigma = t_cumulative_c.size() - 1;
+    n_ = t_cumulative_c[sigma];
+    is_bit_vector_ = sdsl::bit_vector(sigma, 0);
+    partial_psi_bv_.resize(sigma);
+
+    const double sample_dens = TEncVector::sample_dens;
+    for (std::size_t i = 0; i < sigma; ++i) {
+      const double n_c = t_cumulative_c[i + 1] - t_cumulative_c[i];
+      const double n_values = 2.0 * psi_rle_.countRuns(i); // Start and length of each run
+
+      auto rle_steps = std::log2(std::ceil(n_values / sample_dens)) + std::min(n_values, sample_dens) / 2;
+      auto rle_cost = 8.0 * psi_rle_.partialSizeInBytes(i) + t_bits_per_step * n_c * rle_steps;
+      auto bv_query_cost = t_bits_per_step * n_c * kBitVectorSteps;
+      if (rle_cost <= n_ + bv_query_cost) continue; // The bit-vector cannot beat it
+
+      PartialPsiBV partial_psi_bv(t_psi, t_cumulative_c[i], t_cumulative_c[i + 1], n_);
+      if (rle_cost <= 8.0 * sdsl::size_in_bytes(partial_psi_bv) + bv_query_cost) continue;
+
+      is_bit_vector_[i] = 1;
+      partial_psi_bv_[i] = std::move(partial_psi_bv);
+      psi_rle_.dropPartial(i);
+    }
+  }
+
+  //! Constructor with the given representation of each partial psi
+  /**
+   * @tparam TCumulativeC Random access container
+   * @tparam TPsi Random access container
+   * @param t_cumulative_c Cumulative count for the alphabet [0..sigma]
+   * @param t_psi Full psi function as a container
+   * @param t_use_bit_vector Whether the partial psi of each symbol is stored as a bit-vector
+   */
+  template<typename TCumulativeC, typename TPsi>
+  PsiCoreHybrid(const TCumulativeC &t_cumulative_c, const TPsi &t_psi, const std::vector<bool> &t_use_bit_vector)
+      : psi_rle_(t_cumulative_c, t_psi, [&t_use_bit_vector](auto tt_c) { return !t_use_bit_vector[tt_c]; }) {
+    auto sigma = t_cumulative_c.size() - 1;
+    n_ = t_cumulative_c[sigma];
+
+    is_bit_vector_ = sdsl::bit_vector(sigma, 0);
+    partial_psi_bv_.resize(sigma);
+    for (std::size_t i = 0; i < sigma; ++i) {
+      if (!t_use_bit_vector[i]) continue;
+
+      is_bit_vector_[i] = 1;
+      partial_psi_bv_[i] = PartialPsiBV(t_psi, t_cumulative_c[i], t_cumulative_c[i + 1], n_);
+    }
+  }
+
+  [[nodiscard]] inline std::size_t size() const { return n_; }
+
+  //! Whether the partial psi of the symbol is stored as a bit-vector
+  bool isBitVector(TChar t_c) const { return is_bit_vector_[t_c]; }
+
+  //! Select operation over partial psi function for symbol c
+  //! \param t_c Symbol c
+  //! \param t_rnk Rank (or number of symbols c) query. It must be less or equal than the number of symbol c
+  //! \return Psi value for t_rnk-th symbol c
+  std::size_t select(TChar t_c, std::size_t t_rnk) const {
+    return isBitVector(t_c) ? partial_psi_bv_[t_c].select(t_rnk) : psi_rle_.select(t_c, t_rnk);
+  }
+
+  //! Select operation over partial psi function for symbol c
+  //! \param t_c Symbol c
+  //! \param t_rnk Rank (or number of symbols c) query. It must be less or equal than the number of symbol c
+  //! \param t_report Report psi value for t_rnk-th symbol c and data of run containing that value
+  template<typename TReport>
+  void select(TChar t_c, std::size_t t_rnk, TReport t_report) const {
+    if (isBitVector(t_c)) partial_psi_bv_[t_c].select(t_rnk, t_report);
+    else psi_rle_.select(t_c, t_rnk, t_report);
+  }
+
+  //! Rank operation over partial psi function for symbol c
+  //! \param t_c Symbol c
+  //! \param t_value Psi value (or SA position) query
+  //! \return Rank for symbol c before the position given, i.e., number of symbols c with psi value less than t_value
+  std::size_t rank(TChar t_c, std::size_t t_value) const {
+    return isBitVector(t_c) ? partial_psi_bv_[t_c].rank(t_value) : psi_rle_.rank(t_c, t_value);
+  }
+
+  //! Rank operation over partial psi function for symbol c
+  //! \param t_c Symbol c
+  //! \param t_value Psi value (or SA position) query
+  //! \param t_report Report rank for symbol c before the position given and data of run containing the value or the
+  //! next (upper) run if value does not belong to any run
+  template<typename TReport>
+  void rank(TChar t_c, std::size_t t_value, TReport t_report) const {
+    if (isBitVector(t_c)) partial_psi_bv_[t_c].rank(t_value, t_report);
+    else psi_rle_.rank(t_c, t_value, t_report);
+  }
+
+  //! Find if the given psi value corresponds to the given symbol
+  bool exist(TChar t_c, std::size_t t_value) const {
+    return isBitVector(t_c) ? partial_psi_bv_[t_c].exist(t_value) : psi_rle_.exist(t_c, t_value);
+  }
+
+  //! Rank operation over runs (run length encoded) in psi (these runs match with BWT runs)
+  //! \param t_value Psi value (or SA position) query
+  //! \return Number of runs with start psi value less than t_value
+  auto rankRun(std::size_t t_value) const {
+    auto [n_runs, run_start] = rankSoftRun(t_value);
+    if (t_value != n_ && run_start == t_value) --n_runs;
+
+    return n_runs;
+  }
+
+  //! Compute the number of runs up to the value (including it) and the start value of the run containing it
+  auto rankSoftRun(std::size_t t_value) const {
+    std::size_t n_runs = 0;
+    std::size_t run_start = n_;
+    for (std::size_t i = 0; i < sigma(); ++i) {
+      auto [n_runs_c, run_start_c] = rankSoftRun(i, t_value);
+      if (run_start_c != n_) run_start = run_start_c;
+
+      n_runs += n_runs_c;
+    }
+
+    return std::make_pair(n_runs, run_start);
+  }
+
+  //! Compute the number of runs of the symbol up to the value (including it) and the start value of the run
+  //! containing it or n if it does not belong to any run
+  std::pair<std::size_t, std::size_t> rankSoftRun(TChar t_c, std::size_t t_value) const {
+    return isBitVector(t_c) ? partial_psi_bv_[t_c].rankSoftRun(t_value) : psi_rle_.rankSoftRun(t_c, t_value);
+  }
+
+  //! Compute the number of runs for symbols smaller than @p t_c
+  auto rankCharRun(TChar t_c) const {
+    std::size_t n_runs = 0;
+    for (std::size_t i = 0; i < t_c; ++i) {
+      n_runs += countRuns(i);
+    }
+
+    return n_runs;
+  }
+
+  //! Split in runs (BWT runs) on the given range [t_first..t_last)
+  auto splitInRuns(std::size_t t_first, std::size_t t_last) const {
+    using Run = std::pair<std::size_t, std::size_t>;
+
+    auto construct_run = [](auto tt_first, auto tt_last, auto, auto, auto) {
+      return Run(tt_first, tt_last);
+    };
+
+    return splitInSortedRuns(t_first, t_last, construct_run);
+  }
+
+  //! Split in runs (BWT runs) on the given range [t_first..t_last)
+  //! \param t_create_run Create a run from <first, last, symbol, number of run, if first is the real first of run>
+  //! \return Runs (BWT) in the queried range
+  template<typename TCreateRun>
+  auto splitInSortedRuns(std::size_t t_first, std::size_t t_last, TCreateRun t_create_run) const {
+    std::vector<decltype(t_create_run(t_first, t_last, TChar(0u), 0u, true))> runs;
+
+    auto report = [&runs, &t_create_run](auto tt_first, auto tt_last, auto tt_c, auto tt_n_run, auto tt_is_first) {
+      runs.emplace_back(t_create_run(tt_first, tt_last, tt_c, tt_n_run, tt_is_first));
+    };
+
+    splitInRuns(t_first, t_last, report);
+    std::sort(runs.begin(), runs.end());
+    return runs;
+  }
+
+  //! Split in runs (BWT runs) on the given range [t_first..t_last)
+  template<typename TReportRun>
+  void splitInRuns(std::size_t t_first, std::size_t t_last, TReportRun t_report_run) const {
+    for (std::size_t i = 0; i < sigma(); ++i) {
+      splitInRuns(i, t_first, t_last, t_report_run);
+    }
+  }
+
+  //! Split in runs (BWT runs) of symbol c on the given range [@p t_first..@p t_last)
+  template<typename TReportRun>
+  void splitInRuns(TChar t_c, std::size_t t_first, std::size_t t_last, TReportRun t_report_run) const {
+    if (!isBitVector(t_c)) {
+      psi_rle_.splitInRuns(t_c, t_first, t_last, t_report_run);
+      return;
+    }
+
+    auto report = [t_c, &t_report_run](auto tt_first, auto tt_last, auto tt_n_run, auto tt_is_first) {
+      t_report_run(tt_first, tt_last, t_c, tt_n_run, tt_is_first);
+    };
+    partial_psi_bv_[t_c].splitInRuns(t_first, t_last, report);
+  }
+
+  //! Compute forward runs (BWT runs) of symbol @p c on the given ranks range [@p t_first_rank..@p t_last_rank)
+  auto computeForwardRuns(TChar t_c, std::size_t t_first_rank, std::size_t t_last_rank) const {
+    using Run = std::pair<std::size_t, std::size_t>;
+    std::vector<Run> runs;
+    auto report = [&runs](auto tt_first, auto tt_last, auto, auto, auto) {
+      runs.emplace_back(tt_first, tt_last);
+    };
+
+    computeForwardRuns(t_c, t_first_rank, t_last_rank, report);
+
+    return runs;
+  }
+
+  //! Compute forward runs (BWT runs) of symbol @p c on the given ranks range [@p t_first_rank..@p t_last_rank)
+  template<typename TReportRun>
+  void computeForwardRuns(TChar t_c, std::size_t t_first_rank, std::size_t t_last_rank, TReportRun t_report_run) const {
+    if (!isBitVector(t_c)) {
+      psi_rle_.computeForwardRuns(t_c, t_first_rank, t_last_rank, t_report_run);
+      return;
+    }
+
+    auto report = [t_c, &t_report_run](auto tt_first, auto tt_last, auto tt_n_run, auto tt_is_first) {
+      t_report_run(tt_first, tt_last, t_c, tt_n_run, tt_is_first);
+    };
+    partial_psi_bv_[t_c].computeForwardRuns(t_first_rank, t_last_rank, report);
+  }
+
+  template<typename TReportRun>
+  void traverse(TChar t_c, TReportRun t_report_run) const {
+    if (isBitVector(t_c)) partial_psi_bv_[t_c].traverse(t_report_run);
+    else psi_rle_.traverse(t_c, t_report_run);
+  }
+
+  inline auto getFirstBWTSymbol() const { return psi_rle_.getFirstBWTSymbol(); }
+
+  inline auto sigma() const { return is_bit_vector_.size(); }
+
+  std::size_t countRuns(TChar t_c) const {
+    return isBitVector(t_c) ? partial_psi_bv_[t_c].countRuns() : psi_rle_.countRuns(t_c);
+  }
+
+  typedef std::size_t size_type;
+
+  //! Serialize method
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, const std::string &name = "") const {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(n_, out, child, "m_n");
+    written_bytes += is_bit_vector_.serialize(out, child, "m_is_bit_vector");
+    written_bytes += psi_rle_.serialize(out, child, "m_psi_rle");
+    written_bytes += sdsl::serialize(partial_psi_bv_, out, child, "m_partial_psi_bv");
+
+    sdsl::structure_tree::add_size(child, written_bytes);
+
+    return written_bytes;
+  }
+
+  //! Load method
+  void load(std::istream &in) {
+    sdsl::read_member(n_, in);
+    is_bit_vector_.load(in);
+    psi_rle_.load(in);
+    sdsl::load(partial_psi_bv_, in);
+  }
+
+ private:
+  std::size_t n_ = 0; // Size of sequence
+
+  sdsl::bit_vector is_bit_vector_; // Marks the symbols whose partial psi is a bit-vector
+  PsiCoreRLEType psi_rle_; // Run-length encoded partial psi functions (empty for the bit-vector ones)
+  std::vector<PartialPsiBV> partial_psi_bv_; // Bit-vector partial psi functions (empty for the run-length encoded ones)
+};
+
+}
+
+#endif //SRI_PSI_HYBRID_H_
@@ -10,6 +10,7 @@
 #include <any>
 #include <functional>
 #include <memory>
+#include <stdexcept>
 
 #include <sdsl/csa_alphabet_strategy.hpp>
 
@@ -69,6 +70,22 @@ class RCSAWithBWTRun : public IndexBaseWithExternalStorage<TStorage> {
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    std::vector<std::pair<std::string, size_t>> parts;
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("alphabet", this->template serializeItem<TAlphabet>(key(ItemKey::ALPHABET), nulls, child, "alphabet"));
+    parts.emplace_back("psi", this->template serializeItem<TPsiRLE>(key(ItemKey::NAVIGATE), nulls, child, "psi"));
+    parts.emplace_back("samples", this->template serializeItem<TSample>(key(ItemKey::SAMPLES), nulls, child, "samples"));
+    parts.emplace_back("marks", this->template serializeItem<TBvMark>(key(ItemKey::MARKS), nulls, child, "marks"));
+    parts.emplace_back("marks_rank", this->template serializeRank<TBvMark>(key(ItemKey::MARKS), nulls, child, "marks_rank"));
+    parts.emplace_back("marks_select", this->template serializeSelect<TBvMark>(key(ItemKey::MARKS), nulls, child, "marks_select"));
+    parts.emplace_back("mark_to_sample", this->template serializeItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), nulls, child, "mark_to_sample"));
+
+    return parts;
+  }
+
  protected:
 
   using typename Base::TSource;
@@ -206,7 +223,7 @@ class RCSAWithBWTRun : public IndexBaseWithExternalStorage<TStorage> {
   auto constructPhiForRange(TSource &t_source) {
     auto bv_mark_rank = this->template loadBVRank<TBvMark>(key(ItemKey::MARKS), t_source, true);
     auto bv_mark_select = this->template loadBVSelect<TBvMark>(key(ItemKey::MARKS), t_source, true);
-    auto successor = CircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
+    auto successor = buildCircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
 
     auto cref_mark_to_sample_idx = this->template loadItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), t_source);
     auto get_mark_to_sample_idx = RandomAccessForTwoContainersDefault(cref_mark_to_sample_idx, true);
@@ -288,6 +305,18 @@ class CSARaw : public RCSAWithBWTRun<TStorage, TAlphabet, TPsiRLE> {
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    std::vector<std::pair<std::string, size_t>> parts;
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("alphabet", this->template serializeItem<TAlphabet>(conf::KEY_ALPHABET, nulls, child, "alphabet"));
+    parts.emplace_back("psi", this->template serializeItem<TPsiRLE>(sdsl::conf::KEY_PSI, nulls, child, "psi"));
+    parts.emplace_back("sa", this->template serializeItem<TSA>(sdsl::conf::KEY_SA, nulls, child, "sa"));
+
+    return parts;
+  }
+
  protected:
 
   using typename Base::TSource;
@@ -344,6 +373,22 @@ void construct(RCSAWithBWTRun<TStorage, TAlphabet<t_width>, TPsiCore, TBvMark, T
                const std::string &t_data_path,
                sri::Config &t_config) {
   constructRCSAWithBWTRuns<t_width, TBvMark>(t_data_path, t_config);
+  constructPsiCore<t_width, TPsiCore>(t_config);
+
+  t_index.load(t_config);
+}
+
+//! The raw CSA keeps the whole SA, so it needs an SA algorithm that computes it (i.e., neither BigBWT nor an imported BWT)
+template<typename TStorage, template<uint8_t> typename TAlphabet, uint8_t t_width, typename TPsiRLE, typename TSA>
+void construct(CSARaw<TStorage, TAlphabet<t_width>, TPsiRLE, TSA> &t_index,
+               const std::string &t_data_path,
+               sri::Config &t_config) {
+  if (t_config.sa_algo == BIG_BWT || t_config.sa_algo == IMPORTED) {
+    throw std::invalid_argument("Error: the CSA needs the whole SA, so it must be built from the text");
+  }
+
+  constructRCSAWithBWTRuns<t_width, sdsl::sd_vector<>>(t_data_path, t_config);
+  constructPsiCore<t_width, TPsiRLE>(t_config);
 
   t_index.load(t_config);
 }
@@ -353,26 +398,22 @@ void constructRCSAWithBWTRuns(const std::string &t_data_path, sri::Config &t_con
   constructIndexBaseItems<t_width>(t_data_path, t_config);
 
   // Construct Psi
-  if (!cache_file_exists(sdsl::conf::KEY_PSI, t_config)) {
-    auto event = sdsl::memory_monitor::event("Psi");
+  if (!sri::cacheFileExists(sdsl::conf::KEY_PSI, t_config)) {
+    sri::StageEvent event("Psi");
     constructPsi<t_width>(t_config);
   }
 
   // Construct Links from Mark to Sample
-  if (!cache_file_exists(conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config)) {
-    auto event = sdsl::memory_monitor::event("Mark2Sample Links");
+  if (!sri::cacheFileExists(conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config)) {
+    sri::StageEvent event("Mark2Sample Links");
     constructMarkToSampleLinksForPhiForwardWithBWTRuns<t_width>(t_config);
   }
 
-  std::size_t n;
-  {
-    sdsl::int_vector_buffer<t_width> bwt_buf(sdsl::cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
-    n = bwt_buf.size();
-  }
+  const auto n = bwtSize(t_config);
 
   // Construct Successor on the text positions of BWT run last letter
-  if (!sdsl::cache_file_exists<TBvMark>(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config)) {
-    auto event = sdsl::memory_monitor::event("Successor");
+  if (!sri::cacheFileExists<TBvMark>(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config)) {
+    sri::StageEvent event("Successor");
     constructBitVectorFromIntVector<TBvMark>(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config, n, false);
   }
 }
@@ -386,6 +427,7 @@ template<typename TStorage = GenericStorage,
 class RCSAWithPsiRun : public IndexBaseWithExternalStorage<TStorage> {
  public:
   using Alphabet = TAlphabet;
+  using PsiCore = TPsiRLE;
   using Samples = TSample;
   using BvMarks = TBvMark;
   using MarksToSamples = TMarkToSampleIdx;
@@ -429,6 +471,22 @@ class RCSAWithPsiRun : public IndexBaseWithExternalStorage<TStorage> {
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    std::vector<std::pair<std::string, size_t>> parts;
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("alphabet", this->template serializeItem<TAlphabet>(key(ItemKey::ALPHABET), nulls, child, "alphabet"));
+    parts.emplace_back("psi", this->template serializeItem<TPsiRLE>(key(ItemKey::NAVIGATE), nulls, child, "psi"));
+    parts.emplace_back("samples", this->template serializeItem<TSample>(key(ItemKey::SAMPLES), nulls, child, "samples"));
+    parts.emplace_back("marks", this->template serializeItem<TBvMark>(key(ItemKey::MARKS), nulls, child, "marks"));
+    parts.emplace_back("marks_rank", this->template serializeRank<TBvMark>(key(ItemKey::MARKS), nulls, child, "marks_rank"));
+    parts.emplace_back("marks_select", this->template serializeSelect<TBvMark>(key(ItemKey::MARKS), nulls, child, "marks_select"));
+    parts.emplace_back("mark_to_sample", this->template serializeItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), nulls, child, "mark_to_sample"));
+
+    return parts;
+  }
+
  protected:
 
   using typename Base::TSource;
@@ -566,7 +624,7 @@ class RCSAWithPsiRun : public IndexBaseWithExternalStorage<TStorage> {
   auto constructPhiForRange(TSource &t_source) {
     auto bv_mark_rank = this->template loadBVRank<TBvMark>(key(ItemKey::MARKS), t_source, true);
     auto bv_mark_select = this->template loadBVSelect<TBvMark>(key(ItemKey::MARKS), t_source, true);
-    auto successor = CircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
+    auto successor = buildCircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
 
     auto cref_mark_to_sample_idx = this->template loadItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), t_source);
     auto get_mark_to_sample_idx = RandomAccessForTwoContainersDefault(cref_mark_to_sample_idx, true);
@@ -630,48 +688,49 @@ void constructItems(RCSAWithPsiRun<TArgs...>& t_index, Config& t_config) {
   constructIndexBaseItems<width>(t_config.data_path, t_config);
 
   // Construct Psi
-  if (!cache_file_exists(keys[kPsi][kBase], t_config)) {
-    auto event = sdsl::memory_monitor::event("Psi");
+  if (!sri::cacheFileExists(keys[kPsi][kBase], t_config)) {
+    sri::StageEvent event("Psi");
     constructPsi<width>(t_config);
   }
+  constructPsiCore<width, typename Index::PsiCore>(t_config);
 
   // Construct Psi Runs
-  if (!sdsl::cache_file_exists<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config)) {
-    auto event = sdsl::memory_monitor::event("Psi Runs");
+  if (!sri::cacheFileExists<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config)) {
+    sri::StageEvent event("Psi Runs");
     constructPsiRuns<width>(t_config);
   }
 
   // Construct Samples for the template type
   if (!std::is_same_v<typename Index::Samples, sdsl::int_vector<>>) {
-    auto event = sdsl::memory_monitor::event("Samples");
+    sri::StageEvent event("Samples");
     sdsl::int_vector<> samples_iv;
-    sdsl::load_from_cache(samples_iv, keys[kPsi][kHead][kTextPos], t_config, true);
+    sri::loadFromCache(samples_iv, keys[kPsi][kHead][kTextPos], t_config, true);
 
     auto samples = sri::construct<typename Index::Samples>(samples_iv);
-    sri::store_to_cache(samples, keys[kPsi][kHead][kTextPos], t_config, true);
+    sri::storeToCache(std::move(samples), keys[kPsi][kHead][kTextPos], t_config, true);
   }
 
   // Construct Successor on the text positions of Psi run last item
-  if (!sdsl::cache_file_exists<typename Index::BvMarks>(keys[kPsi][kTail][kTextPos], t_config)) {
-    auto event = sdsl::memory_monitor::event("Successor");
-    const auto n = sdsl::int_vector_buffer<>(cache_file_name(keys[kBWT][kBase], t_config)).size();
+  if (!sri::cacheFileExists<typename Index::BvMarks>(keys[kPsi][kTail][kTextPos], t_config)) {
+    sri::StageEvent event("Successor");
+    const auto n = bwtSize(t_config);
     constructBitVectorFromIntVector<typename Index::BvMarks>(keys[kPsi][kTail][kTextPos], t_config, n, false, true);
   }
 
   // Construct Links from Mark to Sample
-  if (!sdsl::cache_file_exists<typename Index::MarksToSamples>(keys[kPsi][kTail][kTextPosAsc][kLink], t_config)) {
-    auto event = sdsl::memory_monitor::event("Mark2Sample Links");
+  if (!sri::cacheFileExists<typename Index::MarksToSamples>(keys[kPsi][kTail][kTextPosAsc][kLink], t_config)) {
+    sri::StageEvent event("Mark2Sample Links");
 
     sdsl::int_vector<> mark_to_sample_links;
-    if (!sdsl::cache_file_exists<sdsl::int_vector<>>(keys[kPsi][kTail][kTextPosAsc][kLink], t_config)) {
+    if (!sri::cacheFileExists<sdsl::int_vector<>>(keys[kPsi][kTail][kTextPosAsc][kLink], t_config)) {
       mark_to_sample_links = constructMarkToSampleLinksForPhiForwardWithPsiRuns(t_config);
     } else {
-      sdsl::load_from_cache(mark_to_sample_links, keys[kPsi][kTail][kTextPosAsc][kLink], t_config, true);
+      sri::loadFromCache(mark_to_sample_links, keys[kPsi][kTail][kTextPosAsc][kLink], t_config, true);
     }
 
     if (!std::is_same_v<typename Index::MarksToSamples, sdsl::int_vector<>>) {
       auto values = sri::construct<typename Index::MarksToSamples>(mark_to_sample_links);
-      sri::store_to_cache(values, keys[kPsi][kTail][kTextPosAsc][kLink], t_config, true);
+      sri::storeToCache(std::move(values), keys[kPsi][kTail][kTextPosAsc][kLink], t_config, true);
     }
   }
 }
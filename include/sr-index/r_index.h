@@ -18,22 +18,11 @@
 #include "sequence_ops.h"
 #include "construct.h"
 #include "config.h"
+#include "kmer_table.h"
+#include "suffix_cache.h"
 
 namespace sri {
 
-    struct nullstream : std::ostream {
-        struct nullbuf: std::streambuf {
-            int overflow(int c)
-            {
-                return traits_type::not_eof(c);
-            }
-            int xputc(int) { return 0; }
-            std::streamsize xsputn(char const*, std::streamsize n) { return n; }
-            int sync() { return 0; }
-        } m_sbuf;
-        nullstream(): std::ios(&m_sbuf), std::ostream(&m_sbuf), m_sbuf() {}
-    };
-
 template<typename TStorage = GenericStorage,
     typename TAlphabet = Alphabet<>,
     typename TBwtRLE = RLEString<>,
@@ -48,6 +37,10 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
 
   RIndex() = default;
 
+  //! Runtime cache of the backward-search state of the queried suffixes (disabled by default).
+  //! It is shared by the copies of the index, and it is not serialized. Use SuffixRangeCache::reset to enable it.
+  SuffixRangeCache &SuffixCache() const { return *suffix_cache_; }
+
   void load(Config t_config) override {
     TSource source(std::ref(t_config));
     loadInner(source);
@@ -58,6 +51,17 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
     loadInner(source);
   }
 
+  //! Store the loaded items in the cache, under the keys of their construction, so other indexes can be derived from
+  //! them without the text (see resample.h)
+  virtual void storeItems(Config &t_config) const {
+    this->template storeItem<TAlphabet>(key(ItemKey::ALPHABET), t_config);
+    this->template storeItem<TBwtRLE>(key(ItemKey::NAVIGATE), t_config);
+    this->template storeItem<TSample>(key(ItemKey::SAMPLES), t_config);
+    this->template storeItem<TBvMark>(key(ItemKey::MARKS), t_config, true);
+    this->template storeItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), t_config);
+    this->template storeItem<KmerTable>(key(ItemKey::KMER_TABLE), t_config);
+  }
+
   std::vector<std::pair<std::string, size_t>> breakdown() const override {
 
       std::vector<std::pair<std::string, size_t>> parts;
@@ -86,6 +90,9 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
       written_bytes = this->template serializeItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), nulls, child, "mark_to_sample");
       parts.emplace_back("mark_to_sample", written_bytes);
 
+      written_bytes = this->template serializeItem<KmerTable>(key(ItemKey::KMER_TABLE), nulls, child, "kmer_table");
+      parts.emplace_back("kmer_table", written_bytes);
+
       return parts;
   }
 
@@ -108,6 +115,12 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
     written_bytes +=
         this->template serializeItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), out, child, "mark_to_sample");
 
+    if (hasKmerTable()) {
+      // Optional item, tagged so the indexes without the table keep the original layout
+      written_bytes += sdsl::write_member(kKmerTableTag, out, child, "kmer_table_tag");
+      written_bytes += this->template serializeItem<KmerTable>(key(ItemKey::KMER_TABLE), out, child, "kmer_table");
+    }
+
     return written_bytes;
   }
 
@@ -128,6 +141,7 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
     key(ItemKey::SAMPLES) = conf::KEY_BWT_RUN_LAST_TEXT_POS;
     key(ItemKey::MARKS) = conf::KEY_BWT_RUN_FIRST_TEXT_POS;
     key(ItemKey::MARK_TO_SAMPLE) = conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX;
+    key(ItemKey::KMER_TABLE) = conf::KEY_KMER_TABLE;
   }
 
   virtual void loadAllItems(TSource &t_source) {
@@ -142,6 +156,34 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
     this->template loadBVSelect<TBvMark>(key(ItemKey::MARKS), t_source, true);
 
     this->template loadItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), t_source);
+
+    loadKmerTable(t_source);
+  }
+
+  //! Tag preceding the serialized k-mer table ("SRIKMERT")
+  static constexpr uint64_t kKmerTableTag = 0x5452454d4b495253ULL;
+
+  bool hasKmerTable() const {
+    auto item = get<KmerTable>(this->storage_, key(ItemKey::KMER_TABLE));
+    return item && item->K() != 0;
+  }
+
+  //! Load the k-mer table, which is in the stream only if it is preceded by its tag
+  void loadKmerTable(TSource &t_source) {
+    auto *in = std::get_if<std::reference_wrapper<std::istream>>(&t_source);
+    if (in) {
+      auto &stream = in->get();
+      auto pos = stream.tellg();
+      uint64_t tag = 0;
+      sdsl::read_member(tag, stream);
+      if (!stream || tag != kKmerTableTag) {
+        stream.clear();
+        stream.seekg(pos);
+        set(this->storage_, key(ItemKey::KMER_TABLE), KmerTable());
+      }
+    }
+
+    this->template loadOptionalItem<KmerTable>(key(ItemKey::KMER_TABLE), t_source);
   }
 
   virtual void constructIndex(TSource &t_source) {
@@ -153,7 +195,8 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
         [](const auto &tt_step) { return DataBackwardSearchStep{0, RunData{0, 0}}; },
         constructGetSymbol(t_source),
         [](auto tt_seq_size) { return Range{0, tt_seq_size}; },
-        constructIsRangeEmpty()
+        constructIsRangeEmpty(),
+        constructSeedBackwardSearch(t_source, constructCreateDataBackwardSearchStep())
     });
   }
 
@@ -281,7 +324,7 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
                     const TSampleValidator &t_sample_validator) {
     auto bv_mark_rank = this->template loadBVRank<TBvMark>(key(ItemKey::MARKS), t_source, true);
     auto bv_mark_select = this->template loadBVSelect<TBvMark>(key(ItemKey::MARKS), t_source, true);
-    auto predecessor = CircularPredecessor(bv_mark_rank, bv_mark_select, this->n_);
+    auto predecessor = buildCircularPredecessor(bv_mark_rank, bv_mark_select, this->n_);
 
     auto cref_samples = this->template loadItem<TSample>(key(ItemKey::SAMPLES), t_source);
     auto get_sample = RandomAccessForCRefContainer(cref_samples);
@@ -314,6 +357,37 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
     return ComputeAllValuesWithPhiForRange(t_phi_range, t_compute_toehold, update_range);
   }
 
+  //! Seed for the backward search using the suffix cache and the k-mer table (empty if it was not constructed)
+  template<typename TCreateDataBackwardSearchStep>
+  auto constructSeedBackwardSearch(TSource &t_source, const TCreateDataBackwardSearchStep &t_create_data) {
+    auto get_toehold = [](const auto &tt_data, std::size_t tt_pattern_size) {
+      const auto &[step, run_data] = tt_data;
+      return KmerTable::Toehold{tt_pattern_size - 1 - step, run_data.c, run_data.last_run_rnk, 0};
+    };
+
+    return constructSeedBackwardSearch(t_source, t_create_data, get_toehold);
+  }
+
+  //! Seed for the backward search using the suffix cache and the k-mer table (empty if it was not constructed)
+  //! \param t_get_toehold Function to get the data stored in the seeds from the toehold data (inverse of @p t_create_data)
+  template<typename TCreateDataBackwardSearchStep, typename TGetToehold>
+  auto constructSeedBackwardSearch(TSource &t_source,
+                                   const TCreateDataBackwardSearchStep &t_create_data,
+                                   const TGetToehold &t_get_toehold) {
+    auto cref_kmer_table = this->template loadOptionalItem<KmerTable>(key(ItemKey::KMER_TABLE), t_source);
+
+    auto create_toehold_data = [t_create_data](const KmerTable::Toehold &tt_toehold, std::size_t tt_step) {
+      RangeLF next_range{DataLF{}, DataLF{tt_toehold.value, {tt_toehold.run_rank, false}}};
+      return t_create_data(Range{0, 0}, Char(tt_toehold.c), next_range, tt_step);
+    };
+
+    return SeedBackwardSearchWithCache(
+        SeedBackwardSearchWithKmerTable(cref_kmer_table, constructGetSymbol(t_source), create_toehold_data),
+        suffix_cache_,
+        create_toehold_data,
+        t_get_toehold);
+  }
+
   auto constructGetSymbol(TSource &t_source) {
     auto cref_alphabet = this->template loadItem<TAlphabet>(key(ItemKey::ALPHABET), t_source);
 
@@ -321,6 +395,8 @@ class RIndex : public IndexBaseWithExternalStorage<TStorage> {
     return get_symbol;
   }
 
+  std::shared_ptr<SuffixRangeCache> suffix_cache_ = std::make_shared<SuffixRangeCache>();
+
 };
 
 template<uint8_t t_width, typename TBvMark>
@@ -343,27 +419,32 @@ void constructRIndex(const std::string &t_data_path, sri::Config &t_config) {
   {
     // Construct Links from Mark to Sample
     std::cout<<"Constructing Mark to Sample Links"<<std::endl;
-    auto event = sdsl::memory_monitor::event("Mark2Sample Links");
-    if (!cache_file_exists(conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config)) {
+    sri::StageEvent event("Mark2Sample Links");
+    if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config)) {
       constructMarkToSampleLinksForPhiBackward(t_config);
     }
   }
 
-  std::size_t n;
-  {
-    sdsl::int_vector_buffer<t_width> bwt_buf(sdsl::cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
-    n = bwt_buf.size();
-  }
+  const auto n = bwtSize(t_config);
 
   {
     // Construct Predecessor on the text positions of BWT run first letter
     std::cout<<"Constructing Predecessor"<<std::endl;
-    auto event = sdsl::memory_monitor::event("Predecessor");
+    sri::StageEvent event("Predecessor");
     const auto key_marks = conf::KEY_BWT_RUN_FIRST_TEXT_POS;
-    if (!sdsl::cache_file_exists<TBvMark>(key_marks, t_config)) {
+    if (!sri::cacheFileExists<TBvMark>(key_marks, t_config)) {
       constructBitVectorFromIntVector<TBvMark>(key_marks, t_config, n, false);
     }
   }
+
+  if (t_config.kmer_k) {
+    // Construct the backward-search state of the k-mers
+    std::cout<<"Constructing K-mer Table"<<std::endl;
+    sri::StageEvent event("K-mer Table");
+    if (!sri::cacheFileExists(conf::KEY_KMER_TABLE, t_config)) {
+      constructKmerTable<t_width>(t_config);
+    }
+  }
 }
 
 }
@@ -0,0 +1,141 @@
+//
+// Parallel radix sort of indices by their keys, used by the construction.
+//
+
+#ifndef SRI_RADIX_SORT_H_
+#define SRI_RADIX_SORT_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <sdsl/int_vector.hpp>
+
+#include "parallel.h"
+
+namespace sri {
+
+namespace radix {
+
+constexpr uint8_t kDigitBits = 8;
+constexpr std::size_t kBuckets = std::size_t{1} << kDigitBits;
+
+//! Minimum number of items per thread; smaller inputs use fewer threads
+constexpr std::size_t kMinItemsPerThread = std::size_t{1} << 16;
+
+inline std::size_t threadsFor(std::size_t t_n, std::size_t t_n_threads) {
+  return std::max<std::size_t>(1, std::min(t_n_threads, t_n / kMinItemsPerThread));
+}
+
+//! Stable LSD radix sort of the items by the lowest t_key_bits bits of their keys
+//! \param t_get_key Key of an item
+template<typename TItem, typename TGetKey>
+void lsdSort(std::vector<TItem> &t_items, uint8_t t_key_bits, const TGetKey &t_get_key, std::size_t t_n_threads) {
+  const auto n = t_items.size();
+  std::vector<TItem> buffer;
+  std::vector<std::array<std::size_t, kBuckets>> counts(t_n_threads);
+
+  for (uint8_t shift = 0; shift < t_key_bits; shift += kDigitBits) {
+    auto digit = [&t_get_key, shift](const TItem &tt_item) { return (t_get_key(tt_item) >> shift) & (kBuckets - 1); };
+
+    parallelForBlocks(n, t_n_threads, [&](auto tt_block, auto tt_first, auto tt_last) {
+      auto &count = counts[tt_block];
+      count.fill(0);
+      for (auto i = tt_first; i < tt_last; ++i) ++count[digit(t_items[i])];
+    });
+
+    // Every item has the same digit, so the pass does not move anything
+    std::size_t first_digit_count = 0;
+    const auto first_digit = digit(t_items[0]);
+    for (const auto &count : counts) first_digit_count += count[first_digit];
+    if (first_digit_count == n) continue;
+
+    // Starting position of each block in each bucket, where the blocks are kept in order for stability
+    std::size_t offset = 0;
+    for (std::size_t d = 0; d < kBuckets; ++d) {
+      for (auto &count : counts) {
+        auto block_count = count[d];
+        count[d] = offset;
+        offset += block_count;
+      }
+    }
+
+    if (buffer.empty()) buffer.resize(n);
+    parallelForBlocks(n, t_n_threads, [&](auto tt_block, auto tt_first, auto tt_last) {
+      auto &position = counts[tt_block];
+      for (auto i = tt_first; i < tt_last; ++i) buffer[position[digit(t_items[i])]++] = t_items[i];
+    });
+    t_items.swap(buffer);
+  }
+}
+
+//! Key and index pair, for the keys and indices that do not fit together in a word
+struct KeyIndex {
+  uint64_t key;
+  uint64_t idx;
+};
+
+}
+
+//! Sort the indices [0, n) of the keys by their keys, with a parallel LSD radix sort of (key, index) pairs.
+//! The sort is stable: the indices of equal keys remain in ascending order. The pairs are packed in a single word
+//! when the key and the index fit in 64 bits, and the sorted indices are written directly bit-packed.
+//! \param t_keys Random access container of unsigned integers (read concurrently by the threads)
+//! \return Sorted indices, with width log n
+template<typename TRAContainer>
+sdsl::int_vector<> radixSortIndices(const TRAContainer &t_keys, std::size_t t_n_threads = constructionThreads()) {
+  const std::size_t n = t_keys.size();
+  const uint8_t log_n = sdsl::bits::hi(n) + 1;
+  sdsl::int_vector<> values_idx(n, 0, log_n); // Indices of the values sorted
+  if (n == 0) return values_idx;
+
+  const auto n_threads = radix::threadsFor(n, t_n_threads);
+
+  // Number of bits of the largest key, which bounds the number of passes
+  std::vector<uint64_t> max_keys(n_threads, 0);
+  parallelForBlocks(n, n_threads, [&](auto tt_block, auto tt_first, auto tt_last) {
+    uint64_t max_key = 0;
+    for (auto i = tt_first; i < tt_last; ++i) max_key = std::max<uint64_t>(max_key, t_keys[i]);
+    max_keys[tt_block] = max_key;
+  });
+  const auto max_key = *std::max_element(max_keys.begin(), max_keys.end());
+  const uint8_t key_bits = max_key ? sdsl::bits::hi(max_key) + 1 : 0;
+
+  // Blocks of whole words of the output, so the threads do not write the same word
+  constexpr std::size_t kAlign = 64;
+
+  auto sortAndWrite = [&](auto &tt_items, auto tt_make_item, auto tt_get_key, auto tt_get_index) {
+    parallelForBlocks(n, n_threads, [&](auto, auto tt_first, auto tt_last) {
+      for (auto i = tt_first; i < tt_last; ++i) tt_items[i] = tt_make_item(t_keys[i], i);
+    });
+
+    radix::lsdSort(tt_items, key_bits, tt_get_key, n_threads);
+
+    parallelForBlocks(n, n_threads, [&](auto, auto tt_first, auto tt_last) {
+      for (auto i = tt_first; i < tt_last; ++i) values_idx[i] = tt_get_index(tt_items[i]);
+    }, kAlign);
+  };
+
+  if (key_bits + log_n <= 64) {
+    std::vector<uint64_t> items(n);
+    const uint64_t idx_mask = sdsl::bits::lo_set[log_n];
+    sortAndWrite(items,
+                 [log_n](uint64_t tt_key, uint64_t tt_idx) { return (tt_key << log_n) | tt_idx; },
+                 [log_n](uint64_t tt_item) { return tt_item >> log_n; },
+                 [idx_mask](uint64_t tt_item) { return tt_item & idx_mask; });
+  } else {
+    std::vector<radix::KeyIndex> items(n);
+    sortAndWrite(items,
+                 [](uint64_t tt_key, uint64_t tt_idx) { return radix::KeyIndex{tt_key, tt_idx}; },
+                 [](const radix::KeyIndex &tt_item) { return tt_item.key; },
+                 [](const radix::KeyIndex &tt_item) { return tt_item.idx; });
+  }
+
+  return values_idx;
+}
+
+}
+
+#endif //SRI_RADIX_SORT_H_
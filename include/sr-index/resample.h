@@ -0,0 +1,243 @@
+//
+// Derivation of subsampled r-indexes from a stored r-index, or from a subsampled r-index with a smaller subsampling
+// parameter, without the text or its suffix array.
+//
+
+#ifndef SRI_RESAMPLE_H_
+#define SRI_RESAMPLE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <sdsl/int_vector.hpp>
+#include <sdsl/io.hpp>
+
+#include "config.h"
+#include "io.h"
+#include "construct.h"
+#include "r_index.h"
+#include "sr_index.h"
+
+namespace sri {
+
+namespace inner_resample {
+
+//! Store the samples, marks (by BWT run and sorted by text position) and mark-to-sample links of the stored r-index,
+//! as its construction left them. The subsampling can then be computed as in the construction from the text.
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample>
+void storeRunItems(const RIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample> &t_r_index,
+                   Config &t_config) {
+  t_r_index.storeItems(t_config);
+
+  if constexpr (!std::is_same_v<TSample, sdsl::int_vector<>>) {
+    TSample samples;
+    sri::loadFromCache(samples, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+    sdsl::int_vector<> samples_iv(samples.size(), 0, sdsl::bits::hi(t_r_index.sizeSequence()) + 1);
+    std::copy(samples.begin(), samples.end(), samples_iv.begin());
+    sri::storeToCache(std::move(samples_iv), conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+  }
+
+  TMarkToSampleIdx mark_to_sample;
+  sri::loadFromCache(mark_to_sample, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config);
+  TBvMark bv_marks;
+  sri::loadFromCache(bv_marks, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config, true);
+  typename TBvMark::select_1_type bv_marks_select(&bv_marks);
+
+  // The k-th mark in text order is the head of the run following the run of its linked sample
+  const auto r = mark_to_sample.size();
+  sdsl::int_vector<> marks(r, 0, sdsl::bits::hi(bv_marks.size()) + 1);
+  sdsl::int_vector<> sorted_marks_idx(r, 0, sdsl::bits::hi(r) + 1);
+  for (std::size_t k = 0; k < r; ++k) {
+    auto idx = (mark_to_sample[k] + 1) % r;
+    marks[idx] = bv_marks_select(k + 1);
+    sorted_marks_idx[k] = idx;
+  }
+
+  sri::storeToCache(std::move(marks), conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+  sri::storeToCache(std::move(sorted_marks_idx), conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
+}
+
+//! Store the items of the r-index restricted to the runs subsampled by the stored index, i.e., the samples and marks
+//! at the other runs are unknown. The subsampling of these runs with a larger parameter is a subsampling of the runs of
+//! the r-index. Every mark following an invalid submark in text order (if given) is added to the marks, as these are
+//! the only marks needed to compute the validity of the submarks.
+//! \param t_next_marks Pairs <submark index in text order, next mark> of the invalid submarks
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample, typename TBvSampleIdx>
+void storeSubsampledRunItems(
+    const SrIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample, TBvSampleIdx> &t_index,
+    Config &t_config,
+    const std::vector<std::pair<std::size_t, std::size_t>> *t_next_marks) {
+  const auto prefix = std::to_string(t_index.SubsampleRate()) + "_";
+
+  TBvSampleIdx bv_samples_idx;
+  sri::loadFromCache(bv_samples_idx, prefix + conf::KEY_BWT_RUN_LAST_IDX, t_config, true);
+  typename TBvSampleIdx::select_1_type bv_samples_idx_select(&bv_samples_idx);
+  TSample subsamples;
+  sri::loadFromCache(subsamples, prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+  TMarkToSampleIdx submark_to_subsample;
+  sri::loadFromCache(submark_to_subsample, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config);
+  TBvMark bv_submarks;
+  sri::loadFromCache(bv_submarks, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_BY_LAST, t_config, true);
+  typename TBvMark::select_1_type bv_submarks_select(&bv_submarks);
+
+  const auto n = bv_submarks.size();
+  const auto r = bv_samples_idx.size();
+  const auto r_prime = subsamples.size();
+  const uint8_t log_n = sdsl::bits::hi(n) + 1;
+  const uint8_t log_r = sdsl::bits::hi(r) + 1;
+
+  // Samples by BWT run, and the runs of the subsamples sorted by their text positions
+  sdsl::int_vector<> runs(r_prime, 0, log_r);
+  sdsl::int_vector<> samples(r, 0, log_n);
+  sdsl::int_vector<> subsamples_iv(r_prime, 0, log_n);
+  for (std::size_t j = 0; j < r_prime; ++j) {
+    runs[j] = bv_samples_idx_select(j + 1);
+    samples[runs[j]] = subsamples[j];
+    subsamples_iv[j] = subsamples[j];
+  }
+  sdsl::int_vector<> sorted_samples_idx(r_prime, 0, log_r);
+  {
+    auto sorted_subsamples_idx = sortIndices(subsamples_iv);
+    std::transform(sorted_subsamples_idx.begin(), sorted_subsamples_idx.end(), sorted_samples_idx.begin(),
+                   [&runs](auto tt_j) { return runs[tt_j]; });
+  }
+
+  // Submarks by BWT run (the next marks of the invalid submarks go after the r runs), and their links to the runs of
+  // the subsamples
+  const std::size_t n_next_marks = t_next_marks ? t_next_marks->size() : 0;
+  sdsl::int_vector<> marks(r + n_next_marks, 0, log_n);
+  sdsl::int_vector<> sorted_marks_idx(r_prime + n_next_marks, 0, sdsl::bits::hi(r + n_next_marks) + 1);
+  sdsl::int_vector<> mark_to_sample(r_prime, 0, log_r);
+  for (std::size_t k = 0, i = 0, e = 0; k < r_prime; ++k) {
+    auto run = runs[submark_to_subsample[k]];
+    auto idx = (run + 1) % r;
+    marks[idx] = bv_submarks_select(k + 1);
+    mark_to_sample[k] = run;
+    sorted_marks_idx[i++] = idx;
+
+    if (e < n_next_marks && (*t_next_marks)[e].first == k) {
+      marks[r + e] = (*t_next_marks)[e].second;
+      sorted_marks_idx[i++] = r + e;
+      ++e;
+    }
+  }
+
+  sri::storeToCache(std::move(samples), conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+  sri::storeToCache(std::move(sorted_samples_idx), conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX, t_config);
+  sri::storeToCache(std::move(marks), conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+  sri::storeToCache(std::move(mark_to_sample), conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config);
+  if (t_next_marks) {
+    sri::storeToCache(std::move(sorted_marks_idx), conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
+  }
+}
+
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample, typename TBvSampleIdx>
+void storeRunItems(const SrIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample, TBvSampleIdx> &t_index,
+                   Config &t_config) {
+  t_index.storeItems(t_config);
+
+  // The marks of the r-index following the invalid submarks are unknown
+  storeSubsampledRunItems(t_index, t_config, nullptr);
+}
+
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample, typename TBvSampleIdx, typename TBvValidMark, typename TValidArea>
+void storeRunItems(const SrIndexValidArea<
+    TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample, TBvSampleIdx, TBvValidMark, TValidArea> &t_index,
+                   Config &t_config) {
+  t_index.storeItems(t_config);
+  const auto prefix = std::to_string(t_index.SubsampleRate()) + "_";
+
+  // The next mark of an invalid submark is the end of its valid area
+  TBvMark bv_submarks;
+  sri::loadFromCache(bv_submarks, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_BY_LAST, t_config, true);
+  typename TBvMark::select_1_type bv_submarks_select(&bv_submarks);
+  TBvValidMark bv_valid_marks;
+  sri::loadFromCache(bv_valid_marks, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_MARK, t_config, true);
+  TValidArea valid_areas;
+  sri::loadFromCache(valid_areas, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_AREA, t_config);
+
+  std::vector<std::pair<std::size_t, std::size_t>> next_marks;
+  next_marks.reserve(valid_areas.size());
+  for (std::size_t k = 0; k < bv_valid_marks.size(); ++k) {
+    if (!bv_valid_marks[k]) {
+      next_marks.emplace_back(k, bv_submarks_select(k + 1) + valid_areas[next_marks.size()]);
+    }
+  }
+
+  storeSubsampledRunItems(t_index, t_config, &next_marks);
+}
+
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample, typename TBvSampleIdx>
+void constructItems(SrIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample, TBvSampleIdx> &t_index,
+                    std::size_t t_n,
+                    Config &t_config) {
+  constructSubsamplingItems<TBvMark, TBvSampleIdx>(t_index.SubsampleRate(), t_n, t_config);
+}
+
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample, typename TBvSampleIdx, typename TBvValidMark>
+void constructItems(SrIndexValidMark<
+    TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample, TBvSampleIdx, TBvValidMark> &t_index,
+                    std::size_t t_n,
+                    Config &t_config) {
+  if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config)) {
+    throw std::invalid_argument("Error: the validity of the marks can only be derived from an r-index or from a "
+                                "subsampled r-index with valid areas");
+  }
+
+  constructSubsamplingItems<TBvMark, TBvSampleIdx>(t_index.SubsampleRate(), t_n, t_config);
+  constructSubsamplingValidityItems<TBvValidMark>(t_index.SubsampleRate(), t_config);
+}
+
+//! Subsampling parameter of the stored index: 0 for an r-index, which keeps every sample
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample>
+std::size_t subsampleRate(const RIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample> &) {
+  return 0;
+}
+
+template<typename TStorage, typename TAlphabet, typename TBwtRLE, typename TBvMark, typename TMarkToSampleIdx, typename TSample, typename TBvSampleIdx>
+std::size_t subsampleRate(const SrIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSampleIdx, TSample, TBvSampleIdx> &t_index) {
+  return t_index.SubsampleRate();
+}
+
+} // namespace inner_resample
+
+//! Construct the subsampled index from a stored r-index (TSource = RIndex), which gives the same index as the
+//! construction from the text, or from a stored subsampled index with a smaller subsampling parameter, whose
+//! subsamples are subsampled again. The validity of the marks can be derived from an r-index or from a subsampled
+//! index with valid areas.
+//! Both indexes must have the same components.
+//! \param t_source_file Stored source index
+//! \param t_config Configuration with the folder of the intermediate items
+template<typename TSource, typename TIndex>
+void resample(TIndex &t_index, const std::string &t_source_file, Config &t_config) {
+  std::size_t n;
+  {
+    TSource source;
+    if (!sdsl::load_from_file(source, t_source_file)) {
+      throw std::invalid_argument("Error: cannot load index \"" + t_source_file + "\"");
+    }
+    if (t_index.SubsampleRate() <= inner_resample::subsampleRate(source)) {
+      throw std::invalid_argument("Error: the subsampling parameter must be larger than the one of the stored index ("
+                                      + std::to_string(inner_resample::subsampleRate(source)) + ")");
+    }
+
+    n = source.sizeSequence();
+    sri::StageEvent event("Resample Items");
+    inner_resample::storeRunItems(source, t_config);
+  }
+
+  {
+    sri::StageEvent event("Subsampling");
+    inner_resample::constructItems(t_index, n, t_config);
+  }
+
+  t_index.load(t_config);
+}
+
+}
+
+#endif //SRI_RESAMPLE_H_
@@ -0,0 +1,340 @@
+//
+// Output of query results (ranges and occurrences per pattern) written by a background thread.
+//
+
+#ifndef SRI_RESULTS_H_
+#define SRI_RESULTS_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sri {
+
+//! Format of the results file
+//! - TSV: one line per pattern, "pattern\tstart\tend" (ranges) or "pattern\tn_occs\tocc1,occ2,..." (occurrences).
+//! - BINARY: header, then per pattern the 64-bit words pattern, start, end (ranges) or pattern, n_occs, occs...
+//! - VARINT_DELTA: header, then per pattern the varints of pattern, start, end - start (ranges) or pattern, n_occs
+//!   and the gaps between the sorted occurrences (the first one is absolute).
+enum class ResultFormat { TSV = 0, BINARY = 1, VARINT_DELTA = 2 };
+
+//! Kind of the reported results
+enum class ResultKind { RANGES = 0, OCCURRENCES = 1 };
+
+inline ResultFormat toResultFormat(const std::string &t_name) {
+  if (t_name == "tsv") return ResultFormat::TSV;
+  if (t_name == "binary") return ResultFormat::BINARY;
+  if (t_name == "varint-delta") return ResultFormat::VARINT_DELTA;
+  throw std::invalid_argument("Error: unknown result format \"" + t_name + "\" (tsv, binary or varint-delta)");
+}
+
+//! Magic number at the start of the binary results files
+const char kResultsMagic[4] = {'S', 'R', 'I', 'R'};
+
+//! Append a LEB128 varint
+inline void appendVarint(std::string &t_out, uint64_t t_value) {
+  while (t_value >= 0x80) {
+    t_out.push_back(char((t_value & 0x7F) | 0x80));
+    t_value >>= 7;
+  }
+  t_out.push_back(char(t_value));
+}
+
+inline void appendWord(std::string &t_out, uint64_t t_value) {
+  char bytes[sizeof(uint64_t)];
+  std::memcpy(bytes, &t_value, sizeof(uint64_t));
+  t_out.append(bytes, sizeof(uint64_t));
+}
+
+//! Encode the range [start, end) of a pattern
+inline void encodeRange(ResultFormat t_format, std::string &t_out, std::size_t t_pattern, std::size_t t_start, std::size_t t_end) {
+  switch (t_format) {
+    case ResultFormat::TSV:
+      t_out += std::to_string(t_pattern) + '\t' + std::to_string(t_start) + '\t' + std::to_string(t_end) + '\n';
+      break;
+    case ResultFormat::BINARY:
+      appendWord(t_out, t_pattern);
+      appendWord(t_out, t_start);
+      appendWord(t_out, t_end);
+      break;
+    case ResultFormat::VARINT_DELTA:
+      appendVarint(t_out, t_pattern);
+      appendVarint(t_out, t_start);
+      appendVarint(t_out, t_start < t_end ? t_end - t_start : 0);
+      break;
+  }
+}
+
+//! Encode the occurrences of a pattern. They are sorted for the varint-delta format.
+inline void encodeOccurrences(ResultFormat t_format, std::string &t_out, std::size_t t_pattern, std::vector<std::size_t> t_occs) {
+  switch (t_format) {
+    case ResultFormat::TSV:
+      t_out += std::to_string(t_pattern) + '\t' + std::to_string(t_occs.size()) + '\t';
+      for (std::size_t i = 0; i < t_occs.size(); ++i) {
+        if (i) t_out += ',';
+        t_out += std::to_string(t_occs[i]);
+      }
+      t_out += '\n';
+      break;
+    case ResultFormat::BINARY:
+      appendWord(t_out, t_pattern);
+      appendWord(t_out, t_occs.size());
+      t_out.append(reinterpret_cast<const char *>(t_occs.data()), t_occs.size() * sizeof(std::size_t));
+      break;
+    case ResultFormat::VARINT_DELTA: {
+      std::sort(t_occs.begin(), t_occs.end());
+      appendVarint(t_out, t_pattern);
+      appendVarint(t_out, t_occs.size());
+      std::size_t prev = 0;
+      for (const auto &occ : t_occs) {
+        appendVarint(t_out, occ - prev);
+        prev = occ;
+      }
+      break;
+    }
+  }
+}
+
+//! Writer of query results with a background thread, so the query threads do not wait for the I/O while it keeps up.
+//! Each query thread encodes its results in its own Buffer, which is handed to the writer thread when it is full and
+//! replaced with a recycled one. The writer thread swaps the queue of full buffers with its own (double buffering)
+//! and writes them without holding the lock.
+//! The queue of full buffers is bounded: when the output is slower than the queries, the query threads block on
+//! submit until the writer thread takes the queue, so the memory is bounded by the queue and thread buffers.
+//! The results of the different threads are interleaved in buffer-sized chunks, so each record carries its pattern id.
+class AsyncResultWriter {
+ public:
+  //! Results buffer of a query thread
+  class Buffer {
+   public:
+    explicit Buffer(AsyncResultWriter &t_writer) : writer_{t_writer}, data_{t_writer.acquire()} {}
+
+    Buffer(const Buffer &) = delete;
+    Buffer &operator=(const Buffer &) = delete;
+
+    ~Buffer() { flush(); }
+
+    void addRange(std::size_t t_pattern, std::size_t t_start, std::size_t t_end) {
+      encodeRange(writer_.format_, data_, t_pattern, t_start, t_end);
+      if (data_.size() >= writer_.buffer_size_) flush();
+    }
+
+    void addOccurrences(std::size_t t_pattern, std::vector<std::size_t> t_occs) {
+      encodeOccurrences(writer_.format_, data_, t_pattern, std::move(t_occs));
+      if (data_.size() >= writer_.buffer_size_) flush();
+    }
+
+    //! Hand the buffered results to the writer thread
+    void flush() {
+      if (data_.empty()) return;
+      writer_.submit(std::move(data_));
+      data_ = writer_.acquire();
+    }
+
+   private:
+    AsyncResultWriter &writer_;
+    std::string data_;
+  };
+
+  //! Constructor
+  //! \param t_file Output file
+  //! \param t_buffer_size Size in bytes of the buffers of the query threads
+  //! \param t_max_pending Maximum number of full buffers waiting to be written
+  AsyncResultWriter(const std::string &t_file,
+                    ResultFormat t_format,
+                    ResultKind t_kind,
+                    std::size_t t_buffer_size = 1u << 20,
+                    std::size_t t_max_pending = 16)
+      : out_(t_file, std::ios::binary),
+        format_{t_format},
+        buffer_size_{t_buffer_size},
+        max_pending_{std::max<std::size_t>(t_max_pending, 1)} {
+    if (!out_) {
+      throw std::invalid_argument("Error: cannot open results file \"" + t_file + "\"");
+    }
+
+    if (t_format == ResultFormat::TSV) {
+      out_ << (t_kind == ResultKind::RANGES ? "#pattern\tstart\tend\n" : "#pattern\tn_occs\toccs\n");
+    } else {
+      out_.write(kResultsMagic, sizeof(kResultsMagic));
+      out_.put(char(t_format));
+      out_.put(char(t_kind));
+    }
+
+    thread_ = std::thread([this]() { run(); });
+  }
+
+  AsyncResultWriter(const AsyncResultWriter &) = delete;
+  AsyncResultWriter &operator=(const AsyncResultWriter &) = delete;
+
+  ~AsyncResultWriter() { close(); }
+
+  ResultFormat format() const { return format_; }
+
+  //! Write the pending buffers and stop the writer thread. The query-thread buffers must be flushed before.
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (done_) return;
+      done_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+    out_.close();
+  }
+
+ private:
+  //! Queue a full buffer, waiting while the queue is full
+  void submit(std::string &&t_data) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_cv_.wait(lock, [this]() { return pending_.size() < max_pending_; });
+      pending_.emplace_back(std::move(t_data));
+    }
+    cv_.notify_one();
+  }
+
+  //! Empty buffer, recycled from the written ones if possible
+  std::string acquire() {
+    std::string data;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty()) {
+        data = std::move(free_.back());
+        free_.pop_back();
+      }
+    }
+    if (data.capacity() < buffer_size_) data.reserve(buffer_size_ + buffer_size_ / 4);
+    return data;
+  }
+
+  void run() {
+    std::vector<std::string> writing;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return done_ || !pending_.empty(); });
+        if (pending_.empty()) break; // Done and nothing left to write
+        std::swap(writing, pending_);
+      }
+      not_full_cv_.notify_all();
+
+      for (auto &data : writing) {
+        out_.write(data.data(), data.size());
+        data.clear();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto &data : writing) free_.emplace_back(std::move(data));
+      writing.clear();
+    }
+  }
+
+  std::ofstream out_;
+  ResultFormat format_;
+  std::size_t buffer_size_;
+  std::size_t max_pending_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable not_full_cv_; // Signaled when the writer thread takes the queue
+  std::vector<std::string> pending_; // Full buffers waiting to be written
+  std::vector<std::string> free_; // Written buffers to be reused
+  bool done_ = false;
+  std::thread thread_;
+};
+
+//! Results of a pattern read from a results file
+struct PatternResult {
+  std::size_t pattern = 0;
+  std::size_t start = 0; // Range (only for ranges)
+  std::size_t end = 0;
+  std::vector<std::size_t> occs; // Occurrences (only for occurrences)
+};
+
+//! Read a results file in any of the formats
+//! \return Results in the order they were written
+inline std::vector<PatternResult> readResults(const std::string &t_file) {
+  std::ifstream in(t_file, std::ios::binary);
+  if (!in) {
+    throw std::invalid_argument("Error: cannot open results file \"" + t_file + "\"");
+  }
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  std::vector<PatternResult> results;
+  if (data.size() < sizeof(kResultsMagic) || !std::equal(kResultsMagic, kResultsMagic + sizeof(kResultsMagic), data.begin())) {
+    // TSV
+    std::istringstream lines(data);
+    std::string line;
+    std::getline(lines, line);
+    const bool ranges = line.find("start") != std::string::npos;
+    while (std::getline(lines, line)) {
+      std::istringstream fields(line);
+      PatternResult result;
+      if (ranges) {
+        fields >> result.pattern >> result.start >> result.end;
+      } else {
+        std::size_t n_occs;
+        fields >> result.pattern >> n_occs;
+        result.occs.resize(n_occs);
+        for (std::size_t i = 0; i < n_occs; ++i) {
+          if (i) fields.ignore(1);
+          fields >> result.occs[i];
+        }
+      }
+      results.emplace_back(std::move(result));
+    }
+    return results;
+  }
+
+  const auto format = ResultFormat(data[sizeof(kResultsMagic)]);
+  const auto kind = ResultKind(data[sizeof(kResultsMagic) + 1]);
+  std::size_t pos = sizeof(kResultsMagic) + 2;
+  auto next = [&data, &pos, format]() -> uint64_t {
+    uint64_t value = 0;
+    if (format == ResultFormat::BINARY) {
+      std::memcpy(&value, data.data() + pos, sizeof(uint64_t));
+      pos += sizeof(uint64_t);
+    } else {
+      for (unsigned shift = 0;; shift += 7) {
+        auto byte = uint8_t(data[pos++]);
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+      }
+    }
+    return value;
+  };
+
+  while (pos < data.size()) {
+    PatternResult result;
+    result.pattern = next();
+    if (kind == ResultKind::RANGES) {
+      result.start = next();
+      result.end = next();
+      if (format == ResultFormat::VARINT_DELTA) result.end += result.start;
+    } else {
+      result.occs.resize(next());
+      std::size_t prev = 0;
+      for (auto &occ : result.occs) {
+        occ = next();
+        if (format == ResultFormat::VARINT_DELTA) occ = prev += occ;
+      }
+    }
+    results.emplace_back(std::move(result));
+  }
+
+  return results;
+}
+
+}
+
+#endif //SRI_RESULTS_H_
@@ -711,6 +711,55 @@ class RLEString {
     assert(run_heads_.size() == r_);
   }
 
+  //! Constructor from the runs of the sequence, without the sequence itself
+  //! \param t_heads Symbol of each run. Consecutive runs may have the same symbol.
+  //! \param t_lengths Length of each run
+  //! \param t_b Block size, i.e., number of runs in a block (runs_ has r_/@p t_b, r_ being number of runs)
+  RLEString(const sdsl::int_vector<> &t_heads, const sdsl::int_vector<> &t_lengths, std::size_t t_b = 2) : b_{t_b} {
+    assert(!t_heads.empty() && t_heads.size() == t_lengths.size());
+
+    std::size_t n = 0;
+    std::vector<std::size_t> counts; // Number of occurrences per symbol
+    for (std::size_t i = 0; i < t_heads.size(); ++i) {
+      if (counts.size() <= t_heads[i]) counts.resize(t_heads[i] + 1, 0);
+      counts[t_heads[i]] += t_lengths[i];
+      n += t_lengths[i];
+    }
+
+    sdsl::bit_vector runs(n, 0); // Bits set only at the end of a block
+    std::vector<sdsl::bit_vector> runs_per_symbol(counts.size()); // Bits set at the run ends
+    for (std::size_t c = 0; c < counts.size(); ++c) runs_per_symbol[c] = sdsl::bit_vector(counts[c], 0);
+    counts.assign(counts.size(), 0);
+
+    sdsl::int_vector<> run_heads(t_heads.size(), 0, t_heads.width());
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < t_heads.size(); ++i) {
+      const auto symbol = t_heads[i];
+      pos += t_lengths[i];
+      counts[symbol] += t_lengths[i];
+      if (i + 1 < t_heads.size() && t_heads[i + 1] == symbol) continue;
+
+      // End of a maximal run
+      if (pos < n) runs[pos - 1] = r_ % b_ == b_ - 1;
+      runs_per_symbol[symbol][counts[symbol] - 1] = 1;
+      run_heads[r_++] = symbol;
+    }
+    run_heads.resize(r_);
+
+    // Compact data structures
+
+    runs_ = BitVector(std::move(runs));
+
+    runs_per_symbol_.resize(runs_per_symbol.size());
+    for (std::size_t c = 0; c < runs_per_symbol.size(); ++c) {
+      if (!runs_per_symbol[c].empty()) runs_per_symbol_[c] = BitVector(std::move(runs_per_symbol[c]));
+    }
+
+    constructRunHeads(run_heads);
+
+    assert(run_heads_.size() == r_);
+  }
+
   [[nodiscard]] inline std::size_t size() const { return runs_.data.size(); }
 
   //! Random access
@@ -1024,6 +1073,9 @@ class RLEString {
       select = TBitVectorSelect{&data};
     }
 
+    BitVector(sdsl::bit_vector &&t_bv) : data{std::move(t_bv)}, rank{&data}, select{&data} {
+    }
+
     BitVector(const BitVector &t_bv) : data{t_bv.data}, rank{&data}, select{&data} {
     }
 
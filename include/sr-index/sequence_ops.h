@@ -7,6 +7,9 @@
 
 #include <memory>
 #include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
 
 namespace sri {
 
@@ -43,9 +46,62 @@ class CircularPredecessor {
   std::size_t n_ones_;
 };
 
+//! The item itself, or the one referenced by a std::reference_wrapper (e.g., the items loaded by the indexes)
+template<typename T>
+const T &unwrapRef(const T &t_item) { return t_item; }
+
+template<typename T>
+T &unwrapRef(const std::reference_wrapper<T> &t_item) { return t_item.get(); }
+
+template<typename T>
+using UnwrapRefType = std::remove_cv_t<std::remove_reference_t<decltype(unwrapRef(std::declval<const T &>()))>>;
+
+//! The rank function computes the circular predecessor by itself (e.g., EliasFanoVector::rank_1_type)
+template<typename TRank, typename = void>
+struct HasFusedPredecessor : std::false_type {};
+
+template<typename TRank>
+struct HasFusedPredecessor<TRank, std::void_t<decltype(std::declval<const TRank &>().predecessor(std::size_t{}))>>
+    : std::true_type {};
+
+//! The rank function computes the circular soft successor by itself (e.g., EliasFanoVector::rank_1_type)
+template<typename TRank, typename = void>
+struct HasFusedSoftSuccessor : std::false_type {};
+
+template<typename TRank>
+struct HasFusedSoftSuccessor<TRank, std::void_t<decltype(std::declval<const TRank &>().softSuccessor(std::size_t{}))>>
+    : std::true_type {};
+
+//! Circular predecessor computed in one traversal by the rank function, instead of a rank followed by a select.
+/**
+ * @tparam TRank Rank function for the marked values with a predecessor function (see HasFusedPredecessor)
+ */
+template<typename TRank>
+class CircularFusedPredecessor {
+ public:
+  explicit CircularFusedPredecessor(const TRank &t_rank) : rank_{t_rank} {}
+
+  //! Predecessor function
+  /**
+   * @param i Number to search.
+   * @return <o, v>: the predecessor of i is the o-th number and its value is v (see CircularPredecessor).
+   */
+  auto operator()(std::size_t i) const {
+    return unwrapRef(rank_).predecessor(i);
+  }
+
+ private:
+  TRank rank_;
+};
+
+//! Build the circular predecessor, fused if the rank function supports it.
 template<typename TRank, typename TSelect>
 auto buildCircularPredecessor(const TRank &t_rank, const TSelect &t_select, std::size_t t_bitvector_size) {
-  return CircularPredecessor<TRank, TSelect>(t_rank, t_select, t_bitvector_size);
+  if constexpr (HasFusedPredecessor<UnwrapRefType<TRank>>::value) {
+    return CircularFusedPredecessor<TRank>(t_rank);
+  } else {
+    return CircularPredecessor<TRank, TSelect>(t_rank, t_select, t_bitvector_size);
+  }
 }
 
 //! Find the smallest number greater or equal than the value i or the smallest number if i is greater than all numbers.
@@ -80,6 +136,38 @@ class CircularSoftSuccessor {
 
   std::size_t n_ones_;
 };
+
+//! Circular soft successor computed in one traversal by the rank function, instead of a rank followed by a select.
+/**
+ * @tparam TRank Rank function for the marked values with a soft successor function (see HasFusedSoftSuccessor)
+ */
+template<typename TRank>
+class CircularFusedSoftSuccessor {
+ public:
+  explicit CircularFusedSoftSuccessor(const TRank &t_rank) : rank_{t_rank} {}
+
+  //! Soft successor function
+  /**
+   * @param i Number to search.
+   * @return <o, v>: the successor of i is the o-th number and its value is v (see CircularSoftSuccessor).
+   */
+  auto operator()(std::size_t i) const {
+    return unwrapRef(rank_).softSuccessor(i);
+  }
+
+ private:
+  TRank rank_;
+};
+
+//! Build the circular soft successor, fused if the rank function supports it.
+template<typename TRank, typename TSelect>
+auto buildCircularSoftSuccessor(const TRank &t_rank, const TSelect &t_select, std::size_t t_bitvector_size) {
+  if constexpr (HasFusedSoftSuccessor<UnwrapRefType<TRank>>::value) {
+    return CircularFusedSoftSuccessor<TRank>(t_rank);
+  } else {
+    return CircularSoftSuccessor<TRank, TSelect>(t_rank, t_select, t_bitvector_size);
+  }
+}
 }
 
 #endif //SRI_SEQUENCE_OPS_H_
@@ -0,0 +1,292 @@
+//
+// Sharded index: the documents of a collection split into shards with their own index, queried in parallel.
+//
+
+#ifndef SRI_SHARDS_H_
+#define SRI_SHARDS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sdsl/io.hpp>
+
+#include "config.h"
+#include "build_report.h"
+#include "documents.h"
+#include "parallel.h"
+
+namespace sri {
+
+//! Shard of a collection, i.e., a contiguous group of whole documents with its own index
+struct Shard {
+  std::string file; // Index file
+  std::size_t offset = 0; // Global text position of the first symbol of the shard
+  std::size_t size = 0; // Length of the shard text (without the terminating zero symbol)
+  std::size_t first_doc = 0; // Global number of the first document of the shard
+  std::size_t n_docs = 0;
+};
+
+//! Manifest of a sharded index, which maps the local text positions of each shard to the global ones.
+//! The global text is the concatenation of the shard texts, i.e., of all the documents with their separators, so it
+//! is the same text indexed by a single index of the collection. A shard never splits a document, so the occurrences of
+//! a pattern without the separator are inside the shards.
+//! It is stored as JSON, with the shard files relative to the folder of the manifest.
+struct ShardManifest {
+  inline static const std::string kExtension = ".shards";
+
+  JSON params = JSON::object(); // Parameters of the shard indexes (e.g., variant and subsampling parameter)
+  uint8_t doc_separator = 1;
+  std::size_t size = 0; // Length of the global text (without the terminating zero symbol)
+  std::vector<Shard> shards;
+
+  //! Global text position of the local position of the shard
+  std::size_t toGlobal(std::size_t t_shard, std::size_t t_pos) const { return shards[t_shard].offset + t_pos; }
+
+  void store(const std::filesystem::path &t_file) const {
+    const auto dir = std::filesystem::absolute(t_file).parent_path();
+    JSON manifest = {
+        {"params", params},
+        {"doc_separator", doc_separator},
+        {"size", size},
+        {"shards", JSON::array()}
+    };
+    for (const auto &shard : shards) {
+      manifest["shards"].push_back({
+                                       {"file", std::filesystem::absolute(shard.file).lexically_relative(dir).string()},
+                                       {"offset", shard.offset},
+                                       {"size", shard.size},
+                                       {"first_doc", shard.first_doc},
+                                       {"n_docs", shard.n_docs}
+                                   });
+    }
+
+    std::ofstream out(t_file);
+    out << manifest.dump(2) << std::endl;
+  }
+
+  //! Load the manifest, with the shard files resolved against its folder
+  static ShardManifest load(const std::filesystem::path &t_file) {
+    std::ifstream in(t_file);
+    if (!in) {
+      throw std::invalid_argument("Error: cannot open shard manifest \"" + t_file.string() + "\"");
+    }
+
+    ShardManifest manifest;
+    try {
+      JSON json;
+      in >> json;
+      manifest.params = json.value("params", JSON::object());
+      manifest.doc_separator = json.at("doc_separator").get<uint8_t>();
+      manifest.size = json.at("size").get<std::size_t>();
+
+      const auto dir = std::filesystem::absolute(t_file).parent_path();
+      for (const auto &item : json.at("shards")) {
+        Shard shard;
+        shard.file = (dir / item.at("file").get<std::string>()).lexically_normal().string();
+        shard.offset = item.at("offset").get<std::size_t>();
+        shard.size = item.at("size").get<std::size_t>();
+        shard.first_doc = item.at("first_doc").get<std::size_t>();
+        shard.n_docs = item.at("n_docs").get<std::size_t>();
+        manifest.shards.emplace_back(std::move(shard));
+      }
+    } catch (const JSON::exception &e) {
+      throw std::invalid_argument("Error: malformed shard manifest \"" + t_file.string() + "\": " + e.what());
+    }
+
+    return manifest;
+  }
+};
+
+//! Split the documents into (at most) t_n_shards contiguous non-empty groups with a similar number of bytes
+//! \return Number of documents of each group
+inline std::vector<std::size_t> splitDocuments(const std::vector<std::string> &t_files, std::size_t t_n_shards) {
+  t_n_shards = std::max<std::size_t>(1, std::min(t_n_shards, t_files.size()));
+
+  // Each document is followed by its separator
+  std::vector<std::size_t> sizes;
+  std::size_t total = 0;
+  for (const auto &file : t_files) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(file, ec);
+    if (ec) {
+      throw std::invalid_argument("Error: cannot open document \"" + file + "\"");
+    }
+    sizes.emplace_back(size + 1);
+    total += size + 1;
+  }
+
+  std::vector<std::size_t> groups;
+  std::size_t acc = 0, n_docs = 0;
+  for (std::size_t i = 0; i < sizes.size(); ++i) {
+    acc += sizes[i];
+    ++n_docs;
+    const auto remaining_docs = sizes.size() - i - 1;
+    const auto remaining_groups = t_n_shards - groups.size() - 1;
+    // Close the group once it reaches its share of the bytes, keeping a document for each of the next groups
+    if (remaining_groups && (remaining_docs == remaining_groups
+        || blockBoundary(total, t_n_shards, groups.size() + 1) <= acc)) {
+      groups.emplace_back(n_docs);
+      n_docs = 0;
+    }
+  }
+  groups.emplace_back(n_docs);
+
+  return groups;
+}
+
+//! Output file of the shard, e.g., "collection.shard0.sri_va" for "collection.sri_va"
+inline std::string shardFile(const std::filesystem::path &t_output_file, std::size_t t_shard) {
+  auto file = t_output_file;
+  file.replace_extension(".shard" + std::to_string(t_shard) + t_output_file.extension().string());
+  return file.string();
+}
+
+//! Manifest file of the sharded index, e.g., "collection.sri_va.shards" for "collection.sri_va"
+inline std::string shardManifestFile(const std::filesystem::path &t_output_file) {
+  return t_output_file.string() + ShardManifest::kExtension;
+}
+
+//! Build a sharded index of the documents: split them into shards, concatenate and index each shard in its own folder,
+//! and store the shard manifest.
+//! Up to t_n_jobs shards are built at the same time, sharing the construction threads. With the construction report,
+//! whose stages are nested, the shards are built one at a time.
+//! \param t_build Function t_build(tt_text_file, tt_tmp_dir, tt_output_file) that builds and stores the index of a shard
+//! \param t_params Parameters of the shard indexes recorded in the manifest
+//! \return Manifest file
+template<typename TBuild>
+std::string constructShards(const std::vector<std::string> &t_files,
+                            std::size_t t_n_shards,
+                            uint8_t t_separator,
+                            const std::filesystem::path &t_tmp_dir,
+                            const std::string &t_output_file,
+                            std::size_t t_n_jobs,
+                            const TBuild &t_build,
+                            JSON t_params = JSON::object()) {
+  const auto groups = splitDocuments(t_files, t_n_shards);
+
+  ShardManifest manifest;
+  manifest.params = std::move(t_params);
+  manifest.doc_separator = t_separator;
+  manifest.shards.resize(groups.size());
+  for (std::size_t i = 0, first_doc = 0; i < groups.size(); first_doc += groups[i++]) {
+    manifest.shards[i].file = shardFile(t_output_file, i);
+    manifest.shards[i].first_doc = first_doc;
+    manifest.shards[i].n_docs = groups[i];
+  }
+
+  if (BuildReport::instance().enabled()) t_n_jobs = 1;
+  t_n_jobs = std::max<std::size_t>(1, std::min(t_n_jobs, groups.size()));
+  const auto n_threads = constructionThreads();
+  setConstructionThreads(n_threads / t_n_jobs);
+
+  try {
+    ThreadPool pool(t_n_jobs);
+    pool.forEach(groups.size(), [&](std::size_t tt_i) {
+      auto &shard = manifest.shards[tt_i];
+      const auto dir = t_tmp_dir / ("shard" + std::to_string(tt_i));
+      std::filesystem::create_directories(dir);
+
+      const auto text_file = (dir / "collection").string();
+      const auto first = t_files.begin() + shard.first_doc;
+      concatenateDocuments(std::vector<std::string>(first, first + shard.n_docs), t_separator, text_file);
+      shard.size = std::filesystem::file_size(text_file);
+
+      t_build(text_file, dir, shard.file);
+    });
+  } catch (...) {
+    setConstructionThreads(n_threads);
+    throw;
+  }
+  setConstructionThreads(n_threads);
+
+  for (std::size_t i = 1; i < manifest.shards.size(); ++i) {
+    manifest.shards[i].offset = manifest.shards[i - 1].offset + manifest.shards[i - 1].size;
+  }
+  manifest.size = manifest.shards.back().offset + manifest.shards.back().size;
+
+  const auto manifest_file = shardManifestFile(t_output_file);
+  manifest.store(manifest_file);
+  return manifest_file;
+}
+
+//! Sharded index, whose queries fan out to the shard indexes on a thread pool.
+//! The positions are global text positions, i.e., the ones of a single index of the collection.
+template<typename TIndex>
+class ShardedIndex {
+ public:
+  //! Load the shard indexes of the manifest (in parallel)
+  //! \param t_n_threads Number of threads of the queries, including the calling one
+  ShardedIndex(const std::filesystem::path &t_manifest_file, std::size_t t_n_threads)
+      : manifest_{ShardManifest::load(t_manifest_file)},
+        indexes_(manifest_.shards.size()),
+        pool_{std::make_unique<ThreadPool>(std::max<std::size_t>(1, t_n_threads))} {
+    pool_->forEach(indexes_.size(), [this](std::size_t tt_i) {
+      if (!sdsl::load_from_file(indexes_[tt_i], manifest_.shards[tt_i].file)) {
+        throw std::invalid_argument("Error: cannot load shard \"" + manifest_.shards[tt_i].file + "\"");
+      }
+    });
+  }
+
+  const ShardManifest &manifest() const { return manifest_; }
+
+  std::size_t numShards() const { return indexes_.size(); }
+
+  const TIndex &shard(std::size_t t_i) const { return indexes_[t_i]; }
+
+  //! Length of the global text (including the terminating zero symbol)
+  std::size_t sizeSequence() const { return manifest_.size + 1; }
+
+  std::size_t SubsampleRate() const { return indexes_.empty() ? 0 : indexes_[0].SubsampleRate(); }
+
+  std::size_t sizeInBytes() const {
+    std::size_t size = 0;
+    for (const auto &shard : manifest_.shards) size += std::filesystem::file_size(shard.file);
+    return size;
+  }
+
+  //! Number of occurrences of the pattern, i.e., the sum of the sizes of its ranges in the shards
+  std::size_t Count(const std::string &t_pattern) const {
+    std::vector<std::size_t> counts(indexes_.size());
+    pool_->forEach(indexes_.size(), [&](std::size_t tt_i) {
+      const auto range = indexes_[tt_i].Count(t_pattern);
+      counts[tt_i] = range.first < range.second ? range.second - range.first : 0; // Range [start, end)
+    });
+
+    std::size_t count = 0;
+    for (auto c : counts) count += c;
+    return count;
+  }
+
+  //! Global text positions of the occurrences of the pattern, grouped by shard (in shard order)
+  std::vector<std::size_t> Locate(const std::string &t_pattern) const {
+    std::vector<std::vector<std::size_t>> occs(indexes_.size());
+    pool_->forEach(indexes_.size(), [&](std::size_t tt_i) {
+      occs[tt_i] = indexes_[tt_i].Locate(t_pattern);
+      for (auto &occ : occs[tt_i]) occ = manifest_.toGlobal(tt_i, occ);
+    });
+
+    std::size_t n = 0;
+    for (const auto &shard_occs : occs) n += shard_occs.size();
+    std::vector<std::size_t> result;
+    result.reserve(n);
+    for (const auto &shard_occs : occs) result.insert(result.end(), shard_occs.begin(), shard_occs.end());
+    return result;
+  }
+
+ private:
+  ShardManifest manifest_;
+  std::vector<TIndex> indexes_;
+  std::unique_ptr<ThreadPool> pool_;
+};
+
+}
+
+#endif //SRI_SHARDS_H_
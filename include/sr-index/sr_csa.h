@@ -122,7 +122,7 @@ class SrCSABase : public RCSAWithBWTRun<TStorage, TAlphabet, TPsiRLE, TBvMark, T
                             const TIsRunEmpty &t_is_run_empty) {
     auto bv_mark_rank = this->template loadBVRank<TBvMark>(key(ItemKey::MARKS), t_source, true);
     auto bv_mark_select = this->template loadBVSelect<TBvMark>(key(ItemKey::MARKS), t_source, true);
-    auto successor = CircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
+    auto successor = buildCircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
 
     auto cref_mark_to_sample_idx = this->template loadItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), t_source);
     auto get_mark_to_sample_idx = RandomAccessForTwoContainersDefault(cref_mark_to_sample_idx, false);
@@ -196,6 +196,18 @@ class SrCSASlim : public SrCSABase<TStorage, TAlphabet, TPsiRLE, TBvMark, TMarkT
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("samples_idx", this->template serializeItem<TBvSampleIdx>(key(ItemKey::SAMPLES_IDX), nulls, child, "samples_idx"));
+    parts.emplace_back("samples_idx_rank", this->template serializeRank<TBvSampleIdx>(key(ItemKey::SAMPLES_IDX), nulls, child, "samples_idx_rank"));
+    parts.emplace_back("run_cumulative_count", this->template serializeItem<TRunCumulativeCount>(key(ItemKey::RUN_CUMULATIVE_COUNT), nulls, child, "run_cumulative_count"));
+
+    return parts;
+  }
+
  protected:
 
   using Base::key;
@@ -412,6 +424,18 @@ class SrCSA : public SrCSABase<TStorage, TAlphabet, TPsiRLE, TBvMark, TMarkToSam
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("samples_idx", this->template serializeItem<TBvSamplePos>(key(ItemKey::SAMPLES_IDX), nulls, child, "samples_idx"));
+    parts.emplace_back("samples_idx_rank", this->template serializeRank<TBvSamplePos>(key(ItemKey::SAMPLES_IDX), nulls, child, "samples_idx_rank"));
+    parts.emplace_back("samples_idx_select", this->template serializeSelect<TBvSamplePos>(key(ItemKey::SAMPLES_IDX), nulls, child, "samples_idx_select"));
+
+    return parts;
+  }
+
  protected:
 
   using Base::key;
@@ -433,6 +457,8 @@ class SrCSA : public SrCSABase<TStorage, TAlphabet, TPsiRLE, TBvMark, TMarkToSam
 
     this->template loadItem<TBvSamplePos>(key(ItemKey::SAMPLES_IDX), t_source, true);
     this->template loadBVRank<TBvSamplePos>(key(ItemKey::SAMPLES_IDX), t_source, true);
+    // In the serialization order, so a stored index (with extra items after these ones) is loaded correctly
+    this->template loadBVSelect<TBvSamplePos>(key(ItemKey::SAMPLES_IDX), t_source, true);
   }
 
   void constructIndex(TSource &t_source) override {
@@ -587,6 +613,16 @@ class SrCSAValidMark : public TSrCSA {
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("valid_marks", this->template serializeItem<TBvValidMark>(key(ItemKey::VALID_MARKS), nulls, child, "valid_marks"));
+
+    return parts;
+  }
+
  protected:
 
   using Base::key;
@@ -640,7 +676,7 @@ class SrCSAValidMark : public TSrCSA {
                             const TConstructValidateSample &t_construct_validate_sample) {
     auto bv_mark_rank = this->template loadBVRank<BvMark>(key(ItemKey::MARKS), t_source, true);
     auto bv_mark_select = this->template loadBVSelect<BvMark>(key(ItemKey::MARKS), t_source, true);
-    auto successor = CircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
+    auto successor = buildCircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
 
     auto cref_mark_to_sample_idx = this->template loadItem<MarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), t_source);
     auto cref_bv_valid_mark = this->template loadItem<TBvValidMark>(key(ItemKey::VALID_MARKS), t_source, true);
@@ -690,6 +726,17 @@ class SrCSAValidArea : public SrCSAValidMark<TSrCSA, TBvValidMark> {
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("valid_marks_rank", this->template serializeRank<TBvValidMark, typename TBvValidMark::rank_0_type>(key(ItemKey::VALID_MARKS), nulls, child, "valid_marks_rank"));
+    parts.emplace_back("valid_areas", this->template serializeItem<TValidArea>(key(ItemKey::VALID_AREAS), nulls, child, "valid_areas"));
+
+    return parts;
+  }
+
  protected:
 
   using Base::key;
@@ -758,29 +805,30 @@ void construct(
   Config& t_config
 ) {
   constructRCSAWithBWTRuns<t_width, TBvMark>(t_data_path, t_config);
+  constructPsiCore<t_width, TPsiCore>(t_config);
 
   auto subsample_rate = t_index.SubsampleRate();
 
   constructSrCSACommonsWithBWTRuns<t_width, TBvMark>(subsample_rate, t_config);
 
   // Construct samples' indices sorted by alphabet
-  if (!sdsl::cache_file_exists(KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config)) {
-    auto event = sdsl::memory_monitor::event("Samples");
+  if (!sri::cacheFileExists(KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config)) {
+    sri::StageEvent event("Samples");
     constructSamplesSortedByAlphabet(t_config);
   }
 
   auto prefix_key = std::to_string(subsample_rate) + "_";
 
   // Construct subsampling backward of samples sorted by alphabet
-  if (!sdsl::cache_file_exists(KeySortedByAlphabet(prefix_key + conf::KEY_BWT_RUN_FIRST_TEXT_POS), t_config)) {
-    auto event = sdsl::memory_monitor::event("Subsampling");
+  if (!sri::cacheFileExists(KeySortedByAlphabet(prefix_key + conf::KEY_BWT_RUN_FIRST_TEXT_POS), t_config)) {
+    sri::StageEvent event("Subsampling");
     constructSubsamplingBackwardSamplesSortedByAlphabet(subsample_rate, t_config);
   }
 
   // Construct subsampling indices backward of samples sorted by alphabet
-  if (!sdsl::cache_file_exists<TBVSampleIdx>(KeySortedByAlphabet(prefix_key + conf::KEY_BWT_RUN_FIRST_IDX), t_config)) {
-    auto event = sdsl::memory_monitor::event("Subsampling");
-    const auto r = sdsl::int_vector_buffer<>(sdsl::cache_file_name(conf::KEY_BWT_RUN_FIRST, t_config)).size();
+  if (!sri::cacheFileExists<TBVSampleIdx>(KeySortedByAlphabet(prefix_key + conf::KEY_BWT_RUN_FIRST_IDX), t_config)) {
+    sri::StageEvent event("Subsampling");
+    const auto r = sdsl::int_vector_buffer<>(sri::cacheFileName(conf::KEY_BWT_RUN_FIRST, t_config)).size();
 
     constructBitVectorFromIntVector<TBVSampleIdx>(KeySortedByAlphabet(prefix_key + conf::KEY_BWT_RUN_FIRST_IDX),
                                                   t_config,
@@ -798,28 +846,25 @@ void construct(SrCSA<TStorage, TAlphabet<t_width>, TPsiCore, TBvMark, TMarkToSam
                const std::string &t_data_path,
                sri::Config &t_config) {
   constructRCSAWithBWTRuns<t_width, TBvMark>(t_data_path, t_config);
+  constructPsiCore<t_width, TPsiCore>(t_config);
 
   auto subsample_rate = t_index.SubsampleRate();
 
   constructSrCSACommonsWithBWTRuns<t_width, TBvMark>(subsample_rate, t_config);
 
-  std::size_t n;
-  {
-    sdsl::int_vector_buffer<t_width> buf(sdsl::cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
-    n = buf.size();
-  }
+  const auto n = bwtSize(t_config);
 
   auto prefix = std::to_string(subsample_rate) + "_";
 
   {
     // Construct subsampling backward of samples (text positions of BWT-run last letter)
-    auto event = sdsl::memory_monitor::event("Subsampling");
+    sri::StageEvent event("Subsampling");
     auto key = prefix + conf::KEY_BWT_RUN_FIRST;
-    if (!sdsl::cache_file_exists(key, t_config)) {
+    if (!sri::cacheFileExists(key, t_config)) {
       constructSubsamplingBackwardSamplesPosition(subsample_rate, t_config);
     }
 
-    if (!sdsl::cache_file_exists<TBvSamplePos>(key, t_config)) {
+    if (!sri::cacheFileExists<TBvSamplePos>(key, t_config)) {
       constructBitVectorFromIntVector<TBvSamplePos>(key, t_config, n, false);
     }
   }
@@ -843,16 +888,16 @@ void construct(SrCSAValidMark<TSrCSA<TStorage, TAlphabet<t_width>>, TBvValidMark
 
   {
     // Construct subsampling validity marks and areas
-    auto event = sdsl::memory_monitor::event("Subsampling Validity");
+    sri::StageEvent event("Subsampling Validity");
     auto key = prefix_key + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_MARK;
-    if (!sdsl::cache_file_exists(key, t_config)) {
+    if (!sri::cacheFileExists(key, t_config)) {
       constructSubsamplingBackwardMarksValidity(subsample_rate, t_config);
     }
 
-    if (!sdsl::cache_file_exists<TBvValidMark>(key, t_config)) {
+    if (!sri::cacheFileExists<TBvValidMark>(key, t_config)) {
       std::size_t r_prime;
       {
-        sdsl::int_vector_buffer<> buf(sdsl::cache_file_name(prefix_key + conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config));
+        sdsl::int_vector_buffer<> buf(sri::cacheFileName(prefix_key + conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config));
         r_prime = buf.size();
       }
       constructBitVectorFromIntVector<TBvValidMark,
@@ -879,12 +924,12 @@ inline void constructSubsamplingBackwardSamplesForPhiForwardWithBWTRuns(std::siz
 
   // Samples
   sdsl::int_vector<> samples; // BWT-run starts positions in text
-  sdsl::load_from_cache(samples, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+  sri::loadFromCache(samples, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
   auto r = samples.size();
   auto log_r = sdsl::bits::hi(r) + 1;
 
   sdsl::int_vector<> sorted_samples_idx;
-  sdsl::load_from_cache(sorted_samples_idx, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
+  sri::loadFromCache(sorted_samples_idx, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
 
   // We must sub-sample the samples associated to the first and last marks in the text
   const auto req_samples_idx = getExtremes(t_config, conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX);
@@ -904,7 +949,7 @@ inline void constructSubsamplingBackwardSamplesForPhiForwardWithBWTRuns(std::siz
     std::copy(subsamples_idx_vec.begin(), subsamples_idx_vec.end(), subsamples_idx.begin());
 
     // Store sub-sample indices sorted by BWT positions
-    sdsl::store_to_cache(subsamples_idx, prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
+    sri::storeToCache(subsamples_idx, prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
   }
 
   {
@@ -913,7 +958,7 @@ inline void constructSubsamplingBackwardSamplesForPhiForwardWithBWTRuns(std::siz
     std::transform(subsamples_idx.begin(), subsamples_idx.end(), subsamples.begin(),
                    [&samples](auto tt_i) { return samples[tt_i]; });
 
-    sdsl::store_to_cache(subsamples, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+    sri::storeToCache(std::move(subsamples), prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
   }
 }
 
@@ -937,7 +982,7 @@ void constructSubsamplingBackwardMarksForPhiForwardWithBWTRuns(std::size_t t_sub
     r_prime = subsample_to_mark_links.size();
 
     sdsl::int_vector<> bwt_run_ends_text_pos;
-    sdsl::load_from_cache(bwt_run_ends_text_pos, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+    sri::loadFromCache(bwt_run_ends_text_pos, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
 
     subsampled_mark_text_pos = sdsl::int_vector(r_prime, 0, bwt_run_ends_text_pos.width());
     std::transform(subsample_to_mark_links.begin(),
@@ -946,22 +991,13 @@ void constructSubsamplingBackwardMarksForPhiForwardWithBWTRuns(std::size_t t_sub
                    [&bwt_run_ends_text_pos](auto tt_i) { return bwt_run_ends_text_pos[tt_i]; });
   }
 
-  auto log_r_prime = sdsl::bits::hi(r_prime) + 1;
-
   // Links from sub-sampled marks (sorted by text position) to sub-samples indices. Note that, initially, these are the indices of sub-sample in BWT.
-  sdsl::int_vector<> subsampled_mark_to_subsample_links(r_prime, 0, log_r_prime);
-  std::iota(subsampled_mark_to_subsample_links.begin(), subsampled_mark_to_subsample_links.end(), 0);
-
   // Sort indexes by text positions of its marks, becoming in the links from the sub-sampled marks to sub-sampled samples.
-  std::sort(subsampled_mark_to_subsample_links.begin(),
-            subsampled_mark_to_subsample_links.end(),
-            [&subsampled_mark_text_pos](const auto &tt_a, const auto &tt_b) {
-              return subsampled_mark_text_pos[tt_a] < subsampled_mark_text_pos[tt_b];
-            });
+  sdsl::int_vector<> subsampled_mark_to_subsample_links = sortIndices(subsampled_mark_text_pos);
 
-  sdsl::store_to_cache(subsampled_mark_text_pos, prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_BY_FIRST, t_config);
+  sri::storeToCache(std::move(subsampled_mark_text_pos), prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_BY_FIRST, t_config);
 
-  sdsl::store_to_cache(subsampled_mark_to_subsample_links,
+  sri::storeToCache(std::move(subsampled_mark_to_subsample_links),
                        prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX,
                        t_config);
 }
@@ -970,18 +1006,18 @@ template<uint8_t t_width>
 auto computeSampleToMarkLinksForPhiForward(const std::string &t_prefix, sdsl::cache_config &t_config) {
   // Sub-sampled indices of samples
   sdsl::int_vector<> subsamples_idx;
-  sdsl::load_from_cache(subsamples_idx, t_prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
+  sri::loadFromCache(subsamples_idx, t_prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
 
   sdsl::int_vector<> subsample_to_mark_links(subsamples_idx.size(), 0, subsamples_idx.width());
 
   // LF
   RLEString<> bwt_rle;
-  sdsl::load_from_cache(bwt_rle, conf::KEY_BWT_RLE, t_config);
+  sri::loadFromCache(bwt_rle, conf::KEY_BWT_RLE, t_config);
   auto get_char = buildRandomAccessForContainer(std::cref(bwt_rle));
   auto get_rank_of_char = buildRankOfChar(std::cref(bwt_rle));
 
   Alphabet<t_width> alphabet;
-  sdsl::load_from_cache(alphabet, conf::KEY_ALPHABET, t_config);
+  sri::loadFromCache(alphabet, conf::KEY_ALPHABET, t_config);
   auto n = alphabet.C[alphabet.sigma];
 
   auto get_f = [&alphabet](auto tt_symbol) { return alphabet.C[tt_symbol]; };
@@ -989,7 +1025,7 @@ auto computeSampleToMarkLinksForPhiForward(const std::string &t_prefix, sdsl::ca
 
   // Psi
   PsiCoreRLE<> psi_core;
-  sdsl::load_from_cache(psi_core, sdsl::conf::KEY_PSI, t_config, true);
+  sri::loadFromCache(psi_core, sdsl::conf::KEY_PSI, t_config, true);
   auto psi_select = [&psi_core](auto tt_c, auto tt_rnk) { return psi_core.select(tt_c, tt_rnk); };
 
   auto get_c = [&alphabet](auto tt_index) { return computeCForSAIndex(alphabet.C, tt_index); };
@@ -999,7 +1035,7 @@ auto computeSampleToMarkLinksForPhiForward(const std::string &t_prefix, sdsl::ca
 
   // Marks positions
   sdsl::int_vector<> bwt_run_ends;
-  sdsl::load_from_cache(bwt_run_ends, conf::KEY_BWT_RUN_LAST, t_config);
+  sri::loadFromCache(bwt_run_ends, conf::KEY_BWT_RUN_LAST, t_config);
 
   auto rank_bwt_run_ends = [&bwt_run_ends](const auto &tt_k) {
     return std::lower_bound(bwt_run_ends.begin(), bwt_run_ends.end(), tt_k) - bwt_run_ends.begin();
@@ -1007,7 +1043,7 @@ auto computeSampleToMarkLinksForPhiForward(const std::string &t_prefix, sdsl::ca
 
   // Samples positions
   sdsl::int_vector<> bwt_run_starts;
-  sdsl::load_from_cache(bwt_run_starts, conf::KEY_BWT_RUN_FIRST, t_config);
+  sri::loadFromCache(bwt_run_starts, conf::KEY_BWT_RUN_FIRST, t_config);
 
   // Compute links from samples to marks
   for (int i = 0; i < subsamples_idx.size(); ++i) {
@@ -1020,48 +1056,48 @@ auto computeSampleToMarkLinksForPhiForward(const std::string &t_prefix, sdsl::ca
 
 template<uint8_t t_width, typename TBvMark>
 void constructSrCSACommonsWithBWTRuns(std::size_t t_subsample_rate, sdsl::cache_config &t_config) {
-  const auto n = sdsl::int_vector_buffer<>(cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config)).size();
+  const auto n = bwtSize(t_config);
 
   auto prefix = std::to_string(t_subsample_rate) + "_";
 
   // Sort samples (BWT-run last letter) by its text positions
-  if (!sdsl::cache_file_exists(conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config)) {
-    auto event = sdsl::memory_monitor::event("Subsampling");
+  if (!sri::cacheFileExists(conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config)) {
+    sri::StageEvent event("Subsampling");
     constructSortedIndices(conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX);
   }
 
   // Construct subsampling backward of samples (text positions of BWT-run first letter)
-  if (!sdsl::cache_file_exists(prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config)) {
-    auto event = sdsl::memory_monitor::event("Subsampling");
+  if (!sri::cacheFileExists(prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config)) {
+    sri::StageEvent event("Subsampling");
     constructSubsamplingBackwardSamplesForPhiForwardWithBWTRuns(t_subsample_rate, t_config);
   }
 
   // Construct subsampling backward of marks (text positions of BWT-run last letter)
-  if (!sdsl::cache_file_exists(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config)) {
-    auto event = sdsl::memory_monitor::event("Subsampling");
+  if (!sri::cacheFileExists(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config)) {
+    sri::StageEvent event("Subsampling");
     constructSubsamplingBackwardMarksForPhiForwardWithBWTRuns<t_width>(t_subsample_rate, t_config);
   }
 
   // Construct successor on the text positions of sub-sampled BWT-run last letter
-  if (!sdsl::cache_file_exists<TBvMark>(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_BY_FIRST, t_config)) {
-    auto event = sdsl::memory_monitor::event("Successor");
+  if (!sri::cacheFileExists<TBvMark>(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_BY_FIRST, t_config)) {
+    sri::StageEvent event("Successor");
     constructBitVectorFromIntVector<TBvMark>(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_BY_FIRST, t_config, n, false);
   }
 }
 
 inline void constructSamplesSortedByAlphabet(sdsl::cache_config &t_config) {
   PsiCoreRLE<> psi_rle;
-  sdsl::load_from_cache(psi_rle, sdsl::conf::KEY_PSI, t_config, true);
+  sri::loadFromCache(psi_rle, sdsl::conf::KEY_PSI, t_config, true);
 
   // Samples positions
   sdsl::int_vector<> samples;
-  sdsl::load_from_cache(samples, conf::KEY_BWT_RUN_FIRST, t_config);
+  sri::loadFromCache(samples, conf::KEY_BWT_RUN_FIRST, t_config);
 
   const std::size_t buffer_size = 1 << 20;
   auto r = samples.size();
   auto log_r = sdsl::bits::hi(r) + 1;
   // BWT-run samples sorted by alphabet
-  auto key = sdsl::cache_file_name(KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config);
+  auto key = sri::cacheFileName(KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config);
   sdsl::int_vector_buffer<> samples_idx_sorted(key, std::ios::out, buffer_size, log_r);
   std::size_t n_runs = 0;
   auto report = [&samples, &samples_idx_sorted, &n_runs](const auto &tt_run_start, const auto &tt_run_end) {
@@ -1071,7 +1107,7 @@ inline void constructSamplesSortedByAlphabet(sdsl::cache_config &t_config) {
   };
 
   // Cumulative number of BWT-runs per symbols
-  key = sdsl::cache_file_name(conf::KEY_BWT_RUN_CUMULATIVE_COUNT, t_config);
+  key = sri::cacheFileName(conf::KEY_BWT_RUN_CUMULATIVE_COUNT, t_config);
   sdsl::int_vector_buffer<> cumulative(key, std::ios::out, buffer_size, log_r);
 
   auto sigma = psi_rle.sigma();
@@ -1081,9 +1117,9 @@ inline void constructSamplesSortedByAlphabet(sdsl::cache_config &t_config) {
   }
 
   samples_idx_sorted.close();
-  sdsl::register_cache_file(KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config);
+  sri::registerCacheFile(KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config);
   cumulative.close();
-  sdsl::register_cache_file(conf::KEY_BWT_RUN_CUMULATIVE_COUNT, t_config);
+  sri::registerCacheFile(conf::KEY_BWT_RUN_CUMULATIVE_COUNT, t_config);
 }
 
 inline void constructSubsamplingBackwardSamplesSortedByAlphabet(std::size_t t_subsample_rate, sdsl::cache_config &t_config) {
@@ -1093,12 +1129,12 @@ inline void constructSubsamplingBackwardSamplesSortedByAlphabet(std::size_t t_su
   sdsl::int_vector<> subsamples_idx_to_sorted;
   {
     sdsl::int_vector<> samples_idx_sorted;
-    sdsl::load_from_cache(samples_idx_sorted, KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config);
+    sri::loadFromCache(samples_idx_sorted, KeySortedByAlphabet(conf::KEY_BWT_RUN_FIRST_IDX), t_config);
 
     sdsl::bit_vector subsamples_idx_bv;
     {
       sdsl::int_vector<> subsamples_idx;
-      sdsl::load_from_cache(subsamples_idx, key_prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
+      sri::loadFromCache(subsamples_idx, key_prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
 
       subsamples_idx_bv = constructBitVectorFromIntVector(subsamples_idx, samples_idx_sorted.size(), false);
 
@@ -1107,12 +1143,12 @@ inline void constructSubsamplingBackwardSamplesSortedByAlphabet(std::size_t t_su
     sdsl::bit_vector::rank_1_type rank_subsamples_idx_bv(&subsamples_idx_bv);
 
     sdsl::int_vector<> subsamples;
-    sdsl::load_from_cache(subsamples, key_prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+    sri::loadFromCache(subsamples, key_prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
 
-    auto key = sdsl::cache_file_name(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS), t_config);
+    auto key = sri::cacheFileName(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS), t_config);
     sdsl::int_vector_buffer<> subsamples_sorted(key, std::ios::out, buffer_size, subsamples.width());
 
-    key = sdsl::cache_file_name(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_IDX), t_config);
+    key = sri::cacheFileName(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_IDX), t_config);
     sdsl::int_vector_buffer<> subsamples_idx_sorted(key, std::ios::out, buffer_size, subsamples_idx_to_sorted.width());
 
     std::size_t i = 0;
@@ -1129,14 +1165,14 @@ inline void constructSubsamplingBackwardSamplesSortedByAlphabet(std::size_t t_su
     }
 
     subsamples_sorted.close();
-    sdsl::register_cache_file(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS), t_config);
+    sri::registerCacheFile(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS), t_config);
     subsamples_idx_sorted.close();
-    sdsl::register_cache_file(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_IDX), t_config);
+    sri::registerCacheFile(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_FIRST_IDX), t_config);
   }
 
   sdsl::int_vector<> mark_to_sample_idx;
-  sdsl::load_from_cache(mark_to_sample_idx, key_prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config);
-  auto key = sdsl::cache_file_name(
+  sri::loadFromCache(mark_to_sample_idx, key_prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX, t_config);
+  auto key = sri::cacheFileName(
       KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX), t_config);
   sdsl::int_vector_buffer<> mark_to_sample_idx_sorted(key, std::ios::out, buffer_size, mark_to_sample_idx.width());
   for (const auto &idx : mark_to_sample_idx) {
@@ -1144,7 +1180,7 @@ inline void constructSubsamplingBackwardSamplesSortedByAlphabet(std::size_t t_su
   }
 
   mark_to_sample_idx_sorted.close();
-  sdsl::register_cache_file(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX),
+  sri::registerCacheFile(KeySortedByAlphabet(key_prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_TO_FIRST_IDX),
                             t_config);
 }
 
@@ -1152,31 +1188,31 @@ inline void constructSubsamplingBackwardSamplesPosition(std::size_t t_subsample_
   auto prefix = std::to_string(t_subsample_rate) + "_";
 
   sdsl::int_vector<> samples_pos; // BWT-run starts positions in SA
-  sdsl::load_from_cache(samples_pos, conf::KEY_BWT_RUN_FIRST, t_config);
+  sri::loadFromCache(samples_pos, conf::KEY_BWT_RUN_FIRST, t_config);
 
   sdsl::int_vector<> subsamples_idx; // Sub-samples indices
-  sdsl::load_from_cache(subsamples_idx, prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
+  sri::loadFromCache(subsamples_idx, prefix + conf::KEY_BWT_RUN_FIRST_IDX, t_config);
 
   // Compute sub-samples positions
   sdsl::int_vector<> subsamples_pos(subsamples_idx.size(), 0, samples_pos.width());
   std::transform(subsamples_idx.begin(), subsamples_idx.end(), subsamples_pos.begin(),
                  [&samples_pos](auto tt_i) { return samples_pos[tt_i]; });
 
-  sdsl::store_to_cache(subsamples_pos, prefix + conf::KEY_BWT_RUN_FIRST, t_config);
+  sri::storeToCache(std::move(subsamples_pos), prefix + conf::KEY_BWT_RUN_FIRST, t_config);
 }
 
 inline void constructSubsamplingBackwardMarksValidity(std::size_t t_subsample_rate, sdsl::cache_config &t_config) {
   auto prefix = std::to_string(t_subsample_rate) + "_";
 
   sdsl::int_vector<> marks;
-  sdsl::load_from_cache(marks, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+  sri::loadFromCache(marks, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
   sdsl::int_vector<> sorted_marks_idx;
-  sdsl::load_from_cache(sorted_marks_idx, conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX, t_config);
+  sri::loadFromCache(sorted_marks_idx, conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX, t_config);
   auto it_marks_idx = sorted_marks_idx.end();
   auto get_next_mark = [&marks, &it_marks_idx]() { return marks[*(--it_marks_idx)]; };
 
   sdsl::int_vector<> submarks;
-  sdsl::load_from_cache(submarks, prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_BY_FIRST, t_config);
+  sri::loadFromCache(submarks, prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_BY_FIRST, t_config);
   std::sort(submarks.begin(), submarks.end());
   auto it_submarks = submarks.end();
   auto get_next_submark = [&it_submarks]() { return *(--it_submarks); };
@@ -1196,13 +1232,13 @@ inline void constructSubsamplingBackwardMarksValidity(std::size_t t_subsample_ra
 
   const std::size_t buffer_size = 1 << 20;
   sdsl::int_vector_buffer<> valid_submarks(
-      sdsl::cache_file_name(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_MARK, t_config),
+      sri::cacheFileName(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_MARK, t_config),
       std::ios::out,
       buffer_size,
       sdsl::bits::hi(r_prime) + 1);
 
   sdsl::int_vector_buffer<> valid_areas(
-      sdsl::cache_file_name(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_AREA, t_config),
+      sri::cacheFileName(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_AREA, t_config),
       std::ios::out,
       buffer_size,
       sdsl::bits::hi(max_valid_area) + 1);
@@ -1213,9 +1249,9 @@ inline void constructSubsamplingBackwardMarksValidity(std::size_t t_subsample_ra
   }
 
   valid_submarks.close();
-  sdsl::register_cache_file(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_MARK, t_config);
+  sri::registerCacheFile(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_MARK, t_config);
   valid_areas.close();
-  sdsl::register_cache_file(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_AREA, t_config);
+  sri::registerCacheFile(prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_VALID_AREA, t_config);
 }
 
 }
@@ -41,6 +41,14 @@ public:
 
   [[nodiscard]] std::size_t SubsampleRate() const { return subsample_rate_; }
 
+  using Base::load;
+
+  void load(std::istream& in) override {
+    sdsl::read_member(subsample_rate_, in);
+    key_prefix_ = std::to_string(subsample_rate_) + "_";
+    Base::load(in);
+  }
+
   using typename Base::size_type;
   using typename Base::ItemKey;
 
@@ -48,6 +56,8 @@ public:
     auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
 
     size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(subsample_rate_, out, child, "subsample_rate");
+
     written_bytes += Base::serialize(out, v, name);
 
     written_bytes += this->template serializeItem<TBvSampleIdx>(key(ItemKey::SAMPLES_IDX), out, child, "samples_idx");
@@ -62,6 +72,18 @@ public:
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("samples_idx", this->template serializeItem<TBvSampleIdx>(key(ItemKey::SAMPLES_IDX), nulls, child, "samples_idx"));
+    parts.emplace_back("samples_idx_rank", this->template serializeRank<TBvSampleIdx>(key(ItemKey::SAMPLES_IDX), nulls, child, "samples_idx_rank"));
+    parts.emplace_back("run_cumulative_count", this->template serializeItem<TCumulativeRun>(key(ItemKey::RUN_CUMULATIVE_COUNT), nulls, child, "run_cumulative_count"));
+
+    return parts;
+  }
+
 protected:
   using Base::key;
   void setupKeyNames(const JSON& t_keys) override {
@@ -193,7 +215,7 @@ protected:
   auto constructPhi(TSource& t_source) {
     auto bv_mark_rank = this->template loadBVRank<TBvMark>(key(ItemKey::MARKS), t_source, true);
     auto bv_mark_select = this->template loadBVSelect<TBvMark>(key(ItemKey::MARKS), t_source, true);
-    auto successor = CircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
+    auto successor = buildCircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
 
     auto cref_mark_to_sample_idx = this->template loadItem<TMarkToSampleIdx>(key(ItemKey::MARK_TO_SAMPLE), t_source);
     auto get_mark_to_sample_idx = RandomAccessForTwoContainersDefault(cref_mark_to_sample_idx, false);
@@ -326,6 +348,16 @@ public:
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("valid_marks", this->template serializeItem<TBvValidMark>(key(ItemKey::VALID_MARKS), nulls, child, "valid_marks"));
+
+    return parts;
+  }
+
 protected:
   using Base::key;
   using typename Base::TSource;
@@ -355,7 +387,7 @@ protected:
   auto constructPhi(TSource& t_source, const TValidateSample& t_validate_sample) {
     auto bv_mark_rank = this->template loadBVRank<typename Base::BvMarks>(key(ItemKey::MARKS), t_source, true);
     auto bv_mark_select = this->template loadBVSelect<typename Base::BvMarks>(key(ItemKey::MARKS), t_source, true);
-    auto successor = CircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
+    auto successor = buildCircularSoftSuccessor(bv_mark_rank, bv_mark_select, this->n_);
 
     auto cref_mark_to_sample_idx =
         this->template loadItem<typename Base::MarksToSamples>(key(ItemKey::MARK_TO_SAMPLE), t_source, true);
@@ -419,6 +451,17 @@ public:
     return written_bytes;
   }
 
+  std::vector<std::pair<std::string, size_t>> breakdown() const override {
+    auto parts = Base::breakdown();
+    auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
+    nullstream nulls;
+
+    parts.emplace_back("valid_marks_rank", this->template serializeRank<TBvValidMark, typename TBvValidMark::rank_0_type>(key(ItemKey::VALID_MARKS), nulls, child, "valid_marks_rank"));
+    parts.emplace_back("valid_areas", this->template serializeItem<TValidArea>(key(ItemKey::VALID_AREAS), nulls, child, "valid_areas"));
+
+    return parts;
+  }
+
 protected:
   using Base::key;
   void setupKeyNames(const JSON& t_keys) override {
@@ -483,51 +526,51 @@ void constructItems(SrCSAWithPsiRun<TArgs...>& t_index, Config& t_config) {
   auto subsample_rate = t_index.SubsampleRate();
 
   // Sort samples (Psi-run head) by its text positions
-  if (!cache_file_exists(keys[kPsi][kHead][kTextPosAsc][kIdx], t_config)) {
-    auto event = sdsl::memory_monitor::event("Subsampling");
+  if (!sri::cacheFileExists(keys[kPsi][kHead][kTextPosAsc][kIdx], t_config)) {
+    sri::StageEvent event("Subsampling");
     constructSortedIndices(keys[kPsi][kHead][kTextPos], t_config, keys[kPsi][kHead][kTextPosAsc][kIdx], true);
   }
 
   const auto prefix = std::to_string(subsample_rate) + "_";
 
   // Construct subsampling backward of samples (text positions of Psi-run first letter)
-  if (!sdsl::cache_file_exists<typename Index::Samples>(prefix + keys[kPsi][kHead][kTextPos].get<std::string>(),
+  if (!sri::cacheFileExists<typename Index::Samples>(prefix + keys[kPsi][kHead][kTextPos].get<std::string>(),
                                                         t_config)) {
-    auto event = sdsl::memory_monitor::event("Subsamples");
+    sri::StageEvent event("Subsamples");
     constructSubsamplesForPhiForwardWithPsiRuns<typename Index::Samples>(subsample_rate, t_config);
   }
 
   // Construct subsampling backward of marks (text positions of Psi-run last letter)
-  if (!sdsl::cache_file_exists<typename Index::BvMarks>(prefix + keys[kPsi][kTail][kTextPos].get<std::string>(),
+  if (!sri::cacheFileExists<typename Index::BvMarks>(prefix + keys[kPsi][kTail][kTextPos].get<std::string>(),
                                                         t_config)) {
-    auto event = sdsl::memory_monitor::event("Submarks");
+    sri::StageEvent event("Submarks");
     constructSubmarksForPhiForwardWithPsiRuns<typename Index::BvMarks>(subsample_rate, t_config);
   }
 
   // Construct subsampling backward of mark links (text positions of Psi-run first letter indices from last letter)
-  if (!sdsl::cache_file_exists<typename Index::MarksToSamples>(
+  if (!sri::cacheFileExists<typename Index::MarksToSamples>(
     prefix + keys[kPsi][kTail][kTextPosAsc][kLink].get<std::string>(),
     t_config
   )) {
-    auto event = sdsl::memory_monitor::event("SubmarksToSubsamples");
+    sri::StageEvent event("SubmarksToSubsamples");
     constructSubmarkLinksForPhiForwardWithPsiRuns<typename Index::MarksToSamples>(subsample_rate, t_config);
   }
 
   // Construct indices of subsamples
   if (
     auto key = prefix + keys[kPsi][kHead][kIdx].get<std::string>();
-    !sdsl::cache_file_exists<typename Index::BvSamplesIdx>(key, t_config)
+    !sri::cacheFileExists<typename Index::BvSamplesIdx>(key, t_config)
   ) {
-    auto event = sdsl::memory_monitor::event("Subsamples");
+    sri::StageEvent event("Subsamples");
     const auto r =
-        sdsl::int_vector_buffer<>(sdsl::cache_file_name<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config))
+        sdsl::int_vector_buffer<>(sri::cacheFileName<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config))
         .size();
     constructBitVectorFromIntVector<typename Index::BvSamplesIdx>(key, t_config, r, false, true);
   }
 
   // Construct cumulative counts of Psi (or BWT) runs
-  if (!sdsl::cache_file_exists<typename Index::CumulativeRuns>(keys[kPsi][kCumRun].get<std::string>(), t_config)) {
-    auto event = sdsl::memory_monitor::event("CumulativeRuns");
+  if (!sri::cacheFileExists<typename Index::CumulativeRuns>(keys[kPsi][kCumRun].get<std::string>(), t_config)) {
+    sri::StageEvent event("CumulativeRuns");
     constructCumulativeCountsWithPsiRuns<typename Index::CumulativeRuns>(t_config);
   }
 }
@@ -540,10 +583,10 @@ inline auto constructSubsamplingBackwardSamplesForPhiForwardWithPsiRuns(const st
 
   // Samples
   sdsl::int_vector<> samples; // Psi-run starts positions in text
-  sdsl::load_from_cache(samples, keys[kPsi][kHead][kTextPos], t_config, true);
+  sri::loadFromCache(samples, keys[kPsi][kHead][kTextPos], t_config, true);
 
   sdsl::int_vector<> sorted_samples_idx;
-  sdsl::load_from_cache(sorted_samples_idx, keys[kPsi][kHead][kTextPosAsc][kIdx], t_config);
+  sri::loadFromCache(sorted_samples_idx, keys[kPsi][kHead][kTextPosAsc][kIdx], t_config);
 
   // We must sub-sample the samples associated to the first and last marks in the text
   const auto req_samples_idx = getExtremes(t_config, keys[kPsi][kTail][kTextPosAsc][kLink], true);
@@ -556,7 +599,7 @@ inline auto constructSubsamplingBackwardSamplesForPhiForwardWithPsiRuns(const st
                                                     // sorted_samples_idx.end(),
                                                     samples,
                                                     req_samples_idx);
-  sdsl::store_to_cache(subsamples_idx, prefix + keys[kPsi][kHead][kIdx].get<std::string>(), t_config, true);
+  sri::storeToCache(subsamples_idx, prefix + keys[kPsi][kHead][kIdx].get<std::string>(), t_config, true);
 
   // Compute sub-samples
   sdsl::int_vector<> subsamples(subsamples_idx.size(), 0, samples.width());
@@ -564,7 +607,7 @@ inline auto constructSubsamplingBackwardSamplesForPhiForwardWithPsiRuns(const st
                  subsamples_idx.end(),
                  subsamples.begin(),
                  [&samples](auto tt_i) { return samples[tt_i]; });
-  sri::store_to_cache(subsamples, prefix + keys[kPsi][kHead][kTextPos].get<std::string>(), t_config, true);
+  sri::storeToCache(subsamples, prefix + keys[kPsi][kHead][kTextPos].get<std::string>(), t_config, true);
 
   return subsamples;
 }
@@ -577,15 +620,15 @@ void constructSubsamplesForPhiForwardWithPsiRuns(const std::size_t t_subsample_r
   const auto key = prefix + keys[kPsi][kHead][kTextPos].get<std::string>();
 
   sdsl::int_vector<> subsamples_iv;
-  if (!sdsl::cache_file_exists<sdsl::int_vector<>>(key, t_config)) {
+  if (!sri::cacheFileExists<sdsl::int_vector<>>(key, t_config)) {
     subsamples_iv = constructSubsamplingBackwardSamplesForPhiForwardWithPsiRuns(t_subsample_rate, t_config);
   } else {
-    sdsl::load_from_cache(subsamples_iv, key, t_config, true);
+    sri::loadFromCache(subsamples_iv, key, t_config, true);
   }
 
   if (!std::is_same_v<TSamples, sdsl::int_vector<>>) {
     auto subsamples = construct<TSamples>(subsamples_iv);
-    sri::store_to_cache(subsamples, key, t_config, true);
+    sri::storeToCache(std::move(subsamples), key, t_config, true);
   }
 }
 
@@ -595,12 +638,12 @@ inline auto computeSampleToMarkLinksForPhiForwardWithPsiRuns(const std::string&
 
   // Sub-sampled indices of samples
   sdsl::int_vector<> subsamples_idx;
-  sdsl::load_from_cache(subsamples_idx, t_prefix + keys[kPsi][kHead][kIdx].get<std::string>(), t_config);
+  sri::loadFromCache(subsamples_idx, t_prefix + keys[kPsi][kHead][kIdx].get<std::string>(), t_config);
 
   sdsl::int_vector<> subsample_to_mark_links(subsamples_idx.size(), 0, subsamples_idx.width());
 
   const auto r =
-      sdsl::int_vector_buffer<>(sdsl::cache_file_name<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config))
+      sdsl::int_vector_buffer<>(sri::cacheFileName<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config))
       .size();
 
   // Compute links from samples to marks
@@ -620,7 +663,7 @@ inline auto computeSubmarksForPhiForwardWithPsiRuns(const std::string& t_prefix,
   const auto r_prime = subsample_to_mark_links.size();
 
   sdsl::int_vector<> marks;
-  sdsl::load_from_cache(marks, keys[kPsi][kTail][kTextPos], t_config, true);
+  sri::loadFromCache(marks, keys[kPsi][kTail][kTextPos], t_config, true);
 
   auto submarks = sdsl::int_vector(r_prime, 0, marks.width());
   std::transform(subsample_to_mark_links.begin(),
@@ -641,15 +684,15 @@ void constructSubmarksForPhiForwardWithPsiRuns(const std::size_t t_subsample_rat
   // Text positions of marks indices associated to sub-samples, i.e., text positions of sub-sampled marks.
   // Note that the submarks are sorted by its associated submark position, not by its positions in Psi
   sdsl::int_vector<> submarks_iv;
-  if (!sdsl::cache_file_exists<sdsl::int_vector<>>(key, t_config)) {
+  if (!sri::cacheFileExists<sdsl::int_vector<>>(key, t_config)) {
     submarks_iv = computeSubmarksForPhiForwardWithPsiRuns(prefix, t_config);
-    sri::store_to_cache(submarks_iv, key, t_config, true);
+    sri::storeToCache(submarks_iv, key, t_config, true);
   } else {
-    sdsl::load_from_cache(submarks_iv, key, t_config, true);
+    sri::loadFromCache(submarks_iv, key, t_config, true);
   }
 
   // Construct successor on the text positions of sub-sampled Psi-run last letter
-  const auto n = sdsl::int_vector_buffer<>(cache_file_name(keys[kBWT][kBase], t_config)).size();
+  const auto n = bwtSize(t_config);
   constructBitVectorFromIntVector<TBvMarks>(submarks_iv, key, t_config, n, false);
 }
 
@@ -661,20 +704,12 @@ inline auto computeSubmarkLinksForPhiForwardWithPsiRuns(const std::string& t_pre
   // Text positions of marks indices associated to sub-samples, i.e., text positions of sub-sampled marks.
   // Note that the submarks are sorted by its associated submark position, not by its positions in Psi
   sdsl::int_vector<> submarks;
-  sdsl::load_from_cache(submarks, key, t_config, true);
-
-  const auto r_prime = submarks.size();
-  const auto log_r_prime = sdsl::bits::hi(r_prime) + 1;
+  sri::loadFromCache(submarks, key, t_config, true);
 
   // Links from sub-sampled marks (sorted by text position) to sub-samples indices.
   // Note that, initially, these are the indices of sub-sample in Psi.
-  sdsl::int_vector<> submark_to_subsample_links(r_prime, 0, log_r_prime);
-  std::iota(submark_to_subsample_links.begin(), submark_to_subsample_links.end(), 0);
-
   // Sort indexes by text positions of its marks, becoming in the links from the sub-sampled marks to sub-sampled samples.
-  std::sort(submark_to_subsample_links.begin(),
-            submark_to_subsample_links.end(),
-            [&submarks](const auto& tt_a, const auto& tt_b) { return submarks[tt_a] < submarks[tt_b]; });
+  sdsl::int_vector<> submark_to_subsample_links = sortIndices(submarks);
 
   return submark_to_subsample_links;
 }
@@ -687,16 +722,16 @@ void constructSubmarkLinksForPhiForwardWithPsiRuns(const std::size_t t_subsample
   const auto key = prefix + keys[kPsi][kTail][kTextPosAsc][kLink].get<std::string>();
 
   sdsl::int_vector<> submark_to_subsample_links_iv;
-  if (!sdsl::cache_file_exists<sdsl::int_vector<>>(key, t_config)) {
+  if (!sri::cacheFileExists<sdsl::int_vector<>>(key, t_config)) {
     submark_to_subsample_links_iv = computeSubmarkLinksForPhiForwardWithPsiRuns(prefix, t_config);
-    sri::store_to_cache(submark_to_subsample_links_iv, key, t_config, true);
+    sri::storeToCache(submark_to_subsample_links_iv, key, t_config, true);
   } else {
-    sdsl::load_from_cache(submark_to_subsample_links_iv, key, t_config, true);
+    sri::loadFromCache(submark_to_subsample_links_iv, key, t_config, true);
   }
 
   if (!std::is_same_v<TMarksToSamples, sdsl::int_vector<>>) {
     auto submark_to_subsample_links = construct<TMarksToSamples>(submark_to_subsample_links_iv);
-    sri::store_to_cache(submark_to_subsample_links, key, t_config, true);
+    sri::storeToCache(std::move(submark_to_subsample_links), key, t_config, true);
   }
 }
 
@@ -706,11 +741,11 @@ void constructCumulativeCountsWithPsiRuns(Config& t_config) {
   const auto& keys = t_config.keys;
 
   PsiCoreRLE<> psi_rle;
-  sdsl::load_from_cache(psi_rle, sdsl::conf::KEY_PSI, t_config, true);
+  sri::loadFromCache(psi_rle, sdsl::conf::KEY_PSI, t_config, true);
 
   const auto sigma = psi_rle.sigma();
   const auto r =
-      sdsl::int_vector_buffer<>(sdsl::cache_file_name<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config))
+      sdsl::int_vector_buffer<>(sri::cacheFileName<sdsl::int_vector<>>(keys[kPsi][kHead][kTextPos], t_config))
       .size();
   const auto log_r = sdsl::bits::hi(r) + 1;
   auto cumulative_counts_iv = sdsl::int_vector<>(sigma, 0, log_r);
@@ -721,7 +756,7 @@ void constructCumulativeCountsWithPsiRuns(Config& t_config) {
   }
 
   auto cumulative_counts = construct<TRunCumulativeCounts>(cumulative_counts_iv);
-  sri::store_to_cache(cumulative_counts, keys[kPsi][kCumRun], t_config, true);
+  sri::storeToCache(std::move(cumulative_counts), keys[kPsi][kCumRun], t_config, true);
 }
 
 inline void constructSubmarksValidity(std::size_t t_subsample_rate, Config& t_config);
@@ -740,15 +775,15 @@ void constructItems(SRCSAValidMark<TArgs...>& t_index, Config& t_config) {
   // Construct subsampling validity marks and areas
   if (
     auto key = prefix + keys[kPsi][kTail][kTextPosAsc][kValidMark].get<std::string>();
-    !sdsl::cache_file_exists<typename Index::BvValidMarks>(key, t_config)
+    !sri::cacheFileExists<typename Index::BvValidMarks>(key, t_config)
   ) {
-    auto event = sdsl::memory_monitor::event("Subsampling Validity");
-    if (!sdsl::cache_file_exists<sdsl::int_vector<>>(key, t_config)) {
+    sri::StageEvent event("Subsampling Validity");
+    if (!sri::cacheFileExists<sdsl::int_vector<>>(key, t_config)) {
       constructSubmarksValidity(subsample_rate, t_config);
     }
 
     std::size_t r_prime =
-        sdsl::int_vector_buffer<>(sdsl::cache_file_name<sdsl::int_vector<>>(prefix + str(keys[kPsi][kTail][kTextPos]),
+        sdsl::int_vector_buffer<>(sri::cacheFileName<sdsl::int_vector<>>(prefix + str(keys[kPsi][kTail][kTextPos]),
                                                                             t_config))
         .size();
     constructBitVectorFromIntVector<typename Index::BvValidMarks,
@@ -764,13 +799,13 @@ inline void constructSubmarksValidity(const std::size_t t_subsample_rate, Config
   auto prefix = std::to_string(t_subsample_rate) + "_";
 
   sdsl::int_vector<> marks;
-  sdsl::load_from_cache(marks, keys[kPsi][kTail][kTextPos], t_config, true);
+  sri::loadFromCache(marks, keys[kPsi][kTail][kTextPos], t_config, true);
   std::sort(marks.begin(), marks.end());
   auto it_marks = marks.end();
   auto get_next_mark = [&it_marks]() { return *(--it_marks); };
 
   sdsl::int_vector<> submarks;
-  sdsl::load_from_cache(submarks, prefix + keys[kPsi][kTail][kTextPos].get<std::string>(), t_config, true);
+  sri::loadFromCache(submarks, prefix + keys[kPsi][kTail][kTextPos].get<std::string>(), t_config, true);
   std::sort(submarks.begin(), submarks.end());
   auto it_submarks = submarks.end();
   auto get_next_submark = [&it_submarks]() { return *(--it_submarks); };
@@ -797,8 +832,8 @@ inline void constructSubmarksValidity(const std::size_t t_subsample_rate, Config
     valid_areas[i] = it->second;
   }
 
-  sri::store_to_cache(valid_marks, prefix + str(keys[kPsi][kTail][kTextPosAsc][kValidMark]), t_config, true);
-  sri::store_to_cache(valid_areas, prefix + str(keys[kPsi][kTail][kTextPosAsc][kValidArea]), t_config, true);
+  sri::storeToCache(std::move(valid_marks), prefix + str(keys[kPsi][kTail][kTextPosAsc][kValidMark]), t_config, true);
+  sri::storeToCache(std::move(valid_areas), prefix + str(keys[kPsi][kTail][kTextPosAsc][kValidArea]), t_config, true);
 }
 
 template<typename... TArgs>
@@ -815,15 +850,15 @@ void constructItems(SRCSAValidArea<TArgs...>& t_index, Config& t_config) {
   // Construct subsampling validity marks and areas
   if (
     auto key = prefix + str(keys[kPsi][kTail][kTextPosAsc][kValidArea]);
-    !sdsl::cache_file_exists<typename Index::ValidAreas>(key, t_config)
+    !sri::cacheFileExists<typename Index::ValidAreas>(key, t_config)
   ) {
-    auto event = sdsl::memory_monitor::event("Subsampling Validity");
+    sri::StageEvent event("Subsampling Validity");
 
     sdsl::int_vector<> valid_areas_iv;
-    sdsl::load_from_cache(valid_areas_iv, key, t_config, true);
+    sri::loadFromCache(valid_areas_iv, key, t_config, true);
 
     auto valid_areas = construct<typename Index::ValidAreas>(valid_areas_iv);
-    sri::store_to_cache(valid_areas, key, t_config, true);
+    sri::storeToCache(std::move(valid_areas), key, t_config, true);
   }
 }
 }
@@ -40,10 +40,16 @@ class SrIndex : public RIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSamp
 
   void load(std::istream &in) override {
     sdsl::read_member(subsample_rate_, in);
+    key_prefix_ = std::to_string(subsample_rate_) + "_";
     TSource source(std::ref(in));
     this->loadInner(source);
   }
 
+  void storeItems(Config &t_config) const override {
+    Base::storeItems(t_config);
+    this->template storeItem<TBvSampleIdx>(key(ItemKey::SAMPLES_IDX), t_config, true);
+  }
+
   [[nodiscard]] std::vector<std::pair<std::string, size_t>> breakdown() const override{
 
       std::vector<std::pair<std::string, size_t>> parts = Base::breakdown();
@@ -111,7 +117,8 @@ class SrIndex : public RIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSamp
         [](const auto &tt_step) { return DataBackwardSearchStep{0, RunDataExt{0, 0, false, 0}}; },
         this->constructGetSymbol(t_source),
         [](auto tt_seq_size) { return Range{0, tt_seq_size}; },
-        this->constructIsRangeEmpty()
+        this->constructIsRangeEmpty(),
+        this->constructSeedBackwardSearch(t_source, constructCreateDataBackwardSearchStep(), constructGetToehold())
     });
   }
 
@@ -135,6 +142,14 @@ class SrIndex : public RIndex<TStorage, TAlphabet, TBwtRLE, TBvMark, TMarkToSamp
     };
   }
 
+  //! Inverse of the toehold data creation, used to store the toehold data in the backward-search seeds
+  auto constructGetToehold() {
+    return [](const DataBackwardSearchStep &tt_data, std::size_t tt_pattern_size) {
+      const auto &[step, run_data] = tt_data;
+      return KmerTable::Toehold{tt_pattern_size - 1 - step, run_data.c, run_data.last_run_rnk, run_data.next_pos + 1};
+    };
+  }
+
   auto constructGetSample(TSource &t_source) {
     auto cref_samples = this->template loadItem<TSample>(key(ItemKey::SAMPLES), t_source);
     auto cref_bv_sample_idx = this->template loadItem<TBvSampleIdx>(key(ItemKey::SAMPLES_IDX), t_source, true);
@@ -278,6 +293,11 @@ class SrIndexValidMark : public SrIndex<
 
   SrIndexValidMark() = default;
 
+  void storeItems(Config &t_config) const override {
+    Base::storeItems(t_config);
+    this->template storeItem<TBvValidMark>(key(ItemKey::VALID_MARKS), t_config, true);
+  }
+
   [[nodiscard]] std::vector<std::pair<std::string, size_t>> breakdown() const override{
 
       std::vector<std::pair<std::string, size_t>> parts = Base::breakdown();
@@ -393,6 +413,11 @@ class SrIndexValidArea : public SrIndexValidMark<
 
   SrIndexValidArea() = default;
 
+  void storeItems(Config &t_config) const override {
+    Base::storeItems(t_config);
+    this->template storeItem<TValidArea>(key(ItemKey::VALID_AREAS), t_config);
+  }
+
   [[nodiscard]] std::vector<std::pair<std::string, size_t>> breakdown() const override{
       std::vector<std::pair<std::string, size_t>> parts = Base::breakdown();
       auto child = sdsl::structure_tree::add_child(nullptr, "", sdsl::util::class_name(*this));
@@ -513,34 +538,46 @@ void constructSubsamplingForwardSamplesForPhiBackward(std::size_t t_subsample_ra
 
 void constructSubsamplingForwardMarksForPhiBackward(std::size_t t_subsample_rate, sdsl::cache_config &t_config);
 
+template<typename TBvMark, typename TBvSampleIdx>
+void constructSubsamplingItems(std::size_t t_subsample_rate, std::size_t t_n, sri::Config &t_config);
+
 template<uint8_t t_width, typename TBvMark, typename TBvSampleIdx>
 void constructSRI(const std::string &t_data_path, std::size_t t_subsample_rate, sri::Config &t_config) {
   constructRIndex<t_width, TBvMark>(t_data_path, t_config);
 
+  const auto n = bwtSize(t_config);
+
+  constructSubsamplingItems<TBvMark, TBvSampleIdx>(t_subsample_rate, n, t_config);
+}
+
+//! Construct the items of the subsampled index from the samples, marks and mark-to-sample links of the r-index
+//! \param t_n Length of the BWT
+template<typename TBvMark, typename TBvSampleIdx>
+void constructSubsamplingItems(std::size_t t_subsample_rate, std::size_t t_n, sri::Config &t_config) {
   auto prefix = std::to_string(t_subsample_rate) + "_";
 
   {
     // Sort samples (BWT-run last letter) by its text positions
-    auto event = sdsl::memory_monitor::event("Subsampling");
+    sri::StageEvent event("Subsampling");
     const auto key = conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX;
-    if (!sdsl::cache_file_exists(key, t_config)) {
+    if (!sri::cacheFileExists(key, t_config)) {
       constructSortedIndices(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config, key);
     }
   }
 
   {
     // Construct subsampling forward of samples (text positions of BWT-run last letter)
-    auto event = sdsl::memory_monitor::event("Subsampling");
+    sri::StageEvent event("Subsampling");
     auto key = prefix + conf::KEY_BWT_RUN_LAST_IDX;
-    if (!sdsl::cache_file_exists(key, t_config)) {
+    if (!sri::cacheFileExists(key, t_config)) {
       constructSubsamplingForwardSamplesForPhiBackward(t_subsample_rate, t_config);
     }
 
-    if (!sdsl::cache_file_exists<TBvSampleIdx>(key, t_config)) {
+    if (!sri::cacheFileExists<TBvSampleIdx>(key, t_config)) {
       std::size_t r;
       {
-        sdsl::int_vector_buffer<> bwt(sdsl::cache_file_name(conf::KEY_BWT_RUN_LAST, t_config));
-        r = bwt.size();
+        sdsl::int_vector_buffer<> samples(sri::cacheFileName(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config));
+        r = samples.size();
       }
 
       constructBitVectorFromIntVector<TBvSampleIdx>(key, t_config, r, false);
@@ -549,23 +586,18 @@ void constructSRI(const std::string &t_data_path, std::size_t t_subsample_rate,
 
   {
     // Construct subsampling forward of marks (text positions of BWT-run first letter)
-    auto event = sdsl::memory_monitor::event("Subsampling");
-    if (!sdsl::cache_file_exists(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config)) {
+    sri::StageEvent event("Subsampling");
+    if (!sri::cacheFileExists(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config)) {
       constructSubsamplingForwardMarksForPhiBackward(t_subsample_rate, t_config);
     }
   }
 
   {
     // Construct predecessor on the text positions of sub-sampled BWT-run first letter
-    auto event = sdsl::memory_monitor::event("Predecessor");
+    sri::StageEvent event("Predecessor");
     const auto key = prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_BY_LAST;
-    if (!sdsl::cache_file_exists<TBvMark>(key, t_config)) {
-      std::size_t n;
-      {
-        sdsl::int_vector_buffer<t_width> bwt(sdsl::cache_file_name(sdsl::key_bwt_trait<t_width>::KEY_BWT, t_config));
-        n = bwt.size();
-      }
-      constructBitVectorFromIntVector<TBvMark>(key, t_config, n, false);
+    if (!sri::cacheFileExists<TBvMark>(key, t_config)) {
+      constructBitVectorFromIntVector<TBvMark>(key, t_config, t_n, false);
     }
   }
 
@@ -573,24 +605,33 @@ void constructSRI(const std::string &t_data_path, std::size_t t_subsample_rate,
 
 void constructSubsamplingForwardMarksValidity(std::size_t t_subsample_rate, sdsl::cache_config &t_config);
 
+template<typename TBvValidMark>
+void constructSubsamplingValidityItems(std::size_t t_subsample_rate, sri::Config &t_config);
+
 template<uint8_t t_width, typename TBvMark, typename TBvSampleIdx, typename TBvValidMark>
 void constructSRIValidMark(const std::string &t_data_path, std::size_t t_subsample_rate, sri::Config &t_config) {
   constructSRI<t_width, TBvMark, TBvSampleIdx>(t_data_path, t_subsample_rate, t_config);
 
+  constructSubsamplingValidityItems<TBvValidMark>(t_subsample_rate, t_config);
+}
+
+//! Construct the validity marks and areas of the subsampled marks, which need every mark of the r-index
+template<typename TBvValidMark>
+void constructSubsamplingValidityItems(std::size_t t_subsample_rate, sri::Config &t_config) {
   auto prefix_key = std::to_string(t_subsample_rate) + "_";
 
   {
     // Construct subsampling validity marks and areas
-    auto event = sdsl::memory_monitor::event("Subsampling Validity");
+    sri::StageEvent event("Subsampling Validity");
     auto key = prefix_key + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_MARK;
-    if (!sdsl::cache_file_exists(key, t_config)) {
+    if (!sri::cacheFileExists(key, t_config)) {
       constructSubsamplingForwardMarksValidity(t_subsample_rate, t_config);
     }
 
-    if (!sdsl::cache_file_exists<TBvValidMark>(key, t_config)) {
+    if (!sri::cacheFileExists<TBvValidMark>(key, t_config)) {
       std::size_t r_prime;
       {
-        sdsl::int_vector_buffer<> buf(sdsl::cache_file_name(prefix_key + conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config));
+        sdsl::int_vector_buffer<> buf(sri::cacheFileName(prefix_key + conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config));
         r_prime = buf.size();
       }
       constructBitVectorFromIntVector<TBvValidMark,
@@ -605,18 +646,18 @@ void constructSubsamplingForwardSamplesForPhiBackward(std::size_t t_subsample_ra
 
   // Samples
   sdsl::int_vector<> samples; // BWT-run end positions in text
-  sdsl::load_from_cache(samples, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+  sri::loadFromCache(samples, conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
   auto r = samples.size();
   auto log_r = sdsl::bits::hi(r) + 1;
 
   sdsl::int_vector<> sorted_samples_idx;
-  sdsl::load_from_cache(sorted_samples_idx, conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX, t_config);
+  sri::loadFromCache(sorted_samples_idx, conf::KEY_BWT_RUN_LAST_TEXT_POS_SORTED_IDX, t_config);
 
   std::array<std::size_t, 2> req_samples_idx{};
   {
     // We must sub-sample the samples associated to the first and last marks in the text
     sdsl::int_vector_buffer<> mark_to_sample(
-        sdsl::cache_file_name(conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config));
+        sri::cacheFileName(conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX, t_config));
     req_samples_idx[0] = mark_to_sample[0];
     req_samples_idx[1] = mark_to_sample[mark_to_sample.size() - 1];
   }
@@ -636,7 +677,7 @@ void constructSubsamplingForwardSamplesForPhiBackward(std::size_t t_subsample_ra
     std::copy(subsamples_idx_vec.begin(), subsamples_idx_vec.end(), subsamples_idx.begin());
 
     // Store sub-sample indices sorted by BWT positions
-    sdsl::store_to_cache(subsamples_idx, prefix + conf::KEY_BWT_RUN_LAST_IDX, t_config);
+    sri::storeToCache(subsamples_idx, prefix + conf::KEY_BWT_RUN_LAST_IDX, t_config);
   }
 
   {
@@ -645,20 +686,20 @@ void constructSubsamplingForwardSamplesForPhiBackward(std::size_t t_subsample_ra
     std::transform(subsamples_idx.begin(), subsamples_idx.end(), subsamples.begin(),
                    [&samples](auto tt_i) { return samples[tt_i]; });
 
-    sdsl::store_to_cache(subsamples, prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
+    sri::storeToCache(std::move(subsamples), prefix + conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config);
   }
 }
 
 auto computeSampleToMarkLinksForPhiBackward(const std::string &t_prefix, sdsl::cache_config &t_config) {
   // Sub-sampled indices of samples
   sdsl::int_vector<> subsamples_idx;
-  sdsl::load_from_cache(subsamples_idx, t_prefix + conf::KEY_BWT_RUN_LAST_IDX, t_config);
+  sri::loadFromCache(subsamples_idx, t_prefix + conf::KEY_BWT_RUN_LAST_IDX, t_config);
 
   sdsl::int_vector<> subsample_to_mark_links(subsamples_idx.size(), 0, subsamples_idx.width());
 
   std::size_t r;
   {
-    sdsl::int_vector_buffer<> buf(sdsl::cache_file_name(conf::KEY_BWT_RUN_FIRST, t_config));
+    sdsl::int_vector_buffer<> buf(sri::cacheFileName(conf::KEY_BWT_RUN_LAST_TEXT_POS, t_config));
     r = buf.size();
   }
 
@@ -685,7 +726,7 @@ void constructSubsamplingForwardMarksForPhiBackward(std::size_t t_subsample_rate
     r_prime = subsample_to_mark_links.size();
 
     sdsl::int_vector<> marks;
-    sdsl::load_from_cache(marks, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+    sri::loadFromCache(marks, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
 
     subsampled_mark_text_pos = sdsl::int_vector(r_prime, 0, marks.width());
     std::transform(subsample_to_mark_links.begin(),
@@ -694,22 +735,13 @@ void constructSubsamplingForwardMarksForPhiBackward(std::size_t t_subsample_rate
                    [&marks](auto tt_i) { return marks[tt_i]; });
   }
 
-  auto log_r_prime = sdsl::bits::hi(r_prime) + 1;
-
   // Links from sub-sampled marks (sorted by text position) to sub-samples indices. Note that, initially, these are the indices of sub-sample in BWT.
-  sdsl::int_vector<> subsampled_mark_to_subsample_links(r_prime, 0, log_r_prime);
-  std::iota(subsampled_mark_to_subsample_links.begin(), subsampled_mark_to_subsample_links.end(), 0);
-
   // Sort indexes by text positions of its marks, becoming in the links from the sub-sampled marks to sub-sampled samples.
-  std::sort(subsampled_mark_to_subsample_links.begin(),
-            subsampled_mark_to_subsample_links.end(),
-            [&subsampled_mark_text_pos](const auto &tt_a, const auto &tt_b) {
-              return subsampled_mark_text_pos[tt_a] < subsampled_mark_text_pos[tt_b];
-            });
+  sdsl::int_vector<> subsampled_mark_to_subsample_links = sortIndices(subsampled_mark_text_pos);
 
-  sdsl::store_to_cache(subsampled_mark_text_pos, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_BY_LAST, t_config);
+  sri::storeToCache(std::move(subsampled_mark_text_pos), prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_BY_LAST, t_config);
 
-  sdsl::store_to_cache(subsampled_mark_to_subsample_links,
+  sri::storeToCache(std::move(subsampled_mark_to_subsample_links),
                        prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_TO_LAST_IDX,
                        t_config);
 }
@@ -718,14 +750,14 @@ void constructSubsamplingForwardMarksValidity(std::size_t t_subsample_rate, sdsl
   auto prefix = std::to_string(t_subsample_rate) + "_";
 
   sdsl::int_vector<> marks;
-  sdsl::load_from_cache(marks, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
+  sri::loadFromCache(marks, conf::KEY_BWT_RUN_FIRST_TEXT_POS, t_config);
   sdsl::int_vector<> sorted_marks_idx;
-  sdsl::load_from_cache(sorted_marks_idx, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
+  sri::loadFromCache(sorted_marks_idx, conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_IDX, t_config);
   auto it_marks_idx = sorted_marks_idx.begin();
   auto get_next_mark = [&marks, &it_marks_idx]() { return marks[*(it_marks_idx++)]; };
 
   sdsl::int_vector<> submarks;
-  sdsl::load_from_cache(submarks, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_BY_LAST, t_config);
+  sri::loadFromCache(submarks, prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_BY_LAST, t_config);
   std::sort(submarks.begin(), submarks.end());
   auto it_submarks = submarks.begin();
   auto get_next_submark = [&it_submarks]() { return *(it_submarks++); };
@@ -745,13 +777,13 @@ void constructSubsamplingForwardMarksValidity(std::size_t t_subsample_rate, sdsl
 
   const std::size_t buffer_size = 1 << 20;
   sdsl::int_vector_buffer<> valid_submarks(
-      sdsl::cache_file_name(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_MARK, t_config),
+      sri::cacheFileName(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_MARK, t_config),
       std::ios::out,
       buffer_size,
       sdsl::bits::hi(r_prime) + 1);
 
   sdsl::int_vector_buffer<> valid_areas(
-      sdsl::cache_file_name(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_AREA, t_config),
+      sri::cacheFileName(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_AREA, t_config),
       std::ios::out,
       buffer_size,
       sdsl::bits::hi(max_valid_area) + 1);
@@ -763,9 +795,9 @@ void constructSubsamplingForwardMarksValidity(std::size_t t_subsample_rate, sdsl
   }
 
   valid_submarks.close();
-  sdsl::register_cache_file(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_MARK, t_config);
+  sri::registerCacheFile(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_MARK, t_config);
   valid_areas.close();
-  sdsl::register_cache_file(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_AREA, t_config);
+  sri::registerCacheFile(prefix + conf::KEY_BWT_RUN_FIRST_TEXT_POS_SORTED_VALID_AREA, t_config);
 }
 
 }
@@ -0,0 +1,278 @@
+//
+// Encoded vector with byte-aligned deltas (Stream VByte style) decoded in blocks, an alternative to enc_vector for the
+// partial psi functions of PsiCoreRLE.
+//
+
+#ifndef SRI_STREAM_VBYTE_VECTOR_H_
+#define SRI_STREAM_VBYTE_VECTOR_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define SRI_STREAM_VBYTE_SSSE3
+#endif
+
+#include <sdsl/int_vector.hpp>
+#include <sdsl/io.hpp>
+#include <sdsl/structure_tree.hpp>
+#include <sdsl/util.hpp>
+
+namespace sri {
+
+namespace stream_vbyte {
+
+//! Number of bytes of each 2-bit length code
+constexpr std::array<uint8_t, 4> kLengths = {1, 2, 4, 8};
+
+//! Length code of the value, i.e., the smallest of 1, 2, 4 or 8 bytes that holds it
+inline uint8_t lengthCode(uint64_t t_value) {
+  return t_value < (1ull << 8) ? 0 : t_value < (1ull << 16) ? 1 : t_value < (1ull << 32) ? 2 : 3;
+}
+
+//! Shuffle masks that spread a pair of values (4-bit code, the first value in the low bits) from a 16-byte load into
+//! two 64-bit lanes
+struct PairShuffles {
+  alignas(16) uint8_t masks[16][16];
+  uint8_t lengths[16];
+
+  constexpr PairShuffles() : masks{}, lengths{} {
+    for (int code = 0; code < 16; ++code) {
+      const uint8_t first = kLengths[code & 3], second = kLengths[code >> 2];
+      for (int i = 0; i < 8; ++i) {
+        masks[code][i] = i < first ? i : 0x80;
+        masks[code][8 + i] = i < second ? first + i : 0x80;
+      }
+      lengths[code] = first + second;
+    }
+  }
+};
+
+inline constexpr PairShuffles kPairShuffles{};
+
+#if defined(SRI_STREAM_VBYTE_SSSE3)
+//! Decode a group with two byte shuffles. It is built for SSSE3 even if the rest of the code is not (see decodeGroup).
+__attribute__((target("ssse3")))
+inline std::size_t decodeGroupSSSE3(uint8_t t_control, const uint8_t *t_data, uint64_t *t_out) {
+  const auto low = t_control & 0xF, high = t_control >> 4;
+  const auto first = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t_data)),
+                                      _mm_load_si128(reinterpret_cast<const __m128i *>(kPairShuffles.masks[low])));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(t_out), first);
+
+  const auto *data = t_data + kPairShuffles.lengths[low];
+  const auto second = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)),
+                                       _mm_load_si128(reinterpret_cast<const __m128i *>(kPairShuffles.masks[high])));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(t_out + 2), second);
+
+  return kPairShuffles.lengths[low] + kPairShuffles.lengths[high];
+}
+#endif
+
+//! Decode a group one value at a time
+inline std::size_t decodeGroupScalar(uint8_t t_control, const uint8_t *t_data, uint64_t *t_out) {
+  std::size_t offset = 0;
+  for (int i = 0; i < 4; ++i) {
+    const auto length = kLengths[(t_control >> (2 * i)) & 3];
+    uint64_t value = 0;
+    std::memcpy(&value, t_data + offset, length); // Little-endian
+    t_out[i] = value;
+    offset += length;
+  }
+  return offset;
+}
+
+//! Whether the groups are decoded with SSSE3: always when the code is built for it (e.g., with -march=native), and
+//! otherwise when the CPU supports it, checked once
+inline bool useSSSE3() {
+#if defined(__SSSE3__)
+  return true;
+#elif defined(SRI_STREAM_VBYTE_SSSE3)
+  static const bool supported = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+  }();
+  return supported;
+#else
+  return false;
+#endif
+}
+
+//! Name of the path that decodes the groups, e.g., to report it in the benchmarks
+inline std::string decodePath() { return useSSSE3() ? "SSSE3" : "scalar"; }
+
+//! Decode the group of four values of the control byte into t_out, returning the number of data bytes read.
+//! The data must be readable 16 bytes past the start of each pair (see StreamVByteVector::kPadding).
+inline std::size_t decodeGroup(uint8_t t_control, const uint8_t *t_data, uint64_t *t_out) {
+#if defined(__SSSE3__)
+  return decodeGroupSSSE3(t_control, t_data, t_out);
+#else
+#if defined(SRI_STREAM_VBYTE_SSSE3)
+  if (useSSSE3()) return decodeGroupSSSE3(t_control, t_data, t_out);
+#endif
+  return decodeGroupScalar(t_control, t_data, t_out);
+#endif
+}
+
+}
+
+//! Immutable vector of non-decreasing integers, sampled every t_dens items, whose other items are stored as their
+//! deltas with the previous one, like enc_vector. The deltas are written with 1, 2, 4 or 8 bytes and their 2-bit
+//! length codes are kept apart, one control byte per group of four deltas, so a group is decoded at once (with two
+//! byte shuffles when the CPU has SSSE3) instead of one bit-level code at a time.
+//! The deltas of consecutive samples are contiguous, so a Decoder started at a sample can go on past the next one.
+//! It has the interface of enc_vector used by PsiCoreRLE.
+//! \tparam t_dens Every t_dens-th item is sampled
+template<uint32_t t_dens = 64>
+class StreamVByteVector {
+  static_assert(t_dens > 1, "StreamVByteVector: sample density must be larger than `1`");
+
+ public:
+  typedef uint64_t value_type;
+  typedef std::size_t size_type;
+  static const uint32_t sample_dens = t_dens;
+
+  //! Readable bytes after the data, as the decoder loads 16 bytes at the start of each pair of deltas
+  static constexpr std::size_t kPadding = 32;
+
+  StreamVByteVector() = default;
+
+  //! Constructor
+  //! \param t_values Container of non-decreasing unsigned integers
+  template<typename TContainer>
+  explicit StreamVByteVector(const TContainer &t_values) {
+    size_ = t_values.size();
+    if (size_ == 0) return;
+
+    const auto n_samples = (size_ - 1) / t_dens + 1;
+    const auto n_deltas = size_ - n_samples;
+
+    std::vector<uint8_t> control((n_deltas + 3) / 4 + 1, 0);
+    std::vector<uint8_t> data;
+    data.reserve(n_deltas + kPadding);
+    std::vector<std::size_t> samples, pointers;
+    samples.reserve(n_samples + 1);
+    pointers.reserve(n_samples + 1);
+
+    std::size_t i = 0, d = 0, group_offset = 0;
+    uint64_t prev = 0;
+    for (const auto &item : t_values) {
+      const uint64_t value = item;
+      if (i % t_dens == 0) {
+        samples.emplace_back(value);
+        // The deltas of the sample start at the d-th one, in the group of the control byte d / 4
+        pointers.emplace_back(d % 4 ? group_offset : data.size());
+      } else {
+        if (d % 4 == 0) group_offset = data.size();
+        const auto delta = value - prev;
+        const auto code = stream_vbyte::lengthCode(delta);
+        control[d / 4] |= code << (2 * (d % 4));
+        for (std::size_t b = 0; b < stream_vbyte::kLengths[code]; ++b) data.emplace_back((delta >> (8 * b)) & 0xFF);
+        ++d;
+      }
+      prev = value;
+      ++i;
+    }
+    samples.emplace_back(0);
+    pointers.emplace_back(d % 4 ? group_offset : data.size());
+    data.resize(data.size() + kPadding, 0);
+
+    std::size_t max_value = data.size();
+    for (auto sample : samples) max_value = std::max<std::size_t>(max_value, sample);
+    sample_vals_and_pointer_ = sdsl::int_vector<>(2 * samples.size(), 0, sdsl::bits::hi(max_value) + 1);
+    for (std::size_t j = 0; j < samples.size(); ++j) {
+      sample_vals_and_pointer_[2 * j] = samples[j];
+      sample_vals_and_pointer_[2 * j + 1] = pointers[j];
+    }
+
+    control_ = sdsl::int_vector<8>(control.size());
+    std::copy(control.begin(), control.end(), control_.begin());
+    data_ = sdsl::int_vector<8>(data.size());
+    std::copy(data.begin(), data.end(), data_.begin());
+  }
+
+  //! Sequential decoder of the deltas following the t_i-th sample, i.e., of items t_i * t_dens + 1, ...
+  class Decoder {
+   public:
+    Decoder(const StreamVByteVector &t_values, std::size_t t_i) {
+      const auto d = t_i * (t_dens - 1); // Number of deltas before the sample
+      control_ = t_values.controlBytes() + d / 4;
+      data_ = t_values.dataBytes() + t_values.sample_and_pointer()[2 * t_i + 1];
+      decodeGroup();
+      pos_ = d % 4;
+    }
+
+    uint64_t operator()() {
+      if (pos_ == 4) decodeGroup();
+      return buffer_[pos_++];
+    }
+
+   private:
+    void decodeGroup() {
+      data_ += stream_vbyte::decodeGroup(*control_++, data_, buffer_);
+      pos_ = 0;
+    }
+
+    const uint8_t *control_ = nullptr;
+    const uint8_t *data_ = nullptr;
+    alignas(16) uint64_t buffer_[4] = {0, 0, 0, 0};
+    std::size_t pos_ = 0;
+  };
+
+  size_type size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  value_type operator[](size_type t_i) const {
+    const auto idx = t_i / t_dens;
+    value_type value = sample(idx);
+    Decoder decoder(*this, idx);
+    for (auto j = idx * t_dens; j < t_i; ++j) value += decoder();
+    return value;
+  }
+
+  //! Returns the t_i-th sample
+  value_type sample(size_type t_i) const { return sample_vals_and_pointer_[t_i << 1]; }
+
+  //! Samples and byte offsets of the group of their first delta, interleaved
+  const auto &sample_and_pointer() const { return sample_vals_and_pointer_; }
+
+  uint32_t get_sample_dens() const { return t_dens; }
+
+  size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, const std::string &name = "") const {
+    auto child = sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this));
+    size_type written_bytes = 0;
+    written_bytes += sdsl::write_member(size_, out, child, "size");
+    written_bytes += control_.serialize(out, child, "control");
+    written_bytes += data_.serialize(out, child, "data");
+    written_bytes += sample_vals_and_pointer_.serialize(out, child, "samples_and_pointers");
+    sdsl::structure_tree::add_size(child, written_bytes);
+    return written_bytes;
+  }
+
+  void load(std::istream &in) {
+    sdsl::read_member(size_, in);
+    control_.load(in);
+    data_.load(in);
+    sample_vals_and_pointer_.load(in);
+  }
+
+ private:
+  const uint8_t *controlBytes() const { return reinterpret_cast<const uint8_t *>(control_.data()); }
+
+  const uint8_t *dataBytes() const { return reinterpret_cast<const uint8_t *>(data_.data()); }
+
+  size_type size_ = 0;
+  sdsl::int_vector<8> control_; // Length codes, 2 bits per delta
+  sdsl::int_vector<8> data_; // Deltas, followed by kPadding zeros
+  sdsl::int_vector<> sample_vals_and_pointer_;
+};
+
+}
+
+#endif //SRI_STREAM_VBYTE_VECTOR_H_
@@ -0,0 +1,327 @@
+//
+// Runtime cache of the backward-search state (range and toehold data) for recently queried pattern suffixes.
+//
+
+#ifndef SRI_SUFFIX_CACHE_H_
+#define SRI_SUFFIX_CACHE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+
+#include "kmer_table.h"
+
+namespace sri {
+
+//! Bounded cache mapping pattern suffixes to their backward-search state.
+//! It is a direct-mapped table whose slots are guarded by sequence locks: reads never block nor write shared memory
+//! (besides the statistic counters), and a write gives up if another thread is writing the same slot.
+//! Each slot stores the symbols of its suffix, so a hit is verified against the pattern (the fingerprint only selects
+//! the slot and discards most of the mismatches); a suffix that is not found falls back to the backward search.
+//! Only suffixes whose length is a power of two between the minimum and maximum lengths are cached, so a query hashes
+//! O(m) symbols to look up and record its suffixes.
+class SuffixRangeCache {
+ public:
+  using Toehold = KmerTable::Toehold;
+
+  struct Entry {
+    std::size_t start;
+    std::size_t end;
+    bool has_toehold; // Entries recorded by count have no toehold data
+    Toehold toehold;
+  };
+
+  struct Fingerprint {
+    uint64_t h = 0;
+
+    //! Extend the fingerprint with the previous symbol of the suffix
+    void prepend(uint8_t t_c) {
+      h = (h + t_c + 1) * 0x9E3779B97F4A7C15ULL;
+      h ^= h >> 32;
+    }
+  };
+
+  SuffixRangeCache() = default;
+
+  //! Constructor
+  //! \param t_max_bytes Memory cap of the cache (0 disables it)
+  //! \param t_min_length Minimum length of the cached suffixes
+  //! \param t_max_length Maximum length of the cached suffixes, whose symbols are stored in each slot
+  explicit SuffixRangeCache(std::size_t t_max_bytes, std::size_t t_min_length = 8, std::size_t t_max_length = 64) {
+    reset(t_max_bytes, t_min_length, t_max_length);
+  }
+
+  //! Reallocate (and clear) the cache. It must not be called while there are queries running.
+  void reset(std::size_t t_max_bytes, std::size_t t_min_length = 8, std::size_t t_max_length = 64) {
+    min_length_ = std::max<std::size_t>(t_min_length, 1);
+    max_length_ = std::max(t_max_length, min_length_);
+    key_words_ = (max_length_ + 7) / 8;
+    n_slots_ = t_max_bytes / (sizeof(Slot) + key_words_ * sizeof(uint64_t));
+    slots_ = n_slots_ ? std::make_unique<Slot[]>(n_slots_) : nullptr;
+    keys_ = n_slots_ ? std::make_unique<std::atomic<uint64_t>[]>(n_slots_ * key_words_) : nullptr;
+    lookups_ = 0;
+    hits_ = 0;
+    inserts_ = 0;
+  }
+
+  bool enabled() const { return n_slots_ > 0; }
+
+  std::size_t minLength() const { return min_length_; }
+
+  std::size_t maxLength() const { return max_length_; }
+
+  //! Whether the suffixes of the given length are cached
+  bool isCachedLength(std::size_t t_length) const {
+    return min_length_ <= t_length && t_length <= max_length_ && (t_length & (t_length - 1)) == 0;
+  }
+
+  std::size_t sizeInBytes() const { return n_slots_ * (sizeof(Slot) + key_words_ * sizeof(uint64_t)); }
+
+  std::size_t lookups() const { return lookups_.load(std::memory_order_relaxed); }
+
+  std::size_t hits() const { return hits_.load(std::memory_order_relaxed); }
+
+  std::size_t inserts() const { return inserts_.load(std::memory_order_relaxed); }
+
+  double hitRate() const { return lookups() ? double(hits()) / lookups() : 0.0; }
+
+  //! Fingerprint of the suffix of the given length
+  template<typename TPattern>
+  static Fingerprint fingerprint(const TPattern &t_pattern, std::size_t t_length) {
+    Fingerprint fp;
+    auto it = std::end(t_pattern);
+    for (std::size_t i = 0; i < t_length; ++i) fp.prepend(*--it);
+    return fp;
+  }
+
+  //! Find the longest cached suffix of the pattern that is longer than the given length
+  //! \param t_need_toehold Skip the entries without toehold data
+  //! \return Length of the suffix and its entry
+  template<typename TPattern>
+  std::optional<std::pair<std::size_t, Entry>> findLongest(const TPattern &t_pattern,
+                                                           std::size_t t_min_exclusive,
+                                                           bool t_need_toehold) const {
+    if (!enabled() || t_pattern.size() < min_length_) return std::nullopt;
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+
+    // Fingerprints of the suffixes with cacheable lengths (powers of two), computed in a single pass
+    std::array<std::pair<std::size_t, Fingerprint>, 64> candidates;
+    std::size_t n_candidates = 0;
+    Fingerprint fp;
+    auto it = std::end(t_pattern);
+    for (std::size_t len = 1; len <= std::min(t_pattern.size(), max_length_); ++len) {
+      fp.prepend(*--it);
+      if (isCachedLength(len)) candidates[n_candidates++] = {len, fp};
+    }
+
+    for (; n_candidates > 0 && t_min_exclusive < candidates[n_candidates - 1].first; --n_candidates) {
+      const auto &[len, len_fp] = candidates[n_candidates - 1];
+      auto entry = find(t_pattern, len_fp, len);
+      if (entry && (entry->has_toehold || !t_need_toehold)) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return std::make_pair(len, *entry);
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  //! Entry of the suffix of the pattern with the given length
+  template<typename TPattern>
+  std::optional<Entry> find(const TPattern &t_pattern, std::size_t t_length) const {
+    if (!enabled() || !isCachedLength(t_length) || t_pattern.size() < t_length) return std::nullopt;
+    return find(t_pattern, fingerprint(t_pattern, t_length), t_length);
+  }
+
+  //! Insert (or replace) the entry of the suffix of the pattern with the given length.
+  //! It gives up if another thread is writing the slot.
+  template<typename TPattern>
+  void insert(const TPattern &t_pattern, std::size_t t_length, const Entry &t_entry) {
+    if (!enabled() || !isCachedLength(t_length) || t_pattern.size() < t_length) return;
+
+    const auto fp = fingerprint(t_pattern, t_length);
+    const auto i = index(fp, t_length);
+    auto &slot = slots_[i];
+
+    auto version = slot.version.load(std::memory_order_relaxed);
+    if ((version & 1u) || !slot.version.compare_exchange_strong(version, version + 1, std::memory_order_acquire)) {
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.h.store(fp.h, std::memory_order_relaxed);
+    slot.length.store(t_length, std::memory_order_relaxed);
+    slot.start.store(t_entry.start, std::memory_order_relaxed);
+    slot.end.store(t_entry.end, std::memory_order_relaxed);
+    slot.has_toehold.store(t_entry.has_toehold, std::memory_order_relaxed);
+    slot.offset.store(t_entry.toehold.offset, std::memory_order_relaxed);
+    slot.c.store(t_entry.toehold.c, std::memory_order_relaxed);
+    slot.run_rank.store(t_entry.toehold.run_rank, std::memory_order_relaxed);
+    slot.value.store(t_entry.toehold.value, std::memory_order_relaxed);
+    auto *key = &keys_[i * key_words_];
+    for (std::size_t w = 0; w < (t_length + 7) / 8; ++w) {
+      key[w].store(keyWord(t_pattern, t_length, w), std::memory_order_relaxed);
+    }
+
+    slot.version.store(version + 2, std::memory_order_release);
+    inserts_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> version{0}; // Odd while being written; 0 if empty
+    std::atomic<uint64_t> h{0};
+    std::atomic<uint64_t> length{0};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+    std::atomic<uint64_t> has_toehold{0};
+    std::atomic<uint64_t> offset{0};
+    std::atomic<uint64_t> c{0};
+    std::atomic<uint64_t> run_rank{0};
+    std::atomic<uint64_t> value{0};
+  };
+
+  //! Entry of the suffix of the pattern with the given fingerprint and length, if the stored symbols match it
+  template<typename TPattern>
+  std::optional<Entry> find(const TPattern &t_pattern, const Fingerprint &t_fp, std::size_t t_length) const {
+    const auto i = index(t_fp, t_length);
+    const auto &slot = slots_[i];
+
+    auto version = slot.version.load(std::memory_order_acquire);
+    if (version == 0 || (version & 1u)) return std::nullopt; // Empty or being written
+
+    if (slot.h.load(std::memory_order_relaxed) != t_fp.h
+        || slot.length.load(std::memory_order_relaxed) != t_length) {
+      return std::nullopt;
+    }
+    const auto *key = &keys_[i * key_words_];
+    for (std::size_t w = 0; w < (t_length + 7) / 8; ++w) {
+      if (key[w].load(std::memory_order_relaxed) != keyWord(t_pattern, t_length, w)) return std::nullopt;
+    }
+    Entry entry{slot.start.load(std::memory_order_relaxed),
+                slot.end.load(std::memory_order_relaxed),
+                slot.has_toehold.load(std::memory_order_relaxed) != 0,
+                {slot.offset.load(std::memory_order_relaxed),
+                 slot.c.load(std::memory_order_relaxed),
+                 slot.run_rank.load(std::memory_order_relaxed),
+                 slot.value.load(std::memory_order_relaxed)}};
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.version.load(std::memory_order_relaxed) != version) return std::nullopt; // Overwritten meanwhile
+
+    return entry;
+  }
+
+  //! Symbols [8 * t_w, 8 * t_w + 8) of the suffix of the pattern with the given length, packed in a word
+  template<typename TPattern>
+  static uint64_t keyWord(const TPattern &t_pattern, std::size_t t_length, std::size_t t_w) {
+    auto first = std::end(t_pattern) - t_length;
+    uint64_t word = 0;
+    for (std::size_t i = 8 * t_w, e = std::min(t_length, 8 * t_w + 8); i < e; ++i) {
+      word |= uint64_t(uint8_t(first[i])) << (8 * (i - 8 * t_w));
+    }
+    return word;
+  }
+
+  std::size_t index(const Fingerprint &t_fp, std::size_t t_length) const {
+    auto h = t_fp.h ^ (t_length * 0xC2B2AE3D27D4EB4FULL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h % n_slots_;
+  }
+
+  std::unique_ptr<Slot[]> slots_;
+  std::unique_ptr<std::atomic<uint64_t>[]> keys_; // Symbols of the suffix of each slot, key_words_ words per slot
+  std::size_t n_slots_ = 0;
+  std::size_t key_words_ = 0;
+  std::size_t min_length_ = 8;
+  std::size_t max_length_ = 64;
+
+  mutable std::atomic<std::size_t> lookups_{0};
+  mutable std::atomic<std::size_t> hits_{0};
+  std::atomic<std::size_t> inserts_{0};
+};
+
+//! Seed for the backward search that resumes from the longest cached suffix of the pattern (or from another seed,
+//! e.g., the k-mer table, if it skips more steps), and records the states of the cacheable suffixes.
+//! \tparam TSeed Fallback seed
+//! \tparam TCreateToeholdData Function to create the toehold data from the cached data and the pattern step
+//! \tparam TGetToehold Function to get the cached data from the toehold data and the pattern length
+template<typename TSeed, typename TCreateToeholdData, typename TGetToehold>
+class SeedBackwardSearchWithCache {
+ public:
+  SeedBackwardSearchWithCache(const TSeed &t_seed,
+                              std::shared_ptr<SuffixRangeCache> t_cache,
+                              const TCreateToeholdData &t_create_toehold_data,
+                              const TGetToehold &t_get_toehold)
+      : seed_{t_seed},
+        cache_{std::move(t_cache)},
+        create_toehold_data_{t_create_toehold_data},
+        get_toehold_{t_get_toehold} {}
+
+  //! Seed for count
+  template<typename TPattern, typename TRange>
+  std::size_t operator()(const TPattern &t_pattern, TRange &t_range) const {
+    auto k = seed_(t_pattern, t_range);
+
+    auto cached = cache_->findLongest(t_pattern, k, false);
+    if (!cached) return k;
+
+    const auto &[len, entry] = *cached;
+    t_range = TRange{entry.start, entry.end};
+    return len;
+  }
+
+  //! Seed for locate
+  template<typename TPattern, typename TRange, typename TToeholdData>
+  std::size_t operator()(const TPattern &t_pattern, TRange &t_range, TToeholdData &t_toehold_data) const {
+    auto k = seed_(t_pattern, t_range, t_toehold_data);
+
+    auto cached = cache_->findLongest(t_pattern, k, true);
+    if (!cached) return k;
+
+    const auto &[len, entry] = *cached;
+    t_range = TRange{entry.start, entry.end};
+    t_toehold_data = create_toehold_data_(entry.toehold, t_pattern.size() - 1 - entry.toehold.offset);
+    return len;
+  }
+
+  //! Record the state for count after processing the given number of symbols
+  template<typename TPattern, typename TRange>
+  void record(const TPattern &t_pattern, std::size_t t_n_processed, const TRange &t_range) const {
+    const auto &[start, end] = t_range;
+    if (!cache_->enabled() || !cache_->isCachedLength(t_n_processed) || !(start < end)) return;
+
+    SuffixRangeCache::Entry entry{start, end, false, {}};
+    cache_->insert(t_pattern, t_n_processed, entry);
+  }
+
+  //! Record the state for locate after processing the given number of symbols
+  template<typename TPattern, typename TRange, typename TToeholdData>
+  void record(const TPattern &t_pattern,
+              std::size_t t_n_processed,
+              const TRange &t_range,
+              const TToeholdData &t_toehold_data) const {
+    const auto &[start, end] = t_range;
+    if (!cache_->enabled() || !cache_->isCachedLength(t_n_processed) || !(start < end)) return;
+
+    // The toehold offset is relative to the end of the pattern, so the entry is valid for any pattern with this suffix
+    SuffixRangeCache::Entry entry{start, end, true, get_toehold_(t_toehold_data, t_pattern.size())};
+    cache_->insert(t_pattern, t_n_processed, entry);
+  }
+
+ private:
+  TSeed seed_;
+  std::shared_ptr<SuffixRangeCache> cache_;
+  TCreateToeholdData create_toehold_data_;
+  TGetToehold get_toehold_;
+};
+
+}
+
+#endif //SRI_SUFFIX_CACHE_H_
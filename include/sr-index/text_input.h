@@ -0,0 +1,212 @@
+//
+// Streaming input of the text to be indexed: plain, gzip or zstd files, or the standard input.
+//
+
+#ifndef SRI_TEXT_INPUT_H_
+#define SRI_TEXT_INPUT_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sri {
+
+//! Input read in blocks from a file, from the standard input ("-"), or from a gzip or zstd file (detected by its magic
+//! number). The compressed files are decompressed on the fly by the gzip and zstd tools.
+class InputStream {
+ public:
+  static constexpr const char *kStdin = "-";
+
+  explicit InputStream(const std::string &t_file) : file_{t_file} {
+    if (t_file == kStdin) {
+      stream_ = stdin;
+      return;
+    }
+
+    stream_ = std::fopen(t_file.c_str(), "rb");
+    if (!stream_) {
+      throw std::invalid_argument("Error: cannot open input \"" + t_file + "\"");
+    }
+
+    const auto decompressor = decompressorFor(stream_);
+    if (!decompressor.empty()) {
+      std::fclose(stream_);
+      stream_ = popen((decompressor + " -dc -- " + quoted(t_file)).c_str(), "r");
+      if (!stream_) {
+        throw std::runtime_error("Error: cannot run " + decompressor + " to read \"" + t_file + "\"");
+      }
+      decompressor_ = decompressor;
+    }
+  }
+
+  InputStream(const InputStream &) = delete;
+  InputStream &operator=(const InputStream &) = delete;
+
+  ~InputStream() {
+    if (stream_) closeStream();
+  }
+
+  //! Whether the file is compressed, so it is decompressed while it is read
+  static bool isCompressed(const std::string &t_file) {
+    if (t_file == kStdin) return false;
+    std::FILE *stream = std::fopen(t_file.c_str(), "rb");
+    if (!stream) return false;
+    const bool compressed = !decompressorFor(stream).empty();
+    std::fclose(stream);
+    return compressed;
+  }
+
+  //! Size of the (decompressed) input if it can be told before reading it, or 0, e.g., to reserve the memory of the
+  //! text. For a gzip file, it is the size recorded in its trailer (modulo 2^32), and for a zstd file, the content size
+  //! of its first frame, if it is recorded.
+  static std::size_t sizeHint(const std::string &t_file) {
+    std::error_code ec;
+    if (t_file == kStdin || !std::filesystem::is_regular_file(t_file, ec)) return 0;
+    const auto file_size = std::filesystem::file_size(t_file, ec);
+    if (ec) return 0;
+
+    std::FILE *stream = std::fopen(t_file.c_str(), "rb");
+    if (!stream) return 0;
+    const auto decompressor = decompressorFor(stream);
+    std::size_t size = file_size;
+    if (decompressor == "gzip") {
+      size = gzipSize(stream, file_size);
+    } else if (decompressor == "zstd") {
+      size = zstdSize(stream);
+    }
+    std::fclose(stream);
+    return size;
+  }
+
+  //! Read up to t_size bytes
+  //! \return Number of bytes read, 0 at the end of the input
+  std::size_t read(char *t_buffer, std::size_t t_size) {
+    auto n = std::fread(t_buffer, 1, t_size, stream_);
+    if (n < t_size && std::ferror(stream_)) {
+      throw std::runtime_error("Error: cannot read input \"" + file_ + "\"");
+    }
+    return n;
+  }
+
+  //! Close the input, checking that the decompressor (if any) succeeded
+  void close() {
+    if (closeStream() != 0) {
+      throw std::runtime_error("Error: " + decompressor_ + " failed to decompress \"" + file_ + "\"");
+    }
+  }
+
+ private:
+  //! Name of the tool decompressing the file, or empty if it is not compressed
+  static std::string decompressorFor(std::FILE *t_stream) {
+    std::array<unsigned char, 4> magic{};
+    const auto n = std::fread(magic.data(), 1, magic.size(), t_stream);
+    std::rewind(t_stream);
+
+    if (2 <= n && magic[0] == 0x1F && magic[1] == 0x8B) return "gzip";
+    if (4 <= n && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) return "zstd";
+    return "";
+  }
+
+  //! Size recorded in the last 4 bytes (little-endian) of the gzip file
+  static std::size_t gzipSize(std::FILE *t_stream, std::size_t t_file_size) {
+    std::array<unsigned char, 4> trailer{};
+    if (t_file_size < 18 || std::fseek(t_stream, -4, SEEK_END) != 0) return 0;
+    if (std::fread(trailer.data(), 1, trailer.size(), t_stream) != trailer.size()) return 0;
+    return littleEndian(trailer.data(), trailer.size());
+  }
+
+  //! Content size in the header of the first frame of the zstd file, if it is recorded
+  static std::size_t zstdSize(std::FILE *t_stream) {
+    // Magic number, frame header descriptor, window descriptor, dictionary id and frame content size
+    std::array<unsigned char, 18> header{};
+    const auto n = std::fread(header.data(), 1, header.size(), t_stream);
+    if (n < 5) return 0;
+
+    const unsigned fcs_flag = header[4] >> 6;
+    const bool single_segment = header[4] & 0x20;
+    const std::size_t fcs_pos = 5 + !single_segment + std::array<std::size_t, 4>{0, 1, 2, 4}[header[4] & 0x3];
+    const std::size_t fcs_size = fcs_flag ? std::size_t{1} << fcs_flag : single_segment;
+    if (fcs_size == 0 || n < fcs_pos + fcs_size) return 0;
+
+    return littleEndian(header.data() + fcs_pos, fcs_size) + (fcs_size == 2 ? 256 : 0);
+  }
+
+  static std::size_t littleEndian(const unsigned char *t_bytes, std::size_t t_size) {
+    std::size_t value = 0;
+    for (std::size_t i = t_size; 0 < i; --i) value = (value << 8) | t_bytes[i - 1];
+    return value;
+  }
+
+  static std::string quoted(const std::string &t_str) {
+    std::string quoted = "'";
+    for (auto c : t_str) {
+      if (c == '\'') quoted += "'\\''";
+      else quoted += c;
+    }
+    return quoted + "'";
+  }
+
+  int closeStream() {
+    int status = 0;
+    if (!decompressor_.empty()) status = pclose(stream_);
+    else if (stream_ != stdin) status = std::fclose(stream_);
+    stream_ = nullptr;
+    return status;
+  }
+
+  std::string file_;
+  std::string decompressor_;
+  std::FILE *stream_ = nullptr;
+};
+
+//! Statistics of a byte text computed while it is read
+struct TextStats {
+  std::size_t size = 0; // Number of symbols read (without the appended zero symbol)
+  std::array<std::size_t, 256> histogram{}; // Occurrences of each symbol
+
+  //! Number of distinct symbols
+  std::size_t sigma() const {
+    return std::count_if(histogram.begin(), histogram.end(), [](auto tt_count) { return 0 < tt_count; });
+  }
+};
+
+//! Read the byte text in blocks, passing each block to t_consume(tt_data, tt_size), while it computes the histogram of
+//! the symbols and validates that the zero symbol can only be the last one.
+//! A single pass, without keeping the whole text.
+//! \param t_input Text file, "-" for the standard input, or a gzip or zstd file
+//! \return Statistics of the text read
+template<typename TConsume>
+TextStats streamText(const std::string &t_input, const TConsume &t_consume, std::size_t t_block_size = 1 << 22) {
+  InputStream in(t_input);
+  TextStats stats;
+  std::vector<char> block(t_block_size);
+
+  std::size_t n;
+  while ((n = in.read(block.data(), block.size())) > 0) {
+    // A zero symbol is only allowed at the end, so a previous block cannot have had one
+    if (stats.histogram[0]) {
+      throw std::logic_error("Error: File \"" + t_input + "\" contains inner zero symbol.");
+    }
+
+    for (std::size_t i = 0; i < n; ++i) ++stats.histogram[(uint8_t) block[i]];
+    if (stats.histogram[0] && (1 < stats.histogram[0] || block[n - 1] != 0)) {
+      throw std::logic_error("Error: File \"" + t_input + "\" contains inner zero symbol.");
+    }
+
+    t_consume(block.data(), n);
+    stats.size += n;
+  }
+
+  in.close();
+  return stats;
+}
+
+}
+
+#endif //SRI_TEXT_INPUT_H_
@@ -0,0 +1,133 @@
+//
+// Tuning of the subsampling parameter s: index size and query latency over a grid of values.
+//
+
+#ifndef SRI_TUNE_H_
+#define SRI_TUNE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "config.h"
+
+namespace sri {
+
+//! Index size and average query latency for a subsampling parameter s
+struct TuningPoint {
+  std::size_t s = 0;
+  std::size_t size_in_bytes = 0;
+  double count_ns = 0; // Nanoseconds per pattern
+  double locate_ns = 0; // Nanoseconds per pattern
+  std::size_t n = 0; // Length of the text (decompressed, if it is read from a compressed file)
+  std::size_t count_occs = 0; // Occurrences of the patterns, added up from the count ranges
+  std::size_t locate_occs = 0; // Occurrences of the patterns reported by locate
+};
+
+//! Pareto frontier of the points in (size, locate latency), i.e., the points not dominated by any other
+//! \return Frontier points sorted by increasing size (and thus by decreasing latency)
+inline std::vector<TuningPoint> paretoFrontier(std::vector<TuningPoint> t_points) {
+  std::sort(t_points.begin(), t_points.end(), [](const auto &tt_a, const auto &tt_b) {
+    return tt_a.size_in_bytes < tt_b.size_in_bytes
+        || (tt_a.size_in_bytes == tt_b.size_in_bytes && tt_a.locate_ns < tt_b.locate_ns);
+  });
+
+  std::vector<TuningPoint> frontier;
+  for (const auto &point : t_points) {
+    if (frontier.empty() || point.locate_ns < frontier.back().locate_ns) {
+      frontier.emplace_back(point);
+    }
+  }
+
+  return frontier;
+}
+
+//! Choose the subsampling parameter under the given constraints (0 means no constraint):
+//! the fastest point within the memory budget, and, with a latency target, the smallest point meeting it.
+//! \param t_budget Memory budget in bytes
+//! \param t_latency Latency target of locate in nanoseconds per pattern
+//! \return Chosen point, or nullopt if no point meets the constraints or there are no constraints
+inline std::optional<TuningPoint> chooseSubsampleRate(const std::vector<TuningPoint> &t_points,
+                                                      std::size_t t_budget,
+                                                      double t_latency) {
+  if (!t_budget && t_latency <= 0) return std::nullopt;
+
+  std::optional<TuningPoint> chosen;
+  for (const auto &point : paretoFrontier(t_points)) {
+    if (t_budget && t_budget < point.size_in_bytes) break;
+    if (0 < t_latency && t_latency < point.locate_ns) continue;
+
+    chosen = point;
+    // The frontier is sorted by size, so the first point meeting a latency target is the smallest one
+    if (0 < t_latency) break;
+  }
+
+  return chosen;
+}
+
+//! Sample of the patterns for tuning (fixed seed, so the measures are reproducible)
+inline std::vector<std::string> samplePatterns(const std::vector<std::string> &t_patterns, std::size_t t_size) {
+  if (t_patterns.size() <= t_size) return t_patterns;
+
+  std::vector<std::string> sample;
+  sample.reserve(t_size);
+  std::sample(t_patterns.begin(), t_patterns.end(), std::back_inserter(sample), t_size, std::mt19937_64(42));
+  return sample;
+}
+
+//! Measure the size and the average latency of count and locate for the given index
+template<typename TIndex>
+TuningPoint measureIndex(const TIndex &t_index, const std::vector<std::string> &t_patterns) {
+  TuningPoint point;
+  point.s = t_index.SubsampleRate();
+  point.n = t_index.sizeSequence();
+  for (const auto &part : t_index.breakdown()) point.size_in_bytes += part.second;
+
+  if (t_patterns.empty()) return point;
+
+  // The occurrences are returned, so the queries cannot be optimized away
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (const auto &pattern : t_patterns) {
+    auto [start, end] = t_index.Count(pattern); // Range [start, end)
+    if (start < end) point.count_occs += end - start;
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  for (const auto &pattern : t_patterns) {
+    point.locate_occs += t_index.Locate(pattern).size();
+  }
+  auto t3 = std::chrono::high_resolution_clock::now();
+
+  point.count_ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count()) / t_patterns.size();
+  point.locate_ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count()) / t_patterns.size();
+
+  return point;
+}
+
+//! Build the index for each subsampling parameter in the grid and measure it.
+//! All the indexes share the configuration (and its cache), so the items that do not depend on s (SA, BWT, runs,
+//! RLE BWT, sorted marks, ...) are built once; only the subsampled items, keyed by the "<s>_" prefix, are built per s.
+//! \tparam TIndex Index type, constructible from s
+//! \return Measures in the grid order
+template<typename TIndex>
+std::vector<TuningPoint> tuneSubsampleRate(const std::string &t_data_path,
+                                           Config &t_config,
+                                           const std::vector<std::size_t> &t_grid,
+                                           const std::vector<std::string> &t_patterns) {
+  std::vector<TuningPoint> points;
+  for (const auto &s : t_grid) {
+    TIndex index(s);
+    construct(index, t_data_path, t_config);
+    points.emplace_back(measureIndex(index, t_patterns));
+  }
+
+  return points;
+}
+
+}
+
+#endif //SRI_TUNE_H_
@@ -0,0 +1,237 @@
+//
+// Persistent work directory for the construction, with a manifest of the completed stages.
+//
+
+#ifndef SRI_WORK_DIR_H_
+#define SRI_WORK_DIR_H_
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "config.h"
+
+namespace sri {
+
+//! Manifest of the construction stages completed in a work directory.
+//! Each cached file of the directory is recorded once it is completely written, with its size, checksum and the
+//! construction parameters. A file of the directory is only trusted (i.e., its stage is skipped) if it is recorded with
+//! the current parameters and its size and checksum match, so a construction that died in any stage resumes at the first
+//! incomplete one. The manifest is stored in the directory as JSON, written atomically (temporary file and rename).
+class StageManifest {
+ public:
+  inline static const std::string kFileName = "manifest.json";
+
+  //! Constructor
+  //! \param t_dir Work directory (created if it does not exist)
+  //! \param t_params Construction parameters; the stages recorded with other parameters are not trusted
+  StageManifest(const std::filesystem::path &t_dir, JSON t_params) : dir_{t_dir}, params_(std::move(t_params)) {
+    std::filesystem::create_directories(dir_);
+
+    std::ifstream in(dir_ / kFileName);
+    if (!in) return;
+
+    JSON manifest;
+    try {
+      in >> manifest;
+    } catch (const JSON::exception &) {
+      return; // Corrupted manifest: nothing is trusted
+    }
+    for (const auto &stage : manifest.value("stages", JSON::array())) {
+      stages_[stage.at("file").get<std::string>()] = stage;
+    }
+  }
+
+  const std::filesystem::path &dir() const { return dir_; }
+
+  const JSON &params() const { return params_; }
+
+  //! Whether the file of the directory was completely written with the current parameters
+  //! \param t_file File name (relative to the work directory)
+  bool isComplete(const std::string &t_file) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stages_.find(t_file);
+    if (it == stages_.end() || it->second.at("params") != params_) return false;
+
+    const auto path = dir_ / t_file;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec || size != it->second.at("size").get<uint64_t>()) return false;
+
+    // The checksum is verified once per run
+    if (!verified_.count(t_file)) {
+      if (checksum(path) != it->second.at("checksum").get<uint64_t>()) return false;
+      verified_.insert(t_file);
+    }
+
+    return true;
+  }
+
+  //! Record the file as completely written
+  //! \param t_file File name (relative to the work directory)
+  void record(const std::string &t_file, const std::string &t_key = "") {
+    const auto path = dir_ / t_file;
+    JSON stage = {
+        {"file", t_file},
+        {"key", t_key},
+        {"size", std::filesystem::file_size(path)},
+        {"checksum", checksum(path)},
+        {"params", params_}
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_[t_file] = std::move(stage);
+    verified_.insert(t_file);
+    save();
+  }
+
+  //! Number of trusted stages
+  std::size_t size() const { return stages_.size(); }
+
+  //! 64-bit FNV-1a checksum of the file, processed by words
+  static uint64_t checksum(const std::filesystem::path &t_file) {
+    std::ifstream in(t_file, std::ios::binary);
+    std::vector<char> buffer(1 << 20);
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+      const std::size_t n = in.gcount();
+      std::size_t i = 0;
+      for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, buffer.data() + i, sizeof(uint64_t));
+        hash = (hash ^ word) * 0x100000001B3ULL;
+      }
+      for (; i < n; ++i) {
+        hash = (hash ^ uint8_t(buffer[i])) * 0x100000001B3ULL;
+      }
+    }
+    return hash;
+  }
+
+ private:
+  void save() const {
+    JSON manifest = {{"params", params_}, {"stages", JSON::array()}};
+    for (const auto &[file, stage] : stages_) manifest["stages"].push_back(stage);
+
+    const auto path = dir_ / kFileName;
+    const auto tmp_path = dir_ / (kFileName + ".tmp");
+    {
+      std::ofstream out(tmp_path);
+      out << manifest.dump(2);
+    }
+    std::filesystem::rename(tmp_path, path);
+  }
+
+  std::filesystem::path dir_;
+  JSON params_;
+  std::map<std::string, JSON> stages_;
+  std::set<std::string> verified_;
+  std::mutex mutex_;
+};
+
+//! Construction parameters that determine the content of the cached files
+inline JSON workDirParams(const Config &t_config) {
+  JSON params = {
+      {"data", t_config.data_path.string()},
+      {"sa_algo", int(t_config.sa_algo)},
+      {"doc_separator", int(t_config.doc_separator)},
+      {"kmer_k", t_config.kmer_k},
+      {"kmer_budget", t_config.kmer_budget}
+  };
+
+  if (t_config.sa_algo == IMPORTED) {
+    const auto &spec = t_config.import;
+    params["import"] = {
+        {"bwt_format", spec.bwt_format},
+        {"samples_format", spec.samples_format},
+        {"ssa_file", spec.ssa_file},
+        {"esa_file", spec.esa_file},
+        {"sa_file", spec.sa_file},
+        {"int_bytes", spec.int_bytes},
+        {"run_length_bytes", spec.run_length_bytes}
+    };
+  }
+
+  // Identify the version of the input by its size and modification time, which the standard input or a pipe lack
+  std::error_code ec;
+  const auto status = std::filesystem::status(t_config.data_path, ec);
+  if (t_config.data_path == "-" || (std::filesystem::exists(status) && !std::filesystem::is_regular_file(status))) {
+    throw std::invalid_argument("Error: the input \"" + t_config.data_path.string()
+                                    + "\" of a work directory must be a regular file, so its changes are detected");
+  }
+  auto size = std::filesystem::file_size(t_config.data_path, ec);
+  if (!ec) {
+    params["data_size"] = size;
+    params["data_mtime"] = std::filesystem::last_write_time(t_config.data_path).time_since_epoch().count();
+  }
+
+  return params;
+}
+
+//! Open work directories by path
+inline std::map<std::filesystem::path, std::shared_ptr<StageManifest>> &workDirs() {
+  static std::map<std::filesystem::path, std::shared_ptr<StageManifest>> work_dirs;
+  return work_dirs;
+}
+
+//! Guard of the open work directories, which are opened by the concurrent constructions of a sharded index
+inline std::mutex &workDirsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+inline std::filesystem::path normalizedDir(const std::filesystem::path &t_dir) {
+  return std::filesystem::absolute(t_dir).lexically_normal();
+}
+
+//! Use the cache directory of the configuration as a persistent work directory with a stage manifest
+inline std::shared_ptr<StageManifest> openWorkDir(const Config &t_config) {
+  auto dir = normalizedDir(t_config.dir);
+  auto params = workDirParams(t_config);
+  std::lock_guard<std::mutex> lock(workDirsMutex());
+  auto &manifest = workDirs()[dir];
+  if (!manifest || manifest->params() != params) {
+    manifest = std::make_shared<StageManifest>(dir, std::move(params));
+  }
+  return manifest;
+}
+
+inline void closeWorkDir(const std::filesystem::path &t_dir) {
+  std::lock_guard<std::mutex> lock(workDirsMutex());
+  workDirs().erase(normalizedDir(t_dir));
+}
+
+//! Manifest of the work directory containing the file, if any
+inline std::shared_ptr<StageManifest> findWorkDir(const std::string &t_file) {
+  std::lock_guard<std::mutex> lock(workDirsMutex());
+  if (workDirs().empty()) return nullptr;
+  auto it = workDirs().find(normalizedDir(std::filesystem::path(t_file).parent_path()));
+  return it != workDirs().end() ? it->second : nullptr;
+}
+
+//! Whether the cached file is complete: recorded in the manifest for files of a work directory, or just existing
+inline bool isCachedFileComplete(const std::string &t_file) {
+  if (auto manifest = findWorkDir(t_file)) {
+    return manifest->isComplete(std::filesystem::path(t_file).filename());
+  }
+  return std::ifstream(t_file).good();
+}
+
+//! Record the cached file as complete if it belongs to a work directory
+inline void recordCachedFile(const std::string &t_file, const std::string &t_key = "") {
+  if (auto manifest = findWorkDir(t_file)) {
+    manifest->record(std::filesystem::path(t_file).filename(), t_key);
+  }
+}
+
+}
+
+#endif //SRI_WORK_DIR_H_
@@ -1,11 +1,29 @@
 #include "CLI11.hpp"
 #include "include/sr-index/sr_index.h"
+#include "include/sr-index/r_csa.h"
+#include "include/sr-index/sr_csa.h"
+#include "include/sr-index/sr_csa_psi.h"
 #include "include/sr-index/construct.h"
 #include "include/sr-index/config.h"
+#include "include/sr-index/numa.h"
+#include "include/sr-index/documents.h"
+#include "include/sr-index/results.h"
+#include "include/sr-index/tune.h"
+#include "include/sr-index/resample.h"
+#include "include/sr-index/merge.h"
+#include "include/sr-index/shards.h"
+#include "include/sr-index/extract.h"
+#include "include/sr-index/matching_statistics.h"
 #include "sri_cli_utils.h"
 
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <optional>
 #include <random>
+#include <thread>
+#include <type_traits>
 
 // Helper: generate a random hex string for unique names
 std::string random_hex(std::size_t length = 16) {
@@ -41,19 +59,122 @@ enum SRI_TYPE{
     SRI_INDEX=0,
     SRI_VALID_MARKS=1,
     SRI_VALID_AREA=2,
+    SRI_R_INDEX=3,
+    SRI_R_CSA=4,
+    SRI_CSA_RAW=5,
+    SRI_SR_CSA=6,
+    SRI_SR_CSA_VALID_MARKS=7,
+    SRI_SR_CSA_VALID_AREA=8,
+    SRI_SR_CSA_SLIM=9,
+    SRI_SR_CSA_SLIM_VALID_MARKS=10,
+    SRI_SR_CSA_SLIM_VALID_AREA=11,
+    SRI_R_CSA_PSI=12,
+    SRI_SR_CSA_PSI=13,
+    SRI_SR_CSA_PSI_VALID_MARKS=14,
+    SRI_SR_CSA_PSI_VALID_AREA=15,
 };
 
+const std::string csa_variants_help = "4=r_csa, 5=csa (whole SA), 6=sr_csa, 7=sr_csa_valid_marks, 8=sr_csa_valid_area, "
+                                      "9=sr_csa_slim, 10=sr_csa_slim_valid_marks, 11=sr_csa_slim_valid_area, "
+                                      "12=r_csa_psi, 13=sr_csa_psi, 14=sr_csa_psi_valid_marks, 15=sr_csa_psi_valid_area";
+
+template<class index_type>
+struct index_tag{ using type = index_type; };
+
+//! Call f(index_tag<index_type>{}, name) with the index type of the CSA-based variant (Psi instead of the BWT).
+//! Returns false if the variant is not one of them
+template<class function_type>
+bool with_csa_variant(int variant, function_type f){
+    switch (variant) {
+        case SRI_R_CSA: f(index_tag<sri::RCSAWithBWTRun<>>{}, "r_csa"); return true;
+        case SRI_CSA_RAW: f(index_tag<sri::CSARaw<>>{}, "csa"); return true;
+        case SRI_SR_CSA: f(index_tag<sri::SrCSA<>>{}, "sr_csa"); return true;
+        case SRI_SR_CSA_VALID_MARKS: f(index_tag<sri::SrCSAValidMark<sri::SrCSA<>>>{}, "sr_csa_valid_marks"); return true;
+        case SRI_SR_CSA_VALID_AREA: f(index_tag<sri::SrCSAValidArea<sri::SrCSA<>>>{}, "sr_csa_valid_area"); return true;
+        case SRI_SR_CSA_SLIM: f(index_tag<sri::SrCSASlim<>>{}, "sr_csa_slim"); return true;
+        case SRI_SR_CSA_SLIM_VALID_MARKS: f(index_tag<sri::SrCSAValidMark<sri::SrCSASlim<>>>{}, "sr_csa_slim_valid_marks"); return true;
+        case SRI_SR_CSA_SLIM_VALID_AREA: f(index_tag<sri::SrCSAValidArea<sri::SrCSASlim<>>>{}, "sr_csa_slim_valid_area"); return true;
+        case SRI_R_CSA_PSI: f(index_tag<sri::RCSAWithPsiRun<>>{}, "r_csa_psi"); return true;
+        case SRI_SR_CSA_PSI: f(index_tag<sri::SrCSAWithPsiRun<>>{}, "sr_csa_psi"); return true;
+        case SRI_SR_CSA_PSI_VALID_MARKS: f(index_tag<sri::SRCSAValidMark<>>{}, "sr_csa_psi_valid_marks"); return true;
+        case SRI_SR_CSA_PSI_VALID_AREA: f(index_tag<sri::SRCSAValidArea<>>{}, "sr_csa_psi_valid_area"); return true;
+        default: return false;
+    }
+}
+
+//! Call f(index_tag<index_type>{}, name) with the index type of the subsample r-index variant extended with text
+//! extraction. Returns false if the variant is not one of them
+template<class function_type>
+bool with_extract_variant(int variant, function_type f){
+    switch (variant) {
+        case SRI_INDEX: f(index_tag<sri::IndexExtract<sri::SrIndex<>>>{}, "sri_ext"); return true;
+        case SRI_VALID_MARKS: f(index_tag<sri::IndexExtract<sri::SrIndexValidMark<>>>{}, "sri_valid_marks_ext"); return true;
+        case SRI_VALID_AREA: f(index_tag<sri::IndexExtract<sri::SrIndexValidArea<>>>{}, "sri_valid_area_ext"); return true;
+        default: return false;
+    }
+}
+
+// The CSA-based variants have neither a suffix cache nor (some of them) a subsampling parameter
+template<class index_type, class = void>
+struct has_suffix_cache : std::false_type {};
+template<class index_type>
+struct has_suffix_cache<index_type, std::void_t<decltype(std::declval<const index_type&>().SuffixCache())>> : std::true_type {};
+
+template<class index_type, class = void>
+struct has_subsample_rate : std::false_type {};
+template<class index_type>
+struct has_subsample_rate<index_type, std::void_t<decltype(std::declval<const index_type&>().SubsampleRate())>> : std::true_type {};
+
+// The extensions with a sampled inverse suffix array (text extraction and matching statistics) take its sampling rate
+template<class index_type, class = void>
+struct has_isa_rate : std::false_type {};
+template<class index_type>
+struct has_isa_rate<index_type, std::void_t<decltype(std::declval<const index_type&>().ISARate())>> : std::true_type {};
+
 struct arguments{
     std::string input_file;
     std::string output_file;
     std::string tmp_dir="";
+    std::string work_dir;
     std::string pat_file;
     size_t n_threads{};
-    size_t ssamp=4;
+    std::vector<size_t> ssamps={4};
     sri::SAAlgo sa_algo = sri::SDSL_LIBDIVSUFSORT;
     SRI_TYPE index_type = SRI_VALID_AREA;
+    std::vector<int> build_types={SRI_VALID_AREA};
+    std::vector<int> resample_types;
+    std::vector<int> merge_types={SRI_VALID_AREA};
+    std::string merge_file;
+    int boundary=1;
     std::string bigbwt_pref;
+    std::string import_bwt;
+    sri::ImportSpec import;
     size_t bytes_sa=5;
+    bool numa=false;
+    bool huge_pages=false;
+    std::vector<std::string> doc_files;
+    int doc_separator=1;
+    size_t kmer_k=0;
+    size_t kmer_budget=0;
+    size_t suffix_cache=0;
+    std::string result_file;
+    std::string result_format="tsv";
+    std::vector<size_t> tune_grid={4, 8, 16, 32, 64, 128, 256};
+    size_t tune_sample=1000;
+    size_t mem_budget=0;
+    size_t memory_limit=0;
+    std::string report_file;
+    double latency=0;
+    bool docs=false;
+    size_t n_shards=0;
+    bool shards=false;
+    bool doc_freqs=false;
+    bool ms=false;
+    bool extract=false;
+    size_t isa_rate=64;
+    size_t extract_pos=0;
+    size_t extract_len=0;
+    size_t context=10;
 };
 
 class MyFormatter : public CLI::Formatter {
@@ -62,48 +183,229 @@ public:
     std::string make_option_opts(const CLI::Option *) const override { return ""; }
 };
 
+//! Load the index (one replica per NUMA node if requested) and report the setup
 template<class index_type>
-void test_count(std::string input_file, std::string& pat_file, std::string index_name){
+sri::ReplicatedIndex<index_type> load_replicas(const std::string& input_file, const arguments& args){
+    if(args.huge_pages){
+        const size_t page_size = sri::defaultHugePageSize();
+        bool enabled = sri::useHugePages();
+        std::cerr<<"Huge pages: "<<(enabled ? "enabled" : "disabled")<<" (page size "<<page_size/1024<<" KB)"<<std::endl;
+    }
 
-    index_type index;
-    sdsl::load_from_file(index, input_file);
+    std::vector<sri::NumaNode> nodes = sri::computeNumaTopology();
+    if(!args.numa){
+        // Single replica shared by all the threads and without binding them to a node
+        sri::NumaNode all;
+        for(auto const& node : nodes) all.cpus.insert(all.cpus.end(), node.cpus.begin(), node.cpus.end());
+        nodes = {all};
+    }
+
+    sri::ReplicatedIndex<index_type> replicas(input_file, nodes);
+    if(args.numa){
+        std::cerr<<"NUMA replication: "<<replicas.size()<<" replica(s)"<<std::endl;
+        for(size_t i=0;i<replicas.size();i++){
+            std::cerr<<"\tnode "<<replicas.node(i).id<<": "<<replicas.node(i).cpus.size()<<" cpus"<<std::endl;
+        }
+    }
+    return replicas;
+}
+
+//! Run a query for every pattern using n_threads threads. Each thread takes a contiguous block of patterns.
+//! The i-th thread is pinned to the node of the (i mod #replicas)-th replica and only queries that replica.
+//! If there is a results writer, each thread reports the answers to its own buffer (outside the measured time).
+//! Returns the total number of occurrences, the accumulated query time and the wall time (nanoseconds).
+template<class index_type, class query_type, class count_type, class report_type>
+std::tuple<size_t, size_t, size_t> run_queries(const sri::ReplicatedIndex<index_type>& replicas,
+                                               const std::vector<std::string>& pat_list,
+                                               size_t n_threads, bool pin, sri::AsyncResultWriter* writer,
+                                               query_type query, count_type count, report_type report){
+    n_threads = std::max<size_t>(1, std::min(n_threads, pat_list.size()));
+    std::vector<size_t> acc_time(n_threads, 0);
+    std::vector<size_t> acc_count(n_threads, 0);
+
+    auto worker = [&](size_t t){
+        const auto& replica = replicas[t % replicas.size()];
+        if(pin) sri::pinThreadToNode(replicas.node(t % replicas.size()));
+        std::optional<sri::AsyncResultWriter::Buffer> buffer;
+        if(writer) buffer.emplace(*writer);
+        const size_t first = (pat_list.size()*t)/n_threads;
+        const size_t last = (pat_list.size()*(t+1))/n_threads;
+        for(size_t i=first;i<last;i++){
+            decltype(query(replica, pat_list[i])) ans;
+            MEASURE(query(replica, pat_list[i]), acc_time[t], ans, std::chrono::nanoseconds)
+            acc_count[t]+=count(ans);
+            if(buffer) report(*buffer, i, std::move(ans));
+        }
+    };
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    if(n_threads==1){
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for(size_t t=0;t<n_threads;t++) threads.emplace_back(worker, t);
+        for(auto& thread : threads) thread.join();
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+    return {std::accumulate(acc_count.begin(), acc_count.end(), size_t(0)),
+            std::accumulate(acc_time.begin(), acc_time.end(), size_t(0)),
+            wall_time};
+}
+
+template<class index_type, class query_type, class count_type, class report_type>
+void test_query(std::string input_file, std::string& pat_file, std::string index_name, const arguments& args,
+                sri::ResultKind kind, query_type query, count_type count, report_type report){
+
+    const sri::ReplicatedIndex<index_type> replicas = load_replicas<index_type>(input_file, args);
+    const index_type& index = replicas[0];
 
     const double bps = double(std::filesystem::file_size(input_file)*8)/double(index.sizeSequence());
     const std::string file = std::filesystem::path(input_file).filename();
-    index_name=index_name+"_s_"+std::to_string(index.SubsampleRate());
+    if constexpr (has_subsample_rate<index_type>::value) index_name=index_name+"_s_"+std::to_string(index.SubsampleRate());
+
+    // Each replica has its own suffix cache
+    if constexpr (has_suffix_cache<index_type>::value) {
+        for(size_t i=0;i<replicas.size();i++) replicas[i].SuffixCache().reset(args.suffix_cache<<20UL);
+    } else if(args.suffix_cache){
+        std::cerr<<"Error: the suffix cache is not available for "<<index_name<<std::endl;
+        exit(1);
+    }
 
     uint64_t n_pats, pat_len;
     const std::vector<std::string> pat_list = file2pat_list(pat_file, n_pats, pat_len);
 
-    size_t acc_time=0;
-    size_t acc_count=0;
-    std::pair<size_t, size_t> ans;
-    for(auto const& p : pat_list) {
-        MEASURE(index.Count(p), acc_time, ans, std::chrono::nanoseconds)
-        acc_count+=ans.second-ans.first+1;
+    std::unique_ptr<sri::AsyncResultWriter> writer;
+    if(!args.result_file.empty()){
+        writer = std::make_unique<sri::AsyncResultWriter>(args.result_file, sri::toResultFormat(args.result_format), kind);
     }
 
-    //std::cout<<std::fixed<<std::setprecision(3);
-    //std::cout<<"Index type \""<<index_name<<"\""<<std::endl;
-    //std::cout<<"\tTotal number of occurrences "<<acc_count<<std::endl;
-    //std::cout<<"\t"<<double(acc_time)/double(n_pats)<<" nanosecs/pat"<<std::endl;
-    //std::cout<<"\t"<<double(acc_time)/double(acc_count)<<" nanosecs/occ"<<std::endl;
+    auto [acc_count, acc_time, wall_time] = run_queries(replicas, pat_list, args.n_threads, args.numa, writer.get(), query, count, report);
+
+    if(writer){
+        writer->close();
+        std::cerr<<"Results ("<<args.result_format<<") written to "<<args.result_file<<std::endl;
+    }
+
+    if constexpr (has_suffix_cache<index_type>::value) {
+        if(args.suffix_cache){
+            size_t lookups=0, hits=0, inserts=0;
+            for(size_t i=0;i<replicas.size();i++){
+                lookups+=replicas[i].SuffixCache().lookups();
+                hits+=replicas[i].SuffixCache().hits();
+                inserts+=replicas[i].SuffixCache().inserts();
+            }
+            std::cerr<<"Suffix cache: "<<hits<<"/"<<lookups<<" hits ("<<(lookups ? 100.0*double(hits)/double(lookups) : 0.0)<<"%), "<<inserts<<" inserts"<<std::endl;
+        }
+    }
 
     const double ns_per_pat = double(acc_time)/double(n_pats);
     const double ns_per_occ = double(acc_time)/double(acc_count);
+    const double pats_per_sec = double(n_pats)*1e9/double(wall_time);
 
     std::cout<<std::fixed<<std::setprecision(3);
-    std::cout<<"#file\tindex_type\tbits_per_sym\tn_pats\tpat_len\tn_occ\tnanosecs/pat\tnanosecs/occ"<<std::endl;
-    std::cout<<file<<"\t"<<index_name<<"\t"<<bps<<"\t"<<n_pats<<"\t"<<pat_len<<"\t"<<acc_count<<"\t"<<ns_per_pat<<"\t"<<ns_per_occ<<std::endl;
+    std::cout<<"#file\tindex_type\tbits_per_sym\tn_pats\tpat_len\tn_occ\tnanosecs/pat\tnanosecs/occ\tthreads\tpats/sec"<<std::endl;
+    std::cout<<file<<"\t"<<index_name<<"\t"<<bps<<"\t"<<n_pats<<"\t"<<pat_len<<"\t"<<acc_count<<"\t"<<ns_per_pat<<"\t"<<ns_per_occ<<"\t"<<std::max<size_t>(1, args.n_threads)<<"\t"<<pats_per_sec<<std::endl;
+}
+
+//! Query every pattern on the sharded index, one pattern at a time, fanning out each query to the shards with
+//! args.n_threads threads. The answers are reported outside the measured time.
+template<class index_type, class query_type, class count_type, class report_type>
+void test_sharded_query(std::string manifest_file, std::string& pat_file, std::string index_name, const arguments& args,
+                        sri::ResultKind kind, query_type query, count_type count, report_type report){
+    if(args.huge_pages){
+        bool enabled = sri::useHugePages();
+        std::cerr<<"Huge pages: "<<(enabled ? "enabled" : "disabled")<<" (page size "<<sri::defaultHugePageSize()/1024<<" KB)"<<std::endl;
+    }
+
+    const sri::ShardedIndex<index_type> index(manifest_file, args.n_threads);
+    std::cerr<<"Shards: "<<index.numShards()<<std::endl;
+
+    const double bps = double(index.sizeInBytes()*8)/double(index.sizeSequence());
+    const std::string file = std::filesystem::path(manifest_file).filename();
+    if constexpr (has_subsample_rate<index_type>::value) index_name=index_name+"_s_"+std::to_string(index.SubsampleRate());
+    index_name=index_name+"_shards_"+std::to_string(index.numShards());
+
+    uint64_t n_pats, pat_len;
+    const std::vector<std::string> pat_list = file2pat_list(pat_file, n_pats, pat_len);
+
+    std::unique_ptr<sri::AsyncResultWriter> writer;
+    std::optional<sri::AsyncResultWriter::Buffer> buffer;
+    if(!args.result_file.empty()){
+        writer = std::make_unique<sri::AsyncResultWriter>(args.result_file, sri::toResultFormat(args.result_format), kind);
+        buffer.emplace(*writer);
+    }
+
+    size_t acc_count=0, acc_time=0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(size_t i=0;i<pat_list.size();i++){
+        decltype(query(index, pat_list[i])) ans;
+        MEASURE(query(index, pat_list[i]), acc_time, ans, std::chrono::nanoseconds)
+        acc_count+=count(ans);
+        if(buffer) report(*buffer, i, std::move(ans));
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    const size_t wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+
+    if(writer){
+        buffer.reset();
+        writer->close();
+        std::cerr<<"Results ("<<args.result_format<<") written to "<<args.result_file<<std::endl;
+    }
+
+    const double ns_per_pat = double(acc_time)/double(n_pats);
+    const double ns_per_occ = double(acc_time)/double(acc_count);
+    const double pats_per_sec = double(n_pats)*1e9/double(wall_time);
+
+    std::cout<<std::fixed<<std::setprecision(3);
+    std::cout<<"#file\tindex_type\tbits_per_sym\tn_pats\tpat_len\tn_occ\tnanosecs/pat\tnanosecs/occ\tthreads\tpats/sec"<<std::endl;
+    std::cout<<file<<"\t"<<index_name<<"\t"<<bps<<"\t"<<n_pats<<"\t"<<pat_len<<"\t"<<acc_count<<"\t"<<ns_per_pat<<"\t"<<ns_per_occ<<"\t"<<std::max<size_t>(1, args.n_threads)<<"\t"<<pats_per_sec<<std::endl;
 }
 
 template<class index_type>
-void test_locate(std::string input_file, std::string& pat_file, std::string index_name){
+void test_count(std::string input_file, std::string& pat_file, std::string index_name, const arguments& args){
+    if(args.shards){
+        // The ranges are local to each shard, so only their sizes are added up
+        test_sharded_query<index_type>(input_file, pat_file, index_name, args, sri::ResultKind::RANGES,
+                                       [](const sri::ShardedIndex<index_type>& index, const std::string& p){ return index.Count(p); },
+                                       [](size_t ans){ return ans; },
+                                       [](sri::AsyncResultWriter::Buffer&, size_t, size_t){});
+        return;
+    }
+    test_query<index_type>(input_file, pat_file, index_name, args, sri::ResultKind::RANGES,
+                           [](const index_type& index, const std::string& p){ return index.Count(p); },
+                           [](const std::pair<size_t, size_t>& ans){ return ans.first<ans.second ? ans.second-ans.first : 0; },
+                           [](sri::AsyncResultWriter::Buffer& out, size_t i, std::pair<size_t, size_t> ans){
+                               out.addRange(i, ans.first, ans.second);
+                           });
+}
+
+template<class index_type>
+void test_locate(std::string input_file, std::string& pat_file, std::string index_name, const arguments& args){
+    if(args.shards){
+        test_sharded_query<index_type>(input_file, pat_file, index_name, args, sri::ResultKind::OCCURRENCES,
+                                       [](const sri::ShardedIndex<index_type>& index, const std::string& p){ return index.Locate(p); },
+                                       [](const std::vector<size_t>& ans){ return ans.size(); },
+                                       [](sri::AsyncResultWriter::Buffer& out, size_t i, std::vector<size_t> ans){
+                                           out.addOccurrences(i, std::move(ans));
+                                       });
+        return;
+    }
+    test_query<index_type>(input_file, pat_file, index_name, args, sri::ResultKind::OCCURRENCES,
+                           [](const index_type& index, const std::string& p){ return index.Locate(p); },
+                           [](const std::vector<size_t>& ans){ return ans.size(); },
+                           [](sri::AsyncResultWriter::Buffer& out, size_t i, std::vector<size_t> ans){
+                               out.addOccurrences(i, std::move(ans));
+                           });
+}
+
+template<class index_type>
+void test_docs(std::string input_file, std::string& pat_file, std::string index_name, bool doc_freqs){
 
     index_type index;
     sdsl::load_from_file(index, input_file);
 
-    const double bps = double(std::filesystem::file_size(input_file)*8)/double(index.sizeSequence());
     const std::string file = std::filesystem::path(input_file).filename();
     index_name=index_name+"_s_"+std::to_string(index.SubsampleRate());
 
@@ -111,25 +413,114 @@ void test_locate(std::string input_file, std::string& pat_file, std::string inde
     const std::vector<std::string> pat_list = file2pat_list(pat_file, n_pats, pat_len);
 
     size_t acc_time=0;
-    size_t acc_count=0;
+    size_t acc_docs=0;
+    size_t acc_occs=0;
     for(auto const& p : pat_list) {
-        std::vector<size_t> occ;
-        MEASURE(index.Locate(p), acc_time, occ, std::chrono::nanoseconds)
-        acc_count+=occ.size();
+        if(doc_freqs){
+            std::vector<std::pair<size_t, size_t>> freqs;
+            MEASURE(index.DocFrequencies(p), acc_time, freqs, std::chrono::nanoseconds)
+            acc_docs+=freqs.size();
+            for(auto const& [doc, freq] : freqs) acc_occs+=freq;
+        } else {
+            std::vector<size_t> docs;
+            MEASURE(index.ListDocs(p), acc_time, docs, std::chrono::nanoseconds)
+            acc_docs+=docs.size();
+        }
     }
 
     const double ns_per_pat = double(acc_time)/double(n_pats);
-    const double ns_per_occ = double(acc_time)/double(acc_count);
+    const double ns_per_doc = double(acc_time)/double(acc_docs);
+
+    std::cout<<std::fixed<<std::setprecision(3);
+    std::cout<<"#file\tindex_type\tn_docs\tn_pats\tpat_len\tn_reported_docs\tn_occ\tnanosecs/pat\tnanosecs/doc"<<std::endl;
+    std::cout<<file<<"\t"<<index_name<<"\t"<<index.NumDocs()<<"\t"<<n_pats<<"\t"<<pat_len<<"\t"<<acc_docs<<"\t";
+    if(doc_freqs) std::cout<<acc_occs; else std::cout<<"-";
+    std::cout<<"\t"<<ns_per_pat<<"\t"<<ns_per_doc<<std::endl;
+}
+
+//! Compute the matching statistics of every pattern. With an output file, each pattern gets a line with its index, the
+//! matching lengths and the text positions ("-" for the length 0), written outside the measured time.
+template<class index_type>
+void test_ms(std::string input_file, std::string& pat_file, std::string index_name, const arguments& args){
+
+    index_type index;
+    sdsl::load_from_file(index, input_file);
+
+    const std::string file = std::filesystem::path(input_file).filename();
+    index_name=index_name+"_s_"+std::to_string(index.SubsampleRate())+"_isa_"+std::to_string(index.ISARate());
+
+    uint64_t n_pats, pat_len;
+    const std::vector<std::string> pat_list = file2pat_list(pat_file, n_pats, pat_len);
+
+    std::ofstream out;
+    if(!args.result_file.empty()) out.open(args.result_file);
+
+    size_t acc_time=0;
+    size_t acc_len=0;
+    size_t n_syms=0;
+    std::vector<size_t> lengths, positions;
+    auto report = [&lengths, &positions](size_t tt_i, size_t tt_len, size_t tt_pos){
+        lengths[tt_i] = tt_len;
+        positions[tt_i] = tt_pos;
+    };
+    for(size_t i=0;i<pat_list.size();i++){
+        const auto& p = pat_list[i];
+        lengths.assign(p.size(), 0);
+        positions.assign(p.size(), 0);
+        MEASURE_VOID(index.MS(p, report), acc_time, std::chrono::nanoseconds)
+        acc_len=std::accumulate(lengths.begin(), lengths.end(), acc_len);
+        n_syms+=p.size();
+
+        if(out.is_open()){
+            out<<i<<"\t";
+            for(size_t j=0;j<lengths.size();j++) out<<(j ? "," : "")<<lengths[j];
+            out<<"\t";
+            for(size_t j=0;j<positions.size();j++){
+                out<<(j ? "," : "");
+                if(lengths[j]) out<<positions[j]; else out<<"-";
+            }
+            out<<"\n";
+        }
+    }
+
+    if(out.is_open()){
+        out.close();
+        std::cerr<<"Matching statistics written to "<<args.result_file<<std::endl;
+    }
+
+    const double avg_len = double(acc_len)/double(n_syms);
+    const double ns_per_pat = double(acc_time)/double(n_pats);
+    const double ns_per_sym = double(acc_time)/double(n_syms);
 
     std::cout<<std::fixed<<std::setprecision(3);
-    std::cout<<"#file\tindex_type\tbits_per_sym\tn_pats\tpat_len\tn_occ\tnanosecs/pat\tnanosecs/occ"<<std::endl;
-    std::cout<<file<<"\t"<<index_name<<"\t"<<bps<<"\t"<<n_pats<<"\t"<<pat_len<<"\t"<<acc_count<<"\t"<<ns_per_pat<<"\t"<<ns_per_occ<<std::endl;
-
-    //std::cout<<std::fixed<<std::setprecision(3);
-    //std::cout<<"Index type \""<<index_name<<"\""<<std::endl;
-    //std::cout<<"\tTotal number of occurrences "<<acc_count<<std::endl;
-    //std::cout<<"\t"<<double(acc_time)/double(n_pats)<<" microsecs/pat"<<std::endl;
-    //std::cout<<"\t"<<double(acc_time)/double(acc_count)<<" microsecs/occ"<<std::endl;
+    std::cout<<"#file\tindex_type\tn_pats\tpat_len\tavg_ms_len\tnanosecs/pat\tnanosecs/sym"<<std::endl;
+    std::cout<<file<<"\t"<<index_name<<"\t"<<n_pats<<"\t"<<pat_len<<"\t"<<avg_len<<"\t"<<ns_per_pat<<"\t"<<ns_per_sym<<std::endl;
+}
+
+//! Print the text substring T[pos..pos+len)
+template<class index_type>
+void extract_int(const std::string& input_file, const arguments& args){
+    index_type index;
+    sdsl::load_from_file(index, input_file);
+    std::cout<<index.Extract(args.extract_pos, args.extract_len)<<std::endl;
+}
+
+//! Print each occurrence of every pattern surrounded by its context, one line per occurrence (sorted by text position)
+//! preceded by the pattern number
+template<class index_type>
+void display_int(const std::string& input_file, std::string& pat_file, const arguments& args){
+    index_type index;
+    sdsl::load_from_file(index, input_file);
+
+    uint64_t n_pats, pat_len;
+    const std::vector<std::string> pat_list = file2pat_list(pat_file, n_pats, pat_len);
+
+    for(size_t i=0;i<pat_list.size();i++){
+        for(auto const& snippet : index.Display(pat_list[i], args.context)){
+            std::cout<<i<<"\t"<<snippet<<"\n";
+        }
+    }
+    std::cout<<std::flush;
 }
 
 static void parse_app(CLI::App& app, struct arguments& args){
@@ -140,55 +531,344 @@ static void parse_app(CLI::App& app, struct arguments& args){
     app.formatter(fmt);
 
     auto * build = app.add_subcommand("build");
-    build->add_option("-s,--ssamp", args.ssamp, "Subsampling parameter (def 4)")->default_val(4);
-    build->add_option("-i,--index-type", args.index_type, "Subsample r-index variant to be constructed (0=standard, 1=valid_marks, 2=valid_area [def=2])")->default_val(SRI_VALID_AREA)->check(CLI::Range(0,2));
-    build->add_option("-t,--threads", args.n_threads, "Maximum number of working threads")->default_val(1);
+    build->add_option("-s,--ssamp", args.ssamps, "Subsampling parameters, e.g., 4,8,16 (def 4). The items that do not depend on s are built once")->delimiter(',');
+    build->add_option("-i,--index-type", args.build_types, "Subsample r-index variants to be constructed, e.g., 0,2 (0=standard, 1=valid_marks, 2=valid_area, 3=r-index, which can be merged or resampled, "+csa_variants_help+" [def=2])")->delimiter(',')->check(CLI::Range(0,15));
+    build->add_option("-j,--threads", args.n_threads, "Maximum number of working threads")->default_val(1);
     build->add_option("-o,--output", args.output_file, "Output file where the index will be stored");
-    build->add_option("-T,--tmp", args.tmp_dir, "Temporary folder (def. /os_tmp/sri_xxxx)")-> check(CLI::ExistingDirectory);
-    auto *build_algo = build->add_option("-a,--sa-algorithm", args.sa_algo, "Algorithm for computing the SA (0=LIBDIVSUFSORT, 1=SE_SAIS, 2=BIG_BWT [def=0])")->default_val(LIBDIVSUFSORT)->check(CLI::Range(0,2));
+    auto *build_tmp = build->add_option("-T,--tmp", args.tmp_dir, "Temporary folder (def. /os_tmp/sri_xxxx)")-> check(CLI::ExistingDirectory);
+    build->add_option("-w,--work-dir", args.work_dir, "Persistent work folder. It keeps a manifest of the completed stages, so a rerun resumes at the first incomplete one")->excludes(build_tmp);
+    build->add_option("--report", args.report_file, "JSON file where the wall time, CPU time, peak RSS, bytes read/written and output size of each construction stage are written");
+    build->add_option("-M,--memory-limit", args.memory_limit, "Keep the intermediate items (text, SA, BWT, ...) in memory up to this size in MB, spilling the rest to disk (def. 0 = all on disk)");
+    auto *build_algo = build->add_option("-a,--sa-algorithm", args.sa_algo, "Algorithm for computing the SA (0=LIBDIVSUFSORT, 1=SE_SAIS, 2=BIG_BWT, 3=PARALLEL_SAIS with --threads [def=0])")->default_val(LIBDIVSUFSORT)->check(CLI::Range(0,3));
 
     auto * group_option = build->add_option_group("Source of the index components (one of the two is mandatory):");
-    auto *text = group_option->add_option("-t,--text", args.input_file, "Input TEXT to be indexed")->check(CLI::ExistingFile);
+    auto *text = group_option->add_option("-t,--text", args.input_file, "Input TEXT to be indexed (\"-\" for the standard input; gzip and zstd files are decompressed on the fly)")->check(CLI::ExistingFile | CLI::IsMember({"-"}));
 
     auto *bwt_pref = group_option->add_option("-b,--bigbwt-pref", args.bigbwt_pref, "BigBWT prefix containing the already computed BWT and SA samples")->expected(1)->check(CLI::ExistingFile);
 
+    auto *docs = group_option->add_option("-d,--docs", args.doc_files, "Documents of the collection to be indexed (each document is terminated by the separator)")->check(CLI::ExistingFile);
+
+    auto *import_bwt = group_option->add_option("-B,--import-bwt", args.import_bwt, "BWT computed by another tool (gzip and zstd files are decompressed on the fly), imported with the SA samples of --import-ssa/--import-esa or --import-sa")->check(CLI::ExistingFile);
+
     group_option->require_option(1,2);
     bwt_pref->excludes(text);
     bwt_pref->excludes(build_algo);
+    docs->excludes(text);
+    docs->excludes(bwt_pref);
+    import_bwt->excludes(text);
+    import_bwt->excludes(bwt_pref);
+    import_bwt->excludes(docs);
+    import_bwt->excludes(build_algo);
+
+    build->add_option("--import-format", args.import.bwt_format, "Format of the imported BWT (plain = a byte per symbol, rle = a byte symbol and its run length [def=plain])")->check(CLI::IsMember({"plain", "rle"}))->needs(import_bwt);
+    auto *import_ssa = build->add_option("--import-ssa", args.import.ssa_file, "Pairs <BWT position, SA value> at the heads of the BWT runs of the imported BWT")->check(CLI::ExistingFile)->needs(import_bwt);
+    auto *import_esa = build->add_option("--import-esa", args.import.esa_file, "Pairs <BWT position, SA value> at the tails of the BWT runs of the imported BWT")->check(CLI::ExistingFile)->needs(import_bwt);
+    auto *import_sa = build->add_option("--import-sa", args.import.sa_file, "Whole SA of the imported BWT, read only at the run boundaries (uncompressed)")->check(CLI::ExistingFile)->needs(import_bwt);
+    build->add_option("--import-int-bytes", args.import.int_bytes, "Bytes of each integer of the imported SA samples, little-endian (def. 5)")->check(CLI::Range(1,8))->needs(import_bwt);
+    build->add_option("--import-run-length-bytes", args.import.run_length_bytes, "Bytes of each run length of an rle BWT, little-endian (def. 4)")->check(CLI::Range(1,8))->needs(import_bwt);
+    import_ssa->needs(import_esa);
+    import_esa->needs(import_ssa);
+    import_sa->excludes(import_ssa);
+    import_sa->excludes(import_esa);
+
+    build->add_option("--shards", args.n_shards, "Split the documents into this number of shards with a similar size, each one with its own index built in parallel (up to --threads at a time). The output is a shard manifest <output>.<variant>.shards")->needs(docs)->check(CLI::PositiveNumber);
+    build->add_option("--doc-separator", args.doc_separator, "Symbol terminating each document of a collection (def. 1). Builds an index supporting document queries")->check(CLI::Range(1,255));
+
+    build->add_option("--kmer-table", args.kmer_k, "Length k of the k-mers whose backward-search state is precomputed, so count/locate skip the first k steps (def. 0 = no table)")->check(CLI::Range(0,32));
+    build->add_option("--kmer-budget", args.kmer_budget, "Maximum size in MB of the k-mer table. Only the most frequent k-mers are kept (def. 0 = unbounded)");
+    auto *build_ms = build->add_flag("--ms", args.ms, "Extend the variants 0-2 with matching statistics (BWT-run thresholds and run boundary samples), for the ms command. The output files get the suffix _ms");
+    build->add_flag("--extract", args.extract, "Extend the variants 0-2 with text extraction, for the extract and display commands. The output files get the suffix _ext")->excludes(build_ms);
+    build->add_option("--isa-rate", args.isa_rate, "Sampling rate of the inverse suffix array used by --ms and --extract to extract the text (def. 64)")->check(CLI::PositiveNumber);
 
     build_algo->needs(text);
 
     auto * count = app.add_subcommand("count");
     count->add_option("INDEX", args.input_file, "Index file")->check(CLI::ExistingFile)->required();
     count->add_option("PAT_FILE", args.pat_file, "List of patterns")->check(CLI::ExistingFile)->required();
-    count->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area)")->required();
+    count->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area, 3=r-index, "+csa_variants_help+")")->required()->check(CLI::Range(0,15));
+    count->add_option("-t,--threads", args.n_threads, "Number of query threads")->default_val(1);
+    auto *count_numa = count->add_flag("--numa", args.numa, "Replicate the index on each NUMA node and pin the query threads to their node");
+    count->add_flag("--huge-pages", args.huge_pages, "Back the index with huge pages");
+    auto *count_cache = count->add_option("--suffix-cache", args.suffix_cache, "Memory cap in MB of the cache of queried pattern suffixes, which lets the queries resume from the longest cached suffix (def. 0 = disabled)");
+    auto *count_output = count->add_option("-o,--output", args.result_file, "File where the ranges [start, end) of each pattern are written (by a background thread)");
+    count->add_flag("--shards", args.shards, "INDEX is the manifest of a sharded index: each query fans out to the shards with --threads threads, adding up their counts")->excludes(count_numa)->excludes(count_cache)->excludes(count_output);
+    count->add_option("--format", args.result_format, "Format of the output file (tsv, binary or varint-delta [def=tsv])")->default_val("tsv")->check(CLI::IsMember({"tsv", "binary", "varint-delta"}));
 
     auto * locate = app.add_subcommand("locate");
     locate->add_option("INDEX", args.input_file, "Index file")->check(CLI::ExistingFile)->required();
     locate->add_option("PAT_FILE", args.pat_file, "List of patterns")->check(CLI::ExistingFile)->required();
-    locate->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area)")->required();
+    locate->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area, 3=r-index, "+csa_variants_help+")")->required()->check(CLI::Range(0,15));
+    locate->add_option("-t,--threads", args.n_threads, "Number of query threads")->default_val(1);
+    auto *locate_numa = locate->add_flag("--numa", args.numa, "Replicate the index on each NUMA node and pin the query threads to their node");
+    locate->add_flag("--huge-pages", args.huge_pages, "Back the index with huge pages");
+    auto *locate_cache = locate->add_option("--suffix-cache", args.suffix_cache, "Memory cap in MB of the cache of queried pattern suffixes, which lets the queries resume from the longest cached suffix (def. 0 = disabled)");
+    locate->add_flag("--shards", args.shards, "INDEX is the manifest of a sharded index: each query fans out to the shards with --threads threads, merging their global positions")->excludes(locate_numa)->excludes(locate_cache);
+    locate->add_option("-o,--output", args.result_file, "File where the occurrences of each pattern are written (by a background thread)");
+    locate->add_option("--format", args.result_format, "Format of the output file (tsv, binary or varint-delta [def=tsv])")->default_val("tsv")->check(CLI::IsMember({"tsv", "binary", "varint-delta"}));
+
+    auto * docs_cmd = app.add_subcommand("docs");
+    docs_cmd->add_option("INDEX", args.input_file, "Index file (built from a document collection)")->check(CLI::ExistingFile)->required();
+    docs_cmd->add_option("PAT_FILE", args.pat_file, "List of patterns")->check(CLI::ExistingFile)->required();
+    docs_cmd->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area)")->required();
+    docs_cmd->add_flag("-f,--freq", args.doc_freqs, "Report the frequency of the patterns in each document");
+
+    auto * tune = app.add_subcommand("tune");
+    tune->add_option("TEXT", args.input_file, "Input TEXT to be indexed")->check(CLI::ExistingFile)->required();
+    tune->add_option("PAT_FILE", args.pat_file, "List of patterns (a sample of them is queried)")->check(CLI::ExistingFile)->required();
+    tune->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area [def=2])")->default_val(SRI_VALID_AREA)->check(CLI::Range(0,2));
+    tune->add_option("-s,--grid", args.tune_grid, "Subsampling parameters to evaluate (def. 4,8,16,32,64,128,256)")->delimiter(',');
+    tune->add_option("-n,--sample", args.tune_sample, "Number of sampled patterns (def. 1000)")->default_val(1000);
+    tune->add_option("-m,--budget", args.mem_budget, "Memory budget in MB: choose the fastest s within it");
+    tune->add_option("-l,--latency", args.latency, "Locate latency target in nanosecs/pat: choose the smallest index meeting it");
+    tune->add_option("-T,--tmp", args.tmp_dir, "Temporary folder (def. /os_tmp/sri_xxxx)")-> check(CLI::ExistingDirectory);
+    tune->add_option("-M,--memory-limit", args.memory_limit, "Keep the intermediate items in memory up to this size in MB, spilling the rest to disk (def. 0 = all on disk)");
+    tune->add_option("-a,--sa-algorithm", args.sa_algo, "Algorithm for computing the SA (0=LIBDIVSUFSORT, 1=SE_SAIS [def=0])")->default_val(LIBDIVSUFSORT)->check(CLI::Range(0,1));
+
+    auto * resample = app.add_subcommand("resample");
+    resample->add_option("INDEX", args.input_file, "Stored index, an r-index or a subsample r-index with a smaller subsampling parameter")->check(CLI::ExistingFile)->required();
+    resample->add_option("-i,--index-type", args.index_type, "Variant of the stored index (0=standard, 1=valid_marks, 2=valid_area, 3=r-index)")->required()->check(CLI::Range(0,3));
+    resample->add_option("-s,--ssamp", args.ssamps, "Subsampling parameters of the derived indexes, e.g., 8,16")->delimiter(',')->required();
+    resample->add_option("-v,--variants", args.resample_types, "Subsample r-index variants to be derived, e.g., 0,2 (0=standard, 1=valid_marks, 2=valid_area [def=the variant of INDEX, or 2 for an r-index]). The validity needs an r-index or a valid_area index")->delimiter(',')->check(CLI::Range(0,2));
+    resample->add_option("-o,--output", args.output_file, "Output file, whose extension is replaced by s<s>.<variant> (def. INDEX)");
+    resample->add_option("-T,--tmp", args.tmp_dir, "Temporary folder (def. /os_tmp/sri_xxxx)")-> check(CLI::ExistingDirectory);
+
+    auto * merge = app.add_subcommand("merge");
+    merge->add_option("INDEX1", args.input_file, "Stored r-index of the first text")->check(CLI::ExistingFile)->required();
+    merge->add_option("INDEX2", args.merge_file, "Stored r-index of the second text (e.g., the new documents), whose length dominates the cost")->check(CLI::ExistingFile)->required();
+    merge->add_option("-o,--output", args.output_file, "Output file, whose extension is replaced by the variant")->required();
+    merge->add_option("-s,--ssamp", args.ssamps, "Subsampling parameters, e.g., 4,8,16 (def 4)")->delimiter(',');
+    merge->add_option("-v,--variants", args.merge_types, "Variants of the merged index, e.g., 2,3 (0=standard, 1=valid_marks, 2=valid_area, 3=r-index [def=2])")->delimiter(',')->check(CLI::Range(0,3));
+    merge->add_option("-t,--threads", args.n_threads, "Maximum number of working threads")->default_val(1);
+    merge->add_option("-b,--boundary", args.boundary, "Symbol between both texts, which must be smaller than their symbols (def. 1)")->default_val(1)->check(CLI::Range(1,255));
+    merge->add_option("-T,--tmp", args.tmp_dir, "Temporary folder (def. /os_tmp/sri_xxxx)")-> check(CLI::ExistingDirectory);
+
+    auto * ms = app.add_subcommand("ms");
+    ms->add_option("INDEX", args.input_file, "Index file (built with --ms)")->check(CLI::ExistingFile)->required();
+    ms->add_option("PAT_FILE", args.pat_file, "List of patterns")->check(CLI::ExistingFile)->required();
+    ms->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area)")->required()->check(CLI::Range(0,2));
+    ms->add_option("-o,--output", args.result_file, "File where the matching lengths and text positions of each pattern are written");
+
+    auto * extract = app.add_subcommand("extract");
+    extract->add_option("INDEX", args.input_file, "Index file (built with --extract)")->check(CLI::ExistingFile)->required();
+    extract->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area)")->required()->check(CLI::Range(0,2));
+    extract->add_option("-p,--position", args.extract_pos, "Text position of the substring")->required();
+    extract->add_option("-l,--length", args.extract_len, "Length of the substring (clipped to the text end)")->required();
+
+    auto * display = app.add_subcommand("display");
+    display->add_option("INDEX", args.input_file, "Index file (built with --extract)")->check(CLI::ExistingFile)->required();
+    display->add_option("PAT_FILE", args.pat_file, "List of patterns")->check(CLI::ExistingFile)->required();
+    display->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area)")->required()->check(CLI::Range(0,2));
+    display->add_option("-c,--context", args.context, "Number of symbols shown before and after each occurrence (def. 10)")->default_val(10);
 
     auto * bkdown = app.add_subcommand("breakdown");
     bkdown->add_option("INDEX", args.input_file, "Index to be read")->check(CLI::ExistingFile)->required();
-    bkdown->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area)")->required();
+    bkdown->add_option("-i,--index-type", args.index_type, "Subsample r-index variant (0=standard, 1=valid_marks, 2=valid_area, 3=r-index, "+csa_variants_help+")")->required()->check(CLI::Range(0,15));
+    auto *bkdown_ms = bkdown->add_flag("--ms", args.ms, "INDEX was built with --ms (variants 0-2)");
+    bkdown->add_flag("--extract", args.extract, "INDEX was built with --extract (variants 0-2)")->excludes(bkdown_ms);
 
     app.require_subcommand(1,1);
 }
 
+//! Set the optional construction parameters given in the command line
+void setup_config(sri::Config& config, const arguments& args){
+    config.doc_separator = args.doc_separator;
+    config.kmer_k = args.kmer_k;
+    config.kmer_budget = args.kmer_budget<<20UL;
+    if(!args.work_dir.empty()) sri::openWorkDir(config);
+    if(args.memory_limit) sri::openArtifactStore(config, args.memory_limit<<20UL);
+}
+
+//! Release the intermediate items kept in memory for the folder, reporting their usage
+void close_memory_store(const std::string& tmp_dir, const arguments& args){
+    if(auto store = sri::closeArtifactStore(tmp_dir)){
+        std::cerr<<"In-memory items: peak "<<(store->peak()>>20UL)<<" MB of "<<args.memory_limit<<" MB, "
+                 <<store->spilled()<<" spilled to disk"<<std::endl;
+    }
+}
+
+//! Index with the subsampling parameter (the r-index has none) and the sampling rate of the inverse suffix array
+//! (only the extensions that have one)
 template<class index_type>
-void build_int(std::string input_text, size_t ssamp_val, std::filesystem::path tmp_path, sri::SAAlgo sa_algo, std::string& output_file){
-    index_type index(ssamp_val);
+index_type make_index(size_t ssamp_val, size_t isa_rate=0){
+    if constexpr (has_isa_rate<index_type>::value) return index_type(ssamp_val, isa_rate);
+    else if constexpr (std::is_constructible_v<index_type, size_t>) return index_type(ssamp_val);
+    else return index_type();
+}
+
+template<class index_type>
+void build_int(std::string input_text, size_t ssamp_val, std::filesystem::path tmp_path, sri::SAAlgo sa_algo, std::string& output_file, const arguments& args){
+    auto index = make_index<index_type>(ssamp_val, args.isa_rate);
     sri::Config config(input_text, tmp_path, sa_algo);
+    setup_config(config, args);
     sri::construct(index, input_text, config);
-    sdsl::store_to_file(index, output_file);
+    {
+        sri::StageEvent event("Store");
+        sdsl::store_to_file(index, output_file);
+    }
 }
 
 template<class index_type>
-void build_from_bigbwt(std::string bigbwt_pref, size_t ssamp_val, std::filesystem::path tmp_path, std::string& output_file){
-    index_type index(ssamp_val);
+void build_from_bigbwt(std::string bigbwt_pref, size_t ssamp_val, std::filesystem::path tmp_path, std::string& output_file, const arguments& args){
+    auto index = make_index<index_type>(ssamp_val, args.isa_rate);
     sri::Config config(bigbwt_pref, tmp_path, sri::SAAlgo::BIG_BWT);
+    setup_config(config, args);
     sri::construct(index, bigbwt_pref, config);
+    {
+        sri::StageEvent event("Store");
+        sdsl::store_to_file(index, output_file);
+    }
+}
+
+template<class index_type>
+void build_from_import(const std::string& bwt_file, size_t ssamp_val, std::filesystem::path tmp_path, std::string& output_file, const arguments& args){
+    auto index = make_index<index_type>(ssamp_val, args.isa_rate);
+    sri::Config config(bwt_file, tmp_path, sri::SAAlgo::IMPORTED);
+    config.import = args.import;
+    setup_config(config, args);
+    sri::construct(index, bwt_file, config);
+    {
+        sri::StageEvent event("Store");
+        sdsl::store_to_file(index, output_file);
+    }
+}
+
+//! Build the index from the input text, the BigBWT output, or the imported BWT, and store it with the given extension.
+//! All the builds use the same temporary folder, so the items that do not depend on s (or on the variant) are only built
+//! by the first one. With several subsampling parameters, the extension is prefixed by "s<s>." (but for the r-index)
+template<class index_type>
+std::string build_variant(const arguments& args, const std::string& tmp_dir, size_t ssamp, std::string ext){
+    if(args.docs) ext += "_docs";
+    if(args.ssamps.size()>1 && std::is_constructible_v<index_type, size_t>) ext = "s"+std::to_string(ssamp)+"."+ext;
+    std::string output_file = std::filesystem::path(args.output_file).replace_extension(ext);
+    auto& report = sri::BuildReport::instance();
+    if(report.enabled()) report.beginIndex({{"output", output_file}, {"s", ssamp}, {"index_type", ext}});
+    if (!args.input_file.empty()) {
+        build_int<index_type>(args.input_file, ssamp, tmp_dir, args.sa_algo, output_file, args);
+    } else if (!args.bigbwt_pref.empty()) {
+        build_from_bigbwt<index_type>(args.bigbwt_pref, ssamp, tmp_dir, output_file, args);
+    } else {
+        build_from_import<index_type>(args.import_bwt, ssamp, tmp_dir, output_file, args);
+    }
+    if(report.enabled()) report.endIndex(std::filesystem::file_size(output_file));
+    return output_file;
+}
+
+//! Build one of the subsample r-index variants, for documents or with matching statistics or text extraction if requested
+template<class index_type>
+std::string build_sr_variant(const arguments& args, const std::string& tmp_dir, size_t ssamp, const std::string& ext){
+    if(args.docs) return build_variant<sri::IndexDoc<index_type>>(args, tmp_dir, ssamp, ext);
+    if(args.ms) return build_variant<sri::IndexMS<index_type>>(args, tmp_dir, ssamp, ext+"_ms");
+    if(args.extract) return build_variant<sri::IndexExtract<index_type>>(args, tmp_dir, ssamp, ext+"_ext");
+    return build_variant<index_type>(args, tmp_dir, ssamp, ext);
+}
+
+//! Build the sharded index of the documents, with an index of the variant per shard, and store its manifest with the
+//! extension of build_variant (plus ".shards"). Each shard has its own subfolder of the temporary folder, so the items
+//! that do not depend on s (or on the variant) are only built by the first build of the shard
+template<class index_type>
+std::string build_shards(const arguments& args, const std::string& tmp_dir, size_t ssamp, std::string ext){
+    if(args.ssamps.size()>1) ext = "s"+std::to_string(ssamp)+"."+ext;
+    const std::string output_file = std::filesystem::path(args.output_file).replace_extension(ext);
+    auto& report = sri::BuildReport::instance();
+    auto build = [&](const std::string& text_file, const std::filesystem::path& shard_dir, const std::string& shard_file){
+        std::string output = shard_file;
+        if(report.enabled()) report.beginIndex({{"output", output}, {"s", ssamp}, {"index_type", ext}});
+        build_int<index_type>(text_file, ssamp, shard_dir, args.sa_algo, output, args);
+        if(report.enabled()) report.endIndex(std::filesystem::file_size(output));
+    };
+    return sri::constructShards(args.doc_files, args.n_shards, args.doc_separator, tmp_dir, output_file, args.n_threads,
+                                build, {{"index_type", ext}, {"s", ssamp}});
+}
+
+//! Build the index for each s in the grid (sharing the s-independent items), measure it on a sample of the patterns,
+//! and report the Pareto frontier (size vs. locate latency) and the s chosen under the budget or latency target
+template<class index_type>
+void tune_int(const std::string& tmp_dir, std::string index_name, const arguments& args){
+    uint64_t n_pats, pat_len;
+    std::string pat_file = args.pat_file;
+    const std::vector<std::string> pat_list = sri::samplePatterns(file2pat_list(pat_file, n_pats, pat_len), args.tune_sample);
+
+    sri::Config config(args.input_file, tmp_dir, args.sa_algo);
+    setup_config(config, args);
+    std::vector<size_t> grid = args.tune_grid;
+    std::sort(grid.begin(), grid.end());
+    grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+    const std::vector<sri::TuningPoint> points = sri::tuneSubsampleRate<index_type>(args.input_file, config, grid, pat_list);
+    const std::vector<sri::TuningPoint> frontier = sri::paretoFrontier(points);
+
+    auto is_pareto = [&](const sri::TuningPoint& point){
+        return std::any_of(frontier.begin(), frontier.end(), [&](auto const& f){ return f.s == point.s; });
+    };
+
+    const std::string file = std::filesystem::path(args.input_file).filename();
+    std::cout<<std::fixed<<std::setprecision(3);
+    std::cout<<"#file\tindex_type\ts\tsize_bytes\tbits_per_sym\tcount_nanosecs/pat\tlocate_nanosecs/pat\tpareto"<<std::endl;
+    for(auto const& point : points){
+        std::cout<<file<<"\t"<<index_name<<"\t"<<point.s<<"\t"<<point.size_in_bytes<<"\t"
+                 <<double(point.size_in_bytes*8)/double(point.n)<<"\t"
+                 <<point.count_ns<<"\t"<<point.locate_ns<<"\t"<<(is_pareto(point) ? "*" : "")<<std::endl;
+    }
+
+    auto chosen = sri::chooseSubsampleRate(points, args.mem_budget<<20UL, args.latency);
+    if(chosen){
+        std::cout<<"Chosen subsampling parameter: "<<chosen->s<<" ("<<chosen->size_in_bytes<<" bytes, "<<chosen->locate_ns<<" nanosecs/pat)"<<std::endl;
+        std::cout<<"Build it with: sr-index-cli build -i "<<args.index_type<<" -s "<<chosen->s<<" -t "<<args.input_file<<std::endl;
+    } else if(args.mem_budget || args.latency>0){
+        std::cout<<"No subsampling parameter in the grid meets the "<<(args.mem_budget ? "budget" : "")<<(args.mem_budget && args.latency>0 ? " and the " : "")<<(args.latency>0 ? "latency target" : "")<<std::endl;
+    }
+}
+
+//! Derive the index with the given subsampling parameter from the stored index, without the text, and store it
+template<class source_type, class index_type>
+std::string resample_variant(const arguments& args, const std::string& tmp_dir, size_t ssamp, const std::string& ext){
+    std::string output_file = std::filesystem::path(args.output_file).replace_extension("s"+std::to_string(ssamp)+"."+ext);
+    index_type index(ssamp);
+    sri::Config config(args.input_file, tmp_dir, sri::SDSL_LIBDIVSUFSORT);
+    sri::resample<source_type>(index, args.input_file, config);
     sdsl::store_to_file(index, output_file);
+    sdsl::util::delete_all_files(config.file_map);
+    return output_file;
+}
+
+template<class source_type>
+void resample_int(const std::string& tmp_dir, const arguments& args){
+    for(auto const& ssamp : args.ssamps){
+        for(auto const& index_type : args.resample_types){
+            std::string output_file;
+            switch (index_type) {
+                case SRI_INDEX:
+                    output_file = resample_variant<source_type, sri::SrIndex<>>(args, tmp_dir, ssamp, "sri");
+                    break;
+                case SRI_VALID_MARKS:
+                    output_file = resample_variant<source_type, sri::SrIndexValidMark<>>(args, tmp_dir, ssamp, "sri_vm");
+                    break;
+                case SRI_VALID_AREA:
+                    output_file = resample_variant<source_type, sri::SrIndexValidArea<>>(args, tmp_dir, ssamp, "sri_va");
+                    break;
+                default:
+                    std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                    exit(1);
+            }
+            std::cout<<"The output index was stored in "<<output_file<<std::endl;
+        }
+    }
+}
+
+//! Construct the index of the concatenation of the texts of both stored r-indexes, and store it. All the variants use
+//! the same temporary folder, so the RLBWTs are only merged by the first one.
+template<class index_type>
+std::string merge_variant(const arguments& args, const std::string& tmp_dir, size_t ssamp, std::string ext){
+    if(args.ssamps.size()>1 && std::is_constructible_v<index_type, size_t>) ext = "s"+std::to_string(ssamp)+"."+ext;
+    std::string output_file = std::filesystem::path(args.output_file).replace_extension(ext);
+    auto index = make_index<index_type>(ssamp);
+    sri::Config config(args.input_file, tmp_dir, sri::SAAlgo::IMPORTED);
+    setup_config(config, args);
+    sri::merge<sri::RIndex<>>(index, args.input_file, args.merge_file, config, args.boundary);
+    {
+        sri::StageEvent event("Store");
+        sdsl::store_to_file(index, output_file);
+    }
+    return output_file;
 }
 
 template<class index_type>
@@ -197,7 +877,7 @@ void breakdown_int(std::string input_index){
     sdsl::load_from_file(index, input_index);
     std::vector<std::pair<std::string, size_t>> parts = index.breakdown();
     std::cout<<"Index file: "<<input_index<<std::endl;
-    std::cout<<"Subsampling parameter: "<<index.SubsampleRate()<<std::endl;
+    if constexpr (has_subsample_rate<index_type>::value) std::cout<<"Subsampling parameter: "<<index.SubsampleRate()<<std::endl;
     size_t acc=0;
     for(auto const& part : parts){
         acc+=part.second;
@@ -215,111 +895,426 @@ int main(int argc, char** argv) {
     parse_app(app, args);
 
     CLI11_PARSE(app, argc, argv);
+    sri::setConstructionThreads(args.n_threads);
 
     if(app.got_subcommand("build")) {
+        args.docs = app.get_subcommand("build")->count("--doc-separator") > 0;
+    }
 
-        std::string tmp_dir = create_tmp_dir(args.tmp_dir);
-        std::cout<<"Temporary folder: "<<tmp_dir<<std::endl;
+    if(app.got_subcommand("build")) {
+
+        if(args.ms){
+            if(args.docs || !args.doc_files.empty() || std::any_of(args.build_types.begin(), args.build_types.end(), [](int t){ return t >= SRI_R_INDEX; })){
+                std::cerr<<"Error: the matching statistics (--ms) are only available for the variants 0-2, without documents"<<std::endl;
+                exit(1);
+            }
+            if(args.input_file.empty() || args.sa_algo == sri::BIG_BWT){
+                std::cerr<<"Error: the BWT-run thresholds of the matching statistics (--ms) need the text and its SA, so the index must be built from the text without BIG_BWT"<<std::endl;
+                exit(1);
+            }
+        }
+        if(args.extract && (args.docs || !args.doc_files.empty() || std::any_of(args.build_types.begin(), args.build_types.end(), [](int t){ return t >= SRI_R_INDEX; }))){
+            std::cerr<<"Error: the text extraction (--extract) is only available for the variants 0-2, without documents"<<std::endl;
+            exit(1);
+        }
+
+        if(!args.report_file.empty()) sri::BuildReport::instance().enable();
+
+        std::string tmp_dir;
+        if(!args.work_dir.empty()){
+            fs::create_directories(args.work_dir);
+            tmp_dir = std::filesystem::absolute(args.work_dir).lexically_normal().string();
+            std::cout<<"Work folder: "<<tmp_dir<<std::endl;
+        } else {
+            tmp_dir = create_tmp_dir(args.tmp_dir);
+            std::cout<<"Temporary folder: "<<tmp_dir<<std::endl;
+        }
+
+        if (args.n_shards) {
+            if(args.output_file.empty()) args.output_file = "collection";
+            args.docs = true;
+            for(auto const& index_type : args.build_types){
+                if(index_type >= SRI_R_INDEX){
+                    std::cerr<<"Error: the r-index (3) and the CSA variants (4-15) are not available for sharded indexes"<<std::endl;
+                    exit(1);
+                }
+            }
+            std::sort(args.ssamps.begin(), args.ssamps.end());
+            args.ssamps.erase(std::unique(args.ssamps.begin(), args.ssamps.end()), args.ssamps.end());
+            std::cout<<"Building the sharded subsample r-index of "<<args.doc_files.size()<<" documents in "
+                     <<std::min(args.n_shards, args.doc_files.size())<<" shards"<<std::endl;
+
+            std::vector<std::string> manifest_files;
+            try {
+                for(auto const& ssamp : args.ssamps){
+                    for(auto const& index_type : args.build_types){
+                        switch (index_type) {
+                            case SRI_INDEX:
+                                manifest_files.emplace_back(build_shards<sri::SrIndex<>>(args, tmp_dir, ssamp, "sri"));
+                                break;
+                            case SRI_VALID_MARKS:
+                                manifest_files.emplace_back(build_shards<sri::SrIndexValidMark<>>(args, tmp_dir, ssamp, "sri_vm"));
+                                break;
+                            case SRI_VALID_AREA:
+                                manifest_files.emplace_back(build_shards<sri::SrIndexValidArea<>>(args, tmp_dir, ssamp, "sri_va"));
+                                break;
+                            default:
+                                std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                                exit(1);
+                        }
+                    }
+                }
+            } catch (const std::invalid_argument& e) {
+                std::cerr<<e.what()<<std::endl;
+                exit(1);
+            }
+            for(size_t i=0;i<std::min(args.n_shards, args.doc_files.size());i++){
+                close_memory_store((fs::path(tmp_dir)/("shard"+std::to_string(i))).string(), args);
+            }
+            for(auto const& manifest_file : manifest_files){
+                std::cout<<"The shard manifest was stored in "<<manifest_file<<std::endl;
+            }
+            if(!args.report_file.empty()){
+                sri::BuildReport::instance().write(args.report_file);
+                std::cout<<"The construction report was stored in "<<args.report_file<<std::endl;
+            }
+            return 0;
+        }
+
+        if (!args.doc_files.empty()) {
+            // Concatenate the documents into a single text
+            args.input_file = (std::filesystem::path(tmp_dir) / "collection").string();
+            if(args.output_file.empty()) args.output_file = "collection";
+            std::cout<<"Concatenating "<<args.doc_files.size()<<" documents"<<std::endl;
+            const std::string collection_tmp = args.input_file+".tmp";
+            sri::concatenateDocuments(args.doc_files, args.doc_separator, collection_tmp);
+            // Keep the previous collection of the work folder if it did not change, so its stages are still valid
+            if(fs::exists(args.input_file) && fs::file_size(args.input_file)==fs::file_size(collection_tmp)
+               && sri::StageManifest::checksum(args.input_file)==sri::StageManifest::checksum(collection_tmp)){
+                fs::remove(collection_tmp);
+            } else {
+                fs::rename(collection_tmp, args.input_file);
+            }
+            args.docs = true;
+            if(std::any_of(args.build_types.begin(), args.build_types.end(), [](int t){ return t >= SRI_R_INDEX; })){
+                std::cerr<<"Error: the r-index (3) and the CSA variants (4-15) are not available for document collections"<<std::endl;
+                exit(1);
+            }
+        }
 
         if (!args.input_file.empty()) {
             assert(args.bigbwt_pref.empty());
-            if(args.output_file.empty()) args.output_file = std::filesystem::path(args.input_file).filename();
+            if(args.output_file.empty()) args.output_file = args.input_file == sri::InputStream::kStdin ? "stdin" : std::filesystem::path(args.input_file).filename().string();
             std::cout<<"Building the subsample r-index for "<<args.input_file<<std::endl;
-            std::cout<<"Subsampling parameter: "<<args.ssamp<<std::endl;
-            switch (args.index_type) {
-                case SRI_INDEX:
-                    args.output_file = std::filesystem::path(args.output_file).replace_extension("sri");
-                    build_int<sri::SrIndex<>>(args.input_file, args.ssamp, tmp_dir, args.sa_algo, args.output_file);
-                    break;
-                case SRI_VALID_MARKS:
-                    args.output_file = std::filesystem::path(args.output_file).replace_extension("sri_vm");
-                    build_int<sri::SrIndexValidMark<>>(args.input_file, args.ssamp, tmp_dir, args.sa_algo, args.output_file);
-                    break;
-                case SRI_VALID_AREA:
-                    args.output_file = std::filesystem::path(args.output_file).replace_extension("sri_va");
-                    build_int<sri::SrIndexValidArea<>>(args.input_file, args.ssamp, tmp_dir, args.sa_algo, args.output_file);
-                    break;
-                default:
-                    std::cerr<<"Unknown subsample r-index type"<<std::endl;
-                    exit(1);
-            }
-            std::cout<<"The output index was stored in "<<args.output_file<<std::endl;
         } else if (!args.bigbwt_pref.empty()) {
             assert(args.input_file.empty());
-
             if(args.output_file.empty()) args.output_file = std::filesystem::path(args.bigbwt_pref).filename();
-
             std::cout<<"Building the subsample r-index from the precomputed BWT/SA elements in "<<args.bigbwt_pref<<std::endl;
-            std::cout<<"Subsampling parameter: "<<args.ssamp<<std::endl;
-            switch (args.index_type) {
-                case SRI_INDEX:
-                    args.output_file = std::filesystem::path(args.output_file).replace_extension("sri");
-                    build_from_bigbwt<sri::SrIndex<>>(args.bigbwt_pref, args.ssamp, tmp_dir, args.output_file);
-                    break;
-                case SRI_VALID_MARKS:
-                    args.output_file = std::filesystem::path(args.output_file).replace_extension("sri_vm");
-                    build_from_bigbwt<sri::SrIndexValidMark<>>(args.bigbwt_pref, args.ssamp, tmp_dir, args.output_file);
-                    break;
-                case SRI_VALID_AREA:
-                    args.output_file = std::filesystem::path(args.output_file).replace_extension("sri_va");
-                    build_from_bigbwt<sri::SrIndexValidArea<>>(args.bigbwt_pref, args.ssamp, tmp_dir, args.output_file);
-                    break;
-                default:
-                    std::cerr<<"Unknown subsample r-index type"<<std::endl;
-                    exit(1);
+        } else if (!args.import_bwt.empty()) {
+            if(args.import.sa_file.empty() && args.import.ssa_file.empty()){
+                std::cerr<<"Error: the imported BWT needs its SA samples (--import-ssa/--import-esa or --import-sa)"<<std::endl;
+                exit(1);
+            }
+            if(!args.import.sa_file.empty()) args.import.samples_format = "sa";
+            if(args.output_file.empty()) args.output_file = std::filesystem::path(args.import_bwt).filename();
+            std::cout<<"Building the subsample r-index from the imported BWT "<<args.import_bwt<<" ("<<args.import.bwt_format<<")"<<std::endl;
+        }
+        std::sort(args.ssamps.begin(), args.ssamps.end());
+        args.ssamps.erase(std::unique(args.ssamps.begin(), args.ssamps.end()), args.ssamps.end());
+        std::sort(args.build_types.begin(), args.build_types.end());
+        args.build_types.erase(std::unique(args.build_types.begin(), args.build_types.end()), args.build_types.end());
+
+        std::cout<<"Subsampling parameter"<<(args.ssamps.size()>1 ? "s" : "")<<":";
+        for(auto const& ssamp : args.ssamps) std::cout<<" "<<ssamp;
+        std::cout<<std::endl;
+        if(args.docs) std::cout<<"Document separator: "<<args.doc_separator<<std::endl;
+        if(args.docs && (args.input_file.empty() || args.sa_algo == sri::BIG_BWT)){
+            std::cerr<<"Error: the document listing needs the text and its SA, so the collection must be built from the text without BIG_BWT"<<std::endl;
+            exit(1);
+        }
+        if(args.sa_algo == sri::BIG_BWT && !args.input_file.empty()
+           && (args.input_file == sri::InputStream::kStdin || sri::InputStream::isCompressed(args.input_file))){
+            std::cerr<<"Error: bigbwt (-a 2) reads the text file by itself, so the text must be a plain file, not the standard input or a compressed file"<<std::endl;
+            exit(1);
+        }
+        if(!args.work_dir.empty() && !args.input_file.empty()
+           && (args.input_file == sri::InputStream::kStdin || !fs::is_regular_file(args.input_file))){
+            std::cerr<<"Error: the work folder (-w) detects the changes of the text by its size and modification time, so the text must be a regular file, not the standard input or a pipe"<<std::endl;
+            exit(1);
+        }
+        if(args.ms) std::cout<<"Matching statistics: ISA sampling rate "<<args.isa_rate<<std::endl;
+        if(args.extract) std::cout<<"Text extraction: ISA sampling rate "<<args.isa_rate<<std::endl;
+        if(args.kmer_k) std::cout<<"K-mer table: k="<<args.kmer_k<<(args.kmer_budget ? ", budget="+std::to_string(args.kmer_budget)+" MB" : "")<<std::endl;
+        if(args.input_file.empty() && std::find(args.build_types.begin(), args.build_types.end(), SRI_CSA_RAW) != args.build_types.end()){
+            std::cerr<<"Error: the CSA (5) needs the whole SA, so it must be built from the text"<<std::endl;
+            exit(1);
+        }
+        if(args.kmer_k && args.build_types.back() >= SRI_R_CSA){
+            std::cerr<<"Warning: the CSA variants (4-15) do not use the k-mer table"<<std::endl;
+        }
+
+        // One output per combination of subsampling parameter and variant, sharing the s-independent items
+        std::vector<std::string> output_files;
+        for(auto const& ssamp : args.ssamps){
+            for(auto const& index_type : args.build_types){
+                switch (index_type) {
+                    case SRI_INDEX:
+                        output_files.emplace_back(build_sr_variant<sri::SrIndex<>>(args, tmp_dir, ssamp, "sri"));
+                        break;
+                    case SRI_VALID_MARKS:
+                        output_files.emplace_back(build_sr_variant<sri::SrIndexValidMark<>>(args, tmp_dir, ssamp, "sri_vm"));
+                        break;
+                    case SRI_VALID_AREA:
+                        output_files.emplace_back(build_sr_variant<sri::SrIndexValidArea<>>(args, tmp_dir, ssamp, "sri_va"));
+                        break;
+                    case SRI_R_INDEX:
+                        // It does not depend on s
+                        if(ssamp == args.ssamps.front()) output_files.emplace_back(build_variant<sri::RIndex<>>(args, tmp_dir, ssamp, "ri"));
+                        break;
+                    default:
+                        if(!with_csa_variant(index_type, [&](auto tag, const std::string& name){
+                            using csa_type = typename decltype(tag)::type;
+                            // The variants without subsampling do not depend on s
+                            if(std::is_constructible_v<csa_type, size_t> || ssamp == args.ssamps.front()){
+                                output_files.emplace_back(build_variant<csa_type>(args, tmp_dir, ssamp, name));
+                            }
+                        })){
+                            std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                            exit(1);
+                        }
+                }
             }
-            std::uintmax_t removed = fs::remove_all(tmp_dir);
-            std::cout<<"The output index was stored in "<<args.output_file<<std::endl;
+        }
+        close_memory_store(tmp_dir, args);
+        if ((!args.bigbwt_pref.empty() || !args.import_bwt.empty()) && args.work_dir.empty()) fs::remove_all(tmp_dir);
+        for(auto const& output_file : output_files){
+            std::cout<<"The output index was stored in "<<output_file<<std::endl;
+        }
+        if(!args.report_file.empty()){
+            sri::BuildReport::instance().write(args.report_file);
+            std::cout<<"The construction report was stored in "<<args.report_file<<std::endl;
         }
 
     } else if(app.got_subcommand("count")){
         switch (args.index_type) {
             case SRI_INDEX:
-                test_count<sri::SrIndex<>>(args.input_file, args.pat_file, "sri");
+                test_count<sri::SrIndex<>>(args.input_file, args.pat_file, "sri", args);
                 break;
             case SRI_VALID_MARKS:
-                test_count<sri::SrIndexValidMark<>>(args.input_file, args.pat_file, "sri_valid_marks");
+                test_count<sri::SrIndexValidMark<>>(args.input_file, args.pat_file, "sri_valid_marks", args);
                 break;
             case SRI_VALID_AREA:
-                test_count<sri::SrIndexValidArea<>>(args.input_file, args.pat_file, "sri_valid_area");
+                test_count<sri::SrIndexValidArea<>>(args.input_file, args.pat_file, "sri_valid_area", args);
+                break;
+            case SRI_R_INDEX:
+                test_count<sri::RIndex<>>(args.input_file, args.pat_file, "r_index", args);
+                break;
+            default:
+                if(!with_csa_variant(args.index_type, [&](auto tag, const std::string& name){
+                    test_count<typename decltype(tag)::type>(args.input_file, args.pat_file, name, args);
+                })){
+                    std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                    exit(1);
+                }
+        }
+    } else if(app.got_subcommand("locate")){
+        switch (args.index_type) {
+            case SRI_INDEX:
+                test_locate<sri::SrIndex<>>(args.input_file, args.pat_file, "sri", args);
+                break;
+            case SRI_VALID_MARKS:
+                test_locate<sri::SrIndexValidMark<>>(args.input_file, args.pat_file, "sri_valid_marks", args);
+                break;
+            case SRI_VALID_AREA:
+                test_locate<sri::SrIndexValidArea<>>(args.input_file, args.pat_file, "sri_valid_area", args);
+                break;
+            case SRI_R_INDEX:
+                test_locate<sri::RIndex<>>(args.input_file, args.pat_file, "r_index", args);
+                break;
+            default:
+                if(!with_csa_variant(args.index_type, [&](auto tag, const std::string& name){
+                    test_locate<typename decltype(tag)::type>(args.input_file, args.pat_file, name, args);
+                })){
+                    std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                    exit(1);
+                }
+        }
+    } else if(app.got_subcommand("docs")){
+        switch (args.index_type) {
+            case SRI_INDEX:
+                test_docs<sri::IndexDoc<sri::SrIndex<>>>(args.input_file, args.pat_file, "sri", args.doc_freqs);
+                break;
+            case SRI_VALID_MARKS:
+                test_docs<sri::IndexDoc<sri::SrIndexValidMark<>>>(args.input_file, args.pat_file, "sri_valid_marks", args.doc_freqs);
+                break;
+            case SRI_VALID_AREA:
+                test_docs<sri::IndexDoc<sri::SrIndexValidArea<>>>(args.input_file, args.pat_file, "sri_valid_area", args.doc_freqs);
                 break;
             default:
                 std::cerr<<"Unknown subsample r-index type"<<std::endl;
                 exit(1);
         }
-    } else if(app.got_subcommand("locate")){
+    } else if(app.got_subcommand("ms")){
         switch (args.index_type) {
             case SRI_INDEX:
-                test_locate<sri::SrIndex<>>(args.input_file, args.pat_file, "sri");
+                test_ms<sri::IndexMS<sri::SrIndex<>>>(args.input_file, args.pat_file, "sri_ms", args);
                 break;
             case SRI_VALID_MARKS:
-                test_locate<sri::SrIndexValidMark<>>(args.input_file, args.pat_file, "sri_valid_marks");
+                test_ms<sri::IndexMS<sri::SrIndexValidMark<>>>(args.input_file, args.pat_file, "sri_valid_marks_ms", args);
                 break;
             case SRI_VALID_AREA:
-                test_locate<sri::SrIndexValidArea<>>(args.input_file, args.pat_file, "sri_valid_area");
+                test_ms<sri::IndexMS<sri::SrIndexValidArea<>>>(args.input_file, args.pat_file, "sri_valid_area_ms", args);
                 break;
             default:
                 std::cerr<<"Unknown subsample r-index type"<<std::endl;
                 exit(1);
         }
-    } else if(app.got_subcommand("breakdown")){
+    } else if(app.got_subcommand("extract")){
+        if(!with_extract_variant(args.index_type, [&](auto tag, const std::string&){
+            extract_int<typename decltype(tag)::type>(args.input_file, args);
+        })){
+            std::cerr<<"Unknown subsample r-index type"<<std::endl;
+            exit(1);
+        }
+    } else if(app.got_subcommand("display")){
+        if(!with_extract_variant(args.index_type, [&](auto tag, const std::string&){
+            display_int<typename decltype(tag)::type>(args.input_file, args.pat_file, args);
+        })){
+            std::cerr<<"Unknown subsample r-index type"<<std::endl;
+            exit(1);
+        }
+    } else if(app.got_subcommand("tune")){
+        std::string tmp_dir = create_tmp_dir(args.tmp_dir);
+        std::cerr<<"Temporary folder: "<<tmp_dir<<std::endl;
         switch (args.index_type) {
             case SRI_INDEX:
-                std::cout<<"Index type: sri"<<std::endl;
-                breakdown_int<sri::SrIndex<>>(args.input_file);
+                tune_int<sri::SrIndex<>>(tmp_dir, "sri", args);
                 break;
             case SRI_VALID_MARKS:
-                std::cout<<"Index type: sri_valid_marks"<<std::endl;
-                breakdown_int<sri::SrIndexValidMark<>>(args.input_file);
+                tune_int<sri::SrIndexValidMark<>>(tmp_dir, "sri_valid_marks", args);
                 break;
             case SRI_VALID_AREA:
-                std::cout<<"Index type: sri_valid_area"<<std::endl;
-                breakdown_int<sri::SrIndexValidArea<>>(args.input_file);
+                tune_int<sri::SrIndexValidArea<>>(tmp_dir, "sri_valid_area", args);
                 break;
             default:
                 std::cerr<<"Unknown subsample r-index type"<<std::endl;
                 exit(1);
         }
+        close_memory_store(tmp_dir, args);
+        fs::remove_all(tmp_dir);
+    } else if(app.got_subcommand("resample")){
+        std::string tmp_dir = create_tmp_dir(args.tmp_dir);
+        std::cerr<<"Temporary folder: "<<tmp_dir<<std::endl;
+        if(args.output_file.empty()) args.output_file = args.input_file;
+        if(args.resample_types.empty()) args.resample_types = {args.index_type == SRI_R_INDEX ? SRI_VALID_AREA : args.index_type};
+        std::cout<<"Resampling the index "<<args.input_file<<std::endl;
+        try {
+            switch (args.index_type) {
+                case SRI_INDEX:
+                    resample_int<sri::SrIndex<>>(tmp_dir, args);
+                    break;
+                case SRI_VALID_MARKS:
+                    resample_int<sri::SrIndexValidMark<>>(tmp_dir, args);
+                    break;
+                case SRI_VALID_AREA:
+                    resample_int<sri::SrIndexValidArea<>>(tmp_dir, args);
+                    break;
+                case SRI_R_INDEX:
+                    resample_int<sri::RIndex<>>(tmp_dir, args);
+                    break;
+                default:
+                    std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                    exit(1);
+            }
+        } catch (const std::invalid_argument& e) {
+            std::cerr<<e.what()<<std::endl;
+            fs::remove_all(tmp_dir);
+            exit(1);
+        }
+        fs::remove_all(tmp_dir);
+    } else if(app.got_subcommand("merge")){
+        std::string tmp_dir = create_tmp_dir(args.tmp_dir);
+        std::cerr<<"Temporary folder: "<<tmp_dir<<std::endl;
+        std::sort(args.ssamps.begin(), args.ssamps.end());
+        args.ssamps.erase(std::unique(args.ssamps.begin(), args.ssamps.end()), args.ssamps.end());
+        std::cout<<"Merging the r-indexes "<<args.input_file<<" and "<<args.merge_file<<std::endl;
+        std::vector<std::string> output_files;
+        try {
+            for(auto const& ssamp : args.ssamps){
+                for(auto const& index_type : args.merge_types){
+                    switch (index_type) {
+                        case SRI_INDEX:
+                            output_files.emplace_back(merge_variant<sri::SrIndex<>>(args, tmp_dir, ssamp, "sri"));
+                            break;
+                        case SRI_VALID_MARKS:
+                            output_files.emplace_back(merge_variant<sri::SrIndexValidMark<>>(args, tmp_dir, ssamp, "sri_vm"));
+                            break;
+                        case SRI_VALID_AREA:
+                            output_files.emplace_back(merge_variant<sri::SrIndexValidArea<>>(args, tmp_dir, ssamp, "sri_va"));
+                            break;
+                        case SRI_R_INDEX:
+                            if(ssamp == args.ssamps.front()) output_files.emplace_back(merge_variant<sri::RIndex<>>(args, tmp_dir, ssamp, "ri"));
+                            break;
+                        default:
+                            std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                            exit(1);
+                    }
+                }
+            }
+        } catch (const std::invalid_argument& e) {
+            std::cerr<<e.what()<<std::endl;
+            fs::remove_all(tmp_dir);
+            exit(1);
+        }
+        close_memory_store(tmp_dir, args);
+        fs::remove_all(tmp_dir);
+        for(auto const& output_file : output_files){
+            std::cout<<"The output index was stored in "<<output_file<<std::endl;
+        }
+    } else if(app.got_subcommand("breakdown")){
+        if(args.ms && args.index_type > SRI_VALID_AREA){
+            std::cerr<<"Error: the matching statistics are only available for the variants 0-2"<<std::endl;
+            exit(1);
+        }
+        if(args.extract){
+            if(!with_extract_variant(args.index_type, [&](auto tag, const std::string& name){
+                std::cout<<"Index type: "<<name<<std::endl;
+                breakdown_int<typename decltype(tag)::type>(args.input_file);
+            })){
+                std::cerr<<"Error: the text extraction is only available for the variants 0-2"<<std::endl;
+                exit(1);
+            }
+            return 0;
+        }
+        switch (args.index_type) {
+            case SRI_INDEX:
+                std::cout<<"Index type: sri"<<(args.ms ? "_ms" : "")<<std::endl;
+                if(args.ms) breakdown_int<sri::IndexMS<sri::SrIndex<>>>(args.input_file);
+                else breakdown_int<sri::SrIndex<>>(args.input_file);
+                break;
+            case SRI_VALID_MARKS:
+                std::cout<<"Index type: sri_valid_marks"<<(args.ms ? "_ms" : "")<<std::endl;
+                if(args.ms) breakdown_int<sri::IndexMS<sri::SrIndexValidMark<>>>(args.input_file);
+                else breakdown_int<sri::SrIndexValidMark<>>(args.input_file);
+                break;
+            case SRI_VALID_AREA:
+                std::cout<<"Index type: sri_valid_area"<<(args.ms ? "_ms" : "")<<std::endl;
+                if(args.ms) breakdown_int<sri::IndexMS<sri::SrIndexValidArea<>>>(args.input_file);
+                else breakdown_int<sri::SrIndexValidArea<>>(args.input_file);
+                break;
+            case SRI_R_INDEX:
+                std::cout<<"Index type: r_index"<<std::endl;
+                breakdown_int<sri::RIndex<>>(args.input_file);
+                break;
+            default:
+                if(!with_csa_variant(args.index_type, [&](auto tag, const std::string& name){
+                    std::cout<<"Index type: "<<name<<std::endl;
+                    breakdown_int<typename decltype(tag)::type>(args.input_file);
+                })){
+                    std::cerr<<"Unknown subsample r-index type"<<std::endl;
+                    exit(1);
+                }
+        }
     } else {
         std::cerr<<" Unknown command "<<std::endl;
         exit(1);
@@ -0,0 +1,177 @@
+//
+// In-memory artifact store tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+
+#include <sdsl/int_vector.hpp>
+#include <sdsl/int_vector_buffer.hpp>
+
+#include "sr-index/artifact_store.h"
+#include "sr-index/io.h"
+#include "sr-index/sr_index.h"
+#include "sr-index/construct.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+namespace fs = std::filesystem;
+
+class ArtifactStoreTests : public testing::Test {
+ protected:
+  void SetUp() override {
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+    config_ = sdsl::cache_config(false, dir_.string(), "test");
+  }
+
+  void TearDown() override {
+    sri::closeArtifactStore(dir_);
+    fs::remove_all(dir_);
+  }
+
+  static IntVector values(std::size_t t_n) {
+    IntVector values(t_n, 0, 64);
+    for (std::size_t i = 0; i < t_n; ++i) values[i] = i * i;
+    return values;
+  }
+
+  fs::path dir_ = fs::temp_directory_path() / "sri_artifact_store_tests";
+  sdsl::cache_config config_;
+};
+
+TEST_F(ArtifactStoreTests, KeepInMemory) {
+  auto store = sri::openArtifactStore(config_, 1 << 20);
+  auto item = values(100);
+
+  ASSERT_TRUE(sri::storeToCache(values(100), "item", config_));
+  EXPECT_FALSE(fs::exists(sdsl::cache_file_name("item", config_)));
+  EXPECT_TRUE(sri::cacheFileExists("item", config_));
+  EXPECT_EQ(store->size(), sri::serializedSize(item));
+
+  IntVector loaded;
+  ASSERT_TRUE(sri::loadFromCache(loaded, "item", config_));
+  EXPECT_EQ(loaded, item);
+  EXPECT_EQ(*sri::sharedFromCache<IntVector>("item", config_), item);
+}
+
+TEST_F(ArtifactStoreTests, SpillOverLimit) {
+  const auto item_size = sri::serializedSize(values(100));
+  auto store = sri::openArtifactStore(config_, 2 * item_size);
+
+  sri::storeToCache(values(100), "first", config_);
+  sri::storeToCache(values(100), "second", config_);
+  EXPECT_EQ(store->spilled(), 0);
+
+  // The least recently used item is spilled
+  IntVector loaded;
+  sri::loadFromCache(loaded, "first", config_);
+  sri::storeToCache(values(100), "third", config_);
+  EXPECT_EQ(store->spilled(), 1);
+  EXPECT_TRUE(fs::exists(sdsl::cache_file_name("second", config_)));
+  EXPECT_FALSE(fs::exists(sdsl::cache_file_name("first", config_)));
+  EXPECT_EQ(store->peak(), 2 * item_size);
+
+  // Larger than the limit: written to disk directly
+  sri::storeToCache(values(1000), "large", config_);
+  EXPECT_TRUE(fs::exists(sdsl::cache_file_name("large", config_)));
+
+  for (const auto &key : {"first", "second", "third", "large"}) {
+    EXPECT_TRUE(sri::cacheFileExists(key, config_)) << key;
+    ASSERT_TRUE(sri::loadFromCache(loaded, key, config_)) << key;
+    EXPECT_EQ(loaded, values(std::string(key) == "large" ? 1000 : 100)) << key;
+  }
+}
+
+TEST_F(ArtifactStoreTests, SpillOnFileAccess) {
+  auto store = sri::openArtifactStore(config_, 1 << 20);
+  auto item = values(100);
+  sri::storeToCache(values(100), "item", config_);
+
+  // The stages streaming a file need it on disk
+  sdsl::int_vector_buffer<> buffer(sri::cacheFileName("item", config_));
+  EXPECT_EQ(buffer.size(), item.size());
+  EXPECT_EQ(buffer[10], item[10]);
+  EXPECT_EQ(store->size(), 0);
+}
+
+TEST_F(ArtifactStoreTests, StoreLvalueOnDisk) {
+  auto store = sri::openArtifactStore(config_, 1 << 20);
+  auto item = values(100);
+
+  // The caller keeps the item, so it is not copied into memory
+  ASSERT_TRUE(sri::storeToCache(item, "item", config_));
+  EXPECT_TRUE(fs::exists(sdsl::cache_file_name("item", config_)));
+  EXPECT_EQ(store->size(), 0);
+  EXPECT_EQ(item, values(100));
+}
+
+TEST_F(ArtifactStoreTests, CountSharedUntilReleased) {
+  const auto item_size = sri::serializedSize(values(100));
+  auto store = sri::openArtifactStore(config_, item_size);
+
+  sri::storeToCache(values(100), "first", config_);
+  auto shared = sri::sharedFromCache<IntVector>("first", config_);
+  ASSERT_TRUE(shared);
+
+  // The first item is spilled, but it is still in memory while it is shared, so the second one does not fit
+  sri::storeToCache(values(100), "second", config_);
+  EXPECT_TRUE(fs::exists(sdsl::cache_file_name("first", config_)));
+  EXPECT_TRUE(fs::exists(sdsl::cache_file_name("second", config_)));
+  EXPECT_EQ(store->size(), item_size);
+  EXPECT_EQ(*shared, values(100));
+
+  shared.reset();
+  EXPECT_EQ(store->size(), 0);
+
+  sri::storeToCache(values(100), "third", config_);
+  EXPECT_FALSE(fs::exists(sdsl::cache_file_name("third", config_)));
+  EXPECT_EQ(store->size(), item_size);
+  EXPECT_EQ(store->peak(), item_size);
+}
+
+template<typename TIndex>
+class ArtifactStoreConstructTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+};
+
+using ArtifactStoreIndexes = ::testing::Types<sri::SrIndex<>, sri::SrIndexValidMark<>, sri::SrIndexValidArea<>>;
+TYPED_TEST_SUITE(ArtifactStoreConstructTests, ArtifactStoreIndexes);
+
+TYPED_TEST(ArtifactStoreConstructTests, SameIndex) {
+  TypeParam on_disk(4);
+  sri::construct(on_disk, this->config_.data_path, this->config_);
+
+  const auto dir = fs::temp_directory_path() / "sri_artifact_store_construct_tests";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  sri::Config config(this->config_.data_path, dir, sri::SDSL_LIBDIVSUFSORT);
+  sri::openArtifactStore(config, 1 << 30);
+
+  TypeParam in_memory(4);
+  sri::construct(in_memory, config.data_path, config);
+
+  // The text and the SA never hit the disk
+  EXPECT_FALSE(fs::exists(sdsl::cache_file_name(sdsl::conf::KEY_SA, config)));
+  EXPECT_FALSE(fs::exists(sdsl::cache_file_name(sdsl::key_text_trait<8>::KEY_TEXT, config)));
+
+  for (const std::string &pattern : {"ab", "abc", "cab", "bbac", "x"}) {
+    EXPECT_EQ(in_memory.Count(pattern), on_disk.Count(pattern)) << pattern;
+    auto expected = on_disk.Locate(pattern);
+    auto occs = in_memory.Locate(pattern);
+    std::sort(expected.begin(), expected.end());
+    std::sort(occs.begin(), occs.end());
+    EXPECT_EQ(occs, expected) << pattern;
+  }
+
+  sri::closeArtifactStore(dir);
+  fs::remove_all(dir);
+}
@@ -0,0 +1,74 @@
+//
+// Batch backward-search tests.
+//
+
+#include <gtest/gtest.h>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+template<typename TIndex>
+class BatchTypedTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+
+    // Overlapping k-mers of the text (many shared suffixes), plus absent and repeated patterns
+    for (std::size_t len = 1; len <= 8; ++len) {
+      for (std::size_t i = 0; i + len <= text_.size(); ++i) {
+        patterns_.emplace_back(text_.substr(i, len));
+      }
+    }
+    patterns_.insert(patterns_.end(), {"x", "abx", "xab", "bxab", "abcabcabcabc", "cbbaccab", "cbbaccab"});
+  }
+
+  void checkBatch(const TIndex &t_index) {
+    auto ranges = t_index.CountBatch(patterns_);
+    auto occs = t_index.LocateBatch(patterns_);
+    ASSERT_EQ(ranges.size(), patterns_.size());
+    ASSERT_EQ(occs.size(), patterns_.size());
+
+    for (std::size_t i = 0; i < patterns_.size(); ++i) {
+      const auto &pattern = patterns_[i];
+      std::vector<std::size_t> expected;
+      for (auto pos = text_.find(pattern); pos != String::npos; pos = text_.find(pattern, pos + 1)) {
+        expected.emplace_back(pos);
+      }
+
+      EXPECT_EQ(ranges[i], t_index.Count(pattern)) << pattern;
+
+      std::sort(occs[i].begin(), occs[i].end());
+      EXPECT_EQ(occs[i], expected) << pattern;
+    }
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccab";
+  std::vector<String> patterns_;
+};
+
+using BatchIndexes = ::testing::Types<sri::SrIndex<>, sri::SrIndexValidMark<>, sri::SrIndexValidArea<>>;
+TYPED_TEST_SUITE(BatchTypedTests, BatchIndexes);
+
+TYPED_TEST(BatchTypedTests, queries) {
+  TypeParam index;
+  sri::construct(index, this->config_.file_map[this->key_tmp_input_], this->config_);
+
+  this->checkBatch(index);
+}
+
+TYPED_TEST(BatchTypedTests, subsampled) {
+  TypeParam index(4);
+  sri::construct(index, this->config_.file_map[this->key_tmp_input_], this->config_);
+
+  this->checkBatch(index);
+}
+
+TYPED_TEST(BatchTypedTests, empty) {
+  TypeParam index;
+  sri::construct(index, this->config_.file_map[this->key_tmp_input_], this->config_);
+
+  EXPECT_TRUE(index.CountBatch({}).empty());
+  EXPECT_TRUE(index.LocateBatch({}).empty());
+}
@@ -0,0 +1,85 @@
+//
+// Construction report tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "sr-index/build_report.h"
+#include "sr-index/sr_index.h"
+#include "sr-index/construct.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+TEST(BuildReportTests, NestedStages) {
+  auto &report = sri::BuildReport::instance();
+  report.enable();
+
+  report.beginIndex({{"output", "index"}, {"s", 4}});
+  {
+    sri::StageEvent outer("Outer");
+    {
+      sri::StageEvent inner("Inner");
+      report.addOutput(10);
+    }
+    report.addOutput(5);
+  }
+  report.endIndex(100);
+
+  const auto &build = report.builds().back();
+  ASSERT_EQ(build.stages.size(), 2);
+  const auto &inner = build.stages[0];
+  const auto &outer = build.stages[1];
+  EXPECT_EQ(inner.name, "Inner");
+  EXPECT_EQ(outer.name, "Outer");
+
+  // The enclosing stage includes the nested one
+  EXPECT_EQ(inner.output_bytes, 10);
+  EXPECT_EQ(outer.output_bytes, 15);
+  EXPECT_GE(outer.wall_secs, inner.wall_secs);
+  EXPECT_GE(outer.peak_rss_bytes, inner.peak_rss_bytes);
+
+  EXPECT_EQ(build.output_bytes, 100);
+  auto json = report.toJSON()["builds"].back();
+  EXPECT_EQ(json["output"], "index");
+  EXPECT_EQ(json["s"], 4);
+  EXPECT_EQ(json["stages"].size(), 2);
+}
+
+template<typename TIndex>
+class BuildReportConstructTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+    sri::BuildReport::instance().enable();
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+};
+
+using BuildReportIndexes = ::testing::Types<sri::SrIndex<>, sri::SrIndexValidMark<>, sri::SrIndexValidArea<>>;
+TYPED_TEST_SUITE(BuildReportConstructTests, BuildReportIndexes);
+
+TYPED_TEST(BuildReportConstructTests, Stages) {
+  auto &report = sri::BuildReport::instance();
+  report.beginIndex({{"s", 4}});
+
+  TypeParam index(4);
+  sri::construct(index, this->config_.data_path, this->config_);
+  report.endIndex(0);
+
+  std::map<std::string, sri::StageReport> stages;
+  for (const auto &stage : report.builds().back().stages) {
+    EXPECT_GE(stage.wall_secs, 0) << stage.name;
+    EXPECT_GE(stage.cpu_secs, 0) << stage.name;
+    stages[stage.name] = stage;
+  }
+
+  for (const auto &name : {"Text", "SA", "BWT", "BWT Runs", "BWT RLE", "Predecessor", "Subsampling"}) {
+    EXPECT_TRUE(stages.count(name)) << name;
+  }
+  EXPECT_GT(stages["SA"].output_bytes, 0);
+  EXPECT_GT(stages["BWT RLE"].output_bytes, 0);
+}
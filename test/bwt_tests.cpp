@@ -2,6 +2,7 @@
 // Created by Dustin Cobas <dustin.cobas@gmail.com> on 8/9/20.
 //
 
+#include <random>
 #include <string>
 #include <vector>
 
@@ -131,3 +132,46 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(BWT{4, 4, 3, 4, 1, 2, 2, 2, 2, 3, 3, 3}, F{0, 0, 1, 5, 9, 12}, Range{10, 11}, 3, Range{7, 8}) // 3 before 42
     )
 );
+
+class BWTRunHeads_Tests : public testing::TestWithParam<std::tuple<std::size_t, std::size_t, std::size_t>> {
+};
+
+TEST_P(BWTRunHeads_Tests, ByChunks) {
+  auto [n, max_run, n_chunks] = GetParam();
+
+  // Random runs of random lengths
+  std::mt19937 gen(n + max_run);
+  std::vector<uint8_t> bwt;
+  while (bwt.size() < n) {
+    auto symbol = gen() % 4;
+    auto length = 1 + gen() % max_run;
+    bwt.insert(bwt.end(), std::min(length, n - bwt.size()), symbol);
+  }
+
+  std::vector<std::size_t> e_heads;
+  for (std::size_t i = 1; i < n; ++i) {
+    if (bwt[i - 1] != bwt[i]) e_heads.push_back(i);
+  }
+
+  std::vector<std::size_t> heads;
+  std::vector<std::size_t> byte_heads;
+  for (std::size_t chunk = 0; chunk < n_chunks; ++chunk) {
+    auto first = n * chunk / n_chunks;
+    auto last = n * (chunk + 1) / n_chunks;
+    sri::computeBWTRunHeads(first, last, [&bwt](auto i) { return bwt[i]; }, [&heads](auto i) { heads.push_back(i); });
+    sri::computeBWTRunHeads(bwt.data(), first, last, [&byte_heads](auto i) { byte_heads.push_back(i); });
+  }
+
+  EXPECT_THAT(heads, testing::ElementsAreArray(e_heads));
+  EXPECT_THAT(byte_heads, testing::ElementsAreArray(e_heads));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BWT,
+    BWTRunHeads_Tests,
+    testing::Combine(
+        testing::Values(1, 31, 1000, 100000), // BWT size
+        testing::Values(1, 3, 100), // Maximum run length
+        testing::Values(1, 3, 7) // Chunks
+    )
+);
@@ -0,0 +1,74 @@
+//
+// Stored CSA-based indexes tests.
+//
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <sstream>
+#include <type_traits>
+
+#include "sr-index/r_csa.h"
+#include "sr-index/sr_csa.h"
+#include "sr-index/sr_csa_psi.h"
+
+#include "base_tests.h"
+
+template<typename TIndex>
+class CSASerializeTests : public BaseConfigTests {
+ protected:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+  }
+
+  static TIndex makeIndex() {
+    if constexpr (std::is_constructible_v<TIndex, std::size_t>) return TIndex(4);
+    else return TIndex();
+  }
+
+  std::vector<std::size_t> occurrences(const std::string &t_pattern) const {
+    std::vector<std::size_t> occs;
+    for (auto pos = text_.find(t_pattern); pos != std::string::npos; pos = text_.find(t_pattern, pos + 1)) {
+      occs.push_back(pos);
+    }
+    return occs;
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+};
+
+using CSAIndexes = ::testing::Types<sri::RCSAWithBWTRun<>,
+                                    sri::CSARaw<>,
+                                    sri::SrCSA<>,
+                                    sri::SrCSAValidMark<sri::SrCSA<>>,
+                                    sri::SrCSAValidArea<sri::SrCSA<>>,
+                                    sri::SrCSASlim<>,
+                                    sri::SrCSAValidMark<sri::SrCSASlim<>>,
+                                    sri::SrCSAValidArea<sri::SrCSASlim<>>,
+                                    sri::RCSAWithPsiRun<>,
+                                    sri::SrCSAWithPsiRun<>,
+                                    sri::SRCSAValidMark<>,
+                                    sri::SRCSAValidArea<>>;
+TYPED_TEST_SUITE(CSASerializeTests, CSAIndexes);
+
+// The index loaded from the stream answers the queries as the constructed one, as the CLI does with a stored index
+TYPED_TEST(CSASerializeTests, LoadedIndexLocates) {
+  auto index = this->makeIndex();
+  sri::construct(index, this->config_.data_path, this->config_);
+
+  std::stringstream stream;
+  index.serialize(stream);
+  TypeParam loaded;
+  loaded.load(stream);
+
+  for (const std::string &pattern : {"a", "ab", "abc", "cab", "bbac", "cabcbb", "x"}) {
+    EXPECT_EQ(loaded.Count(pattern), index.Count(pattern)) << pattern;
+    auto occs = loaded.Locate(pattern);
+    std::sort(occs.begin(), occs.end());
+    EXPECT_THAT(occs, testing::ElementsAreArray(this->occurrences(pattern))) << pattern;
+  }
+
+  auto parts = loaded.breakdown();
+  EXPECT_FALSE(parts.empty());
+}
@@ -0,0 +1,97 @@
+//
+// Document collection tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <sdsl/io.hpp>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/documents.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+using Docs = std::vector<std::size_t>;
+using DocFreqs = std::vector<std::pair<std::size_t, std::size_t>>;
+
+template<typename TIndex>
+class DocTypedTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    String collection;
+    for (const auto &doc : docs_) {
+      collection += doc + '\1';
+    }
+    Init(collection, sri::SDSL_LIBDIVSUFSORT);
+  }
+
+  //! Naive per-document frequencies
+  DocFreqs computeNaiveFreqs(const String &t_pattern) {
+    DocFreqs freqs;
+    for (std::size_t d = 0; d < docs_.size(); ++d) {
+      std::size_t freq = 0;
+      for (auto pos = docs_[d].find(t_pattern); pos != String::npos; pos = docs_[d].find(t_pattern, pos + 1)) ++freq;
+      if (freq) freqs.emplace_back(d, freq);
+    }
+    return freqs;
+  }
+
+  std::vector<String> docs_ = {"abcabcab", "ababc", "cccb", "abcabcababc"};
+  std::vector<String> patterns_ = {"ab", "abc", "c", "cb", "ccc", "x"};
+};
+
+using DocIndexes = ::testing::Types<sri::IndexDoc<sri::SrIndex<>>,
+                                    sri::IndexDoc<sri::SrIndexValidMark<>>,
+                                    sri::IndexDoc<sri::SrIndexValidArea<>>>;
+TYPED_TEST_SUITE(DocTypedTests, DocIndexes);
+
+TYPED_TEST(DocTypedTests, frequencies) {
+  TypeParam index(2);
+  sri::construct(index, this->config_.file_map[this->key_tmp_input_], this->config_);
+
+  EXPECT_EQ(index.NumDocs(), this->docs_.size());
+  for (const auto &pattern : this->patterns_) {
+    auto e_freqs = this->computeNaiveFreqs(pattern);
+    EXPECT_EQ(index.DocFrequencies(pattern), e_freqs) << pattern;
+
+    Docs e_docs;
+    for (const auto &[doc, freq] : e_freqs) e_docs.emplace_back(doc);
+    EXPECT_EQ(index.ListDocs(pattern), e_docs) << pattern;
+  }
+}
+
+TYPED_TEST(DocTypedTests, list_doc_rate) {
+  for (std::size_t doc_rate : {1, 3, 64}) {
+    TypeParam index(2, doc_rate);
+    sri::construct(index, this->config_.file_map[this->key_tmp_input_], this->config_);
+
+    for (const auto &pattern : this->patterns_) {
+      Docs e_docs;
+      for (const auto &[doc, freq] : this->computeNaiveFreqs(pattern)) e_docs.emplace_back(doc);
+      EXPECT_EQ(index.ListDocs(pattern), e_docs) << pattern << " (doc_rate " << doc_rate << ")";
+    }
+  }
+}
+
+TYPED_TEST(DocTypedTests, serialize) {
+  auto key_index = "index";
+  {
+    TypeParam index(2);
+    sri::construct(index, this->config_.file_map[this->key_tmp_input_], this->config_);
+    sdsl::store_to_cache(index, key_index, this->config_);
+  }
+
+  TypeParam index;
+  sdsl::load_from_cache(index, key_index, this->config_);
+
+  EXPECT_EQ(index.NumDocs(), this->docs_.size());
+  for (const auto &pattern : this->patterns_) {
+    auto e_freqs = this->computeNaiveFreqs(pattern);
+    EXPECT_EQ(index.DocFrequencies(pattern), e_freqs) << pattern;
+
+    Docs e_docs;
+    for (const auto &[doc, freq] : e_freqs) e_docs.emplace_back(doc);
+    EXPECT_EQ(index.ListDocs(pattern), e_docs) << pattern;
+  }
+}
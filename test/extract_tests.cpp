@@ -0,0 +1,82 @@
+//
+// Text extraction tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <sdsl/io.hpp>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/extract.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+template<typename TIndex>
+class ExtractTypedTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+  }
+
+  void buildIndex(TIndex &t_index) {
+    sri::construct(t_index, config_.file_map[key_tmp_input_], config_);
+  }
+
+  //! Every substring of the text, including the ones clipped at the text end
+  void checkExtract(const TIndex &t_index) {
+    for (std::size_t i = 0; i < text_.size(); ++i) {
+      for (std::size_t len = 0; i + len <= text_.size() + 2; ++len) {
+        EXPECT_EQ(t_index.Extract(i, len), text_.substr(i, len)) << i << ", " << len;
+      }
+    }
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccab";
+  std::vector<String> patterns_ = {"ab", "abc", "cbb", "bbacc", "x"};
+};
+
+using ExtractIndexes = ::testing::Types<sri::IndexExtract<sri::SrIndex<>>,
+                                        sri::IndexExtract<sri::SrIndexValidMark<>>,
+                                        sri::IndexExtract<sri::SrIndexValidArea<>>>;
+TYPED_TEST_SUITE(ExtractTypedTests, ExtractIndexes);
+
+TYPED_TEST(ExtractTypedTests, extract) {
+  for (auto isa_rate : {1u, 3u, 8u, 64u}) {
+    TypeParam index(4, isa_rate);
+    this->buildIndex(index);
+
+    this->checkExtract(index);
+  }
+}
+
+TYPED_TEST(ExtractTypedTests, display) {
+  TypeParam index(4, 5);
+  this->buildIndex(index);
+
+  const std::size_t context = 3;
+  for (const auto &pattern : this->patterns_) {
+    std::vector<String> expected;
+    for (auto pos = this->text_.find(pattern); pos != String::npos; pos = this->text_.find(pattern, pos + 1)) {
+      auto first = pos < context ? 0 : pos - context;
+      expected.emplace_back(this->text_.substr(first, pos - first + pattern.size() + context));
+    }
+
+    EXPECT_EQ(index.Display(pattern, context), expected) << pattern;
+  }
+}
+
+TYPED_TEST(ExtractTypedTests, serialize) {
+  auto key_index = "index";
+  {
+    TypeParam index(4, 5);
+    this->buildIndex(index);
+    sdsl::store_to_cache(index, key_index, this->config_);
+  }
+
+  TypeParam index;
+  sdsl::load_from_cache(index, key_index, this->config_);
+
+  EXPECT_EQ(index.ISARate(), 5);
+  this->checkExtract(index);
+}
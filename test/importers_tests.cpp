@@ -0,0 +1,202 @@
+//
+// Import of pre-built BWTs and SA samples tests.
+//
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "sr-index/importers.h"
+#include "sr-index/construct.h"
+#include "sr-index/sr_index.h"
+
+namespace fs = std::filesystem;
+
+class ImportersTests : public testing::Test {
+ protected:
+  void SetUp() override {
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+
+    // Naive SA and BWT of the text with the zero terminator
+    text_.push_back('\0');
+    sa_.resize(text_.size());
+    std::iota(sa_.begin(), sa_.end(), 0);
+    std::sort(sa_.begin(), sa_.end(), [this](auto tt_a, auto tt_b) {
+      return text_.compare(tt_a, std::string::npos, text_, tt_b, std::string::npos) < 0;
+    });
+    for (auto sa_i : sa_) bwt_.push_back(text_[sa_i ? sa_i - 1 : text_.size() - 1]);
+    text_.pop_back();
+  }
+
+  void TearDown() override {
+    fs::remove_all(dir_);
+  }
+
+  std::string write(const std::string &t_name, const std::string &t_content) {
+    auto file = (dir_ / t_name).string();
+    std::ofstream(file, std::ios::binary) << t_content;
+    return file;
+  }
+
+  static void putInt(std::string &t_out, uint64_t t_value, std::size_t t_bytes) {
+    for (std::size_t i = 0; i < t_bytes; ++i) t_out.push_back(char((t_value >> (8 * i)) & 0xFF));
+  }
+
+  //! Run-length BWT, splitting some runs in two to check they are merged back
+  std::string rleBWT(std::size_t t_length_bytes) const {
+    std::string rle;
+    for (std::size_t i = 0; i < bwt_.size();) {
+      auto j = i;
+      while (j < bwt_.size() && bwt_[j] == bwt_[i]) ++j;
+      const auto first_length = (2 < j - i) ? 1 : j - i;
+      rle.push_back(bwt_[i]);
+      putInt(rle, first_length, t_length_bytes);
+      if (first_length < j - i) {
+        rle.push_back(bwt_[i]);
+        putInt(rle, j - i - first_length, t_length_bytes);
+      }
+      i = j;
+    }
+    return rle;
+  }
+
+  //! Pairs <BWT position, SA value> at the heads (t_heads) or tails of the maximal BWT runs
+  std::string runSamples(bool t_heads, std::size_t t_int_bytes) const {
+    std::string samples;
+    for (std::size_t j = 0; j < bwt_.size(); ++j) {
+      const bool boundary = t_heads ? (j == 0 || bwt_[j - 1] != bwt_[j])
+                                    : (j + 1 == bwt_.size() || bwt_[j + 1] != bwt_[j]);
+      if (!boundary) continue;
+      putInt(samples, j, t_int_bytes);
+      putInt(samples, sa_[j], t_int_bytes);
+    }
+    return samples;
+  }
+
+  std::string wholeSA(std::size_t t_int_bytes) const {
+    std::string sa;
+    for (auto sa_i : sa_) putInt(sa, sa_i, t_int_bytes);
+    return sa;
+  }
+
+  //! Build the index from the imported files and check its occurrences against the text
+  void checkIndex(const std::string &t_bwt_file, const sri::ImportSpec &t_spec) {
+    sri::Config config(t_bwt_file, dir_, sri::IMPORTED);
+    config.import = t_spec;
+
+    sri::SrIndex<> index(4);
+    sri::construct(index, t_bwt_file, config);
+
+    for (const std::string &pattern : {"ab", "abc", "cab", "bbac", "x"}) {
+      std::vector<std::size_t> expected;
+      for (auto pos = text_.find(pattern); pos != std::string::npos; pos = text_.find(pattern, pos + 1)) {
+        expected.push_back(pos);
+      }
+      auto occs = index.Locate(pattern);
+      std::sort(occs.begin(), occs.end());
+      EXPECT_THAT(occs, testing::ElementsAreArray(expected)) << pattern;
+    }
+
+    sdsl::util::delete_all_files(config.file_map);
+  }
+
+  fs::path dir_ = fs::temp_directory_path() / "sri_importers_tests";
+  std::string text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+  std::vector<std::size_t> sa_;
+  std::string bwt_;
+};
+
+TEST_F(ImportersTests, BufferedInput) {
+  std::string content = "xy";
+  putInt(content, 0x0102030405, 5);
+  sri::BufferedInput in(write("ints", content), 3);
+
+  uint8_t byte;
+  EXPECT_TRUE(in.peek(byte));
+  EXPECT_EQ(byte, 'x');
+  EXPECT_TRUE(in.get(byte));
+  EXPECT_TRUE(in.get(byte));
+  EXPECT_EQ(byte, 'y');
+
+  uint64_t value;
+  EXPECT_TRUE(in.getInt(value, 5));
+  EXPECT_EQ(value, 0x0102030405);
+  EXPECT_FALSE(in.getInt(value, 5));
+}
+
+TEST_F(ImportersTests, TruncatedInteger) {
+  sri::BufferedInput in(write("ints", "abc"));
+  uint64_t value;
+  EXPECT_THROW(in.getInt(value, 5), std::runtime_error);
+}
+
+TEST_F(ImportersTests, BWTReaders) {
+  auto read_all = [](sri::BWTRunReader &tt_reader) {
+    std::string bwt;
+    uint8_t symbol;
+    uint64_t length;
+    while (tt_reader.next(symbol, length)) bwt.append(length, char(symbol));
+    return bwt;
+  };
+
+  sri::PlainBWTReader plain(write("bwt", bwt_));
+  EXPECT_EQ(plain.size(), bwt_.size());
+  EXPECT_EQ(read_all(plain), bwt_);
+
+  sri::RunLengthBWTReader rle(write("bwt.rle", rleBWT(2)), 2);
+  EXPECT_EQ(rle.size(), bwt_.size());
+  EXPECT_EQ(read_all(rle), bwt_);
+}
+
+TEST_F(ImportersTests, SampleReadersCheckTheRuns) {
+  sri::RunPairsReader reader(write("ssa", runSamples(true, 5)), write("esa", runSamples(false, 5)), 5);
+  EXPECT_EQ(reader.head(0), sa_[0]);
+  EXPECT_THROW(reader.head(0), std::runtime_error); // The next head is not at 0
+
+  sri::SAFileReader sa_reader(write("sa", wholeSA(4)), 4);
+  EXPECT_EQ(sa_reader.tail(bwt_.size() - 1), sa_.back());
+  EXPECT_EQ(sa_reader.head(1), sa_[1]);
+  EXPECT_THROW(sa_reader.head(bwt_.size()), std::runtime_error);
+}
+
+TEST_F(ImportersTests, UnknownFormat) {
+  sri::ImportSpec spec;
+  spec.bwt_format = "unknown";
+  sdsl::cache_config config(false, dir_.string(), "import");
+  EXPECT_THROW(sri::inner_import::importBWTAndRuns(write("bwt", bwt_), spec, config), std::invalid_argument);
+}
+
+TEST_F(ImportersTests, PlainBWTAndRunSamples) {
+  sri::ImportSpec spec;
+  spec.ssa_file = write("bwt.ssa", runSamples(true, 5));
+  spec.esa_file = write("bwt.esa", runSamples(false, 5));
+  checkIndex(write("bwt", bwt_), spec);
+}
+
+TEST_F(ImportersTests, RunLengthBWTAndWholeSA) {
+  sri::ImportSpec spec;
+  spec.bwt_format = "rle";
+  spec.run_length_bytes = 3;
+  spec.samples_format = "sa";
+  spec.sa_file = write("sa", wholeSA(4));
+  spec.int_bytes = 4;
+  checkIndex(write("bwt.rle", rleBWT(3)), spec);
+}
+
+TEST_F(ImportersTests, GzipBWT) {
+  auto file = write("bwt", bwt_);
+  if (std::system(("gzip -f " + file).c_str()) != 0) GTEST_SKIP() << "gzip is not available";
+
+  sri::ImportSpec spec;
+  spec.samples_format = "sa";
+  spec.sa_file = write("sa", wholeSA(5));
+  checkIndex(file + ".gz", spec);
+}
@@ -0,0 +1,104 @@
+//
+// K-mer table tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <sdsl/io.hpp>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/kmer_table.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+template<typename TIndex>
+class KmerTableTypedTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+
+    for (std::size_t len = 1; len <= 6; ++len) {
+      for (std::size_t i = 0; i + len <= text_.size(); ++i) {
+        patterns_.emplace_back(text_.substr(i, len));
+      }
+    }
+    patterns_.insert(patterns_.end(), {"x", "abx", "xab", "abcabcabcabc", "cbbaccabx"});
+  }
+
+  void buildIndex(TIndex &t_index, std::size_t t_k, std::size_t t_budget = 0) {
+    // The table is rebuilt for each k
+    std::filesystem::remove(sdsl::cache_file_name(sri::conf::KEY_KMER_TABLE, config_));
+    config_.kmer_k = t_k;
+    config_.kmer_budget = t_budget;
+    sri::construct(t_index, config_.file_map[key_tmp_input_], config_);
+  }
+
+  void checkQueries(const TIndex &t_index) {
+    for (const auto &pattern : patterns_) {
+      std::vector<std::size_t> expected;
+      for (auto pos = text_.find(pattern); pos != String::npos; pos = text_.find(pattern, pos + 1)) {
+        expected.emplace_back(pos);
+      }
+
+      auto [start, end] = t_index.Count(pattern);
+      EXPECT_EQ(start < end ? end - start : 0, expected.size()) << pattern;
+
+      auto occs = t_index.Locate(pattern);
+      std::sort(occs.begin(), occs.end());
+      EXPECT_EQ(occs, expected) << pattern;
+    }
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccab";
+  std::vector<String> patterns_;
+};
+
+using KmerTableIndexes = ::testing::Types<sri::SrIndex<>, sri::SrIndexValidMark<>, sri::SrIndexValidArea<>>;
+TYPED_TEST_SUITE(KmerTableTypedTests, KmerTableIndexes);
+
+TYPED_TEST(KmerTableTypedTests, queries) {
+  for (std::size_t k = 1; k <= 4; ++k) {
+    TypeParam index(4);
+    this->buildIndex(index, k);
+
+    this->checkQueries(index);
+  }
+}
+
+TYPED_TEST(KmerTableTypedTests, budget) {
+  // Table with only a few k-mers
+  TypeParam index(4);
+  this->buildIndex(index, 3, 32);
+
+  this->checkQueries(index);
+}
+
+TYPED_TEST(KmerTableTypedTests, serialize) {
+  auto key_index = "index";
+  {
+    TypeParam index(4);
+    this->buildIndex(index, 2);
+    sdsl::store_to_cache(index, key_index, this->config_);
+  }
+
+  TypeParam index;
+  sdsl::load_from_cache(index, key_index, this->config_);
+
+  this->checkQueries(index);
+}
+
+TYPED_TEST(KmerTableTypedTests, serialize_without_table) {
+  // Without the table, the stream has no k-mer table item, and the loaded index has an empty one
+  auto key_index = "index";
+  {
+    TypeParam index(4);
+    this->buildIndex(index, 0);
+    sdsl::store_to_cache(index, key_index, this->config_);
+  }
+
+  TypeParam index;
+  sdsl::load_from_cache(index, key_index, this->config_);
+
+  this->checkQueries(index);
+}
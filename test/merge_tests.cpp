@@ -0,0 +1,128 @@
+//
+// Merge of stored r-indexes tests.
+//
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+
+#include <sdsl/io.hpp>
+
+#include "sr-index/r_index.h"
+#include "sr-index/sr_index.h"
+#include "sr-index/merge.h"
+
+#include "base_tests.h"
+
+namespace fs = std::filesystem;
+
+class MergeTests : public BaseConfigTests {
+ protected:
+  void SetUp() override {
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+  }
+
+  void TearDown() override {
+    BaseConfigTests::TearDown();
+    fs::remove_all(dir_);
+  }
+
+  //! Build the r-index of the text in a folder of its own and store it
+  std::string store(const String &t_text, const std::string &t_name) {
+    fs::create_directories(dir_ / t_name);
+    auto text_file = (dir_ / t_name / "text").string();
+    sdsl::store_to_file(t_text, text_file);
+
+    sri::Config config(text_file, dir_ / t_name, sri::SDSL_LIBDIVSUFSORT);
+    sri::RIndex<> index;
+    sri::construct(index, text_file, config);
+    sdsl::util::delete_all_files(config.file_map);
+
+    auto file = (dir_ / (t_name + ".ri")).string();
+    sdsl::store_to_file(index, file);
+    return file;
+  }
+
+  template<typename TIndex>
+  void merge(TIndex &t_index, const std::string &t_first_file, const std::string &t_second_file, uint8_t t_boundary = 1) {
+    fs::create_directories(dir_ / "merge");
+    sri::Config config(t_first_file, dir_ / "merge", sri::IMPORTED);
+    sri::merge<sri::RIndex<>>(t_index, t_first_file, t_second_file, config, t_boundary);
+    sdsl::util::delete_all_files(config.file_map);
+  }
+
+  template<typename TIndex>
+  void checkLocate(const TIndex &t_index, const String &t_text) {
+    for (const std::string &pattern : {"a", "ab", "abc", "cab", "bbac", "cabcbb", "acd", "dd", "x"}) {
+      std::vector<std::size_t> expected;
+      for (auto pos = t_text.find(pattern); pos != std::string::npos; pos = t_text.find(pattern, pos + 1)) {
+        expected.push_back(pos);
+      }
+      auto occs = t_index.Locate(pattern);
+      std::sort(occs.begin(), occs.end());
+      EXPECT_THAT(occs, testing::ElementsAreArray(expected)) << pattern;
+    }
+  }
+
+  template<typename TIndex>
+  static std::string serialize(const TIndex &t_index) {
+    std::stringstream out;
+    t_index.serialize(out);
+    return out.str();
+  }
+
+  // The second text has a symbol that is not in the first one, and shares long substrings with it
+  String first_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+  String second_ = "cabcbbaccababdcabcddabcacbbacbcabcbbaccabd";
+  fs::path dir_ = fs::temp_directory_path() / "sri_merge_tests";
+};
+
+TEST_F(MergeTests, IsTheConstructedIndex) {
+  auto first_file = store(first_, "first");
+  auto second_file = store(second_, "second");
+  const auto text = first_ + '\1' + second_;
+
+  sri::RIndex<> r_index;
+  merge(r_index, first_file, second_file);
+  checkLocate(r_index, text);
+
+  sri::SrIndexValidArea<> sri_va(4);
+  merge(sri_va, first_file, second_file);
+  checkLocate(sri_va, text);
+
+  Init(text, sri::SDSL_LIBDIVSUFSORT);
+  sri::RIndex<> constructed;
+  sri::construct(constructed, config_.data_path, config_);
+  EXPECT_EQ(serialize(r_index), serialize(constructed));
+}
+
+TEST_F(MergeTests, MergedIndexesCanBeMergedAgain) {
+  auto first_file = store(first_, "first");
+  auto second_file = store(second_, "second");
+
+  // Each boundary must be smaller than the previous ones
+  sri::RIndex<> merged;
+  merge(merged, first_file, second_file, '\2');
+  auto merged_file = (dir_ / "merged.ri").string();
+  sdsl::store_to_file(merged, merged_file);
+
+  sri::SrIndex<> sri(8);
+  merge(sri, merged_file, second_file, '\1');
+  checkLocate(sri, first_ + '\2' + second_ + '\1' + second_);
+
+  sri::SrIndex<> sri_wrong_boundary(8);
+  EXPECT_THROW(merge(sri_wrong_boundary, merged_file, second_file, '\3'), std::invalid_argument);
+}
+
+TEST_F(MergeTests, Errors) {
+  auto first_file = store(first_, "first");
+  auto second_file = store(second_, "second");
+
+  // The boundary symbol must be smaller than the symbols of both texts
+  sri::SrIndex<> sri(4);
+  EXPECT_THROW(merge(sri, first_file, second_file, 'b'), std::invalid_argument);
+}
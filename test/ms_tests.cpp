@@ -0,0 +1,95 @@
+//
+// Matching statistics tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <sdsl/io.hpp>
+
+#include "sr-index/r_index.h"
+#include "sr-index/sr_index.h"
+#include "sr-index/matching_statistics.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+using Lengths = std::vector<std::size_t>;
+
+//! Naive matching statistics: longest prefix of P[i..m) occurring in the text
+Lengths computeNaiveMS(const String &t_text, const String &t_pattern) {
+  Lengths lengths(t_pattern.size(), 0);
+  for (std::size_t i = 0; i < t_pattern.size(); ++i) {
+    auto len = t_pattern.size() - i;
+    while (len > 0 && t_text.find(t_pattern.substr(i, len)) == String::npos) --len;
+    lengths[i] = len;
+  }
+  return lengths;
+}
+
+template<typename TIndex>
+class MSTypedTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+  }
+
+  void buildIndex(TIndex &t_index) {
+    sri::construct(t_index, config_.file_map[key_tmp_input_], config_);
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccab";
+  std::vector<String> patterns_ = {"abc", "cababx", "bbbbaccab", "xyz", "abcabcababcabbcaabca", "cbcabcbbaccabcabcaba"};
+};
+
+using MSIndexes = ::testing::Types<sri::IndexMS<sri::SrIndex<>>,
+                                   sri::IndexMS<sri::SrIndexValidMark<>>,
+                                   sri::IndexMS<sri::SrIndexValidArea<>>>;
+TYPED_TEST_SUITE(MSTypedTests, MSIndexes);
+
+TYPED_TEST(MSTypedTests, lengths) {
+  TypeParam index(6);
+  this->buildIndex(index);
+
+  for (const auto &pattern : this->patterns_) {
+    EXPECT_EQ(index.MS(pattern), computeNaiveMS(this->text_, pattern)) << pattern;
+  }
+}
+
+TYPED_TEST(MSTypedTests, lengths_isa_rate) {
+  for (std::size_t isa_rate : {1, 3, 16}) {
+    TypeParam index(6, isa_rate);
+    this->buildIndex(index);
+
+    for (const auto &pattern : this->patterns_) {
+      EXPECT_EQ(index.MS(pattern), computeNaiveMS(this->text_, pattern)) << pattern << " with ISA rate " << isa_rate;
+    }
+  }
+}
+
+TYPED_TEST(MSTypedTests, positions) {
+  TypeParam index(6);
+  this->buildIndex(index);
+
+  for (const auto &pattern : this->patterns_) {
+    index.MS(pattern, [this, &pattern](auto tt_i, auto tt_len, auto tt_pos) {
+      if (tt_len == 0) return;
+      EXPECT_EQ(this->text_.substr(tt_pos, tt_len), pattern.substr(tt_i, tt_len)) << pattern << " at " << tt_i;
+    });
+  }
+}
+
+TYPED_TEST(MSTypedTests, serialize) {
+  auto key_index = "index";
+  {
+    TypeParam index(6);
+    this->buildIndex(index);
+    sdsl::store_to_cache(index, key_index, this->config_);
+  }
+
+  TypeParam index;
+  sdsl::load_from_cache(index, key_index, this->config_);
+
+  for (const auto &pattern : this->patterns_) {
+    EXPECT_EQ(index.MS(pattern), computeNaiveMS(this->text_, pattern)) << pattern;
+  }
+}
@@ -0,0 +1,138 @@
+//
+// Parallel suffix array construction tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sdsl/int_vector.hpp>
+
+#include "sr-index/parallel_sa.h"
+#include "sr-index/sr_index.h"
+#include "sr-index/construct.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+using Text = sdsl::int_vector<8>;
+
+//! Text terminated by the zero symbol
+Text toText(const std::string &t_str) {
+  Text text(t_str.size() + 1, 0, 8);
+  std::copy(t_str.begin(), t_str.end(), text.begin());
+  return text;
+}
+
+//! Whether the SA is a permutation of the text positions with its suffixes in increasing order
+bool isSA(const sdsl::int_vector<> &t_sa, const Text &t_text) {
+  std::vector<bool> seen(t_text.size(), false);
+  for (auto pos : t_sa) {
+    if (t_text.size() <= pos || seen[pos]) return false;
+    seen[pos] = true;
+  }
+
+  for (std::size_t i = 1; i < t_sa.size(); ++i) {
+    if (!std::lexicographical_compare(t_text.begin() + t_sa[i - 1], t_text.end(), t_text.begin() + t_sa[i], t_text.end())) {
+      return false;
+    }
+  }
+  return t_sa.size() == t_text.size();
+}
+
+class ParallelSATests : public testing::TestWithParam<std::tuple<std::string, std::size_t>> {
+};
+
+TEST_P(ParallelSATests, Sorted) {
+  auto [str, n_threads] = GetParam();
+  auto text = toText(str);
+
+  auto sa = sri::computeSAByInducedSorting(text, n_threads);
+
+  EXPECT_EQ(sa.width(), sdsl::bits::hi(text.size()) + 1);
+  EXPECT_TRUE(isSA(sa, text));
+}
+
+//! Random text over the first symbols of the alphabet, or a repetition of a random block with a few mutations
+std::string randomText(std::size_t t_n, std::size_t t_sigma, bool t_repetitive) {
+  std::mt19937 gen(t_n + t_sigma);
+  std::string str;
+  if (t_repetitive) {
+    std::string block;
+    for (std::size_t i = 0; i < 1000; ++i) block.push_back('a' + gen() % t_sigma);
+    while (str.size() < t_n) str += block;
+    str.resize(t_n);
+    for (std::size_t i = 0; i < 10; ++i) str[gen() % t_n] = 'a' + gen() % t_sigma;
+  } else {
+    for (std::size_t i = 0; i < t_n; ++i) str.push_back('a' + gen() % t_sigma);
+  }
+  return str;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParallelSA,
+    ParallelSATests,
+    testing::Combine(
+        testing::Values("", "a", "abracadabra", "aaaaaaaaaaaaaaaa", "abababababababab", "mississippi",
+                        randomText(10000, 26, false), randomText(200000, 2, false),
+                        randomText(30000, 4, true), std::string(3000, 'a')),
+        testing::Values(1, 4) // Threads
+    )
+);
+
+TEST(ParallelSATests, SeveralBlocks) {
+  // The induction scans span several blocks, and each L suffix fills the entry read next in its block
+  const std::size_t n = 200000;
+  auto text = toText(std::string(n, 'a'));
+
+  auto sa = sri::computeSAByInducedSorting(text, 4);
+
+  for (std::size_t i = 0; i <= n; ++i) EXPECT_EQ(sa[i], n - i) << i;
+}
+
+TEST(ParallelSATests, LargeSymbols) {
+  // The symbols, larger than the text length, are replaced by their ranks
+  sdsl::int_vector<> text = {7000000000, 5, 7000000000, 123456789, 5, 7000000000, 0};
+
+  auto sa = sri::computeSAByInducedSorting(text, 2);
+
+  EXPECT_THAT(sa, testing::ElementsAre(6, 4, 1, 3, 5, 0, 2));
+}
+
+TEST(ParallelSATests, UnterminatedText) {
+  Text text(4, 'a', 8);
+  EXPECT_THROW(sri::computeSAByInducedSorting(text, 1), std::invalid_argument);
+}
+
+class ParallelSAConstructTests : public BaseConfigTests {
+ protected:
+  void SetUp() override {
+    Init(text_, sri::PARALLEL_SAIS);
+    sri::setConstructionThreads(2);
+  }
+
+  void TearDown() override {
+    sri::setConstructionThreads(1);
+    BaseConfigTests::TearDown();
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+};
+
+TEST_F(ParallelSAConstructTests, Locate) {
+  sri::SrIndex<> index(4);
+  sri::construct(index, this->config_.data_path, this->config_);
+
+  for (const std::string &pattern : {"ab", "abc", "cab", "bbac", "x"}) {
+    std::vector<std::size_t> expected;
+    for (auto pos = text_.find(pattern); pos != std::string::npos; pos = text_.find(pattern, pos + 1)) {
+      expected.push_back(pos);
+    }
+    auto occs = index.Locate(pattern);
+    std::sort(occs.begin(), occs.end());
+    EXPECT_THAT(occs, testing::ElementsAreArray(expected)) << pattern;
+  }
+}
@@ -2,6 +2,9 @@
 // Created by Dustin Cobas <dustin.cobas@gmail.com> on 8/5/21.
 //
 
+#include <array>
+#include <sstream>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -10,6 +13,7 @@
 #include <sdsl/csa_alphabet_strategy.hpp>
 
 #include "sr-index/psi.h"
+#include "sr-index/psi_hybrid.h"
 #include "sr-index/rle_string.hpp"
 #include "sr-index/tools.h"
 
@@ -226,6 +230,194 @@ TEST_P(PsiTests, psi_core_rle_rank_run) {
   }
 }
 
+// A sample every 4 values (2 runs), so the queries go through the samples and the decoding goes on past them
+using PsiCoreStreamVByte = sri::PsiCoreRLE<sri::StreamVByteVector<4>>;
+
+TEST_P(PsiTests, psi_core_rle_stream_vbyte) {
+  const auto &e_psi = std::get<1>(GetParam());
+
+  auto psi_core = PsiCoreStreamVByte(alphabet_.C, e_psi);
+  auto psi_core_enc = sri::PsiCoreRLE<sri::enc_vector<sdsl::coder::elias_delta, 4>>(alphabet_.C, e_psi);
+
+  auto psi_select = [&psi_core](auto tt_c, auto tt_rnk) { return psi_core.select(tt_c, tt_rnk); };
+  auto get_c = [this](auto tt_index) { return sri::computeCForSAIndex(this->alphabet_.C, tt_index); };
+  auto cumulative = sri::RandomAccessForCRefContainer(std::cref(alphabet_.C));
+
+  auto psi = sri::Psi(psi_select, get_c, cumulative);
+
+  for (int i = 0; i < e_psi.size(); ++i) {
+    EXPECT_EQ(psi(i), e_psi[i]) << "psi failed at index " << i;
+  }
+
+  for (int i = 0; i <= e_psi.size(); ++i) {
+    EXPECT_EQ(psi_core.rankRun(i), psi_core_enc.rankRun(i)) << "rank run failed at index " << i;
+    for (std::size_t c = 0; c < psi_core.sigma(); ++c) {
+      EXPECT_EQ(psi_core.rank(c, i), psi_core_enc.rank(c, i)) << "rank failed for " << c << " at index " << i;
+    }
+  }
+
+  EXPECT_EQ(psi_core.splitInRuns(0, e_psi.size()), psi_core_enc.splitInRuns(0, e_psi.size()));
+}
+
+TEST_P(PsiTests, psi_core_rle_stream_vbyte_serialized) {
+  const auto &e_psi = std::get<1>(GetParam());
+  auto key = "psi_core_rle_stream_vbyte";
+
+  {
+    auto tmp_psi_core = PsiCoreStreamVByte(alphabet_.C, e_psi);
+    sdsl::store_to_cache(tmp_psi_core, key, config_);
+  }
+
+  PsiCoreStreamVByte psi_core;
+  sdsl::load_from_cache(psi_core, key, config_);
+
+  auto psi_select = [&psi_core](auto tt_c, auto tt_rnk) { return psi_core.select(tt_c, tt_rnk); };
+  auto get_c = [this](auto tt_index) { return sri::computeCForSAIndex(this->alphabet_.C, tt_index); };
+  auto cumulative = sri::RandomAccessForCRefContainer(std::cref(alphabet_.C));
+
+  auto psi = sri::Psi(psi_select, get_c, cumulative);
+
+  for (int i = 0; i < e_psi.size(); ++i) {
+    EXPECT_EQ(psi(i), e_psi[i]) << "psi failed at index " << i;
+  }
+}
+
+// The group decoding of the CPU (SSSE3 if it has it) gives the values of the scalar one for every control byte
+TEST(StreamVByteTests, decode_group) {
+  std::array<uint8_t, 48> data;
+  for (std::size_t i = 0; i < data.size(); ++i) data[i] = uint8_t(37 * i + 11);
+
+  for (int control = 0; control < 256; ++control) {
+    std::array<uint64_t, 4> values, e_values;
+    auto length = sri::stream_vbyte::decodeGroup(control, data.data(), values.data());
+    auto e_length = sri::stream_vbyte::decodeGroupScalar(control, data.data(), e_values.data());
+
+    EXPECT_EQ(length, e_length) << "failed for control " << control << " (" << sri::stream_vbyte::decodePath() << ")";
+    EXPECT_EQ(values, e_values) << "failed for control " << control << " (" << sri::stream_vbyte::decodePath() << ")";
+  }
+}
+
+// Every partial psi as a bit-vector, the odd symbols as bit-vectors and the choice of the cost model
+template<typename TCumulativeC>
+auto hybridPsiCores(const TCumulativeC &t_cumulative_c, const Psi &t_psi) {
+  auto sigma = t_cumulative_c.size() - 1;
+  std::vector<bool> odd(sigma, false);
+  for (std::size_t c = 1; c < sigma; c += 2) odd[c] = true;
+
+  return std::vector<sri::PsiCoreHybrid<>>{sri::PsiCoreHybrid<>(t_cumulative_c, t_psi, std::vector<bool>(sigma, true)),
+                                          sri::PsiCoreHybrid<>(t_cumulative_c, t_psi, odd),
+                                          sri::PsiCoreHybrid<>(t_cumulative_c, t_psi)};
+}
+
+TEST_P(PsiTests, psi_core_hybrid) {
+  const auto &e_psi = std::get<1>(GetParam());
+
+  auto psi_core_rle = sri::PsiCoreRLE(alphabet_.C, e_psi);
+  auto collect = [](auto &tt_items) {
+    return [&tt_items](auto tt_first, auto tt_last, auto tt_c, auto tt_n_run, auto tt_is_first) {
+      tt_items.emplace_back(tt_first, tt_last, tt_c, tt_n_run, tt_is_first);
+    };
+  };
+  using Item = std::tuple<std::size_t, std::size_t, Char, std::size_t, bool>;
+
+  for (const auto &psi_core : hybridPsiCores(alphabet_.C, e_psi)) {
+    auto psi_select = [&psi_core](auto tt_c, auto tt_rnk) { return psi_core.select(tt_c, tt_rnk); };
+    auto get_c = [this](auto tt_index) { return sri::computeCForSAIndex(this->alphabet_.C, tt_index); };
+    auto cumulative = sri::RandomAccessForCRefContainer(std::cref(alphabet_.C));
+
+    auto psi = sri::Psi(psi_select, get_c, cumulative);
+
+    for (int i = 0; i < e_psi.size(); ++i) {
+      EXPECT_EQ(psi(i), e_psi[i]) << "psi failed at index " << i;
+    }
+
+    for (std::size_t c = 0; c < psi_core.sigma(); ++c) {
+      EXPECT_EQ(psi_core.countRuns(c), psi_core_rle.countRuns(c)) << "count runs failed for " << c;
+      EXPECT_EQ(psi_core.rankCharRun(c), psi_core_rle.rankCharRun(c)) << "rank char run failed for " << c;
+
+      auto n_c = alphabet_.C[c + 1] - alphabet_.C[c];
+      for (std::size_t first = 1; first <= n_c; ++first) {
+        for (std::size_t last = first + 1; last <= n_c + 1; ++last) {
+          std::vector<Item> runs, e_runs;
+          psi_core.computeForwardRuns(c, first, last, collect(runs));
+          psi_core_rle.computeForwardRuns(c, first, last, collect(e_runs));
+          EXPECT_EQ(runs, e_runs) << "forward runs failed for " << c << " on ranks [" << first << ", " << last << ")";
+        }
+      }
+    }
+
+    for (int i = 0; i <= e_psi.size(); ++i) {
+      EXPECT_EQ(psi_core.rankRun(i), psi_core_rle.rankRun(i)) << "rank run failed at index " << i;
+      for (std::size_t c = 0; c < psi_core.sigma(); ++c) {
+        using DataRank = std::tuple<std::size_t, std::size_t, std::size_t, std::size_t>;
+        DataRank data_rank, e_data_rank;
+        psi_core.rank(c, i, [&data_rank](auto tt_rank, auto tt_start, auto tt_end, auto tt_run_rank) {
+          data_rank = DataRank(tt_rank, tt_start, tt_end, tt_run_rank);
+        });
+        psi_core_rle.rank(c, i, [&e_data_rank](auto tt_rank, auto tt_start, auto tt_end, auto tt_run_rank) {
+          e_data_rank = DataRank(tt_rank, tt_start, tt_end, tt_run_rank);
+        });
+        EXPECT_EQ(data_rank, e_data_rank) << "rank failed for " << c << " at index " << i;
+      }
+    }
+
+    for (int first = 0; first < e_psi.size(); ++first) {
+      for (int last = first + 1; last <= e_psi.size(); ++last) {
+        std::vector<Item> runs, e_runs;
+        psi_core.splitInRuns(first, last, collect(runs));
+        psi_core_rle.splitInRuns(first, last, collect(e_runs));
+        std::sort(runs.begin(), runs.end());
+        std::sort(e_runs.begin(), e_runs.end());
+        EXPECT_EQ(runs, e_runs) << "split in runs failed on [" << first << ", " << last << ")";
+      }
+    }
+  }
+}
+
+// The partial psi functions chosen by the cost model are stored as if they had been given
+TEST_P(PsiTests, psi_core_hybrid_choice) {
+  const auto &e_psi = std::get<1>(GetParam());
+
+  for (double bits_per_step : {0.0, sri::PsiCoreHybrid<>::kBitsPerStep, 8.0}) {
+    sri::PsiCoreHybrid<> psi_core(alphabet_.C, e_psi, bits_per_step);
+    std::vector<bool> use_bit_vector(psi_core.sigma());
+    for (std::size_t c = 0; c < psi_core.sigma(); ++c) use_bit_vector[c] = psi_core.isBitVector(c);
+    sri::PsiCoreHybrid<> e_psi_core(alphabet_.C, e_psi, use_bit_vector);
+
+    std::stringstream out, e_out;
+    psi_core.serialize(out);
+    e_psi_core.serialize(e_out);
+    EXPECT_EQ(out.str(), e_out.str()) << "failed for " << bits_per_step << " bits per step";
+  }
+}
+
+TEST_P(PsiTests, psi_core_hybrid_serialized) {
+  const auto &e_psi = std::get<1>(GetParam());
+  auto key = "psi_core_hybrid";
+
+  auto psi_cores = hybridPsiCores(alphabet_.C, e_psi);
+  for (const auto &tmp_psi_core : psi_cores) {
+    sdsl::store_to_cache(tmp_psi_core, key, config_);
+
+    sri::PsiCoreHybrid<> psi_core;
+    sdsl::load_from_cache(psi_core, key, config_);
+
+    for (std::size_t c = 0; c < psi_core.sigma(); ++c) {
+      EXPECT_EQ(psi_core.isBitVector(c), tmp_psi_core.isBitVector(c));
+    }
+
+    auto psi_select = [&psi_core](auto tt_c, auto tt_rnk) { return psi_core.select(tt_c, tt_rnk); };
+    auto get_c = [this](auto tt_index) { return sri::computeCForSAIndex(this->alphabet_.C, tt_index); };
+    auto cumulative = sri::RandomAccessForCRefContainer(std::cref(alphabet_.C));
+
+    auto psi = sri::Psi(psi_select, get_c, cumulative);
+
+    for (int i = 0; i < e_psi.size(); ++i) {
+      EXPECT_EQ(psi(i), e_psi[i]) << "psi failed at index " << i;
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Psi,
     PsiTests,
@@ -303,6 +495,25 @@ TEST_P(RankPsiTests, psi_core_rle_rank_extra) {
   EXPECT_EQ(data_rank, e_data_rank);
 }
 
+TEST_P(RankPsiTests, psi_core_hybrid_bv_rank_extra) {
+  const auto &e_psi = std::get<1>(GetParam());
+  auto psi_core = sri::PsiCoreHybrid<>(alphabet_.C, e_psi, std::vector<bool>(alphabet_.C.size() - 1, true));
+
+  const auto &item = std::get<2>(GetParam());
+  const auto &c = std::get<0>(item);
+  const auto &value = std::get<1>(item);
+
+  DataRank data_rank;
+  auto report =
+      [&data_rank](const auto &tt_rank, const auto &tt_run_start, const auto &tt_run_end, const auto &tt_run_rank) {
+        data_rank = DataRank{tt_rank, {tt_run_start, tt_run_end, tt_run_rank}};
+      };
+  psi_core.rank(c, value, report);
+
+  const auto &e_data_rank = std::get<2>(item);
+  EXPECT_EQ(data_rank, e_data_rank);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Psi,
     RankPsiTests,
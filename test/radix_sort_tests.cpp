@@ -0,0 +1,76 @@
+//
+// Parallel radix sort tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <sdsl/int_vector.hpp>
+
+#include "sr-index/radix_sort.h"
+
+class RadixSortTests : public testing::TestWithParam<std::tuple<std::size_t, uint8_t, std::size_t>> {
+ protected:
+  //! Random keys of the given width
+  static sdsl::int_vector<> keys(std::size_t t_n, uint8_t t_width) {
+    std::mt19937_64 gen(t_n + t_width);
+    sdsl::int_vector<> keys(t_n, 0, t_width);
+    for (auto it = keys.begin(); it != keys.end(); ++it) *it = gen() & sdsl::bits::lo_set[t_width];
+    return keys;
+  }
+
+  //! Expected indices: stable sort by key
+  static std::vector<uint64_t> expected(const sdsl::int_vector<> &t_keys) {
+    std::vector<uint64_t> indices(t_keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(),
+                     [&t_keys](auto tt_a, auto tt_b) { return t_keys[tt_a] < t_keys[tt_b]; });
+    return indices;
+  }
+};
+
+TEST_P(RadixSortTests, SortIndices) {
+  auto [n, width, n_threads] = GetParam();
+  auto values = keys(n, width);
+
+  auto values_idx = sri::radixSortIndices(values, n_threads);
+
+  EXPECT_EQ(values_idx.size(), n);
+  EXPECT_EQ(values_idx.width(), sdsl::bits::hi(n) + 1);
+  auto expected_idx = expected(values);
+  EXPECT_TRUE(std::equal(values_idx.begin(), values_idx.end(), expected_idx.begin(), expected_idx.end()));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    RadixSort,
+    RadixSortTests,
+    testing::Combine(
+        testing::Values(0, 1, 1000, 1 << 19), // Number of keys
+        testing::Values(4, 20, 64), // Key width: many ties, packed pairs, and key-index pairs
+        testing::Values(1, 4) // Threads
+    )
+);
+
+TEST(RadixSortTests, ConstructionThreads) {
+  sri::setConstructionThreads(0);
+  EXPECT_EQ(sri::constructionThreads(), 1);
+
+  sri::setConstructionThreads(3);
+  EXPECT_EQ(sri::constructionThreads(), 3);
+  sri::setConstructionThreads(1);
+}
+
+TEST(RadixSortTests, BlockBoundaries) {
+  // Blocks aligned to words of the output cover the range without overlapping
+  const std::size_t n = 1000;
+  std::vector<std::size_t> covered(n, 0);
+  sri::parallelForBlocks(n, 7, [&covered](auto, auto tt_first, auto tt_last) {
+    EXPECT_TRUE(tt_first % 64 == 0 || tt_first == n);
+    for (auto i = tt_first; i < tt_last; ++i) ++covered[i];
+  }, 64);
+  EXPECT_TRUE(std::all_of(covered.begin(), covered.end(), [](auto tt_c) { return tt_c == 1; }));
+}
@@ -0,0 +1,118 @@
+//
+// Derivation of subsampled r-indexes from stored indexes tests.
+//
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+
+#include <sdsl/io.hpp>
+
+#include "sr-index/r_index.h"
+#include "sr-index/sr_index.h"
+#include "sr-index/resample.h"
+
+#include "base_tests.h"
+
+namespace fs = std::filesystem;
+
+class ResampleTests : public BaseConfigTests {
+ protected:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+    fs::create_directories(dir_);
+  }
+
+  void TearDown() override {
+    BaseConfigTests::TearDown();
+    fs::remove_all(dir_);
+  }
+
+  //! Build the index from the text and store it
+  template<typename TIndex>
+  std::string store(TIndex t_index, const std::string &t_name) {
+    sri::construct(t_index, config_.data_path, config_);
+    auto file = (dir_ / t_name).string();
+    sdsl::store_to_file(t_index, file);
+    return file;
+  }
+
+  //! Derive the index from the stored one, with its own folder of intermediate items
+  template<typename TSource, typename TIndex>
+  void resample(TIndex &t_index, const std::string &t_source_file) {
+    fs::create_directories(dir_ / "resample");
+    sri::Config config(t_source_file, dir_ / "resample", sri::SDSL_LIBDIVSUFSORT);
+    sri::resample<TSource>(t_index, t_source_file, config);
+    sdsl::util::delete_all_files(config.file_map);
+  }
+
+  template<typename TIndex>
+  void checkLocate(const TIndex &t_index) {
+    for (const std::string &pattern : {"a", "ab", "abc", "cab", "bbac", "cabcbb", "x"}) {
+      std::vector<std::size_t> expected;
+      for (auto pos = text_.find(pattern); pos != std::string::npos; pos = text_.find(pattern, pos + 1)) {
+        expected.push_back(pos);
+      }
+      auto occs = t_index.Locate(pattern);
+      std::sort(occs.begin(), occs.end());
+      EXPECT_THAT(occs, testing::ElementsAreArray(expected)) << pattern;
+    }
+  }
+
+  template<typename TIndex>
+  static std::string serialize(const TIndex &t_index) {
+    std::stringstream out;
+    t_index.serialize(out);
+    return out.str();
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+  fs::path dir_ = fs::temp_directory_path() / "sri_resample_tests";
+};
+
+TEST_F(ResampleTests, FromRIndexIsTheConstructedIndex) {
+  auto r_index_file = store(sri::RIndex<>(), "r_index");
+
+  sri::SrIndex<> sri(4);
+  resample<sri::RIndex<>>(sri, r_index_file);
+  checkLocate(sri);
+
+  sri::SrIndexValidArea<> sri_va(4);
+  resample<sri::RIndex<>>(sri_va, r_index_file);
+  checkLocate(sri_va);
+
+  sri::SrIndexValidArea<> constructed(4);
+  sri::construct(constructed, config_.data_path, config_);
+  EXPECT_EQ(serialize(sri_va), serialize(constructed));
+}
+
+TEST_F(ResampleTests, FromSubsampledIndex) {
+  auto source_file = store(sri::SrIndexValidArea<>(2), "sri_va");
+
+  sri::SrIndex<> sri(8);
+  resample<sri::SrIndexValidArea<>>(sri, source_file);
+  checkLocate(sri);
+
+  sri::SrIndexValidMark<> sri_vm(5);
+  resample<sri::SrIndexValidArea<>>(sri_vm, source_file);
+  checkLocate(sri_vm);
+
+  sri::SrIndexValidArea<> sri_va(4);
+  resample<sri::SrIndexValidArea<>>(sri_va, source_file);
+  checkLocate(sri_va);
+}
+
+TEST_F(ResampleTests, Errors) {
+  auto source_file = store(sri::SrIndex<>(4), "sri");
+
+  // The validity of the marks needs the marks of the r-index
+  sri::SrIndexValidArea<> sri_va(8);
+  EXPECT_THROW(resample<sri::SrIndex<>>(sri_va, source_file), std::invalid_argument);
+
+  // The subsampling parameter must grow
+  sri::SrIndex<> sri(4);
+  EXPECT_THROW(resample<sri::SrIndex<>>(sri, source_file), std::invalid_argument);
+}
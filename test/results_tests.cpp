@@ -0,0 +1,127 @@
+//
+// Query results writer tests.
+//
+
+#include <filesystem>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "sr-index/results.h"
+
+class ResultsTests : public testing::TestWithParam<sri::ResultFormat> {
+ public:
+  void TearDown() override {
+    std::filesystem::remove(file_);
+  }
+
+  std::string file_ = (std::filesystem::temp_directory_path() / "sri_results_tests.out").string();
+};
+
+TEST_P(ResultsTests, ranges) {
+  {
+    sri::AsyncResultWriter writer(file_, GetParam(), sri::ResultKind::RANGES);
+    sri::AsyncResultWriter::Buffer buffer(writer);
+    buffer.addRange(0, 10, 20);
+    buffer.addRange(1, 5, 5);
+    buffer.addRange(2, 0, 1ul << 40);
+  }
+
+  auto results = sri::readResults(file_);
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_EQ(results[0].pattern, 0);
+  EXPECT_EQ(results[0].start, 10);
+  EXPECT_EQ(results[0].end, 20);
+  EXPECT_EQ(results[1].start, results[1].end);
+  EXPECT_EQ(results[2].end, 1ul << 40);
+}
+
+TEST_P(ResultsTests, occurrencesConcurrent) {
+  const std::size_t n_patterns = 10000;
+  const std::size_t n_threads = 4;
+  {
+    // Small buffers, so the writer thread gets many of them
+    sri::AsyncResultWriter writer(file_, GetParam(), sri::ResultKind::OCCURRENCES, 256);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < n_threads; ++t) {
+      threads.emplace_back([&writer, t, n_patterns, n_threads]() {
+        sri::AsyncResultWriter::Buffer buffer(writer);
+        for (std::size_t i = t; i < n_patterns; i += n_threads) {
+          buffer.addOccurrences(i, {i * 7, i, i + 1000000});
+        }
+      });
+    }
+    for (auto &thread : threads) thread.join();
+  }
+
+  auto results = sri::readResults(file_);
+  ASSERT_EQ(results.size(), n_patterns);
+  std::sort(results.begin(), results.end(), [](const auto &tt_a, const auto &tt_b) { return tt_a.pattern < tt_b.pattern; });
+  for (std::size_t i = 0; i < n_patterns; ++i) {
+    auto occs = results[i].occs;
+    std::sort(occs.begin(), occs.end());
+    std::vector<std::size_t> expected = {i, i * 7, i + 1000000};
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(results[i].pattern, i);
+    EXPECT_EQ(occs, expected);
+  }
+}
+
+TEST_P(ResultsTests, boundedQueue) {
+  const std::size_t n_patterns = 10000;
+  const std::size_t n_threads = 4;
+  {
+    // A single pending buffer, so the query threads wait for the writer thread
+    sri::AsyncResultWriter writer(file_, GetParam(), sri::ResultKind::RANGES, 64, 1);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < n_threads; ++t) {
+      threads.emplace_back([&writer, t, n_patterns, n_threads]() {
+        sri::AsyncResultWriter::Buffer buffer(writer);
+        for (std::size_t i = t; i < n_patterns; i += n_threads) {
+          buffer.addRange(i, i, 2 * i);
+        }
+      });
+    }
+    for (auto &thread : threads) thread.join();
+  }
+
+  auto results = sri::readResults(file_);
+  ASSERT_EQ(results.size(), n_patterns);
+  std::sort(results.begin(), results.end(), [](const auto &tt_a, const auto &tt_b) { return tt_a.pattern < tt_b.pattern; });
+  for (std::size_t i = 0; i < n_patterns; ++i) {
+    EXPECT_EQ(results[i].pattern, i);
+    EXPECT_EQ(results[i].end, 2 * i);
+  }
+}
+
+TEST_P(ResultsTests, noOccurrences) {
+  {
+    sri::AsyncResultWriter writer(file_, GetParam(), sri::ResultKind::OCCURRENCES);
+    sri::AsyncResultWriter::Buffer buffer(writer);
+    buffer.addOccurrences(0, {});
+    buffer.addOccurrences(1, {3});
+  }
+
+  auto results = sri::readResults(file_);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_TRUE(results[0].occs.empty());
+  EXPECT_EQ(results[1].occs, std::vector<std::size_t>({3}));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Formats,
+    ResultsTests,
+    testing::Values(sri::ResultFormat::TSV, sri::ResultFormat::BINARY, sri::ResultFormat::VARINT_DELTA)
+);
+
+TEST(ResultsVarintTests, compressesGaps) {
+  std::string varint, binary;
+  std::vector<std::size_t> occs(1000);
+  for (std::size_t i = 0; i < occs.size(); ++i) occs[i] = 1000000000 + i * 10;
+  sri::encodeOccurrences(sri::ResultFormat::VARINT_DELTA, varint, 0, occs);
+  sri::encodeOccurrences(sri::ResultFormat::BINARY, binary, 0, occs);
+
+  // One byte per gap, besides the first occurrence
+  EXPECT_LT(varint.size(), occs.size() + 16);
+  EXPECT_GT(binary.size(), 8 * occs.size());
+}
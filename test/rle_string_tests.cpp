@@ -2,6 +2,8 @@
 // Created by Dustin Cobas <dustin.cobas@gmail.com> on 8/26/20.
 //
 
+#include <algorithm>
+#include <sstream>
 #include <type_traits>
 
 #include <gtest/gtest.h>
@@ -54,6 +56,25 @@ TEST_P(AccessTests, RLEString_int) {
   }
 }
 
+TEST_P(AccessTests, RLEString_runs) {
+  const auto &str = std::get<0>(GetParam());
+  // Runs of length one, so consecutive runs may have the same symbol
+  sdsl::int_vector<> heads(str.size(), 0, 8);
+  std::copy(str.begin(), str.end(), heads.begin());
+  sdsl::int_vector<> lengths(str.size(), 1, 8);
+  sri::RLEString<> rle_str(heads, lengths);
+
+  EXPECT_EQ(rle_str.size(), str.size());
+  for (int i = 0; i < str.size(); ++i) {
+    EXPECT_EQ(rle_str[i], str[i]) << "Failed at " << i;
+  }
+
+  std::stringstream expected, out;
+  sri::RLEString<>(str.begin(), str.end()).serialize(expected);
+  rle_str.serialize(out);
+  EXPECT_EQ(out.str(), expected.str());
+}
+
 TEST_P(AccessTests, RLEString_io) {
   const auto &str = std::get<0>(GetParam());
   sdsl::cache_config config;
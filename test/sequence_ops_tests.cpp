@@ -3,12 +3,14 @@
 //
 
 #include <algorithm>
+#include <random>
 
 #include <gtest/gtest.h>
 
 #include <sdsl/bit_vectors.hpp>
 
 #include "sr-index/sequence_ops.h"
+#include "sr-index/elias_fano_vector.h"
 
 using BitVector = std::vector<bool>;
 using Value = std::size_t;
@@ -35,6 +37,26 @@ TEST_P(CircularPredecessor_Tests, compute) {
   EXPECT_EQ(e_p, p);
 }
 
+TEST_P(CircularPredecessor_Tests, fused_elias_fano) {
+  const auto &raw_bv = std::get<0>(GetParam());
+
+  auto bv = sdsl::bit_vector(raw_bv.size());
+  copy(raw_bv.begin(), raw_bv.end(), bv.begin());
+
+  sri::EliasFanoVector<> ef(bv);
+  auto rank = sri::EliasFanoVector<>::rank_1_type(&ef);
+  auto select = sri::EliasFanoVector<>::select_1_type(&ef);
+
+  auto predecessor = sri::buildCircularPredecessor(std::ref(rank), std::ref(select), bv.size());
+  static_assert(sri::HasFusedPredecessor<sri::EliasFanoVector<>::rank_1_type>::value);
+
+  const auto &value = std::get<1>(GetParam());
+  auto p = predecessor(value);
+
+  const auto &e_p = std::get<2>(GetParam());
+  EXPECT_EQ(e_p, p);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Predecessor,
     CircularPredecessor_Tests,
@@ -77,6 +99,25 @@ TEST_P(CircularSoftSuccessor_Tests, compute) {
   EXPECT_EQ(e_s, s);
 }
 
+TEST_P(CircularSoftSuccessor_Tests, fused_elias_fano) {
+  const auto &raw_bv = std::get<0>(GetParam());
+
+  auto bv = sdsl::bit_vector(raw_bv.size());
+  copy(raw_bv.begin(), raw_bv.end(), bv.begin());
+
+  sri::EliasFanoVector<> ef(bv);
+  auto rank = sri::EliasFanoVector<>::rank_1_type(&ef);
+  auto select = sri::EliasFanoVector<>::select_1_type(&ef);
+
+  auto successor = sri::buildCircularSoftSuccessor(std::ref(rank), std::ref(select), bv.size());
+
+  const auto &value = std::get<1>(GetParam());
+  auto s = successor(value);
+
+  const auto &e_s = std::get<2>(GetParam());
+  EXPECT_EQ(e_s, s);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Successor,
     CircularSoftSuccessor_Tests,
@@ -96,3 +137,46 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(BitVector{0, 0, 1, 0, 0, 0, 1, 1, 0, 1, 1, 0}, 11, Predecessor{0, 2})
     )
 );
+
+class EliasFanoVector_Tests : public testing::TestWithParam<std::tuple<std::size_t, double>> {};
+
+//! The Elias-Fano vector and its fused predecessor and soft successor agree with rank and select on a bit_vector
+TEST_P(EliasFanoVector_Tests, compare_with_bit_vector) {
+  const auto &[n, density] = GetParam();
+
+  std::mt19937_64 gen(n);
+  std::bernoulli_distribution dist(density);
+  sdsl::bit_vector bv(n, 0);
+  for (std::size_t i = 0; i < n; ++i) bv[i] = dist(gen);
+  bv[n / 2] = 1;
+
+  auto rank = sdsl::bit_vector::rank_1_type(&bv);
+  auto select = sdsl::bit_vector::select_1_type(&bv);
+  auto predecessor = sri::CircularPredecessor(std::cref(rank), std::cref(select), n);
+  auto successor = sri::CircularSoftSuccessor(std::cref(rank), std::cref(select), n);
+
+  sri::EliasFanoVector<8> ef(bv);
+  auto ef_rank = sri::EliasFanoVector<8>::rank_1_type(&ef);
+  auto ef_select = sri::EliasFanoVector<8>::select_1_type(&ef);
+  auto ef_predecessor = sri::buildCircularPredecessor(std::cref(ef_rank), std::cref(ef_select), n);
+  auto ef_successor = sri::buildCircularSoftSuccessor(std::cref(ef_rank), std::cref(ef_select), n);
+
+  EXPECT_EQ(ef.size(), n);
+  for (std::size_t k = 1; k <= rank(n); ++k) {
+    EXPECT_EQ(ef_select(k), select(k)) << "k = " << k;
+  }
+  for (std::size_t i = 0; i <= n; ++i) {
+    EXPECT_EQ(ef_rank(i), rank(i)) << "i = " << i;
+    EXPECT_EQ(ef_predecessor(i), predecessor(i)) << "i = " << i;
+    EXPECT_EQ(ef_successor(i), successor(i)) << "i = " << i;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    EliasFanoVector,
+    EliasFanoVector_Tests,
+    testing::Combine(
+        testing::Values(1, 63, 64, 1000, 10000),
+        testing::Values(0.001, 0.05, 0.5, 1.0)
+    )
+);
@@ -0,0 +1,115 @@
+//
+// Sharded index tests.
+//
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sdsl/io.hpp>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/shards.h"
+
+namespace fs = std::filesystem;
+
+class ShardsTests : public testing::Test {
+ protected:
+  void SetUp() override {
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+
+    for (std::size_t i = 0; i < docs_.size(); ++i) {
+      auto file = (dir_ / ("doc" + std::to_string(i))).string();
+      std::ofstream(file, std::ios::binary) << docs_[i];
+      files_.emplace_back(file);
+      collection_ += docs_[i] + '\1';
+    }
+  }
+
+  void TearDown() override {
+    fs::remove_all(dir_);
+  }
+
+  //! Build the sharded index of the documents, with an SrIndex per shard
+  std::string build(std::size_t t_n_shards, std::size_t t_n_jobs) {
+    return sri::constructShards(
+        files_, t_n_shards, 1, dir_ / "tmp", (dir_ / "collection.sri").string(), t_n_jobs,
+        [](const std::string &tt_text_file, const fs::path &tt_dir, const std::string &tt_output_file) {
+          sri::SrIndex<> index(4);
+          sri::Config config(tt_text_file, tt_dir, sri::SDSL_LIBDIVSUFSORT);
+          sri::construct(index, tt_text_file, config);
+          sdsl::store_to_file(index, tt_output_file);
+          sdsl::util::delete_all_files(config.file_map);
+        });
+  }
+
+  std::vector<std::size_t> occurrences(const std::string &t_pattern) const {
+    std::vector<std::size_t> occs;
+    for (auto pos = collection_.find(t_pattern); pos != std::string::npos; pos = collection_.find(t_pattern, pos + 1)) {
+      occs.push_back(pos);
+    }
+    return occs;
+  }
+
+  fs::path dir_ = fs::temp_directory_path() / "sri_shards_tests";
+  std::vector<std::string> docs_ = {"abcabcababcabbcaabcacbbacbcabcbbaccab", "abc", "cabcabbacbb", "bbacbcabcbbaccab",
+                                    "ab", "abcabcababcabbcaabcacbbacbcabcbbaccabcab"};
+  std::vector<std::string> files_;
+  std::string collection_;
+};
+
+TEST_F(ShardsTests, SplitDocuments) {
+  EXPECT_THAT(sri::splitDocuments(files_, 1), testing::ElementsAre(6));
+  EXPECT_THAT(sri::splitDocuments(files_, 3), testing::ElementsAre(1, 4, 1));
+  // At most a shard per document
+  EXPECT_THAT(sri::splitDocuments(files_, 10), testing::ElementsAre(1, 1, 1, 1, 1, 1));
+}
+
+TEST_F(ShardsTests, ManifestMapsToGlobalPositions) {
+  auto manifest = sri::ShardManifest::load(build(3, 2));
+  ASSERT_EQ(manifest.shards.size(), 3);
+  EXPECT_EQ(manifest.size, collection_.size());
+  EXPECT_EQ(manifest.shards[1].offset, docs_[0].size() + 1);
+  EXPECT_EQ(manifest.shards[2].first_doc, 5);
+  EXPECT_EQ(manifest.toGlobal(2, 0), collection_.size() - docs_[5].size() - 1);
+}
+
+TEST_F(ShardsTests, QueriesAreTheOnesOfTheCollection) {
+  for (std::size_t n_threads : {1, 3}) {
+    sri::ShardedIndex<sri::SrIndex<>> index(build(3, n_threads), n_threads);
+    EXPECT_EQ(index.sizeSequence(), collection_.size() + 1);
+    EXPECT_EQ(index.SubsampleRate(), 4);
+
+    for (const std::string &pattern : {"a", "ab", "abc", "cab", "bbac", "cabcbb", "x"}) {
+      auto expected = occurrences(pattern);
+      EXPECT_EQ(index.Count(pattern), expected.size()) << pattern;
+      // The occurrences are grouped by shard, in text order
+      auto occs = index.Locate(pattern);
+      for (std::size_t i = 0, j = 0; i < index.numShards(); ++i) {
+        auto end = j;
+        while (end < occs.size() && occs[end] < index.manifest().toGlobal(i, index.manifest().shards[i].size)) ++end;
+        std::sort(occs.begin() + j, occs.begin() + end);
+        j = end;
+      }
+      EXPECT_THAT(occs, testing::ElementsAreArray(expected)) << pattern;
+    }
+  }
+}
+
+TEST_F(ShardsTests, ThreadPool) {
+  sri::ThreadPool pool(4);
+  std::atomic<std::size_t> sum{0};
+  pool.forEach(100, [&sum](std::size_t tt_i) { sum += tt_i; });
+  EXPECT_EQ(sum, 4950);
+
+  EXPECT_THROW(pool.forEach(10, [](std::size_t tt_i) {
+    if (tt_i == 7) throw std::runtime_error("Error");
+  }), std::runtime_error);
+}
@@ -0,0 +1,135 @@
+//
+// Suffix-range cache tests.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/suffix_cache.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+TEST(SuffixRangeCacheTests, insertFind) {
+  sri::SuffixRangeCache cache(1 << 16, 4);
+
+  String pattern = "abcdefghijklmnop";
+  cache.insert(pattern, 8, {3, 7, true, {2, 1, 5, 9}});
+
+  auto entry = cache.find(pattern, 8);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->start, 3);
+  EXPECT_EQ(entry->end, 7);
+  EXPECT_EQ(entry->toehold.run_rank, 5);
+
+  EXPECT_FALSE(cache.find(pattern, 4));
+
+  // Any pattern with the same suffix finds it
+  auto found = cache.findLongest(String("xyz") + pattern.substr(8), 0, true);
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found->first, 8);
+  EXPECT_EQ(cache.hits(), 1);
+}
+
+TEST(SuffixRangeCacheTests, verifiedHits) {
+  // A single slot, so every suffix maps to it and only the stored symbols tell them apart
+  sri::SuffixRangeCache cache(128, 4, 16);
+  ASSERT_TRUE(cache.enabled());
+
+  cache.insert(String("abcdefgh"), 8, {3, 7, false, {}});
+  EXPECT_TRUE(cache.find(String("abcdefgh"), 8));
+  EXPECT_FALSE(cache.find(String("abcdefgx"), 8));
+  EXPECT_FALSE(cache.find(String("xbcdefgh"), 8));
+
+  // Suffixes longer than the maximum length are not cached
+  String pattern(32, 'a');
+  cache.insert(pattern, 32, {1, 2, false, {}});
+  EXPECT_FALSE(cache.find(pattern, 32));
+  EXPECT_TRUE(cache.find(String("abcdefgh"), 8));
+}
+
+TEST(SuffixRangeCacheTests, disabled) {
+  sri::SuffixRangeCache cache;
+
+  EXPECT_FALSE(cache.enabled());
+  EXPECT_FALSE(cache.findLongest(String("abcdefghijklmnop"), 0, false));
+}
+
+template<typename TIndex>
+class SuffixCacheTypedTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+
+    // Patterns sharing long suffixes
+    for (std::size_t len = 9; len <= 20; ++len) {
+      for (std::size_t i = 0; i + len <= text_.size(); ++i) {
+        patterns_.emplace_back(text_.substr(i, len));
+      }
+    }
+    patterns_.insert(patterns_.end(), {"xabcabcababcabbca", "abcabcababcabbcx"});
+  }
+
+  void buildIndex(TIndex &t_index) {
+    sri::construct(t_index, config_.file_map[key_tmp_input_], config_);
+  }
+
+  void checkQueries(const TIndex &t_index) {
+    for (const auto &pattern : patterns_) {
+      std::vector<std::size_t> expected;
+      for (auto pos = text_.find(pattern); pos != String::npos; pos = text_.find(pattern, pos + 1)) {
+        expected.emplace_back(pos);
+      }
+
+      auto [start, end] = t_index.Count(pattern);
+      EXPECT_EQ(start < end ? end - start : 0, expected.size()) << pattern;
+
+      auto occs = t_index.Locate(pattern);
+      std::sort(occs.begin(), occs.end());
+      EXPECT_EQ(occs, expected) << pattern;
+    }
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaab";
+  std::vector<String> patterns_;
+};
+
+using SuffixCacheIndexes = ::testing::Types<sri::SrIndex<>, sri::SrIndexValidMark<>, sri::SrIndexValidArea<>>;
+TYPED_TEST_SUITE(SuffixCacheTypedTests, SuffixCacheIndexes);
+
+TYPED_TEST(SuffixCacheTypedTests, queries) {
+  TypeParam index(4);
+  this->buildIndex(index);
+  index.SuffixCache().reset(1 << 16, 4);
+
+  // The second round resumes from the suffixes cached in the first one
+  this->checkQueries(index);
+  this->checkQueries(index);
+
+  EXPECT_GT(index.SuffixCache().hits(), 0);
+  EXPECT_GT(index.SuffixCache().inserts(), 0);
+}
+
+TYPED_TEST(SuffixCacheTypedTests, smallCache) {
+  TypeParam index(4);
+  this->buildIndex(index);
+  // A few slots, so the entries are continuously replaced
+  index.SuffixCache().reset(512, 4);
+
+  this->checkQueries(index);
+  this->checkQueries(index);
+}
+
+TYPED_TEST(SuffixCacheTypedTests, concurrent) {
+  TypeParam index(4);
+  this->buildIndex(index);
+  index.SuffixCache().reset(1 << 12, 4);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([this, &index]() { this->checkQueries(index); });
+  }
+  for (auto &thread : threads) thread.join();
+}
@@ -0,0 +1,92 @@
+//
+// Streaming text input tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "sr-index/text_input.h"
+
+namespace fs = std::filesystem;
+
+class TextInputTests : public testing::Test {
+ protected:
+  void SetUp() override {
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+  }
+
+  void TearDown() override {
+    fs::remove_all(dir_);
+  }
+
+  std::string write(const std::string &t_name, const std::string &t_content) {
+    auto file = (dir_ / t_name).string();
+    std::ofstream(file, std::ios::binary) << t_content;
+    return file;
+  }
+
+  //! Read the whole input in small blocks
+  static std::pair<std::string, sri::TextStats> read(const std::string &t_file) {
+    std::string text;
+    auto stats = sri::streamText(t_file, [&text](const char *tt_data, std::size_t tt_size) {
+      text.append(tt_data, tt_size);
+    }, 7);
+    return {text, stats};
+  }
+
+  fs::path dir_ = fs::temp_directory_path() / "sri_text_input_tests";
+};
+
+TEST_F(TextInputTests, Plain) {
+  auto [text, stats] = read(write("text", "abracadabra"));
+
+  EXPECT_EQ(text, "abracadabra");
+  EXPECT_EQ(stats.size, 11);
+  EXPECT_EQ(stats.histogram['a'], 5);
+  EXPECT_EQ(stats.histogram['b'], 2);
+  EXPECT_EQ(stats.histogram[0], 0);
+  EXPECT_EQ(stats.sigma(), 5);
+}
+
+TEST_F(TextInputTests, ZeroSymbol) {
+  // Allowed as the last symbol only
+  auto [text, stats] = read(write("text", std::string("abracadabra") + '\0'));
+  EXPECT_EQ(text.size(), 12);
+  EXPECT_EQ(stats.histogram[0], 1);
+
+  EXPECT_THROW(read(write("inner", std::string("abra") + '\0' + "cadabra")), std::logic_error);
+  EXPECT_THROW(read(write("inner_block", std::string("abracad") + '\0' + "abra")), std::logic_error);
+}
+
+TEST_F(TextInputTests, Gzip) {
+  const std::string content(10000, 'a');
+  auto file = write("text", content + "bcd");
+  if (std::system(("gzip -f " + file).c_str()) != 0) GTEST_SKIP() << "gzip is not available";
+
+  auto [text, stats] = read(file + ".gz");
+  EXPECT_EQ(text, content + "bcd");
+  EXPECT_EQ(stats.sigma(), 4);
+}
+
+TEST_F(TextInputTests, SizeHint) {
+  const std::string content(10000, 'a');
+  auto file = write("text", content);
+  EXPECT_EQ(sri::InputStream::sizeHint(file), content.size());
+  EXPECT_EQ(sri::InputStream::sizeHint(sri::InputStream::kStdin), 0);
+  EXPECT_EQ(sri::InputStream::sizeHint((dir_ / "missing").string()), 0);
+
+  // The decompressed size
+  if (std::system(("gzip -kf " + file).c_str()) == 0) EXPECT_EQ(sri::InputStream::sizeHint(file + ".gz"), content.size());
+  if (std::system(("zstd -qf " + file + " -o " + file + ".zst").c_str()) == 0) {
+    EXPECT_EQ(sri::InputStream::sizeHint(file + ".zst"), content.size());
+  }
+}
+
+TEST_F(TextInputTests, MissingFile) {
+  EXPECT_THROW(read((dir_ / "missing").string()), std::invalid_argument);
+}
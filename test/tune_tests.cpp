@@ -0,0 +1,85 @@
+//
+// Subsampling parameter tuning tests.
+//
+
+#include <gtest/gtest.h>
+
+#include "sr-index/sr_index.h"
+#include "sr-index/tune.h"
+#include "sr-index/config.h"
+
+#include "base_tests.h"
+
+class TuneTests : public testing::Test {
+ protected:
+  // s, size, count ns, locate ns
+  std::vector<sri::TuningPoint> points_ = {{4, 1000, 1, 10}, {8, 600, 1, 20}, {16, 400, 1, 50}, {32, 400, 1, 60},
+                                           {64, 300, 1, 40}, {128, 200, 1, 100}};
+};
+
+TEST_F(TuneTests, paretoFrontier) {
+  auto frontier = sri::paretoFrontier(points_);
+
+  std::vector<std::size_t> rates;
+  for (const auto &point : frontier) rates.emplace_back(point.s);
+  EXPECT_EQ(rates, std::vector<std::size_t>({128, 64, 8, 4}));
+}
+
+TEST_F(TuneTests, chooseUnderBudget) {
+  EXPECT_EQ(sri::chooseSubsampleRate(points_, 500, 0)->s, 64);
+  EXPECT_EQ(sri::chooseSubsampleRate(points_, 2000, 0)->s, 4);
+  EXPECT_FALSE(sri::chooseSubsampleRate(points_, 100, 0));
+}
+
+TEST_F(TuneTests, chooseUnderLatency) {
+  EXPECT_EQ(sri::chooseSubsampleRate(points_, 0, 45)->s, 64);
+  EXPECT_EQ(sri::chooseSubsampleRate(points_, 0, 25)->s, 8);
+  EXPECT_FALSE(sri::chooseSubsampleRate(points_, 0, 5));
+}
+
+TEST_F(TuneTests, chooseUnderBoth) {
+  EXPECT_EQ(sri::chooseSubsampleRate(points_, 700, 25)->s, 8);
+  EXPECT_FALSE(sri::chooseSubsampleRate(points_, 500, 25));
+  EXPECT_FALSE(sri::chooseSubsampleRate(points_, 0, 0));
+}
+
+template<typename TIndex>
+class TuneTypedTests : public BaseConfigTests {
+ public:
+  void SetUp() override {
+    Init(text_, sri::SDSL_LIBDIVSUFSORT);
+  }
+
+  String text_ = "abcabcababcabbcaabcacbbacbcabcbbaccababcabcababcabbcaabcacbbacbcabcbbaccab";
+};
+
+using TuneIndexes = ::testing::Types<sri::SrIndex<>, sri::SrIndexValidMark<>, sri::SrIndexValidArea<>>;
+TYPED_TEST_SUITE(TuneTypedTests, TuneIndexes);
+
+TYPED_TEST(TuneTypedTests, grid) {
+  std::vector<std::string> patterns = {"ab", "abc", "cab", "bbac", "ccaba", "x"}; // "ccaba" occurs once
+  std::vector<std::size_t> grid = {1, 2, 4, 8};
+  auto points = sri::tuneSubsampleRate<TypeParam>(this->config_.data_path, this->config_, grid, patterns);
+
+  ASSERT_EQ(points.size(), grid.size());
+  for (std::size_t i = 0; i < grid.size(); ++i) {
+    EXPECT_EQ(points[i].s, grid[i]);
+    EXPECT_GT(points[i].size_in_bytes, 0);
+
+    // The measured index is the same as the one built on its own
+    TypeParam index(grid[i]);
+    sri::construct(index, this->config_.data_path, this->config_);
+    EXPECT_EQ(sri::measureIndex(index, {}).size_in_bytes, points[i].size_in_bytes);
+    EXPECT_EQ(points[i].n, index.sizeSequence());
+
+    // Count and locate agree on the occurrences, including the single-occurrence ranges
+    std::size_t n_occs = 0;
+    for (const auto &pattern : patterns) {
+      for (auto pos = this->text_.find(pattern); pos != String::npos; pos = this->text_.find(pattern, pos + 1)) ++n_occs;
+    }
+    EXPECT_EQ(points[i].count_occs, n_occs);
+    EXPECT_EQ(points[i].locate_occs, n_occs);
+  }
+
+  EXPECT_FALSE(sri::paretoFrontier(points).empty());
+}
@@ -0,0 +1,117 @@
+//
+// Work directory and stage manifest tests.
+//
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "sr-index/config.h"
+#include "sr-index/io.h"
+#include "sr-index/work_dir.h"
+
+namespace fs = std::filesystem;
+
+class WorkDirTests : public testing::Test {
+ protected:
+  void SetUp() override {
+    fs::remove_all(root_);
+    fs::create_directories(root_);
+    std::ofstream(data_) << "abracadabra";
+    config_ = sri::Config(data_, work_, sri::SDSL_LIBDIVSUFSORT);
+    sri::openWorkDir(config_);
+  }
+
+  void TearDown() override {
+    sri::closeWorkDir(work_);
+    fs::remove_all(root_);
+  }
+
+  //! Reopen the work directory, so the manifest is reloaded from disk
+  void reopen() {
+    sri::closeWorkDir(work_);
+    sri::openWorkDir(config_);
+  }
+
+  static void write(const std::string &t_file, const std::string &t_content) {
+    std::ofstream(t_file) << t_content;
+  }
+
+  fs::path root_ = fs::temp_directory_path() / "sri_work_dir_tests";
+  std::string data_ = (root_ / "data.txt").string();
+  std::string work_ = (root_ / "work").string();
+  std::string file_ = (root_ / "work" / "stage.sdsl").string();
+  sri::Config config_;
+};
+
+TEST_F(WorkDirTests, UnrecordedFileIsIncomplete) {
+  write(file_, "0123456789");
+  EXPECT_FALSE(sri::isCachedFileComplete(file_));
+
+  sri::recordCachedFile(file_, "stage");
+  EXPECT_TRUE(sri::isCachedFileComplete(file_));
+}
+
+TEST_F(WorkDirTests, ManifestPersists) {
+  write(file_, "0123456789");
+  sri::recordCachedFile(file_, "stage");
+
+  reopen();
+  EXPECT_TRUE(sri::isCachedFileComplete(file_));
+  EXPECT_TRUE(fs::exists(fs::path(work_) / sri::StageManifest::kFileName));
+}
+
+TEST_F(WorkDirTests, ChangedContentIsIncomplete) {
+  write(file_, "0123456789");
+  sri::recordCachedFile(file_, "stage");
+
+  // Same size, different content
+  write(file_, "0123456780");
+  reopen();
+  EXPECT_FALSE(sri::isCachedFileComplete(file_));
+
+  // Truncated
+  write(file_, "01234");
+  EXPECT_FALSE(sri::isCachedFileComplete(file_));
+}
+
+TEST_F(WorkDirTests, ChangedParamsInvalidate) {
+  write(file_, "0123456789");
+  sri::recordCachedFile(file_, "stage");
+
+  sri::closeWorkDir(work_);
+  config_.kmer_k = config_.kmer_k + 1;
+  sri::openWorkDir(config_);
+  EXPECT_FALSE(sri::isCachedFileComplete(file_));
+}
+
+TEST_F(WorkDirTests, ChangedInputInvalidates) {
+  write(file_, "0123456789");
+  sri::recordCachedFile(file_, "stage");
+
+  sri::closeWorkDir(work_);
+  write(data_, "abracadabra abracadabra");
+  sri::openWorkDir(config_);
+  EXPECT_FALSE(sri::isCachedFileComplete(file_));
+}
+
+TEST_F(WorkDirTests, StandardInputIsRejected) {
+  // Its changes cannot be detected, so its cached text could be stale
+  sri::Config config("-", work_, sri::SDSL_LIBDIVSUFSORT);
+  EXPECT_THROW(sri::openWorkDir(config), std::invalid_argument);
+  config = sri::Config(root_, work_, sri::SDSL_LIBDIVSUFSORT);
+  EXPECT_THROW(sri::openWorkDir(config), std::invalid_argument);
+}
+
+TEST_F(WorkDirTests, StoreToCache) {
+  std::vector<std::size_t> values = {3, 1, 4, 1, 5};
+  EXPECT_FALSE(sri::cacheFileExists("values", config_));
+
+  sri::storeToCache(values, "values", config_);
+  EXPECT_TRUE(sri::cacheFileExists("values", config_));
+
+  reopen();
+  EXPECT_TRUE(sri::cacheFileExists("values", config_));
+  EXPECT_FALSE(fs::exists(sdsl::cache_file_name("values", config_) + ".tmp"));
+}